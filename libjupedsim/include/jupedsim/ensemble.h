@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "error.h"
+#include "export.h"
+#include "simulation.h"
+#include "types.h"
+
+#include <stdbool.h> /*NOLINT(modernize-deprecated-headers)*/
+#include <stddef.h> /*NOLINT(modernize-deprecated-headers)*/
+#include <stdint.h> /*NOLINT(modernize-deprecated-headers)*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Callback type creating the simulation of a single run of an ensemble.
+ * Called concurrently from several threads. Simulations created from the same JPS_Geometry share
+ * its data, so a factory should create the geometry once and pass it via 'userdata'.
+ * @param run index of the run in [0, run_count)
+ * @param userdata optional pointer passed to JPS_Ensemble_Run
+ * @return the simulation of this run, the ensemble takes ownership. NULL marks the run as failed.
+ */
+typedef JPS_Simulation (*JPS_EnsembleScenarioFactory)(size_t run, void* userdata);
+
+/**
+ * Describes how an ensemble is executed.
+ */
+typedef struct JPS_EnsembleSettings {
+    /**
+     * Number of simulations to run
+     */
+    size_t run_count;
+    /**
+     * A run ends after this many iterations or once no agents are left
+     */
+    uint64_t max_iterations;
+    /**
+     * Number of threads to use, 0 uses one thread per hardware thread
+     */
+    size_t thread_count;
+    /**
+     * Record agent positions every 'trajectory_interval' iterations, 0 disables recording
+     */
+    uint64_t trajectory_interval;
+} JPS_EnsembleSettings;
+
+/**
+ * Summary of a single run of an ensemble.
+ */
+typedef struct JPS_EnsembleRunSummary {
+    /**
+     * False if the simulation could not be created or an iteration failed
+     */
+    bool success;
+    /**
+     * Number of iterations performed
+     */
+    uint64_t iterations;
+    /**
+     * Simulated time in seconds when the run ended
+     */
+    double elapsed_time;
+    /**
+     * Agents still in the simulation when the run ended
+     */
+    size_t agent_count;
+    /**
+     * Agents removed during the run
+     */
+    size_t removed_agent_count;
+} JPS_EnsembleRunSummary;
+
+/**
+ * Position of an agent recorded during an ensemble run.
+ */
+typedef struct JPS_TrajectorySample {
+    /**
+     * Iteration the position was recorded at
+     */
+    uint64_t iteration;
+    JPS_AgentId agent_id;
+    JPS_Point position;
+} JPS_TrajectorySample;
+
+/**
+ * Opaque type holding the results of all runs of an ensemble.
+ */
+typedef struct JPS_EnsembleResult_t* JPS_EnsembleResult;
+
+/**
+ * Runs 'settings.run_count' simulations created by 'factory' on a work stealing thread pool.
+ * Returns once all runs ended. A failing run does not affect the other runs.
+ * @param factory creating the simulation for each run
+ * @param userdata passed to each call of 'factory'
+ * @param settings of the ensemble
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return the results, NULL on error. Free with JPS_EnsembleResult_Free.
+ */
+JUPEDSIM_API JPS_EnsembleResult JPS_Ensemble_Run(
+    JPS_EnsembleScenarioFactory factory,
+    void* userdata,
+    JPS_EnsembleSettings settings,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Number of runs in the ensemble.
+ * @param handle of the result to operate on
+ * @return number of runs
+ */
+JUPEDSIM_API size_t JPS_EnsembleResult_RunCount(JPS_EnsembleResult handle);
+
+/**
+ * Summary of a single run.
+ * @param handle of the result to operate on
+ * @param run index of the run, must be less than JPS_EnsembleResult_RunCount
+ * @return the summary
+ */
+JUPEDSIM_API JPS_EnsembleRunSummary
+JPS_EnsembleResult_Summary(JPS_EnsembleResult handle, size_t run);
+
+/**
+ * Reason a run failed.
+ * @param handle of the result to operate on
+ * @param run index of the run, must be less than JPS_EnsembleResult_RunCount
+ * @return the error message or NULL if the run succeeded. Owned by 'handle'.
+ */
+JUPEDSIM_API const char* JPS_EnsembleResult_Error(JPS_EnsembleResult handle, size_t run);
+
+/**
+ * Access the recorded trajectory of a single run, ordered by iteration.
+ * @param handle of the result to operate on
+ * @param run index of the run, must be less than JPS_EnsembleResult_RunCount
+ * @param[out] data will point to the samples, owned by 'handle'
+ * @return number of samples
+ */
+JUPEDSIM_API size_t JPS_EnsembleResult_Trajectory(
+    JPS_EnsembleResult handle,
+    size_t run,
+    const JPS_TrajectorySample** data);
+
+/**
+ * Frees a JPS_EnsembleResult.
+ * @param handle to the result to free
+ */
+JUPEDSIM_API void JPS_EnsembleResult_Free(JPS_EnsembleResult handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "error.h"
+#include "export.h"
+#include "simulation.h"
+
+#include <stdbool.h> /*NOLINT(modernize-deprecated-headers)*/
+#include <stddef.h> /*NOLINT(modernize-deprecated-headers)*/
+#include <stdint.h> /*NOLINT(modernize-deprecated-headers)*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A frame ring buffer publishes agent frames through named shared memory to other processes on
+ * the same machine, e.g. a live viewer. The buffer keeps the most recent frames, publishing never
+ * waits for readers. Readers detect frames that were overwritten while they were copied and
+ * discard them.
+ */
+
+/**
+ * Opaque type of a frame ring buffer writer.
+ */
+typedef struct JPS_FrameRingBufferWriter_t* JPS_FrameRingBufferWriter;
+
+/**
+ * Creates the shared memory for a frame ring buffer, an existing buffer with the same name is
+ * replaced.
+ * @param name of the shared memory, e.g. "jupedsim-live"
+ * @param slots number of frames kept, needs to be greater than 0
+ * @param capacity maximum number of agents per frame
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return the writer, NULL on error. Free with JPS_FrameRingBufferWriter_Free.
+ */
+JUPEDSIM_API JPS_FrameRingBufferWriter JPS_FrameRingBufferWriter_Create(
+    const char* name,
+    uint32_t slots,
+    size_t capacity,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Publishes a frame, overwriting the oldest frame once all slots are used.
+ * @param handle of the writer to operate on
+ * @param frame number of the frame
+ * @param geometry_version identifies the geometry the agents move in
+ * @param time of the frame in seconds
+ * @param count number of agents, length of all arrays, at most 'capacity'
+ * @param ids of the agents
+ * @param x coordinates of the agents
+ * @param y coordinates of the agents
+ * @param orientation_x of the agents
+ * @param orientation_y of the agents
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success
+ */
+JUPEDSIM_API bool JPS_FrameRingBufferWriter_Publish(
+    JPS_FrameRingBufferWriter handle,
+    uint64_t frame,
+    uint64_t geometry_version,
+    double time,
+    size_t count,
+    const uint64_t* ids,
+    const double* x,
+    const double* y,
+    const double* orientation_x,
+    const double* orientation_y,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Publishes all agents of 'simulation' at its current time. The id of the active geometry is used
+ * as geometry version, it changes whenever the geometry is switched.
+ * @param handle of the writer to operate on
+ * @param simulation to read the agents from
+ * @param frame number of the frame
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success
+ */
+JUPEDSIM_API bool JPS_FrameRingBufferWriter_PublishSimulation(
+    JPS_FrameRingBufferWriter handle,
+    JPS_Simulation simulation,
+    uint64_t frame,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Frees a JPS_FrameRingBufferWriter and removes the name of the shared memory. Readers that
+ * opened the buffer before can still read it.
+ * @param handle to the writer to free
+ */
+JUPEDSIM_API void JPS_FrameRingBufferWriter_Free(JPS_FrameRingBufferWriter handle);
+
+/**
+ * Opaque type of a frame ring buffer reader.
+ */
+typedef struct JPS_FrameRingBufferReader_t* JPS_FrameRingBufferReader;
+
+/**
+ * Describes a frame read from a frame ring buffer.
+ */
+typedef struct JPS_FrameRingBufferFrame {
+    /**
+     * Position of the frame in the order of publishing, starting at 0
+     */
+    uint64_t index;
+    uint64_t frame;
+    uint64_t geometry_version;
+    double time;
+    size_t agent_count;
+} JPS_FrameRingBufferFrame;
+
+/**
+ * Opens a frame ring buffer created by JPS_FrameRingBufferWriter_Create, possibly in another
+ * process.
+ * @param name of the shared memory
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return the reader, NULL on error. Free with JPS_FrameRingBufferReader_Free.
+ */
+JUPEDSIM_API JPS_FrameRingBufferReader
+JPS_FrameRingBufferReader_Open(const char* name, JPS_ErrorMessage* errorMessage);
+
+/**
+ * Maximum number of agents per frame.
+ * @param handle of the reader to operate on
+ * @return the capacity
+ */
+JUPEDSIM_API size_t JPS_FrameRingBufferReader_Capacity(JPS_FrameRingBufferReader handle);
+
+/**
+ * Number of frames published so far, including overwritten frames.
+ * @param handle of the reader to operate on
+ * @return number of published frames
+ */
+JUPEDSIM_API uint64_t JPS_FrameRingBufferReader_PublishedCount(JPS_FrameRingBufferReader handle);
+
+/**
+ * Copies a frame.
+ * @param handle of the reader to operate on
+ * @param index of the frame in the order of publishing
+ * @param[out] frame description of the frame
+ * @param[out] ids of the agents, needs to hold 'capacity' values
+ * @param[out] x coordinates of the agents, needs to hold 'capacity' values
+ * @param[out] y coordinates of the agents, needs to hold 'capacity' values
+ * @param[out] orientation_x of the agents, needs to hold 'capacity' values
+ * @param[out] orientation_y of the agents, needs to hold 'capacity' values
+ * @return true if the frame was copied, false if it was not published yet or already overwritten
+ */
+JUPEDSIM_API bool JPS_FrameRingBufferReader_Read(
+    JPS_FrameRingBufferReader handle,
+    uint64_t index,
+    JPS_FrameRingBufferFrame* frame,
+    uint64_t* ids,
+    double* x,
+    double* y,
+    double* orientation_x,
+    double* orientation_y);
+
+/**
+ * Copies the most recently published frame, see JPS_FrameRingBufferReader_Read.
+ * @return true if a frame was copied, false if no frame was published yet
+ */
+JUPEDSIM_API bool JPS_FrameRingBufferReader_ReadLatest(
+    JPS_FrameRingBufferReader handle,
+    JPS_FrameRingBufferFrame* frame,
+    uint64_t* ids,
+    double* x,
+    double* y,
+    double* orientation_x,
+    double* orientation_y);
+
+/**
+ * Frees a JPS_FrameRingBufferReader and unmaps the shared memory.
+ * @param handle to the reader to free
+ */
+JUPEDSIM_API void JPS_FrameRingBufferReader_Free(JPS_FrameRingBufferReader handle);
+
+#ifdef __cplusplus
+}
+#endif
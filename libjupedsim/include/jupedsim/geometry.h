@@ -6,6 +6,7 @@
 #include "operational_model.h"
 #include "types.h"
 
+#include <stdbool.h> /*NOLINT(modernize-deprecated-headers)*/
 #include <stddef.h> /*NOLINT(modernize-deprecated-headers)*/
 
 #ifdef __cplusplus
@@ -15,6 +16,8 @@ extern "C" {
 /**
  * Opaque type that represents the geometry the simulation acts on.
  * This type is created from JPS_GeometryBuilder.
+ * The geometry is immutable and reference counted. Simulations and routing engines created from it
+ * share its data, including the navigation mesh, which is built once on first use.
  */
 typedef struct JPS_Geometry_t const* JPS_Geometry;
 
@@ -107,6 +110,70 @@ JUPEDSIM_API void JPS_GeometryBuilder_ExcludeFromAccessibleArea(
     const JPS_Point* polygon,
     size_t lenPolygon);
 
+/**
+ * Enables simplification of the accessible area when building the geometry. Vertices are removed
+ * as long as the simplified walls stay within 'tolerance' of every removed vertex, this merges
+ * collinear and nearly collinear wall segments and removes wall segments shorter than 'tolerance'.
+ * If the simplified accessible area is not a valid polygon the unsimplified area is used.
+ * @param handle of the JPS_GeometryBuilder to operate on
+ * @param tolerance maximum distance between original and simplified walls in meters, 0 disables
+ * simplification
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error
+ * @return true on success, false on error, e.g. for negative tolerances
+ */
+JUPEDSIM_API bool JPS_GeometryBuilder_SetSimplificationTolerance(
+    JPS_GeometryBuilder handle,
+    double tolerance,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Sets the cell size of the grid the operational models use to find walls within their
+ * interaction range. Cells of about the interaction range perform best, the default is 2m.
+ * @param handle of the JPS_GeometryBuilder to operate on
+ * @param cell_size edge length of the grid cells in meters, needs to be > 0
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error
+ * @return true on success, false on error
+ */
+JUPEDSIM_API bool JPS_GeometryBuilder_SetWallGridCellSize(
+    JPS_GeometryBuilder handle,
+    double cell_size,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Enables a precomputed field of the nearest wall around each point of the geometry. The
+ * Collision Free Speed Model, its V2, the Social Force Model and the Generalized Centrifugal
+ * Force Model then only consider the nearest walls around an agent for the wall forces instead
+ * of all walls within their interaction range. This speeds up geometries with many walls. Walls
+ * being ignored are at least 'sqrt(2) * spacing' farther away than the nearest considered wall.
+ * Interaction ranges above 'range - sqrt(2) * spacing' fall back to the exact wall search.
+ * @param handle of the JPS_GeometryBuilder to operate on
+ * @param spacing distance of neighboring field points in meters, needs to be > 0
+ * @param range distance from the walls in meters covered by the field, needs to be > 0
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error
+ * @return true on success, false on error
+ */
+JUPEDSIM_API bool JPS_GeometryBuilder_SetWallDistanceField(
+    JPS_GeometryBuilder handle,
+    double spacing,
+    double range,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Enables a routing hierarchy of the navigation mesh used by JPS_RoutingAlgorithm_Hierarchical.
+ * The navigation mesh is clustered into regions of about 'region_size' and the distances between
+ * neighboring regions are precomputed, routing then first searches the regions and only the
+ * triangles of the regions along the found path. The hierarchy is built together with the
+ * geometry and stored with it by JPS_GeometryBuilder_BuildCached.
+ * @param handle of the JPS_GeometryBuilder to operate on
+ * @param region_size side length of the regions in meters, needs to be >= 0, 0 disables it
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error
+ * @return true on success, false on error
+ */
+JUPEDSIM_API bool JPS_GeometryBuilder_SetRoutingHierarchy(
+    JPS_GeometryBuilder handle,
+    double region_size,
+    JPS_ErrorMessage* errorMessage);
+
 /**
  * Creates a JPS_Geometry from a JPS_GeometryBuilder. After this call the builder still has to be
  * freed with JPS_GeometryBuilder_Free.
@@ -117,6 +184,22 @@ JUPEDSIM_API void JPS_GeometryBuilder_ExcludeFromAccessibleArea(
 JUPEDSIM_API JPS_Geometry
 JPS_GeometryBuilder_Build(JPS_GeometryBuilder handle, JPS_ErrorMessage* errorMessage);
 
+/**
+ * Creates a JPS_Geometry like JPS_GeometryBuilder_Build but reuses geometries built earlier from
+ * the same polygons. Built geometries, including their navigation mesh, are stored in
+ * 'cache_directory' keyed by a hash of the polygons added to the builder. Loading a stored
+ * geometry skips all polygon operations and the triangulation. The directory is created if needed
+ * and can be shared between processes.
+ * @param handle to operate on.
+ * @param cache_directory directory holding the stored geometries.
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return a JPS_Geometry handle on success or NULL on any error.
+ */
+JUPEDSIM_API JPS_Geometry JPS_GeometryBuilder_BuildCached(
+    JPS_GeometryBuilder handle,
+    const char* cache_directory,
+    JPS_ErrorMessage* errorMessage);
+
 /**
  * Frees a JPS_GeometryBuilder.
  * @param handle to the JPS_GeometryBuilder to free.
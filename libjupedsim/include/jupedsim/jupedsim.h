@@ -6,16 +6,20 @@
 #include "build_info.h"
 #include "collision_free_speed_model.h"
 #include "collision_free_speed_model_v2.h"
+#include "ensemble.h"
 #include "error.h"
 #include "export.h"
+#include "frame_ring_buffer.h"
 #include "generalized_centrifugal_force_model.h"
 #include "geometry.h"
 #include "journey.h"
 #include "logging.h"
+#include "measurement.h"
 #include "operational_model.h"
 #include "routing.h"
 #include "simulation.h"
 #include "social_force_model.h"
 #include "stage.h"
+#include "trajectory_file.h"
 #include "transition.h"
 #include "types.h"
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "error.h"
+#include "export.h"
+#include "simulation.h"
+#include "types.h"
+
+#include <stdbool.h> /*NOLINT(modernize-deprecated-headers)*/
+#include <stddef.h> /*NOLINT(modernize-deprecated-headers)*/
+#include <stdint.h> /*NOLINT(modernize-deprecated-headers)*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Measurements are evaluated by the simulation after the agents moved in each iteration. They are
+ * identified by their index in the order they were added, separately for grids, lines and areas.
+ * Measurements are not part of snapshots and are not copied when forking a simulation.
+ */
+
+/**
+ * Describes a grid measurement.
+ */
+typedef struct JPS_GridMeasurement {
+    /**
+     * Lower left corner of the first cell
+     */
+    JPS_Point origin;
+    /**
+     * Edge length of the square cells in 'meters'
+     */
+    double cell_size;
+    /**
+     * Number of cells along the x-axis
+     */
+    size_t columns;
+    /**
+     * Number of cells along the y-axis
+     */
+    size_t rows;
+    /**
+     * Number of samples taken so far
+     */
+    uint64_t samples;
+} JPS_GridMeasurement;
+
+/**
+ * Measures the number of agents per cell and their speed on a grid every 'interval' seconds,
+ * starting with the next iteration. The grid starts at 'min' and is extended to a multiple of
+ * 'cell_size' towards 'max' if needed.
+ * @param handle of the Simulation to operate on
+ * @param min lower left corner of the measured area
+ * @param max upper right corner of the measured area
+ * @param cell_size edge length of the cells, needs to be greater than 0
+ * @param interval time in seconds between two samples, needs to be greater than 0
+ * @param[out] id of the grid measurement
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error
+ */
+JUPEDSIM_API bool JPS_Simulation_AddGridMeasurement(
+    JPS_Simulation handle,
+    JPS_Point min,
+    JPS_Point max,
+    double cell_size,
+    double interval,
+    size_t* id,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Describes a grid measurement added with JPS_Simulation_AddGridMeasurement.
+ * @param handle of the Simulation to operate on
+ * @param id of the grid measurement
+ * @param[out] grid description of the grid
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. unknown id
+ */
+JUPEDSIM_API bool JPS_Simulation_GetGridMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    JPS_GridMeasurement* grid,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Reads the fields of a grid measurement averaged over all samples. Cells are stored row by row
+ * starting with the cell at 'origin'.
+ * @param handle of the Simulation to operate on
+ * @param id of the grid measurement
+ * @param[out] density agents per square meter, needs to hold 'columns' * 'rows' values
+ * @param[out] speed mean speed of the agents in 'meters/second', NaN for cells no agent was
+ * sampled in, needs to hold 'columns' * 'rows' values
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. unknown id
+ */
+JUPEDSIM_API bool JPS_Simulation_ReadGridMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    double* density,
+    double* speed,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * An agent crossing a measurement line.
+ */
+typedef struct JPS_LineCrossing {
+    /**
+     * Time in seconds the agent crossed the line, interpolated within the iteration
+     */
+    double time;
+    JPS_AgentId agent_id;
+    /**
+     * 1 if the agent crossed from the right to the left side of the line from 'p1' to 'p2', -1
+     * otherwise
+     */
+    int8_t direction;
+} JPS_LineCrossing;
+
+/**
+ * Records all agents crossing the line segment from 'p1' to 'p2'.
+ * @param handle of the Simulation to operate on
+ * @param p1 start of the line
+ * @param p2 end of the line, needs to differ from 'p1'
+ * @param[out] id of the line measurement
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error
+ */
+JUPEDSIM_API bool JPS_Simulation_AddLineMeasurement(
+    JPS_Simulation handle,
+    JPS_Point p1,
+    JPS_Point p2,
+    size_t* id,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Number of agents that crossed a measurement line so far.
+ * @param handle of the Simulation to operate on
+ * @param id of the line measurement
+ * @param[out] forward number of crossings with direction 1
+ * @param[out] backward number of crossings with direction -1
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. unknown id
+ */
+JUPEDSIM_API bool JPS_Simulation_GetLineMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    uint64_t* forward,
+    uint64_t* backward,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Reads the crossings of a measurement line ordered by time.
+ * @param handle of the Simulation to operate on
+ * @param id of the line measurement
+ * @param[out] crossings needs to hold 'forward' + 'backward' elements, see
+ * JPS_Simulation_GetLineMeasurement
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. unknown id
+ */
+JUPEDSIM_API bool JPS_Simulation_ReadLineMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    JPS_LineCrossing* crossings,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Counts the agents inside a polygon every 'interval' seconds, starting with the next iteration.
+ * @param handle of the Simulation to operate on
+ * @param polygon simple polygon, may be concave
+ * @param len_polygon number of points in 'polygon'
+ * @param interval time in seconds between two samples, needs to be greater than 0
+ * @param[out] id of the area measurement
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. polygon is not simple
+ */
+JUPEDSIM_API bool JPS_Simulation_AddAreaMeasurement(
+    JPS_Simulation handle,
+    const JPS_Point* polygon,
+    size_t len_polygon,
+    double interval,
+    size_t* id,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Number of samples an area measurement took so far.
+ * @param handle of the Simulation to operate on
+ * @param id of the area measurement
+ * @param[out] samples number of samples
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. unknown id
+ */
+JUPEDSIM_API bool JPS_Simulation_GetAreaMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    size_t* samples,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Reads the samples of an area measurement.
+ * @param handle of the Simulation to operate on
+ * @param id of the area measurement
+ * @param[out] times in seconds of the samples, needs to hold 'samples' values
+ * @param[out] counts number of agents inside the polygon, needs to hold 'samples' values
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. unknown id
+ */
+JUPEDSIM_API bool JPS_Simulation_ReadAreaMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    double* times,
+    uint64_t* counts,
+    JPS_ErrorMessage* errorMessage);
+
+#ifdef __cplusplus
+}
+#endif
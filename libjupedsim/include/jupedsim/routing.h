@@ -1,10 +1,12 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "error.h"
 #include "export.h"
 #include "geometry.h"
 #include "types.h"
 
+#include <stdbool.h> /*NOLINT(modernize-deprecated-headers)*/
 #include <stddef.h> /*NOLINT(modernize-deprecated-headers)*/
 
 #ifdef __cplusplus
@@ -87,15 +89,68 @@ JUPEDSIM_API void JPS_Mesh_Free(JPS_Mesh mesh);
  */
 typedef struct JPS_RoutingEngine_t* JPS_RoutingEngine;
 
+/**
+ * Creates a routing engine sharing the navigation mesh of 'geometry'.
+ * @param geometry to route on, can be freed after this call.
+ * @return the routing engine, free with JPS_RoutingEngine_Free.
+ */
 JUPEDSIM_API JPS_RoutingEngine JPS_RoutingEngine_Create(JPS_Geometry geometry);
 
 JUPEDSIM_API JPS_Path
 JPS_RoutingEngine_ComputeWaypoint(JPS_RoutingEngine handle, JPS_Point from, JPS_Point to);
 
+/**
+ * Computes the paths between many pairs of points on several threads, e.g. to fill a distance
+ * matrix. Pairs that cannot be routed, because a point is outside of the walkable area or the
+ * points are not connected, receive an infinite length and no waypoints.
+ * @param handle of the routing engine to operate on
+ * @param from array of 'pairs_len' start points
+ * @param to array of 'pairs_len' target points
+ * @param pairs_len number of pairs
+ * @param algorithm search used for all pairs
+ * @param thread_count number of threads to use, 0 uses one thread per hardware thread
+ * @param[out] lengths array of 'pairs_len' elements, receives the length of each path
+ * @param max_waypoints number of waypoints stored per pair in 'waypoints'
+ * @param[out] waypoints NULL or array of 'pairs_len' * 'max_waypoints' elements, receives the
+ * waypoints of pair i including start and target at waypoints[i * max_waypoints]. Only the first
+ * 'max_waypoints' waypoints of longer paths are written.
+ * @param[out] waypoint_counts NULL or array of 'pairs_len' elements, receives the number of
+ * waypoints of each path, may exceed 'max_waypoints'.
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true if the paths were computed, otherwise false
+ */
+JUPEDSIM_API bool JPS_RoutingEngine_ComputeWaypoints(
+    JPS_RoutingEngine handle,
+    const JPS_Point* from,
+    const JPS_Point* to,
+    size_t pairs_len,
+    JPS_RoutingAlgorithm algorithm,
+    size_t thread_count,
+    double* lengths,
+    size_t max_waypoints,
+    JPS_Point* waypoints,
+    size_t* waypoint_counts,
+    JPS_ErrorMessage* errorMessage);
+
 JUPEDSIM_API bool JPS_RoutingEngine_IsRoutable(JPS_RoutingEngine handle, JPS_Point p);
 
 JUPEDSIM_API JPS_Mesh JPS_RoutingEngine_Mesh(JPS_RoutingEngine handle);
 
+/**
+ * Locates many points in the navigation mesh at once.
+ * @param handle of the routing engine to operate on
+ * @param points to locate
+ * @param points_len number of points in 'points'
+ * @param[out] polygon_indices array of 'points_len' elements, receives for each point the index of
+ * the containing polygon in JPS_Mesh::polygons as returned by JPS_RoutingEngine_Mesh or SIZE_MAX if
+ * the point is outside of the mesh.
+ */
+JUPEDSIM_API void JPS_RoutingEngine_FindContainingPolygons(
+    JPS_RoutingEngine handle,
+    const JPS_Point* points,
+    size_t points_len,
+    size_t* polygon_indices);
+
 JUPEDSIM_API void JPS_RoutingEngine_Free(JPS_RoutingEngine handle);
 
 #ifdef __cplusplus
@@ -24,14 +24,23 @@ extern "C" {
  */
 typedef struct JPS_Simulation_t* JPS_Simulation;
 
+/**
+ * Callback type for observing a simulation during JPS_Simulation_IterateN.
+ * The observer must not modify the simulation other than through the proxy and agent APIs.
+ * @param handle of the Simulation being iterated
+ * @param userdata optional pointer passed to JPS_Simulation_IterateN
+ * @return true to continue iterating, false to stop early
+ */
+typedef bool (*JPS_IterationObserver)(JPS_Simulation handle, void* userdata);
+
 /*
  * Creates a new JPS_Simulation object.
  * NOTE: JPS_Simulation_Create will take ownership of all indicated parameters even in case an error
  * occured.
  * @param model to use. Will copy 'model', 'model' can be freed after this call or reused for
  * another simulation.
- * @param geometry to use. Will copy 'geometry', 'geometry' can be freed after this call or reused
- * for another simulation.
+ * @param geometry to use. Will share the data of 'geometry', 'geometry' can be freed after this
+ * call or reused for another simulation.
  * @param dT simulation timestep in seconds
  * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
  * @return the Simulation
@@ -250,6 +259,28 @@ JUPEDSIM_API size_t JPS_Simulation_RemovedAgents(JPS_Simulation handle, const JP
  */
 JUPEDSIM_API bool JPS_Simulation_Iterate(JPS_Simulation handle, JPS_ErrorMessage* errorMessage);
 
+/**
+ * Advances the simulation by 'count' steps without returning to the caller in between.
+ * If an observer is supplied it is called after each step that results in an iteration count
+ * divisible by 'observerInterval', i.e. at the same frames a trajectory writer with the same
+ * interval writes.
+ * @param handle of the Simulation
+ * @param count number of steps to advance
+ * @param observerInterval number of iterations between two observer calls, needs to be greater than
+ * 0 if an observer is supplied
+ * @param observer optional callback, may be NULL
+ * @param userdata optional pointer passed to observer (non-owning)
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true if no errors occured, iterating stops at the first error
+ */
+JUPEDSIM_API bool JPS_Simulation_IterateN(
+    JPS_Simulation handle,
+    uint64_t count,
+    uint64_t observerInterval,
+    JPS_IterationObserver observer,
+    void* userdata,
+    JPS_ErrorMessage* errorMessage);
+
 /**
  * How many agents are in the simulation.
  * @param handle of the simulation
@@ -298,7 +329,8 @@ JUPEDSIM_API JPS_Agent
 JPS_Simulation_GetAgent(JPS_Simulation handle, JPS_AgentId agentId, JPS_ErrorMessage* errorMessage);
 
 /**
- * Switches the journey and currently selected stage of this agent
+ * Switches the journey and currently selected stage of this agent. Records a StageChanged event
+ * if the selected stage changes.
  * @param handle of the Simulation to operate on
  * @param agentId id of the agent to modify
  * @param journeyId of the journey to select
@@ -313,6 +345,64 @@ JUPEDSIM_API bool JPS_Simulation_SwitchAgentJourney(
     JPS_StageId stageId,
     JPS_ErrorMessage* errorMessage);
 
+/**
+ * Pops agents from a notifiable queue at a fixed service rate during the simulation. Pops that fall
+ * due within the same iteration, e.g. with an interval shorter than the time step, are combined.
+ * @param handle of the Simulation to operate on
+ * @param stageId of the notifiable queue to pop from
+ * @param interval time in seconds between two pops, needs to be greater than 0
+ * @param count number of agents to pop each time, needs to be greater than 0
+ * @param startTime time in seconds of the first pop
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. stage is not a notifiable queue
+ */
+JUPEDSIM_API bool JPS_Simulation_AddPeriodicQueuePop(
+    JPS_Simulation handle,
+    JPS_StageId stageId,
+    double interval,
+    size_t count,
+    double startTime,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Deactivates a waiting set once the given number of agents are waiting and activates it again
+ * once the number of agents targeting it dropped to the given number. Thresholds are checked at the
+ * beginning of each iteration.
+ * @param handle of the Simulation to operate on
+ * @param stageId of the waiting set to control
+ * @param deactivateAt number of waiting agents to deactivate the waiting set at, needs to be
+ * between 1 and the number of waiting positions
+ * @param activateAt number of targeting agents to activate the waiting set at, needs to be less
+ * than deactivateAt
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. stage is not a waiting set
+ */
+JUPEDSIM_API bool JPS_Simulation_AddWaitingSetThresholds(
+    JPS_Simulation handle,
+    JPS_StageId stageId,
+    size_t deactivateAt,
+    size_t activateAt,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Switches all agents following a journey to a stage of another journey at the given time.
+ * The switch is applied at the beginning of the first iteration starting at or after 'time'.
+ * @param handle of the Simulation to operate on
+ * @param time in seconds to switch at
+ * @param fromJourneyId journey of the agents to switch
+ * @param toJourneyId journey to switch the agents to
+ * @param toStageId stage in 'toJourneyId' the agents continue with
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success, false on any error, e.g. unknown journey id
+ */
+JUPEDSIM_API bool JPS_Simulation_ScheduleJourneySwitch(
+    JPS_Simulation handle,
+    double time,
+    JPS_JourneyId fromJourneyId,
+    JPS_JourneyId toJourneyId,
+    JPS_StageId toStageId,
+    JPS_ErrorMessage* errorMessage);
+
 /**
  * Query the pedestrian model used by this simulation.
  * @return the type of pedestrian model used in this simulation instance.
@@ -373,6 +463,19 @@ JUPEDSIM_API JPS_DirectSteeringProxy JPS_Simulation_GetDirectSteeringProxy(
  */
 JUPEDSIM_API void JPS_Simulation_SetTracing(JPS_Simulation handle, bool status);
 
+/**
+ * Enable / disable sampling of hardware performance counters (cycles, instructions, cache misses,
+ * branch misses) for each traced span. Counters are only sampled while tracing is enabled with
+ * JPS_Simulation_SetTracing. Counters measure the thread running the traced span.
+ * Hardware counters are only supported on Linux and require permission to use perf events, see
+ * '/proc/sys/kernel/perf_event_paranoid'. If counters are not available tracing continues to work
+ * and all counter values are reported as zero.
+ * @param handle of the Simulation to operate on
+ * @param status new status to set
+ * @return true if hardware counters are enabled and available after this call
+ */
+JUPEDSIM_API bool JPS_Simulation_SetHardwareCounters(JPS_Simulation handle, bool status);
+
 /**
  * Read trace data from alst iteration. If tracing is disable all timings will be zero.
  * @param handle of the Simulation to operate on
@@ -380,11 +483,63 @@ JUPEDSIM_API void JPS_Simulation_SetTracing(JPS_Simulation handle, bool status);
  */
 JUPEDSIM_API JPS_Trace JPS_Simulation_GetTrace(JPS_Simulation handle);
 
+/**
+ * Read the estimated heap memory usage of the simulation per subsystem.
+ * Agent related values are sampled on each call, their peaks are the maximum over all calls.
+ * Geometry related values are sampled whenever the geometry changes. Values are estimates based
+ * on container sizes and do not include allocator overhead.
+ * @param handle of the Simulation to operate on
+ * @return memory usage per subsystem
+ */
+JUPEDSIM_API JPS_MemoryStats JPS_Simulation_GetMemoryStats(JPS_Simulation handle);
+
+/**
+ * Enable / disable recording of events, see JPS_EventType. Recording is disabled by default.
+ * Disabling recording discards all events that have not been read.
+ * @param handle of the Simulation to operate on
+ * @param status enable / disable event recording
+ */
+JUPEDSIM_API void JPS_Simulation_SetEventRecording(JPS_Simulation handle, bool status);
+
+/**
+ * Select the path search used to route agents, see JPS_RoutingAlgorithm.
+ * Defaults to JPS_RoutingAlgorithm_TriangleAStar.
+ * @param handle of the Simulation to operate on
+ * @param algorithm to use from the next iteration on
+ */
+JUPEDSIM_API void
+JPS_Simulation_SetRoutingAlgorithm(JPS_Simulation handle, JPS_RoutingAlgorithm algorithm);
+
+/**
+ * Path search used to route agents.
+ * @param handle of the Simulation to operate on
+ * @return the selected algorithm
+ */
+JUPEDSIM_API JPS_RoutingAlgorithm JPS_Simulation_GetRoutingAlgorithm(JPS_Simulation handle);
+
+/**
+ * Number of recorded events that have not been read yet.
+ * @param handle of the Simulation to operate on
+ * @return count of unread events
+ */
+JUPEDSIM_API size_t JPS_Simulation_EventCount(JPS_Simulation handle);
+
+/**
+ * Copies the oldest unread events into the caller provided buffer and removes them from the
+ * simulation. Events are kept until they are read, so they can be read after any number of
+ * iterations. Events are ordered by the time they occurred.
+ * @param handle of the Simulation to operate on
+ * @param[out] buffer receives up to 'capacity' events
+ * @param capacity number of events 'buffer' can hold
+ * @return number of events written to 'buffer'
+ */
+JUPEDSIM_API size_t
+JPS_Simulation_ReadEvents(JPS_Simulation handle, JPS_Event* buffer, size_t capacity);
+
 /**
  * Gain read access to the geometry used by this simulation.
  * @param handle of the Simulation to operate on
- * @return the geometry. Do not call JPS_Geometry_Free on this handle,
- * the geometry is still owned by the simulation!
+ * @return the geometry, sharing its data with the simulation. Free with JPS_Geometry_Free.
  */
 JUPEDSIM_API JPS_Geometry JPS_Simulation_GetGeometry(JPS_Simulation handle);
 
@@ -394,6 +549,60 @@ JUPEDSIM_API bool JPS_Simulation_SwitchGeometry(
     JPS_AgentIdIterator* faultyAgents,
     JPS_ErrorMessage* errorMessage);
 
+/**
+ * Writes the complete state of the simulation to a binary snapshot file. The snapshot contains all
+ * stages, journeys and agents including their model parameters, the stage controllers and the
+ * iteration. Recorded events, statistics and the random state of the operational model are not
+ * part of a snapshot.
+ * @param handle of the Simulation to operate on
+ * @param path of the file to write, an existing file is replaced
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success
+ */
+JUPEDSIM_API bool JPS_Simulation_SaveSnapshot(
+    JPS_Simulation handle,
+    const char* path,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Restores a snapshot written by JPS_Simulation_SaveSnapshot. The simulation needs to be created
+ * with the same operational model, geometry and time step as the simulation the snapshot was taken
+ * from and may not contain any stages, journeys or agents yet. All ids are the same as in the
+ * snapshot. The simulation should be freed if restoring fails.
+ * @param handle of the Simulation to operate on
+ * @param path of the snapshot file
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success
+ */
+JUPEDSIM_API bool JPS_Simulation_LoadSnapshot(
+    JPS_Simulation handle,
+    const char* path,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Creates an independent copy of a simulation, e.g. to run several continuations from one state.
+ * The copy shares the geometry with 'handle' and copies all stages, journeys, agents and stage
+ * controllers. Ids are the same in both simulations. Recorded events and statistics are not copied.
+ * The random number generator of the operational model continues with the same state as in
+ * 'handle', use JPS_Simulation_CloneWithSeed to diverge stochastic models.
+ * @param handle of the Simulation to copy
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return the copy or NULL on error. Free with JPS_Simulation_Free.
+ */
+JUPEDSIM_API JPS_Simulation
+JPS_Simulation_Clone(JPS_Simulation handle, JPS_ErrorMessage* errorMessage);
+
+/**
+ * Same as JPS_Simulation_Clone but restarts the random number generator of the copied operational
+ * model from 'seed'. Deterministic models are not affected by the seed.
+ * @param handle of the Simulation to copy
+ * @param seed for the random number generator of the copy
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return the copy or NULL on error. Free with JPS_Simulation_Free.
+ */
+JUPEDSIM_API JPS_Simulation
+JPS_Simulation_CloneWithSeed(JPS_Simulation handle, uint64_t seed, JPS_ErrorMessage* errorMessage);
+
 /**
  * Frees a JPS_Simulation.
  * @param handle to the JPS_Simulation to free.
@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "error.h"
+#include "export.h"
+#include "simulation.h"
+
+#include <stdbool.h> /*NOLINT(modernize-deprecated-headers)*/
+#include <stddef.h> /*NOLINT(modernize-deprecated-headers)*/
+#include <stdint.h> /*NOLINT(modernize-deprecated-headers)*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Representation of the coordinate columns in a columnar trajectory file.
+ */
+typedef enum JPS_TrajectoryStorage {
+    /**
+     * double, lossless
+     */
+    JPS_TrajectoryStorage_Float64,
+    /**
+     * float, about 7 significant digits
+     */
+    JPS_TrajectoryStorage_Float32,
+    /**
+     * int32_t multiples of the quantization step
+     */
+    JPS_TrajectoryStorage_Quantized
+} JPS_TrajectoryStorage;
+
+/**
+ * Opaque type of a columnar trajectory file writer.
+ */
+typedef struct JPS_TrajectoryFileWriter_t* JPS_TrajectoryFileWriter;
+
+/**
+ * Creates a columnar trajectory file, an existing file is overwritten.
+ * @param path of the file
+ * @param storage of the coordinate columns
+ * @param quantization_step distance represented by one unit in JPS_TrajectoryStorage_Quantized,
+ * ignored for all other storages
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return the writer, NULL on error. Free with JPS_TrajectoryFileWriter_Free.
+ */
+JUPEDSIM_API JPS_TrajectoryFileWriter JPS_TrajectoryFileWriter_Create(
+    const char* path,
+    JPS_TrajectoryStorage storage,
+    double quantization_step,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Sets a metadata entry, replacing an existing value of 'key'.
+ * @param handle of the writer to operate on
+ * @param key of the entry
+ * @param value of the entry
+ */
+JUPEDSIM_API void JPS_TrajectoryFileWriter_SetMetadata(
+    JPS_TrajectoryFileWriter handle,
+    const char* key,
+    const char* value);
+
+/**
+ * Adds a geometry that frames can refer to.
+ * @param handle of the writer to operate on
+ * @param hash identifying the geometry
+ * @param wkt of the geometry
+ * @return index of the geometry, the existing index if a geometry with 'hash' was added before
+ */
+JUPEDSIM_API uint64_t JPS_TrajectoryFileWriter_AddGeometry(
+    JPS_TrajectoryFileWriter handle,
+    int64_t hash,
+    const char* wkt);
+
+/**
+ * Appends a frame. Frame numbers need to be ascending, agents may be passed in any order.
+ * @param handle of the writer to operate on
+ * @param frame number of the frame
+ * @param geometry index returned by JPS_TrajectoryFileWriter_AddGeometry
+ * @param count number of agents, length of all arrays
+ * @param ids of the agents
+ * @param x coordinates of the agents
+ * @param y coordinates of the agents
+ * @param orientation_x of the agents
+ * @param orientation_y of the agents
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success
+ */
+JUPEDSIM_API bool JPS_TrajectoryFileWriter_WriteFrame(
+    JPS_TrajectoryFileWriter handle,
+    uint64_t frame,
+    uint64_t geometry,
+    size_t count,
+    const uint64_t* ids,
+    const double* x,
+    const double* y,
+    const double* orientation_x,
+    const double* orientation_y,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Appends a frame holding all agents of 'simulation'.
+ * @param handle of the writer to operate on
+ * @param simulation to read the agents from
+ * @param frame number of the frame
+ * @param geometry index returned by JPS_TrajectoryFileWriter_AddGeometry
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success
+ */
+JUPEDSIM_API bool JPS_TrajectoryFileWriter_WriteSimulation(
+    JPS_TrajectoryFileWriter handle,
+    JPS_Simulation simulation,
+    uint64_t frame,
+    uint64_t geometry,
+    JPS_ErrorMessage* errorMessage);
+
+/**
+ * Writes the frame index and closes the file. A file that was not closed cannot be read.
+ * @param handle of the writer to operate on
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return true on success
+ */
+JUPEDSIM_API bool
+JPS_TrajectoryFileWriter_Close(JPS_TrajectoryFileWriter handle, JPS_ErrorMessage* errorMessage);
+
+/**
+ * Frees a JPS_TrajectoryFileWriter without closing the file.
+ * @param handle to the writer to free
+ */
+JUPEDSIM_API void JPS_TrajectoryFileWriter_Free(JPS_TrajectoryFileWriter handle);
+
+/**
+ * Opaque type of a columnar trajectory file reader.
+ */
+typedef struct JPS_TrajectoryFileReader_t* JPS_TrajectoryFileReader;
+
+/**
+ * A single frame of a columnar trajectory file.
+ */
+typedef struct JPS_TrajectoryFrame {
+    uint64_t frame;
+    /**
+     * Index of the geometry, see JPS_TrajectoryFileReader_Geometry
+     */
+    uint64_t geometry;
+    size_t agent_count;
+    /**
+     * Coordinate columns with 'agent_count' values each, ordered by agent id. The values are of
+     * the storage type of the file, see JPS_TrajectoryFileReader_Storage. Owned by the reader.
+     */
+    const void* x;
+    const void* y;
+    const void* orientation_x;
+    const void* orientation_y;
+} JPS_TrajectoryFrame;
+
+/**
+ * Opens a columnar trajectory file through a read only memory mapping.
+ * @param path of the file
+ * @param[out] errorMessage if not NULL: will be set to a JPS_ErrorMessage in case of an error.
+ * @return the reader, NULL on error. Free with JPS_TrajectoryFileReader_Free.
+ */
+JUPEDSIM_API JPS_TrajectoryFileReader
+JPS_TrajectoryFileReader_Open(const char* path, JPS_ErrorMessage* errorMessage);
+
+/**
+ * Storage of the coordinate columns.
+ * @param handle of the reader to operate on
+ * @return the storage
+ */
+JUPEDSIM_API JPS_TrajectoryStorage
+JPS_TrajectoryFileReader_Storage(JPS_TrajectoryFileReader handle);
+
+/**
+ * Distance represented by one unit in JPS_TrajectoryStorage_Quantized.
+ * @param handle of the reader to operate on
+ * @return the quantization step
+ */
+JUPEDSIM_API double JPS_TrajectoryFileReader_QuantizationStep(JPS_TrajectoryFileReader handle);
+
+/**
+ * Number of frames in the file.
+ * @param handle of the reader to operate on
+ * @return number of frames
+ */
+JUPEDSIM_API size_t JPS_TrajectoryFileReader_FrameCount(JPS_TrajectoryFileReader handle);
+
+/**
+ * Access a frame without copying its coordinates.
+ * @param handle of the reader to operate on
+ * @param index of the frame in the file, must be less than JPS_TrajectoryFileReader_FrameCount
+ * @return the frame
+ */
+JUPEDSIM_API JPS_TrajectoryFrame
+JPS_TrajectoryFileReader_Frame(JPS_TrajectoryFileReader handle, size_t index);
+
+/**
+ * Decodes the agent ids of a frame, sorted ascending.
+ * @param handle of the reader to operate on
+ * @param index of the frame in the file, must be less than JPS_TrajectoryFileReader_FrameCount
+ * @param[out] ids needs to hold 'agent_count' elements of the frame
+ */
+JUPEDSIM_API void
+JPS_TrajectoryFileReader_FrameIds(JPS_TrajectoryFileReader handle, size_t index, uint64_t* ids);
+
+/**
+ * Converts a coordinate column of a frame to double.
+ * @param handle of the reader to operate on
+ * @param column one of the coordinate columns of a JPS_TrajectoryFrame of this reader
+ * @param count 'agent_count' of the frame
+ * @param[out] values needs to hold 'count' elements
+ */
+JUPEDSIM_API void JPS_TrajectoryFileReader_DecodeColumn(
+    JPS_TrajectoryFileReader handle,
+    const void* column,
+    size_t count,
+    double* values);
+
+/**
+ * Number of metadata entries.
+ * @param handle of the reader to operate on
+ * @return number of entries
+ */
+JUPEDSIM_API size_t JPS_TrajectoryFileReader_MetadataCount(JPS_TrajectoryFileReader handle);
+
+/**
+ * Access a metadata entry.
+ * @param handle of the reader to operate on
+ * @param index of the entry, must be less than JPS_TrajectoryFileReader_MetadataCount
+ * @param[out] key of the entry, owned by the reader
+ * @param[out] value of the entry, owned by the reader
+ */
+JUPEDSIM_API void JPS_TrajectoryFileReader_Metadata(
+    JPS_TrajectoryFileReader handle,
+    size_t index,
+    const char** key,
+    const char** value);
+
+/**
+ * Number of geometries.
+ * @param handle of the reader to operate on
+ * @return number of geometries
+ */
+JUPEDSIM_API size_t JPS_TrajectoryFileReader_GeometryCount(JPS_TrajectoryFileReader handle);
+
+/**
+ * Access a geometry.
+ * @param handle of the reader to operate on
+ * @param index of the geometry, must be less than JPS_TrajectoryFileReader_GeometryCount
+ * @param[out] hash of the geometry
+ * @return WKT of the geometry, owned by the reader
+ */
+JUPEDSIM_API const char*
+JPS_TrajectoryFileReader_Geometry(JPS_TrajectoryFileReader handle, size_t index, int64_t* hash);
+
+/**
+ * Frees a JPS_TrajectoryFileReader and unmaps the file.
+ * @param handle to the reader to free
+ */
+JUPEDSIM_API void JPS_TrajectoryFileReader_Free(JPS_TrajectoryFileReader handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,6 +10,29 @@
 extern "C" {
 #endif
 
+/**
+ * Hardware performance counter values sampled over a traced span.
+ * All values are zero if hardware counters are disabled or not available on this system.
+ */
+typedef struct JPS_HardwareCounters {
+    /**
+     * CPU cycles spent in user space
+     */
+    uint64_t cycles;
+    /**
+     * Instructions retired in user space
+     */
+    uint64_t instructions;
+    /**
+     * Last level cache misses
+     */
+    uint64_t cache_misses;
+    /**
+     * Mispredicted branches
+     */
+    uint64_t branch_misses;
+} JPS_HardwareCounters;
+
 /**
  * Contains basic performance trace information
  */
@@ -23,8 +46,61 @@ typedef struct JPS_Trace {
      * This is fully contained in iterate.
      */
     uint64_t operational_level_duration;
+    /**
+     * Hardware counters sampled over the iterate call.
+     */
+    JPS_HardwareCounters iteration_counters;
+    /**
+     * Hardware counters sampled over the operational decision level.
+     * This is fully contained in iterate.
+     */
+    JPS_HardwareCounters operational_level_counters;
 } JPS_Trace;
 
+/**
+ * Current and peak heap memory usage of a subsystem in bytes.
+ */
+typedef struct JPS_MemoryUsage {
+    /**
+     * Bytes currently in use
+     */
+    size_t bytes;
+    /**
+     * Highest value of 'bytes' observed since the simulation was created
+     */
+    size_t peak_bytes;
+} JPS_MemoryUsage;
+
+/**
+ * Estimated heap memory usage per subsystem of a simulation.
+ */
+typedef struct JPS_MemoryStats {
+    /**
+     * Agent storage
+     */
+    JPS_MemoryUsage agents;
+    /**
+     * Grid used to look up neighboring agents
+     */
+    JPS_MemoryUsage neighborhood_search;
+    /**
+     * Line segments and lookup grids of the active collision geometry
+     */
+    JPS_MemoryUsage collision_geometry;
+    /**
+     * Triangulation and navigation mesh of the active routing engine
+     */
+    JPS_MemoryUsage routing_engine;
+    /**
+     * Previously used geometries and routing engines kept for switching back
+     */
+    JPS_MemoryUsage geometry_cache;
+    /**
+     * Sum of all subsystems
+     */
+    JPS_MemoryUsage total;
+} JPS_MemoryStats;
+
 /**
  * A 2D coordinate. Units are 'meters'
  */
@@ -64,6 +140,29 @@ typedef enum JPS_ModelType {
     JPS_SocialForceModel
 } JPS_ModelType;
 
+/**
+ * Path search used to compute the next waypoint of agents walking to a stage.
+ */
+typedef enum JPS_RoutingAlgorithm {
+    /**
+     * A* over the triangles of the navigation mesh followed by funnel straightening. Fast, but
+     * paths may be longer than the shortest path.
+     */
+    JPS_RoutingAlgorithm_TriangleAStar,
+    /**
+     * Any-angle search over the merged convex polygons of the navigation mesh. Always finds the
+     * shortest path.
+     */
+    JPS_RoutingAlgorithm_Polyanya,
+    /**
+     * Search between the regions of the navigation mesh first, then A* over the triangles of the
+     * regions along the found path only. Needs a geometry built with a routing hierarchy, see
+     * JPS_GeometryBuilder_SetRoutingHierarchy, otherwise the same as
+     * JPS_RoutingAlgorithm_TriangleAStar.
+     */
+    JPS_RoutingAlgorithm_Hierarchical
+} JPS_RoutingAlgorithm;
+
 /**
  * Id of a journey.
  * Zero represents an invalid id.
@@ -88,6 +187,65 @@ typedef size_t JPS_StageIndex;
  */
 typedef uint64_t JPS_AgentId;
 
+/**
+ * Kind of an event recorded during the simulation.
+ */
+typedef enum JPS_EventType {
+    /**
+     * Agent completed 'previous_stage_id' or has been switched to another journey and now targets
+     * 'stage_id'
+     */
+    JPS_EventType_StageChanged,
+    /**
+     * Agent has been removed from the simulation, 'stage_id' is the last stage it targeted
+     */
+    JPS_EventType_AgentRemoved,
+    /**
+     * Agent has been assigned a slot in the queue 'stage_id'
+     */
+    JPS_EventType_QueueEnqueued,
+    /**
+     * Agent has been popped from the queue 'stage_id'
+     */
+    JPS_EventType_QueuePopped,
+    /**
+     * Agent has been assigned a slot in the waiting set 'stage_id'
+     */
+    JPS_EventType_WaitingSetEntered,
+    /**
+     * All slots of the waiting set 'stage_id' are occupied, 'agent_id' took the last slot
+     */
+    JPS_EventType_WaitingSetFull
+} JPS_EventType;
+
+/**
+ * Event recorded during the simulation.
+ */
+typedef struct JPS_Event {
+    /**
+     * Kind of event
+     */
+    JPS_EventType type;
+    /**
+     * Iteration count of the simulation at the beginning of the iteration the event occurred in.
+     * Events caused between iterations, e.g. by adding agents or popping a queue, carry the
+     * current iteration count.
+     */
+    uint64_t iteration;
+    /**
+     * Agent the event refers to
+     */
+    JPS_AgentId agent_id;
+    /**
+     * Stage the event refers to
+     */
+    JPS_StageId stage_id;
+    /**
+     * Stage the agent left, only valid for JPS_EventType_StageChanged otherwise zero
+     */
+    JPS_StageId previous_stage_id;
+} JPS_Event;
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,6 +2,8 @@
 
 #include "Conversion.hpp"
 
+#include "Unreachable.hpp"
+
 namespace jupedsim::detail
 {
 Point intoPoint(JPS_Point p)
@@ -23,4 +25,30 @@ std::tuple<double, double> intoTuple(JPS_Point p)
 {
     return std::make_tuple(p.x, p.y);
 }
+
+RoutingAlgorithm intoRoutingAlgorithm(JPS_RoutingAlgorithm algorithm)
+{
+    switch(algorithm) {
+        case JPS_RoutingAlgorithm_TriangleAStar:
+            return RoutingAlgorithm::TriangleAStar;
+        case JPS_RoutingAlgorithm_Polyanya:
+            return RoutingAlgorithm::Polyanya;
+        case JPS_RoutingAlgorithm_Hierarchical:
+            return RoutingAlgorithm::Hierarchical;
+    }
+    UNREACHABLE();
+}
+
+JPS_RoutingAlgorithm intoJPS_RoutingAlgorithm(RoutingAlgorithm algorithm)
+{
+    switch(algorithm) {
+        case RoutingAlgorithm::TriangleAStar:
+            return JPS_RoutingAlgorithm_TriangleAStar;
+        case RoutingAlgorithm::Polyanya:
+            return JPS_RoutingAlgorithm_Polyanya;
+        case RoutingAlgorithm::Hierarchical:
+            return JPS_RoutingAlgorithm_Hierarchical;
+    }
+    UNREACHABLE();
+}
 } // namespace jupedsim::detail
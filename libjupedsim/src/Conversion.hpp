@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "Point.hpp"
+#include "RoutingEngine.hpp"
 #include "jupedsim/jupedsim.h"
 #include <tuple>
 
@@ -13,4 +14,8 @@ JPS_Point intoJPS_Point(Point p);
 JPS_Point intoJPS_Point(std::tuple<double, double> p);
 
 std::tuple<double, double> intoTuple(JPS_Point p);
+
+RoutingAlgorithm intoRoutingAlgorithm(JPS_RoutingAlgorithm algorithm);
+
+JPS_RoutingAlgorithm intoJPS_RoutingAlgorithm(RoutingAlgorithm algorithm);
 } // namespace jupedsim::detail
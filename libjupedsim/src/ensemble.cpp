@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "jupedsim/ensemble.h"
+
+#include "ErrorMessage.hpp"
+
+#include <Ensemble.hpp>
+#include <Simulation.hpp>
+
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Trajectories are handed out without conversion
+static_assert(sizeof(JPS_TrajectorySample) == sizeof(TrajectorySample));
+static_assert(std::is_standard_layout_v<TrajectorySample>);
+static_assert(sizeof(JPS_Point) == sizeof(Point));
+static_assert(sizeof(JPS_AgentId) == sizeof(GenericAgent::ID));
+
+using EnsembleResult = std::vector<EnsembleRun>;
+
+JPS_EnsembleResult JPS_Ensemble_Run(
+    JPS_EnsembleScenarioFactory factory,
+    void* userdata,
+    JPS_EnsembleSettings settings,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(factory);
+    JPS_EnsembleResult result{};
+    try {
+        const EnsembleSettings ensembleSettings{
+            settings.run_count,
+            settings.max_iterations,
+            settings.thread_count,
+            settings.trajectory_interval};
+        const auto createScenario = [factory, userdata](size_t run) {
+            return std::unique_ptr<Simulation>(
+                reinterpret_cast<Simulation*>(factory(run, userdata)));
+        };
+        result = reinterpret_cast<JPS_EnsembleResult>(
+            new EnsembleResult(RunEnsemble(createScenario, ensembleSettings)));
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+size_t JPS_EnsembleResult_RunCount(JPS_EnsembleResult handle)
+{
+    assert(handle);
+    return reinterpret_cast<const EnsembleResult*>(handle)->size();
+}
+
+JPS_EnsembleRunSummary JPS_EnsembleResult_Summary(JPS_EnsembleResult handle, size_t run)
+{
+    assert(handle);
+    const auto& ensembleRun = reinterpret_cast<const EnsembleResult*>(handle)->at(run);
+    return JPS_EnsembleRunSummary{
+        ensembleRun.error.empty(),
+        ensembleRun.iterations,
+        ensembleRun.elapsedTime,
+        ensembleRun.agentCount,
+        ensembleRun.removedAgentCount};
+}
+
+const char* JPS_EnsembleResult_Error(JPS_EnsembleResult handle, size_t run)
+{
+    assert(handle);
+    const auto& ensembleRun = reinterpret_cast<const EnsembleResult*>(handle)->at(run);
+    return ensembleRun.error.empty() ? nullptr : ensembleRun.error.c_str();
+}
+
+size_t JPS_EnsembleResult_Trajectory(
+    JPS_EnsembleResult handle,
+    size_t run,
+    const JPS_TrajectorySample** data)
+{
+    assert(handle);
+    assert(data);
+    const auto& trajectory = reinterpret_cast<const EnsembleResult*>(handle)->at(run).trajectory;
+    *data = reinterpret_cast<const JPS_TrajectorySample*>(trajectory.data());
+    return trajectory.size();
+}
+
+void JPS_EnsembleResult_Free(JPS_EnsembleResult handle)
+{
+    delete reinterpret_cast<EnsembleResult*>(handle);
+}
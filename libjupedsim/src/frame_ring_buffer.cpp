@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "jupedsim/frame_ring_buffer.h"
+
+#include "ErrorMessage.hpp"
+
+#include <FrameRingBuffer.hpp>
+#include <Simulation.hpp>
+
+#include <cassert>
+#include <optional>
+
+////////////////////////////////////////////////////////////////////////////////
+/// FrameRingBufferWriter
+////////////////////////////////////////////////////////////////////////////////
+JPS_FrameRingBufferWriter JPS_FrameRingBufferWriter_Create(
+    const char* name,
+    uint32_t slots,
+    size_t capacity,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(name);
+    JPS_FrameRingBufferWriter result{};
+    try {
+        result = reinterpret_cast<JPS_FrameRingBufferWriter>(
+            new FrameRingBufferWriter(name, slots, capacity));
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_FrameRingBufferWriter_Publish(
+    JPS_FrameRingBufferWriter handle,
+    uint64_t frame,
+    uint64_t geometry_version,
+    double time,
+    size_t count,
+    const uint64_t* ids,
+    const double* x,
+    const double* y,
+    const double* orientation_x,
+    const double* orientation_y,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    bool result = false;
+    try {
+        reinterpret_cast<FrameRingBufferWriter*>(handle)->Publish(
+            frame,
+            geometry_version,
+            time,
+            {ids, count},
+            {x, count},
+            {y, count},
+            {orientation_x, count},
+            {orientation_y, count});
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_FrameRingBufferWriter_PublishSimulation(
+    JPS_FrameRingBufferWriter handle,
+    JPS_Simulation simulation,
+    uint64_t frame,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(simulation);
+    bool result = false;
+    try {
+        auto sim = reinterpret_cast<Simulation*>(simulation);
+        reinterpret_cast<FrameRingBufferWriter*>(handle)->Publish(
+            frame, sim->Geo().Id().getID(), sim->ElapsedTime(), sim->Agents());
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+void JPS_FrameRingBufferWriter_Free(JPS_FrameRingBufferWriter handle)
+{
+    delete reinterpret_cast<FrameRingBufferWriter*>(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// FrameRingBufferReader
+////////////////////////////////////////////////////////////////////////////////
+JPS_FrameRingBufferReader
+JPS_FrameRingBufferReader_Open(const char* name, JPS_ErrorMessage* errorMessage)
+{
+    assert(name);
+    JPS_FrameRingBufferReader result{};
+    try {
+        result = reinterpret_cast<JPS_FrameRingBufferReader>(new FrameRingBufferReader(name));
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+size_t JPS_FrameRingBufferReader_Capacity(JPS_FrameRingBufferReader handle)
+{
+    assert(handle);
+    return reinterpret_cast<const FrameRingBufferReader*>(handle)->Capacity();
+}
+
+uint64_t JPS_FrameRingBufferReader_PublishedCount(JPS_FrameRingBufferReader handle)
+{
+    assert(handle);
+    return reinterpret_cast<const FrameRingBufferReader*>(handle)->Published();
+}
+
+static bool
+intoFrame(const std::optional<FrameRingBufferFrame>& read, JPS_FrameRingBufferFrame* frame)
+{
+    if(!read) {
+        return false;
+    }
+    *frame = JPS_FrameRingBufferFrame{
+        read->index, read->frame, read->geometryVersion, read->time, read->agentCount};
+    return true;
+}
+
+bool JPS_FrameRingBufferReader_Read(
+    JPS_FrameRingBufferReader handle,
+    uint64_t index,
+    JPS_FrameRingBufferFrame* frame,
+    uint64_t* ids,
+    double* x,
+    double* y,
+    double* orientation_x,
+    double* orientation_y)
+{
+    assert(handle);
+    assert(frame);
+    const auto reader = reinterpret_cast<const FrameRingBufferReader*>(handle);
+    const auto capacity = reader->Capacity();
+    return intoFrame(
+        reader->Read(
+            index,
+            {ids, capacity},
+            {x, capacity},
+            {y, capacity},
+            {orientation_x, capacity},
+            {orientation_y, capacity}),
+        frame);
+}
+
+bool JPS_FrameRingBufferReader_ReadLatest(
+    JPS_FrameRingBufferReader handle,
+    JPS_FrameRingBufferFrame* frame,
+    uint64_t* ids,
+    double* x,
+    double* y,
+    double* orientation_x,
+    double* orientation_y)
+{
+    assert(handle);
+    assert(frame);
+    const auto reader = reinterpret_cast<const FrameRingBufferReader*>(handle);
+    const auto capacity = reader->Capacity();
+    return intoFrame(
+        reader->ReadLatest(
+            {ids, capacity},
+            {x, capacity},
+            {y, capacity},
+            {orientation_x, capacity},
+            {orientation_y, capacity}),
+        frame);
+}
+
+void JPS_FrameRingBufferReader_Free(JPS_FrameRingBufferReader handle)
+{
+    delete reinterpret_cast<FrameRingBufferReader*>(handle);
+}
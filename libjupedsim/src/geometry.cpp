@@ -6,8 +6,9 @@
 #include "Conversion.hpp"
 #include "ErrorMessage.hpp"
 
-#include <CollisionGeometry.hpp>
 #include <GeometryBuilder.hpp>
+#include <GeometryCache.hpp>
+#include <SharedGeometry.hpp>
 
 using jupedsim::detail::intoJPS_Point;
 using jupedsim::detail::intoPoint;
@@ -48,13 +49,136 @@ void JPS_GeometryBuilder_ExcludeFromAccessibleArea(
     builder->ExcludeFromAccessibleArea(loop);
 }
 
+bool JPS_GeometryBuilder_SetSimplificationTolerance(
+    JPS_GeometryBuilder handle,
+    double tolerance,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle != nullptr);
+    auto builder = reinterpret_cast<GeometryBuilder*>(handle);
+    bool result = false;
+    try {
+        builder->SetSimplificationTolerance(tolerance);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_GeometryBuilder_SetWallGridCellSize(
+    JPS_GeometryBuilder handle,
+    double cell_size,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle != nullptr);
+    auto builder = reinterpret_cast<GeometryBuilder*>(handle);
+    bool result = false;
+    try {
+        builder->SetWallGridCellSize(cell_size);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_GeometryBuilder_SetWallDistanceField(
+    JPS_GeometryBuilder handle,
+    double spacing,
+    double range,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle != nullptr);
+    auto builder = reinterpret_cast<GeometryBuilder*>(handle);
+    bool result = false;
+    try {
+        builder->SetWallDistanceField(spacing, range);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_GeometryBuilder_SetRoutingHierarchy(
+    JPS_GeometryBuilder handle,
+    double region_size,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle != nullptr);
+    auto builder = reinterpret_cast<GeometryBuilder*>(handle);
+    bool result = false;
+    try {
+        builder->SetRoutingHierarchy(region_size);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
 JPS_Geometry JPS_GeometryBuilder_Build(JPS_GeometryBuilder handle, JPS_ErrorMessage* errorMessage)
 {
     assert(handle != nullptr);
     auto builder = reinterpret_cast<GeometryBuilder*>(handle);
     JPS_Geometry result{};
     try {
-        result = reinterpret_cast<JPS_Geometry>(new CollisionGeometry(builder->Build()));
+        result = reinterpret_cast<JPS_Geometry>(
+            new SharedGeometry(builder->Build(), builder->RoutingRegionSize()));
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+JPS_Geometry JPS_GeometryBuilder_BuildCached(
+    JPS_GeometryBuilder handle,
+    const char* cache_directory,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle != nullptr);
+    assert(cache_directory != nullptr);
+    auto builder = reinterpret_cast<GeometryBuilder*>(handle);
+    JPS_Geometry result{};
+    try {
+        const GeometryCache cache{cache_directory};
+        result = reinterpret_cast<JPS_Geometry>(new SharedGeometry(cache.Build(*builder)));
     } catch(const std::exception& ex) {
         if(errorMessage) {
             *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
@@ -79,31 +203,31 @@ void JPS_GeometryBuilder_Free(JPS_GeometryBuilder handle)
 size_t JPS_Geometry_GetBoundarySize(JPS_Geometry handle)
 {
     assert(handle);
-    const auto geo = reinterpret_cast<CollisionGeometry const*>(handle);
-    return std::get<0>(geo->AccessibleArea()).size();
+    const auto& geo = reinterpret_cast<SharedGeometry const*>(handle)->Collision();
+    return std::get<0>(geo.AccessibleArea()).size();
 }
 
 const JPS_Point* JPS_Geometry_GetBoundaryData(JPS_Geometry handle)
 {
     assert(handle);
-    const auto geo = reinterpret_cast<CollisionGeometry const*>(handle);
-    return reinterpret_cast<const JPS_Point*>(std::get<0>(geo->AccessibleArea()).data());
+    const auto& geo = reinterpret_cast<SharedGeometry const*>(handle)->Collision();
+    return reinterpret_cast<const JPS_Point*>(std::get<0>(geo.AccessibleArea()).data());
 }
 
 size_t JPS_Geometry_GetHoleCount(JPS_Geometry handle)
 {
     assert(handle);
-    const auto geo = reinterpret_cast<CollisionGeometry const*>(handle);
-    return std::get<1>(geo->AccessibleArea()).size();
+    const auto& geo = reinterpret_cast<SharedGeometry const*>(handle)->Collision();
+    return std::get<1>(geo.AccessibleArea()).size();
 }
 
 size_t
 JPS_Geometry_GetHoleSize(JPS_Geometry handle, size_t hole_index, JPS_ErrorMessage* errorMessage)
 {
     assert(handle);
-    const auto geo = reinterpret_cast<CollisionGeometry const*>(handle);
+    const auto& geo = reinterpret_cast<SharedGeometry const*>(handle)->Collision();
     try {
-        return std::get<1>(geo->AccessibleArea()).at(hole_index).size();
+        return std::get<1>(geo.AccessibleArea()).at(hole_index).size();
     } catch(const std::exception& ex) {
         if(errorMessage) {
             *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
@@ -121,10 +245,10 @@ const JPS_Point*
 JPS_Geometry_GetHoleData(JPS_Geometry handle, size_t hole_index, JPS_ErrorMessage* errorMessage)
 {
     assert(handle);
-    const auto geo = reinterpret_cast<CollisionGeometry const*>(handle);
+    const auto& geo = reinterpret_cast<SharedGeometry const*>(handle)->Collision();
     try {
         return reinterpret_cast<const JPS_Point*>(
-            std::get<1>(geo->AccessibleArea()).at(hole_index).data());
+            std::get<1>(geo.AccessibleArea()).at(hole_index).data());
     } catch(const std::exception& ex) {
         if(errorMessage) {
             *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
@@ -140,5 +264,5 @@ JPS_Geometry_GetHoleData(JPS_Geometry handle, size_t hole_index, JPS_ErrorMessag
 
 void JPS_Geometry_Free(JPS_Geometry handle)
 {
-    delete reinterpret_cast<CollisionGeometry const*>(handle);
+    delete reinterpret_cast<SharedGeometry const*>(handle);
 }
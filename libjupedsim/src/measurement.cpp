@@ -0,0 +1,293 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "jupedsim/measurement.h"
+
+#include "Conversion.hpp"
+#include "ErrorMessage.hpp"
+
+#include <AABB.hpp>
+#include <Point.hpp>
+#include <Simulation.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <vector>
+
+using jupedsim::detail::intoJPS_Point;
+using jupedsim::detail::intoPoint;
+
+bool JPS_Simulation_AddGridMeasurement(
+    JPS_Simulation handle,
+    JPS_Point min,
+    JPS_Point max,
+    double cell_size,
+    double interval,
+    size_t* id,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(id);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        AABB bounds{};
+        bounds.xmin = min.x;
+        bounds.ymin = min.y;
+        bounds.xmax = max.x;
+        bounds.ymax = max.y;
+        *id = simulation->AddGridMeasurement(bounds, cell_size, interval);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_GetGridMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    JPS_GridMeasurement* grid,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(grid);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        const auto& measurement = simulation->GetGridMeasurement(id);
+        grid->origin = intoJPS_Point(measurement.bounds.BottomLeft());
+        grid->cell_size = measurement.cellSize;
+        grid->columns = measurement.columns;
+        grid->rows = measurement.rows;
+        grid->samples = measurement.samples;
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_ReadGridMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    double* density,
+    double* speed,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(density);
+    assert(speed);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        const auto& measurement = simulation->GetGridMeasurement(id);
+        const auto densities = measurement.Density();
+        const auto speeds = measurement.MeanSpeed();
+        std::copy(std::begin(densities), std::end(densities), density);
+        std::copy(std::begin(speeds), std::end(speeds), speed);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_AddLineMeasurement(
+    JPS_Simulation handle,
+    JPS_Point p1,
+    JPS_Point p2,
+    size_t* id,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(id);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        *id = simulation->AddLineMeasurement(intoPoint(p1), intoPoint(p2));
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_GetLineMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    uint64_t* forward,
+    uint64_t* backward,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(forward);
+    assert(backward);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        const auto& measurement = simulation->GetLineMeasurement(id);
+        *forward = measurement.forward;
+        *backward = measurement.backward;
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_ReadLineMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    JPS_LineCrossing* crossings,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(crossings);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        const auto& measurement = simulation->GetLineMeasurement(id);
+        std::transform(
+            std::begin(measurement.crossings),
+            std::end(measurement.crossings),
+            crossings,
+            [](const auto& crossing) {
+                return JPS_LineCrossing{
+                    crossing.time, crossing.agent.getID(), crossing.direction};
+            });
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_AddAreaMeasurement(
+    JPS_Simulation handle,
+    const JPS_Point* polygon,
+    size_t len_polygon,
+    double interval,
+    size_t* id,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(polygon);
+    assert(id);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        std::vector<Point> points{};
+        points.reserve(len_polygon);
+        std::transform(polygon, polygon + len_polygon, std::back_inserter(points), intoPoint);
+        *id = simulation->AddAreaMeasurement(points, interval);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_GetAreaMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    size_t* samples,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(samples);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        *samples = simulation->GetAreaMeasurement(id).times.size();
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_ReadAreaMeasurement(
+    JPS_Simulation handle,
+    size_t id,
+    double* times,
+    uint64_t* counts,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(times);
+    assert(counts);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        const auto& measurement = simulation->GetAreaMeasurement(id);
+        std::copy(std::begin(measurement.times), std::end(measurement.times), times);
+        std::copy(std::begin(measurement.counts), std::end(measurement.counts), counts);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
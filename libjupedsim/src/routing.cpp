@@ -2,16 +2,31 @@
 #include "jupedsim/routing.h"
 
 #include "Conversion.hpp"
+#include "ErrorMessage.hpp"
 
-#include <CollisionGeometry.hpp>
 #include <RoutingEngine.hpp>
+#include <SharedGeometry.hpp>
 
 #include <algorithm>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Points are passed to batched queries without conversion
+static_assert(sizeof(JPS_Point) == sizeof(Point));
+static_assert(std::is_standard_layout_v<Point>);
 
 using jupedsim::detail::intoJPS_Point;
 using jupedsim::detail::intoPoint;
+using jupedsim::detail::intoRoutingAlgorithm;
 using jupedsim::detail::intoTuple;
 
+/// A routing engine handle shares the routing engine with the geometry it was created from.
+using SharedRoutingEngine = std::shared_ptr<const RoutingEngine>;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// JPS_Path
 ////////////////////////////////////////////////////////////////////////////////
@@ -37,14 +52,14 @@ JUPEDSIM_API void JPS_Mesh_Free(JPS_Mesh mesh)
 ////////////////////////////////////////////////////////////////////////////////
 JUPEDSIM_API JPS_RoutingEngine JPS_RoutingEngine_Create(JPS_Geometry geometry)
 {
-    auto* geo = reinterpret_cast<const CollisionGeometry*>(geometry);
-    return reinterpret_cast<JPS_RoutingEngine>(new RoutingEngine(geo->Polygon()));
+    auto* geo = reinterpret_cast<const SharedGeometry*>(geometry);
+    return reinterpret_cast<JPS_RoutingEngine>(new SharedRoutingEngine(geo->Routing()));
 }
 
 JUPEDSIM_API JPS_Path
 JPS_RoutingEngine_ComputeWaypoint(JPS_RoutingEngine handle, JPS_Point from, JPS_Point to)
 {
-    auto* engine = reinterpret_cast<RoutingEngine*>(handle);
+    const auto& engine = *reinterpret_cast<SharedRoutingEngine*>(handle);
     const auto path = engine->ComputeAllWaypoints(intoPoint(from), intoPoint(to));
     auto points = new JPS_Point[path.size()];
     JPS_Path p{path.size(), points};
@@ -53,15 +68,69 @@ JPS_RoutingEngine_ComputeWaypoint(JPS_RoutingEngine handle, JPS_Point from, JPS_
     return p;
 }
 
+JUPEDSIM_API bool JPS_RoutingEngine_ComputeWaypoints(
+    JPS_RoutingEngine handle,
+    const JPS_Point* from,
+    const JPS_Point* to,
+    size_t pairs_len,
+    JPS_RoutingAlgorithm algorithm,
+    size_t thread_count,
+    double* lengths,
+    size_t max_waypoints,
+    JPS_Point* waypoints,
+    size_t* waypoint_counts,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(lengths);
+    try {
+        const auto& engine = *reinterpret_cast<SharedRoutingEngine*>(handle);
+        const auto consumer = [&](size_t index, const std::vector<Point>& path) {
+            double length = 0;
+            for(size_t waypoint = 1; waypoint < path.size(); ++waypoint) {
+                length += Distance(path[waypoint - 1], path[waypoint]);
+            }
+            lengths[index] = path.empty() ? std::numeric_limits<double>::infinity() : length;
+            if(waypoint_counts) {
+                waypoint_counts[index] = path.size();
+            }
+            if(waypoints) {
+                std::transform(
+                    std::begin(path),
+                    std::begin(path) + std::min(path.size(), max_waypoints),
+                    waypoints + index * max_waypoints,
+                    [](const auto& p) { return intoJPS_Point(p); });
+            }
+        };
+        engine->ComputeAllWaypointsBatch(
+            std::span(reinterpret_cast<const Point*>(from), pairs_len),
+            std::span(reinterpret_cast<const Point*>(to), pairs_len),
+            consumer,
+            intoRoutingAlgorithm(algorithm),
+            thread_count);
+        return true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return false;
+}
+
 JUPEDSIM_API bool JPS_RoutingEngine_IsRoutable(JPS_RoutingEngine handle, JPS_Point p)
 {
-    const auto* engine = reinterpret_cast<RoutingEngine*>(handle);
+    const auto& engine = *reinterpret_cast<SharedRoutingEngine*>(handle);
     return engine->IsRoutable(intoPoint(p));
 }
 
 JUPEDSIM_API JPS_Mesh JPS_RoutingEngine_Mesh(JPS_RoutingEngine handle)
 {
-    const auto* engine = reinterpret_cast<RoutingEngine*>(handle);
+    const auto& engine = *reinterpret_cast<SharedRoutingEngine*>(handle);
     const auto mesh = engine->MeshData();
 
     JPS_Mesh result{};
@@ -93,7 +162,20 @@ JUPEDSIM_API JPS_Mesh JPS_RoutingEngine_Mesh(JPS_RoutingEngine handle)
     return result;
 }
 
+JUPEDSIM_API void JPS_RoutingEngine_FindContainingPolygons(
+    JPS_RoutingEngine handle,
+    const JPS_Point* points,
+    size_t points_len,
+    size_t* polygon_indices)
+{
+    const auto& engine = *reinterpret_cast<SharedRoutingEngine*>(handle);
+    const auto mesh = engine->MeshData();
+    std::transform(points, points + points_len, polygon_indices, [&mesh](const auto& p) {
+        return mesh->FindContainingPolygon({p.x, p.y});
+    });
+}
+
 JUPEDSIM_API void JPS_RoutingEngine_Free(JPS_RoutingEngine handle)
 {
-    delete reinterpret_cast<RoutingEngine*>(handle);
+    delete reinterpret_cast<SharedRoutingEngine*>(handle);
 }
@@ -13,13 +13,18 @@
 
 #include <CollisionGeometry.hpp>
 #include <GeometrySwitchError.hpp>
+#include <SharedGeometry.hpp>
 #include <Simulation.hpp>
+#include <Snapshot.hpp>
 #include <Unreachable.hpp>
 
 #include <cassert>
+#include <optional>
 
 using jupedsim::detail::intoJPS_Point;
+using jupedsim::detail::intoJPS_RoutingAlgorithm;
 using jupedsim::detail::intoPoint;
+using jupedsim::detail::intoRoutingAlgorithm;
 using jupedsim::detail::intoTuple;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -35,11 +40,11 @@ JPS_Simulation JPS_Simulation_Create(
     assert(geometry);
     JPS_Simulation result{};
     try {
-        auto collisionGeometry = reinterpret_cast<const CollisionGeometry*>(geometry);
+        auto sharedGeometry = reinterpret_cast<const SharedGeometry*>(geometry);
         auto modelInternal = reinterpret_cast<OperationalModel*>(model);
         auto model = modelInternal->Clone();
-        result = reinterpret_cast<JPS_Simulation>(new Simulation(
-            std::move(model), std::make_unique<CollisionGeometry>(*collisionGeometry), dT));
+        result =
+            reinterpret_cast<JPS_Simulation>(new Simulation(std::move(model), *sharedGeometry, dT));
     } catch(const std::exception& ex) {
         if(errorMessage) {
             *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
@@ -423,6 +428,43 @@ bool JPS_Simulation_Iterate(JPS_Simulation handle, JPS_ErrorMessage* errorMessag
     return result;
 }
 
+bool JPS_Simulation_IterateN(
+    JPS_Simulation handle,
+    uint64_t count,
+    uint64_t observerInterval,
+    JPS_IterationObserver observer,
+    void* userdata,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        if(observer != nullptr && observerInterval == 0) {
+            throw std::runtime_error("Observer interval needs to be greater than 0");
+        }
+        for(uint64_t step = 0; step < count; ++step) {
+            simulation->Iterate();
+            if(observer != nullptr && simulation->Iteration() % observerInterval == 0) {
+                if(!observer(handle, userdata)) {
+                    break;
+                }
+            }
+        }
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
 size_t JPS_Simulation_AgentCount(JPS_Simulation handle)
 {
     assert(handle);
@@ -507,6 +549,86 @@ bool JPS_Simulation_SwitchAgentJourney(
     return result;
 }
 
+bool JPS_Simulation_AddPeriodicQueuePop(
+    JPS_Simulation handle,
+    JPS_StageId stageId,
+    double interval,
+    size_t count,
+    double startTime,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        simulation->AddPeriodicQueuePop(stageId, interval, count, startTime);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_AddWaitingSetThresholds(
+    JPS_Simulation handle,
+    JPS_StageId stageId,
+    size_t deactivateAt,
+    size_t activateAt,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        simulation->AddWaitingSetThresholds(stageId, deactivateAt, activateAt);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_ScheduleJourneySwitch(
+    JPS_Simulation handle,
+    double time,
+    JPS_JourneyId fromJourneyId,
+    JPS_JourneyId toJourneyId,
+    JPS_StageId toStageId,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    const auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        simulation->ScheduleJourneySwitch(time, fromJourneyId, toJourneyId, toStageId);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
 JPS_ModelType JPS_Simulation_ModelType(JPS_Simulation handle)
 {
     assert(handle);
@@ -666,19 +788,121 @@ void JPS_Simulation_SetTracing(JPS_Simulation handle, bool status)
     simuation->SetTracing(status);
 }
 
+bool JPS_Simulation_SetHardwareCounters(JPS_Simulation handle, bool status)
+{
+    assert(handle);
+    auto simuation = reinterpret_cast<Simulation*>(handle);
+    return simuation->SetHardwareCounters(status);
+}
+
+static JPS_HardwareCounters intoJPS_HardwareCounters(const HardwareCounterValues& values)
+{
+    return JPS_HardwareCounters{
+        values.cycles, values.instructions, values.cacheMisses, values.branchMisses};
+}
+
 JPS_Trace JPS_Simulation_GetTrace(JPS_Simulation handle)
 {
     assert(handle);
     auto simuation = reinterpret_cast<Simulation*>(handle);
     const auto stats = simuation->GetLastStats();
-    return JPS_Trace{stats.IterationDuration(), stats.OpDecSystemRunDuration()};
+    return JPS_Trace{
+        stats.IterationDuration(),
+        stats.OpDecSystemRunDuration(),
+        intoJPS_HardwareCounters(stats.IterationCounters()),
+        intoJPS_HardwareCounters(stats.OpDecSystemRunCounters())};
+}
+
+static JPS_MemoryUsage intoJPS_MemoryUsage(const MemoryUsage& usage)
+{
+    return JPS_MemoryUsage{usage.bytes, usage.peakBytes};
+}
+
+JPS_MemoryStats JPS_Simulation_GetMemoryStats(JPS_Simulation handle)
+{
+    assert(handle);
+    auto simuation = reinterpret_cast<Simulation*>(handle);
+    const auto stats = simuation->GetMemoryStats();
+    return JPS_MemoryStats{
+        intoJPS_MemoryUsage(stats.agents),
+        intoJPS_MemoryUsage(stats.neighborhoodSearch),
+        intoJPS_MemoryUsage(stats.collisionGeometry),
+        intoJPS_MemoryUsage(stats.routingEngine),
+        intoJPS_MemoryUsage(stats.geometryCache),
+        intoJPS_MemoryUsage(stats.total)};
+}
+
+void JPS_Simulation_SetEventRecording(JPS_Simulation handle, bool status)
+{
+    assert(handle);
+    auto simulation = reinterpret_cast<Simulation*>(handle);
+    simulation->SetEventRecording(status);
+}
+
+void JPS_Simulation_SetRoutingAlgorithm(JPS_Simulation handle, JPS_RoutingAlgorithm algorithm)
+{
+    assert(handle);
+    auto simulation = reinterpret_cast<Simulation*>(handle);
+    simulation->SetRoutingAlgorithm(intoRoutingAlgorithm(algorithm));
+}
+
+JPS_RoutingAlgorithm JPS_Simulation_GetRoutingAlgorithm(JPS_Simulation handle)
+{
+    assert(handle);
+    const auto simulation = reinterpret_cast<const Simulation*>(handle);
+    return intoJPS_RoutingAlgorithm(simulation->GetRoutingAlgorithm());
+}
+
+size_t JPS_Simulation_EventCount(JPS_Simulation handle)
+{
+    assert(handle);
+    const auto simulation = reinterpret_cast<const Simulation*>(handle);
+    return simulation->CountEvents();
+}
+
+static JPS_EventType intoJPS_EventType(SimulationEventType type)
+{
+    switch(type) {
+        case SimulationEventType::StageChanged:
+            return JPS_EventType_StageChanged;
+        case SimulationEventType::AgentRemoved:
+            return JPS_EventType_AgentRemoved;
+        case SimulationEventType::QueueEnqueued:
+            return JPS_EventType_QueueEnqueued;
+        case SimulationEventType::QueuePopped:
+            return JPS_EventType_QueuePopped;
+        case SimulationEventType::WaitingSetEntered:
+            return JPS_EventType_WaitingSetEntered;
+        case SimulationEventType::WaitingSetFull:
+            return JPS_EventType_WaitingSetFull;
+    }
+    UNREACHABLE();
+}
+
+size_t JPS_Simulation_ReadEvents(JPS_Simulation handle, JPS_Event* buffer, size_t capacity)
+{
+    assert(handle);
+    assert(buffer || capacity == 0);
+    auto simulation = reinterpret_cast<Simulation*>(handle);
+    std::vector<SimulationEvent> events(std::min(capacity, simulation->CountEvents()));
+    const auto count = simulation->ReadEvents(events);
+    for(size_t index = 0; index < count; ++index) {
+        const auto& event = events[index];
+        buffer[index] = JPS_Event{
+            intoJPS_EventType(event.type),
+            event.iteration,
+            event.agentId.getID(),
+            event.stageId.getID(),
+            event.previousStageId.getID()};
+    }
+    return count;
 }
 
 JPS_Geometry JPS_Simulation_GetGeometry(JPS_Simulation handle)
 {
     assert(handle);
     const auto simulation = reinterpret_cast<const Simulation*>(handle);
-    return reinterpret_cast<JPS_Geometry>(new CollisionGeometry(simulation->Geo()));
+    return reinterpret_cast<JPS_Geometry>(new SharedGeometry(simulation->Geo()));
 }
 
 bool JPS_Simulation_SwitchGeometry(
@@ -691,11 +915,11 @@ bool JPS_Simulation_SwitchGeometry(
     assert(geometry);
 
     auto simulation = reinterpret_cast<Simulation*>(handle);
-    auto collisionGeometry = reinterpret_cast<const CollisionGeometry*>(geometry);
+    auto sharedGeometry = reinterpret_cast<const SharedGeometry*>(geometry);
 
     bool result = false;
     try {
-        simulation->SwitchGeometry(std::make_unique<CollisionGeometry>(*collisionGeometry));
+        simulation->SwitchGeometry(*sharedGeometry);
         result = true;
     } catch(const GeometrySwitchError& ex) {
         if(errorMessage) {
@@ -714,6 +938,88 @@ bool JPS_Simulation_SwitchGeometry(
     return result;
 }
 
+bool JPS_Simulation_SaveSnapshot(
+    JPS_Simulation handle,
+    const char* path,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(path);
+    auto simulation = reinterpret_cast<const Simulation*>(handle);
+    bool result = false;
+    try {
+        WriteSnapshotFile(path, simulation->SaveSnapshot());
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_Simulation_LoadSnapshot(
+    JPS_Simulation handle,
+    const char* path,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(path);
+    auto simulation = reinterpret_cast<Simulation*>(handle);
+    bool result = false;
+    try {
+        simulation->RestoreSnapshot(ReadSnapshotFile(path));
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+static JPS_Simulation
+cloneSimulation(JPS_Simulation handle, std::optional<uint64_t> seed, JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    auto simulation = reinterpret_cast<const Simulation*>(handle);
+    JPS_Simulation result{};
+    try {
+        result = reinterpret_cast<JPS_Simulation>(simulation->Fork(seed).release());
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+JPS_Simulation JPS_Simulation_Clone(JPS_Simulation handle, JPS_ErrorMessage* errorMessage)
+{
+    return cloneSimulation(handle, std::nullopt, errorMessage);
+}
+
+JPS_Simulation
+JPS_Simulation_CloneWithSeed(JPS_Simulation handle, uint64_t seed, JPS_ErrorMessage* errorMessage)
+{
+    return cloneSimulation(handle, seed, errorMessage);
+}
+
 void JPS_Simulation_Free(JPS_Simulation handle)
 {
     delete reinterpret_cast<Simulation*>(handle);
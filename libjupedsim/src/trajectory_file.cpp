@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "jupedsim/trajectory_file.h"
+
+#include "ErrorMessage.hpp"
+
+#include <Simulation.hpp>
+#include <TrajectoryFile.hpp>
+
+#include <cassert>
+#include <vector>
+
+static_assert(
+    static_cast<uint32_t>(JPS_TrajectoryStorage_Float64) ==
+    static_cast<uint32_t>(TrajectoryStorage::Float64));
+static_assert(
+    static_cast<uint32_t>(JPS_TrajectoryStorage_Float32) ==
+    static_cast<uint32_t>(TrajectoryStorage::Float32));
+static_assert(
+    static_cast<uint32_t>(JPS_TrajectoryStorage_Quantized) ==
+    static_cast<uint32_t>(TrajectoryStorage::Quantized));
+
+////////////////////////////////////////////////////////////////////////////////
+/// TrajectoryFileWriter
+////////////////////////////////////////////////////////////////////////////////
+JPS_TrajectoryFileWriter JPS_TrajectoryFileWriter_Create(
+    const char* path,
+    JPS_TrajectoryStorage storage,
+    double quantization_step,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(path);
+    JPS_TrajectoryFileWriter result{};
+    try {
+        result = reinterpret_cast<JPS_TrajectoryFileWriter>(new TrajectoryFileWriter(
+            path, static_cast<TrajectoryStorage>(storage), quantization_step));
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+void JPS_TrajectoryFileWriter_SetMetadata(
+    JPS_TrajectoryFileWriter handle,
+    const char* key,
+    const char* value)
+{
+    assert(handle);
+    assert(key);
+    assert(value);
+    reinterpret_cast<TrajectoryFileWriter*>(handle)->SetMetadata(key, value);
+}
+
+uint64_t JPS_TrajectoryFileWriter_AddGeometry(
+    JPS_TrajectoryFileWriter handle,
+    int64_t hash,
+    const char* wkt)
+{
+    assert(handle);
+    assert(wkt);
+    return reinterpret_cast<TrajectoryFileWriter*>(handle)->AddGeometry(hash, wkt);
+}
+
+bool JPS_TrajectoryFileWriter_WriteFrame(
+    JPS_TrajectoryFileWriter handle,
+    uint64_t frame,
+    uint64_t geometry,
+    size_t count,
+    const uint64_t* ids,
+    const double* x,
+    const double* y,
+    const double* orientation_x,
+    const double* orientation_y,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    bool result = false;
+    try {
+        reinterpret_cast<TrajectoryFileWriter*>(handle)->WriteFrame(
+            frame,
+            geometry,
+            {ids, count},
+            {x, count},
+            {y, count},
+            {orientation_x, count},
+            {orientation_y, count});
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_TrajectoryFileWriter_WriteSimulation(
+    JPS_TrajectoryFileWriter handle,
+    JPS_Simulation simulation,
+    uint64_t frame,
+    uint64_t geometry,
+    JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    assert(simulation);
+    bool result = false;
+    try {
+        const auto& agents = reinterpret_cast<Simulation*>(simulation)->Agents();
+        std::vector<uint64_t> ids{};
+        std::vector<double> columns(4 * agents.size());
+        ids.reserve(agents.size());
+        const auto xs = std::span<double>(columns).subspan(0, agents.size());
+        const auto ys = std::span<double>(columns).subspan(agents.size(), agents.size());
+        const auto orientationXs =
+            std::span<double>(columns).subspan(2 * agents.size(), agents.size());
+        const auto orientationYs =
+            std::span<double>(columns).subspan(3 * agents.size(), agents.size());
+        for(size_t index = 0; index < agents.size(); ++index) {
+            const auto& agent = agents[index];
+            ids.push_back(agent.id.getID());
+            xs[index] = agent.pos.x;
+            ys[index] = agent.pos.y;
+            orientationXs[index] = agent.orientation.x;
+            orientationYs[index] = agent.orientation.y;
+        }
+        reinterpret_cast<TrajectoryFileWriter*>(handle)->WriteFrame(
+            frame, geometry, ids, xs, ys, orientationXs, orientationYs);
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+bool JPS_TrajectoryFileWriter_Close(JPS_TrajectoryFileWriter handle, JPS_ErrorMessage* errorMessage)
+{
+    assert(handle);
+    bool result = false;
+    try {
+        reinterpret_cast<TrajectoryFileWriter*>(handle)->Close();
+        result = true;
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+void JPS_TrajectoryFileWriter_Free(JPS_TrajectoryFileWriter handle)
+{
+    delete reinterpret_cast<TrajectoryFileWriter*>(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// TrajectoryFileReader
+////////////////////////////////////////////////////////////////////////////////
+JPS_TrajectoryFileReader
+JPS_TrajectoryFileReader_Open(const char* path, JPS_ErrorMessage* errorMessage)
+{
+    assert(path);
+    JPS_TrajectoryFileReader result{};
+    try {
+        result = reinterpret_cast<JPS_TrajectoryFileReader>(new TrajectoryFileReader(path));
+    } catch(const std::exception& ex) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(new JPS_ErrorMessage_t{ex.what()});
+        }
+    } catch(...) {
+        if(errorMessage) {
+            *errorMessage = reinterpret_cast<JPS_ErrorMessage>(
+                new JPS_ErrorMessage_t{"Unknown internal error."});
+        }
+    }
+    return result;
+}
+
+JPS_TrajectoryStorage JPS_TrajectoryFileReader_Storage(JPS_TrajectoryFileReader handle)
+{
+    assert(handle);
+    return static_cast<JPS_TrajectoryStorage>(
+        reinterpret_cast<const TrajectoryFileReader*>(handle)->ValueStorage());
+}
+
+double JPS_TrajectoryFileReader_QuantizationStep(JPS_TrajectoryFileReader handle)
+{
+    assert(handle);
+    return reinterpret_cast<const TrajectoryFileReader*>(handle)->QuantizationStep();
+}
+
+size_t JPS_TrajectoryFileReader_FrameCount(JPS_TrajectoryFileReader handle)
+{
+    assert(handle);
+    return reinterpret_cast<const TrajectoryFileReader*>(handle)->Frames().size();
+}
+
+JPS_TrajectoryFrame JPS_TrajectoryFileReader_Frame(JPS_TrajectoryFileReader handle, size_t index)
+{
+    assert(handle);
+    const auto frame = reinterpret_cast<const TrajectoryFileReader*>(handle)->Frame(index);
+    return JPS_TrajectoryFrame{
+        frame.frame,
+        frame.geometry,
+        frame.agentCount,
+        frame.x,
+        frame.y,
+        frame.orientationX,
+        frame.orientationY};
+}
+
+void JPS_TrajectoryFileReader_FrameIds(JPS_TrajectoryFileReader handle, size_t index, uint64_t* ids)
+{
+    assert(handle);
+    const auto reader = reinterpret_cast<const TrajectoryFileReader*>(handle);
+    reader->Ids(index, {ids, reader->Frame(index).agentCount});
+}
+
+void JPS_TrajectoryFileReader_DecodeColumn(
+    JPS_TrajectoryFileReader handle,
+    const void* column,
+    size_t count,
+    double* values)
+{
+    assert(handle);
+    reinterpret_cast<const TrajectoryFileReader*>(handle)->Decode(column, count, {values, count});
+}
+
+size_t JPS_TrajectoryFileReader_MetadataCount(JPS_TrajectoryFileReader handle)
+{
+    assert(handle);
+    return reinterpret_cast<const TrajectoryFileReader*>(handle)->Metadata().size();
+}
+
+void JPS_TrajectoryFileReader_Metadata(
+    JPS_TrajectoryFileReader handle,
+    size_t index,
+    const char** key,
+    const char** value)
+{
+    assert(handle);
+    const auto& entry = reinterpret_cast<const TrajectoryFileReader*>(handle)->Metadata().at(index);
+    *key = entry.first.c_str();
+    *value = entry.second.c_str();
+}
+
+size_t JPS_TrajectoryFileReader_GeometryCount(JPS_TrajectoryFileReader handle)
+{
+    assert(handle);
+    return reinterpret_cast<const TrajectoryFileReader*>(handle)->Geometries().size();
+}
+
+const char*
+JPS_TrajectoryFileReader_Geometry(JPS_TrajectoryFileReader handle, size_t index, int64_t* hash)
+{
+    assert(handle);
+    const auto& geometry =
+        reinterpret_cast<const TrajectoryFileReader*>(handle)->Geometries().at(index);
+    *hash = geometry.hash;
+    return geometry.wkt.c_str();
+}
+
+void JPS_TrajectoryFileReader_Free(JPS_TrajectoryFileReader handle)
+{
+    delete reinterpret_cast<TrajectoryFileReader*>(handle);
+}
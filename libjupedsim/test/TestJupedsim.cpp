@@ -4,7 +4,14 @@
 #include <ErrorMessage.hpp>
 #include <jupedsim/jupedsim.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -127,6 +134,121 @@ TEST(GeometryBuilder, CanConstruct)
     ASSERT_NO_FATAL_FAILURE(JPS_GeometryBuilder_Free(builder));
 }
 
+TEST(GeometryBuilder, BuildCachedReusesStoredGeometry)
+{
+    const auto directory = std::filesystem::temp_directory_path() / "jupedsim-test-geometry-cache";
+    std::filesystem::remove_all(directory);
+    auto builder = JPS_GeometryBuilder_Create();
+    std::vector<JPS_Point> box{{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    JPS_GeometryBuilder_AddAccessibleArea(builder, box.data(), box.size());
+    std::vector<JPS_Point> pillar{{4, 4}, {6, 4}, {6, 6}, {4, 6}};
+    JPS_GeometryBuilder_ExcludeFromAccessibleArea(builder, pillar.data(), pillar.size());
+
+    JPS_ErrorMessage message{};
+    auto built = JPS_GeometryBuilder_BuildCached(builder, directory.string().c_str(), &message);
+    ASSERT_NE(built, nullptr);
+    ASSERT_FALSE(std::filesystem::is_empty(directory));
+    auto loaded = JPS_GeometryBuilder_BuildCached(builder, directory.string().c_str(), &message);
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_EQ(message, nullptr);
+
+    ASSERT_EQ(JPS_Geometry_GetHoleCount(loaded), 1);
+    const auto size = JPS_Geometry_GetBoundarySize(built);
+    ASSERT_EQ(JPS_Geometry_GetBoundarySize(loaded), size);
+    const auto builtBoundary = JPS_Geometry_GetBoundaryData(built);
+    const auto loadedBoundary = JPS_Geometry_GetBoundaryData(loaded);
+    for(size_t index = 0; index < size; ++index) {
+        ASSERT_EQ(loadedBoundary[index].x, builtBoundary[index].x);
+        ASSERT_EQ(loadedBoundary[index].y, builtBoundary[index].y);
+    }
+
+    JPS_Geometry_Free(loaded);
+    JPS_Geometry_Free(built);
+    JPS_GeometryBuilder_Free(builder);
+    std::filesystem::remove_all(directory);
+}
+
+struct SimulationTest : public ::testing::Test {
+    JPS_Geometry geometry{};
+    JPS_OperationalModel model{};
+    JPS_Simulation simulation{};
+    JPS_JourneyId journey_id{};
+    JPS_StageId stage_id{};
+    std::array<JPS_CollisionFreeSpeedModelAgentParameters, 2> agent_templates{
+        JPS_CollisionFreeSpeedModelAgentParameters{{}, 0, 0, 1, 1.5, 0.3},
+        JPS_CollisionFreeSpeedModelAgentParameters{{}, 0, 0, 1, 1.5, 0.3},
+    };
+
+    void SetUp() override
+    {
+        auto geo_builder = JPS_GeometryBuilder_Create();
+        std::vector<JPS_Point> box1{{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+        JPS_GeometryBuilder_AddAccessibleArea(geo_builder, box1.data(), box1.size());
+        geometry = JPS_GeometryBuilder_Build(geo_builder, nullptr);
+        ASSERT_NE(geometry, nullptr);
+        JPS_GeometryBuilder_Free(geo_builder);
+
+        auto modelBuilder = JPS_CollisionFreeSpeedModelBuilder_Create(8, 0.1, 5, 0.02);
+        model = JPS_CollisionFreeSpeedModelBuilder_Build(modelBuilder, nullptr);
+        JPS_CollisionFreeSpeedModelBuilder_Free(modelBuilder);
+
+        ASSERT_NE(model, nullptr);
+
+        simulation = CreateSimulation();
+        ASSERT_NE(simulation, nullptr);
+
+        stage_id = JPS_Simulation_AddStageWaypoint(simulation, {1, 1}, 1, nullptr);
+
+        auto journey = JPS_JourneyDescription_Create();
+        JPS_JourneyDescription_AddStage(journey, stage_id);
+        journey_id = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+
+        JPS_JourneyDescription_Free(journey);
+        ASSERT_NE(journey_id, 0);
+
+        for(auto&& agent : agent_templates) {
+            agent.journeyId = journey_id;
+            agent.stageId = stage_id;
+        }
+    }
+
+    void TearDown() override
+    {
+        JPS_Simulation_Free(simulation);
+        JPS_OperationalModel_Free(model);
+        JPS_Geometry_Free(geometry);
+    }
+
+    // Creates another simulation with the fixture's geometry and model but without stages
+    JPS_Simulation CreateSimulation() const
+    {
+        return JPS_Simulation_Create(model, geometry, 0.01, nullptr);
+    }
+};
+
+TEST_F(SimulationTest, SimulationsShareGeometry)
+{
+    auto second = CreateSimulation();
+    ASSERT_NE(second, nullptr);
+
+    auto firstGeometry = JPS_Simulation_GetGeometry(simulation);
+    auto secondGeometry = JPS_Simulation_GetGeometry(second);
+    ASSERT_EQ(
+        JPS_Geometry_GetBoundaryData(firstGeometry), JPS_Geometry_GetBoundaryData(secondGeometry));
+
+    // Switching to the geometry already in use keeps sharing it
+    ASSERT_TRUE(JPS_Simulation_SwitchGeometry(second, firstGeometry, nullptr, nullptr));
+    auto switchedGeometry = JPS_Simulation_GetGeometry(second);
+    ASSERT_EQ(
+        JPS_Geometry_GetBoundaryData(firstGeometry),
+        JPS_Geometry_GetBoundaryData(switchedGeometry));
+
+    JPS_Geometry_Free(switchedGeometry);
+    JPS_Geometry_Free(secondGeometry);
+    JPS_Geometry_Free(firstGeometry);
+    JPS_Simulation_Free(second);
+}
+
 TEST(Simulation, CanSimulate)
 {
     auto geo_builder = JPS_GeometryBuilder_Create();
@@ -173,51 +295,69 @@ TEST(Simulation, CanSimulate)
     ASSERT_LT(JPS_Simulation_IterationCount(simulation), 2000);
 }
 
-struct SimulationTest : public ::testing::Test {
-    JPS_Simulation simulation{};
-    JPS_JourneyId journey_id{};
-    JPS_StageId stage_id{};
-    std::array<JPS_CollisionFreeSpeedModelAgentParameters, 2> agent_templates{
-        JPS_CollisionFreeSpeedModelAgentParameters{{}, 0, 0, 1, 1.5, 0.3},
-        JPS_CollisionFreeSpeedModelAgentParameters{{}, 0, 0, 1, 1.5, 0.3},
-    };
-
-    void SetUp() override
-    {
-        auto geo_builder = JPS_GeometryBuilder_Create();
-        std::vector<JPS_Point> box1{{0, 0}, {10, 0}, {10, 10}, {0, 10}};
-        JPS_GeometryBuilder_AddAccessibleArea(geo_builder, box1.data(), box1.size());
-        auto geometry = JPS_GeometryBuilder_Build(geo_builder, nullptr);
-        ASSERT_NE(geometry, nullptr);
-        JPS_GeometryBuilder_Free(geo_builder);
-
-        auto modelBuilder = JPS_CollisionFreeSpeedModelBuilder_Create(9, 0.1, 5, 0.02);
-        auto model = JPS_CollisionFreeSpeedModelBuilder_Build(modelBuilder, nullptr);
-
-        ASSERT_NE(model, nullptr);
-
-        simulation = JPS_Simulation_Create(model, geometry, 0.01, nullptr);
-        ASSERT_NE(simulation, nullptr);
+TEST_F(SimulationTest, RecordsEvents)
+{
+    std::vector<JPS_Point> slots{{5, 5}, {3, 5}};
+    const auto queueStage =
+        JPS_Simulation_AddStageNotifiableQueue(simulation, slots.data(), slots.size(), nullptr);
+    std::vector<JPS_Point> exitArea{{8, 8}, {10, 8}, {10, 10}, {8, 10}};
+    const auto exitStage =
+        JPS_Simulation_AddStageExit(simulation, exitArea.data(), exitArea.size(), nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, queueStage);
+    JPS_JourneyDescription_AddStage(journey, exitStage);
+    auto transition = JPS_Transition_CreateFixedTransition(exitStage, nullptr);
+    ASSERT_TRUE(
+        JPS_JourneyDescription_SetTransitionForStage(journey, queueStage, transition, nullptr));
+    JPS_Transition_Free(transition);
+    const auto journeyId = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
 
-        stage_id = JPS_Simulation_AddStageWaypoint(simulation, {1, 1}, 1, nullptr);
+    JPS_CollisionFreeSpeedModelAgentParameters agent_parameters{
+        {5, 5}, journeyId, queueStage, 1, 1.2, 0.3};
+    const auto agentId =
+        JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr);
+    ASSERT_NE(agentId, 0);
 
-        auto journey = JPS_JourneyDescription_Create();
-        JPS_JourneyDescription_AddStage(journey, stage_id);
-        journey_id = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    // Nothing is recorded unless enabled
+    ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    ASSERT_EQ(JPS_Simulation_EventCount(simulation), 0);
 
-        JPS_JourneyDescription_Free(journey);
-        ASSERT_NE(journey_id, 0);
+    // Agent is standing on the first slot but has already been enqueued without recording
+    JPS_Simulation_SetEventRecording(simulation, true);
+    auto queue = JPS_Simulation_GetNotifiableQueueProxy(simulation, queueStage, nullptr);
+    ASSERT_EQ(JPS_NotifiableQueueProxy_GetCountEnqueued(queue), 1);
+    JPS_NotifiableQueueProxy_Pop(queue, 1);
+    JPS_NotifiableQueueProxy_Free(queue);
+    // Pops are recorded right away, not with the next iteration
+    ASSERT_EQ(JPS_Simulation_EventCount(simulation), 1);
 
-        JPS_OperationalModel_Free(model);
-        JPS_Geometry_Free(geometry);
-        for(auto&& agent : agent_templates) {
-            agent.journeyId = journey_id;
-            agent.stageId = stage_id;
-        }
+    const auto popIteration = JPS_Simulation_IterationCount(simulation);
+    while(JPS_Simulation_AgentCount(simulation) > 0) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+        ASSERT_LT(JPS_Simulation_IterationCount(simulation), 2000);
     }
 
-    void TearDown() override { JPS_Simulation_Free(simulation); }
-};
+    ASSERT_EQ(JPS_Simulation_EventCount(simulation), 3);
+    std::array<JPS_Event, 2> buffer{};
+    ASSERT_EQ(JPS_Simulation_ReadEvents(simulation, buffer.data(), buffer.size()), 2);
+    ASSERT_EQ(buffer[0].type, JPS_EventType_QueuePopped);
+    ASSERT_EQ(buffer[0].agent_id, agentId);
+    ASSERT_EQ(buffer[0].stage_id, queueStage);
+    ASSERT_EQ(buffer[0].iteration, popIteration);
+    ASSERT_EQ(buffer[1].type, JPS_EventType_StageChanged);
+    ASSERT_EQ(buffer[1].agent_id, agentId);
+    ASSERT_EQ(buffer[1].stage_id, exitStage);
+    ASSERT_EQ(buffer[1].previous_stage_id, queueStage);
+    ASSERT_EQ(buffer[1].iteration, popIteration);
+
+    ASSERT_EQ(JPS_Simulation_ReadEvents(simulation, buffer.data(), buffer.size()), 1);
+    ASSERT_EQ(buffer[0].type, JPS_EventType_AgentRemoved);
+    ASSERT_EQ(buffer[0].agent_id, agentId);
+    ASSERT_EQ(buffer[0].stage_id, exitStage);
+    ASSERT_EQ(buffer[0].iteration, JPS_Simulation_IterationCount(simulation) - 1);
+    ASSERT_EQ(JPS_Simulation_EventCount(simulation), 0);
+}
 
 TEST_F(SimulationTest, AgentIteratorIsEmptyForNewSimulation)
 {
@@ -249,6 +389,805 @@ TEST_F(SimulationTest, AgentIteratorCanIterate)
     ASSERT_EQ(JPS_AgentIterator_Next(iter), nullptr);
 }
 
+TEST_F(SimulationTest, TraceHardwareCountersDegradeGracefully)
+{
+    JPS_Simulation_SetTracing(simulation, true);
+    ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    auto trace = JPS_Simulation_GetTrace(simulation);
+    ASSERT_EQ(trace.iteration_counters.cycles, 0);
+    ASSERT_EQ(trace.iteration_counters.instructions, 0);
+
+    const bool available = JPS_Simulation_SetHardwareCounters(simulation, true);
+    ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    trace = JPS_Simulation_GetTrace(simulation);
+    if(available) {
+        ASSERT_GE(
+            trace.iteration_counters.instructions,
+            trace.operational_level_counters.instructions);
+    } else {
+        ASSERT_EQ(trace.iteration_counters.cycles, 0);
+        ASSERT_EQ(trace.operational_level_counters.cycles, 0);
+    }
+
+    ASSERT_FALSE(JPS_Simulation_SetHardwareCounters(simulation, false));
+    ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    trace = JPS_Simulation_GetTrace(simulation);
+    ASSERT_EQ(trace.iteration_counters.cycles, 0);
+}
+
+TEST_F(SimulationTest, MemoryStatsTrackAgentsAndPeak)
+{
+    auto stats = JPS_Simulation_GetMemoryStats(simulation);
+    ASSERT_EQ(stats.agents.bytes, 0);
+    ASSERT_GT(stats.collision_geometry.bytes, 0);
+    ASSERT_GT(stats.routing_engine.bytes, 0);
+    ASSERT_EQ(stats.geometry_cache.bytes, 0);
+
+    std::vector<JPS_Point> positions{{3, 3}, {4, 3}, {5, 3}};
+    std::vector<JPS_AgentId> ids{};
+    for(const auto& position : positions) {
+        auto agent_params = agent_templates[0];
+        agent_params.position = position;
+        ids.push_back(
+            JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_params, nullptr));
+    }
+    stats = JPS_Simulation_GetMemoryStats(simulation);
+    ASSERT_GT(stats.agents.bytes, 0);
+    ASSERT_GT(stats.neighborhood_search.bytes, 0);
+    ASSERT_EQ(
+        stats.total.bytes,
+        stats.agents.bytes + stats.neighborhood_search.bytes + stats.collision_geometry.bytes +
+            stats.routing_engine.bytes + stats.geometry_cache.bytes);
+
+    const auto peak = stats.neighborhood_search.peak_bytes;
+    for(const auto id : ids) {
+        ASSERT_TRUE(JPS_Simulation_MarkAgentForRemoval(simulation, id, nullptr));
+    }
+    ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    stats = JPS_Simulation_GetMemoryStats(simulation);
+    ASSERT_LT(stats.neighborhood_search.bytes, peak);
+    ASSERT_EQ(stats.neighborhood_search.peak_bytes, peak);
+}
+
+TEST_F(SimulationTest, IterateNCallsObserverAtInterval)
+{
+    ASSERT_TRUE(JPS_Simulation_IterateN(simulation, 10, 0, nullptr, nullptr, nullptr));
+    ASSERT_EQ(JPS_Simulation_IterationCount(simulation), 10);
+
+    struct Observed {
+        std::vector<uint64_t> iterations{};
+        size_t limit{};
+    } observed{{}, 100};
+    const auto observer = [](JPS_Simulation handle, void* userdata) {
+        auto observed = static_cast<Observed*>(userdata);
+        observed->iterations.push_back(JPS_Simulation_IterationCount(handle));
+        return observed->iterations.size() < observed->limit;
+    };
+    ASSERT_FALSE(JPS_Simulation_IterateN(simulation, 5, 0, observer, &observed, nullptr));
+    ASSERT_EQ(JPS_Simulation_IterationCount(simulation), 10);
+
+    ASSERT_TRUE(JPS_Simulation_IterateN(simulation, 10, 4, observer, &observed, nullptr));
+    ASSERT_EQ(observed.iterations, (std::vector<uint64_t>{12, 16, 20}));
+    ASSERT_EQ(JPS_Simulation_IterationCount(simulation), 20);
+
+    // Observer stops iterating early
+    observed.limit = 4;
+    ASSERT_TRUE(JPS_Simulation_IterateN(simulation, 100, 1, observer, &observed, nullptr));
+    ASSERT_EQ(observed.iterations, (std::vector<uint64_t>{12, 16, 20, 21}));
+    ASSERT_EQ(JPS_Simulation_IterationCount(simulation), 21);
+}
+
+TEST_F(SimulationTest, ScheduledJourneySwitchMovesAllAgentsOfJourney)
+{
+    const auto otherStage = JPS_Simulation_AddStageWaypoint(simulation, {8, 8}, 1, nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, otherStage);
+    const auto otherJourney = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
+
+    ASSERT_FALSE(JPS_Simulation_ScheduleJourneySwitch(
+        simulation, 0.5, journey_id, otherJourney, stage_id, nullptr));
+    ASSERT_TRUE(JPS_Simulation_ScheduleJourneySwitch(
+        simulation, 0.5, journey_id, otherJourney, otherStage, nullptr));
+
+    std::vector<JPS_Point> positions{{3, 3}, {5, 3}};
+    for(const auto& position : positions) {
+        auto agent_params = agent_templates[0];
+        agent_params.position = position;
+        ASSERT_NE(
+            JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_params, nullptr), 0);
+    }
+
+    auto waypoint = JPS_Simulation_GetWaypointProxy(simulation, stage_id, nullptr);
+    auto otherWaypoint = JPS_Simulation_GetWaypointProxy(simulation, otherStage, nullptr);
+    while(JPS_Simulation_ElapsedTime(simulation) < 0.5 - 1e-9) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+        ASSERT_EQ(JPS_WaypointProxy_GetCountTargeting(waypoint), 2);
+    }
+    ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    ASSERT_EQ(JPS_WaypointProxy_GetCountTargeting(waypoint), 0);
+    ASSERT_EQ(JPS_WaypointProxy_GetCountTargeting(otherWaypoint), 2);
+    JPS_WaypointProxy_Free(waypoint);
+    JPS_WaypointProxy_Free(otherWaypoint);
+}
+
+TEST_F(SimulationTest, PeriodicQueuePopServesQueueAtFixedRate)
+{
+    std::vector<JPS_Point> slots{{5, 5}, {4, 5}, {3, 5}};
+    const auto queueStage =
+        JPS_Simulation_AddStageNotifiableQueue(simulation, slots.data(), slots.size(), nullptr);
+    std::vector<JPS_Point> exitArea{{8, 8}, {10, 8}, {10, 10}, {8, 10}};
+    const auto exitStage =
+        JPS_Simulation_AddStageExit(simulation, exitArea.data(), exitArea.size(), nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, queueStage);
+    JPS_JourneyDescription_AddStage(journey, exitStage);
+    auto transition = JPS_Transition_CreateFixedTransition(exitStage, nullptr);
+    ASSERT_TRUE(
+        JPS_JourneyDescription_SetTransitionForStage(journey, queueStage, transition, nullptr));
+    JPS_Transition_Free(transition);
+    const auto journeyId = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
+
+    ASSERT_FALSE(JPS_Simulation_AddPeriodicQueuePop(simulation, exitStage, 1, 1, 1, nullptr));
+    ASSERT_FALSE(JPS_Simulation_AddPeriodicQueuePop(simulation, queueStage, 0, 1, 1, nullptr));
+    ASSERT_TRUE(JPS_Simulation_AddPeriodicQueuePop(simulation, queueStage, 1, 1, 1, nullptr));
+
+    for(const auto& slot : slots) {
+        JPS_CollisionFreeSpeedModelAgentParameters agent_parameters{
+            slot, journeyId, queueStage, 1, 1.2, 0.3};
+        ASSERT_NE(
+            JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr),
+            0);
+    }
+    JPS_Simulation_SetEventRecording(simulation, true);
+
+    while(JPS_Simulation_ElapsedTime(simulation) < 3.5) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    }
+
+    std::vector<JPS_Event> events(JPS_Simulation_EventCount(simulation));
+    events.resize(JPS_Simulation_ReadEvents(simulation, events.data(), events.size()));
+    std::vector<uint64_t> popIterations{};
+    for(const auto& event : events) {
+        if(event.type == JPS_EventType_QueuePopped) {
+            popIterations.push_back(event.iteration);
+        }
+    }
+    ASSERT_EQ(popIterations, (std::vector<uint64_t>{100, 200, 300}));
+}
+
+TEST_F(SimulationTest, PeriodicQueuePopWithIntervalBelowTimeStep)
+{
+    std::vector<JPS_Point> slots{{6, 5}, {5, 5}, {4, 5}, {3, 5}, {2, 5}, {1, 5}};
+    const auto queueStage =
+        JPS_Simulation_AddStageNotifiableQueue(simulation, slots.data(), slots.size(), nullptr);
+    std::vector<JPS_Point> exitArea{{8, 8}, {10, 8}, {10, 10}, {8, 10}};
+    const auto exitStage =
+        JPS_Simulation_AddStageExit(simulation, exitArea.data(), exitArea.size(), nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, queueStage);
+    JPS_JourneyDescription_AddStage(journey, exitStage);
+    auto transition = JPS_Transition_CreateFixedTransition(exitStage, nullptr);
+    ASSERT_TRUE(
+        JPS_JourneyDescription_SetTransitionForStage(journey, queueStage, transition, nullptr));
+    JPS_Transition_Free(transition);
+    const auto journeyId = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
+
+    // Two pops fall due in each iteration after the first one
+    ASSERT_TRUE(JPS_Simulation_AddPeriodicQueuePop(simulation, queueStage, 0.005, 1, 1, nullptr));
+
+    for(const auto& slot : slots) {
+        JPS_CollisionFreeSpeedModelAgentParameters agent_parameters{
+            slot, journeyId, queueStage, 1, 1.2, 0.3};
+        ASSERT_NE(
+            JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr),
+            0);
+    }
+    JPS_Simulation_SetEventRecording(simulation, true);
+
+    while(JPS_Simulation_IterationCount(simulation) < 110) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    }
+
+    std::vector<JPS_Event> events(JPS_Simulation_EventCount(simulation));
+    events.resize(JPS_Simulation_ReadEvents(simulation, events.data(), events.size()));
+    std::vector<uint64_t> popIterations{};
+    for(const auto& event : events) {
+        if(event.type == JPS_EventType_QueuePopped) {
+            popIterations.push_back(event.iteration);
+        }
+    }
+    ASSERT_EQ(popIterations, (std::vector<uint64_t>{100, 101, 101, 102, 102, 103}));
+}
+
+TEST_F(SimulationTest, WaitingSetThresholdsNeedActivationBelowDeactivation)
+{
+    std::vector<JPS_Point> slots{{5, 5}, {4, 5}, {3, 5}};
+    const auto waitingSet =
+        JPS_Simulation_AddStageWaitingSet(simulation, slots.data(), slots.size(), nullptr);
+
+    ASSERT_FALSE(JPS_Simulation_AddWaitingSetThresholds(simulation, waitingSet, 0, 0, nullptr));
+    ASSERT_FALSE(JPS_Simulation_AddWaitingSetThresholds(simulation, waitingSet, 4, 0, nullptr));
+    ASSERT_FALSE(JPS_Simulation_AddWaitingSetThresholds(simulation, waitingSet, 2, 2, nullptr));
+    ASSERT_FALSE(JPS_Simulation_AddWaitingSetThresholds(simulation, waitingSet, 2, 3, nullptr));
+    ASSERT_TRUE(JPS_Simulation_AddWaitingSetThresholds(simulation, waitingSet, 2, 1, nullptr));
+}
+
+using AgentState = std::tuple<JPS_AgentId, JPS_StageId, double, double>;
+
+static std::vector<AgentState> agentStates(JPS_Simulation sim)
+{
+    std::vector<AgentState> states{};
+    auto iter = JPS_Simulation_AgentIterator(sim);
+    while(auto agent = JPS_AgentIterator_Next(iter)) {
+        const auto position = JPS_Agent_GetPosition(agent);
+        states.emplace_back(
+            JPS_Agent_GetId(agent), JPS_Agent_GetStageId(agent), position.x, position.y);
+    }
+    JPS_AgentIterator_Free(iter);
+    return states;
+}
+
+TEST_F(SimulationTest, RestoredSnapshotContinuesIdentically)
+{
+    std::vector<JPS_Point> slots{{5, 5}, {4, 5}, {3, 5}};
+    const auto queueStage =
+        JPS_Simulation_AddStageNotifiableQueue(simulation, slots.data(), slots.size(), nullptr);
+    std::vector<JPS_Point> exitArea{{8, 8}, {10, 8}, {10, 10}, {8, 10}};
+    const auto exitStage =
+        JPS_Simulation_AddStageExit(simulation, exitArea.data(), exitArea.size(), nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, queueStage);
+    JPS_JourneyDescription_AddStage(journey, exitStage);
+    auto transition = JPS_Transition_CreateFixedTransition(exitStage, nullptr);
+    ASSERT_TRUE(
+        JPS_JourneyDescription_SetTransitionForStage(journey, queueStage, transition, nullptr));
+    JPS_Transition_Free(transition);
+    const auto journeyId = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
+    ASSERT_TRUE(JPS_Simulation_AddPeriodicQueuePop(simulation, queueStage, 1, 1, 1, nullptr));
+    for(const JPS_Point position : {JPS_Point{1, 1}, JPS_Point{1, 3}, JPS_Point{2, 8}}) {
+        JPS_CollisionFreeSpeedModelAgentParameters agent_parameters{
+            position, journeyId, queueStage, 1, 1.2, 0.3};
+        ASSERT_NE(
+            JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr),
+            0);
+    }
+    for(size_t iteration = 0; iteration < 150; ++iteration) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    }
+
+    const auto path = (std::filesystem::temp_directory_path() / "jupedsim-snapshot.bin").string();
+    ASSERT_TRUE(JPS_Simulation_SaveSnapshot(simulation, path.c_str(), nullptr));
+
+    auto restored = CreateSimulation();
+    ASSERT_NE(restored, nullptr);
+    ASSERT_TRUE(JPS_Simulation_LoadSnapshot(restored, path.c_str(), nullptr));
+    ASSERT_EQ(JPS_Simulation_IterationCount(restored), 150);
+    ASSERT_EQ(agentStates(restored), agentStates(simulation));
+
+    JPS_ErrorMessage errorMessage{};
+    ASSERT_FALSE(JPS_Simulation_LoadSnapshot(restored, path.c_str(), &errorMessage));
+    ASSERT_NE(errorMessage, nullptr);
+    JPS_ErrorMessage_Free(errorMessage);
+
+    for(size_t iteration = 0; iteration < 1000; ++iteration) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+        ASSERT_TRUE(JPS_Simulation_Iterate(restored, nullptr));
+        ASSERT_EQ(agentStates(restored), agentStates(simulation));
+    }
+    ASSERT_LT(JPS_Simulation_AgentCount(restored), 3);
+
+    std::filesystem::remove(path);
+    JPS_Simulation_Free(restored);
+}
+
+TEST_F(SimulationTest, RestoreRejectsUnknownOrdinals)
+{
+    auto agent_parameters = agent_templates[0];
+    agent_parameters.position = {5, 5};
+    const auto agentId =
+        JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr);
+    ASSERT_NE(agentId, 0);
+
+    const auto path = (std::filesystem::temp_directory_path() / "jupedsim-snapshot.bin").string();
+    ASSERT_TRUE(JPS_Simulation_SaveSnapshot(simulation, path.c_str(), nullptr));
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<char> snapshot{
+        std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    in.close();
+
+    // The agent columns of a single agent start with its id, journey id and stage id followed by
+    // its journey and stage ordinal, each stored as an array of length one.
+    const std::array<uint64_t, 7> columns{1, agentId, 1, journey_id, 1, stage_id, 1};
+    const auto begin = std::search(
+        std::begin(snapshot),
+        std::end(snapshot),
+        reinterpret_cast<const char*>(columns.data()),
+        reinterpret_cast<const char*>(columns.data() + columns.size()));
+    ASSERT_NE(begin, std::end(snapshot));
+    const auto journeyOrdinalOffset = (begin - std::begin(snapshot)) + sizeof(columns);
+    const auto stageOrdinalOffset = journeyOrdinalOffset + 2 * sizeof(uint64_t);
+
+    for(const auto offset : {journeyOrdinalOffset, stageOrdinalOffset}) {
+        auto patched = snapshot;
+        const uint64_t unknownOrdinal = 1;
+        std::memcpy(patched.data() + offset, &unknownOrdinal, sizeof(unknownOrdinal));
+        std::ofstream out(path, std::ios::binary);
+        out.write(patched.data(), patched.size());
+        out.close();
+
+        auto restored = CreateSimulation();
+        ASSERT_NE(restored, nullptr);
+        JPS_ErrorMessage errorMessage{};
+        ASSERT_FALSE(JPS_Simulation_LoadSnapshot(restored, path.c_str(), &errorMessage));
+        ASSERT_NE(errorMessage, nullptr);
+        ASSERT_NE(std::strstr(JPS_ErrorMessage_GetMessage(errorMessage), "unknown"), nullptr);
+        JPS_ErrorMessage_Free(errorMessage);
+        JPS_Simulation_Free(restored);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_F(SimulationTest, CloneContinuesIndependently)
+{
+    std::vector<JPS_Point> exitArea{{8, 4}, {10, 4}, {10, 6}, {8, 6}};
+    const auto exitStage =
+        JPS_Simulation_AddStageExit(simulation, exitArea.data(), exitArea.size(), nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, exitStage);
+    const auto journeyId = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
+    std::vector<JPS_AgentId> agentIds{};
+    for(const JPS_Point position : {JPS_Point{1, 2}, JPS_Point{1, 5}, JPS_Point{1, 8}}) {
+        JPS_CollisionFreeSpeedModelAgentParameters agent_parameters{
+            position, journeyId, exitStage, 1, 1.2, 0.3};
+        agentIds.push_back(
+            JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr));
+    }
+    for(size_t iteration = 0; iteration < 100; ++iteration) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    }
+
+    auto clone = JPS_Simulation_Clone(simulation, nullptr);
+    ASSERT_NE(clone, nullptr);
+    ASSERT_EQ(JPS_Simulation_IterationCount(clone), 100);
+    ASSERT_EQ(agentStates(clone), agentStates(simulation));
+    for(size_t iteration = 0; iteration < 100; ++iteration) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+        ASSERT_TRUE(JPS_Simulation_Iterate(clone, nullptr));
+    }
+    ASSERT_EQ(agentStates(clone), agentStates(simulation));
+
+    // Changes to the clone do not affect the original simulation
+    ASSERT_TRUE(JPS_Simulation_MarkAgentForRemoval(clone, agentIds[0], nullptr));
+    ASSERT_TRUE(JPS_Simulation_Iterate(clone, nullptr));
+    ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    ASSERT_EQ(JPS_Simulation_AgentCount(clone), 2);
+    ASSERT_EQ(JPS_Simulation_AgentCount(simulation), 3);
+
+    auto seeded = JPS_Simulation_CloneWithSeed(simulation, 42, nullptr);
+    ASSERT_NE(seeded, nullptr);
+    ASSERT_EQ(agentStates(seeded), agentStates(simulation));
+
+    JPS_Simulation_Free(seeded);
+    JPS_Simulation_Free(clone);
+}
+
+TEST_F(SimulationTest, CloneWithSeedControlsAnticipationVelocityModel)
+{
+    auto modelBuilder = JPS_AnticipationVelocityModelBuilder_Create(0.3, 1);
+    auto anticipationModel = JPS_AnticipationVelocityModelBuilder_Build(modelBuilder, nullptr);
+    ASSERT_NE(anticipationModel, nullptr);
+    JPS_AnticipationVelocityModelBuilder_Free(modelBuilder);
+    auto original = JPS_Simulation_Create(anticipationModel, geometry, 0.01, nullptr);
+    ASSERT_NE(original, nullptr);
+    JPS_OperationalModel_Free(anticipationModel);
+
+    // Agents walking head-on towards each other on the same line pick a random side to evade
+    for(const double y : {2., 4., 6., 8.}) {
+        for(const auto& [start, goal] : {std::pair{1., 9.}, std::pair{9., 1.}}) {
+            const auto waypoint =
+                JPS_Simulation_AddStageWaypoint(original, JPS_Point{goal, y}, 0.5, nullptr);
+            auto journey = JPS_JourneyDescription_Create();
+            JPS_JourneyDescription_AddStage(journey, waypoint);
+            JPS_AnticipationVelocityModelAgentParameters agent_parameters{};
+            agent_parameters.position = JPS_Point{start, y};
+            agent_parameters.journeyId = JPS_Simulation_AddJourney(original, journey, nullptr);
+            agent_parameters.stageId = waypoint;
+            JPS_JourneyDescription_Free(journey);
+            ASSERT_NE(
+                JPS_Simulation_AddAnticipationVelocityModelAgent(
+                    original, agent_parameters, nullptr),
+                0);
+        }
+    }
+
+    auto sameSeed = JPS_Simulation_CloneWithSeed(original, 1, nullptr);
+    ASSERT_NE(sameSeed, nullptr);
+    auto otherSeed = JPS_Simulation_CloneWithSeed(original, 2, nullptr);
+    ASSERT_NE(otherSeed, nullptr);
+    for(size_t iteration = 0; iteration < 600; ++iteration) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(original, nullptr));
+        ASSERT_TRUE(JPS_Simulation_Iterate(sameSeed, nullptr));
+        ASSERT_TRUE(JPS_Simulation_Iterate(otherSeed, nullptr));
+        ASSERT_EQ(agentStates(sameSeed), agentStates(original));
+    }
+    ASSERT_NE(agentStates(otherSeed), agentStates(original));
+
+    JPS_Simulation_Free(otherSeed);
+    JPS_Simulation_Free(sameSeed);
+    JPS_Simulation_Free(original);
+}
+
+TEST_F(SimulationTest, MeasuresFlowDensityAndOccupancy)
+{
+    std::vector<JPS_Point> exitArea{{9, 0}, {10, 0}, {10, 10}, {9, 10}};
+    const auto exitStage =
+        JPS_Simulation_AddStageExit(simulation, exitArea.data(), exitArea.size(), nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, exitStage);
+    const auto journeyId = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
+    for(const JPS_Point position : {JPS_Point{1, 2}, JPS_Point{1, 5}, JPS_Point{1, 8}}) {
+        JPS_CollisionFreeSpeedModelAgentParameters agent_parameters{
+            position, journeyId, exitStage, 1, 1.2, 0.3};
+        ASSERT_NE(
+            JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr),
+            0);
+    }
+
+    size_t gridId{};
+    ASSERT_TRUE(JPS_Simulation_AddGridMeasurement(
+        simulation, JPS_Point{0, 0}, JPS_Point{10, 10}, 5, 0.1, &gridId, nullptr));
+    size_t lineId{};
+    ASSERT_TRUE(JPS_Simulation_AddLineMeasurement(
+        simulation, JPS_Point{5, 0}, JPS_Point{5, 10}, &lineId, nullptr));
+    std::vector<JPS_Point> leftHalf{{0, 0}, {5, 0}, {5, 10}, {0, 10}};
+    size_t areaId{};
+    ASSERT_TRUE(JPS_Simulation_AddAreaMeasurement(
+        simulation, leftHalf.data(), leftHalf.size(), 0.5, &areaId, nullptr));
+    ASSERT_FALSE(JPS_Simulation_AddLineMeasurement(
+        simulation, JPS_Point{5, 0}, JPS_Point{5, 0}, &lineId, nullptr));
+
+    while(JPS_Simulation_AgentCount(simulation) > 0) {
+        ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+    }
+
+    JPS_GridMeasurement grid{};
+    ASSERT_TRUE(JPS_Simulation_GetGridMeasurement(simulation, gridId, &grid, nullptr));
+    ASSERT_EQ(grid.columns, 2);
+    ASSERT_EQ(grid.rows, 2);
+    ASSERT_GT(grid.samples, 0);
+    std::vector<double> density(grid.columns * grid.rows);
+    std::vector<double> speed(grid.columns * grid.rows);
+    ASSERT_TRUE(JPS_Simulation_ReadGridMeasurement(
+        simulation, gridId, density.data(), speed.data(), nullptr));
+    for(size_t cell = 0; cell < density.size(); ++cell) {
+        ASSERT_GT(density[cell], 0);
+        ASSERT_GT(speed[cell], 0);
+        ASSERT_LE(speed[cell], 1.2 + 1e-9);
+    }
+
+    uint64_t forward{};
+    uint64_t backward{};
+    ASSERT_TRUE(
+        JPS_Simulation_GetLineMeasurement(simulation, lineId, &forward, &backward, nullptr));
+    ASSERT_EQ(forward, 0);
+    ASSERT_EQ(backward, 3);
+    std::vector<JPS_LineCrossing> crossings(forward + backward);
+    ASSERT_TRUE(JPS_Simulation_ReadLineMeasurement(simulation, lineId, crossings.data(), nullptr));
+    for(const auto& crossing : crossings) {
+        ASSERT_EQ(crossing.direction, -1);
+        ASSERT_GT(crossing.time, 0);
+    }
+
+    size_t samples{};
+    ASSERT_TRUE(JPS_Simulation_GetAreaMeasurement(simulation, areaId, &samples, nullptr));
+    std::vector<double> times(samples);
+    std::vector<uint64_t> counts(samples);
+    ASSERT_TRUE(JPS_Simulation_ReadAreaMeasurement(
+        simulation, areaId, times.data(), counts.data(), nullptr));
+    ASSERT_EQ(counts.front(), 3);
+    ASSERT_EQ(counts.back(), 0);
+
+    size_t unknown{};
+    JPS_ErrorMessage errorMessage{};
+    ASSERT_FALSE(JPS_Simulation_GetAreaMeasurement(simulation, 1, &unknown, &errorMessage));
+    ASSERT_NE(errorMessage, nullptr);
+    JPS_ErrorMessage_Free(errorMessage);
+}
+
+TEST_F(SimulationTest, TrajectoryFileWritesSimulationFrames)
+{
+    std::vector<JPS_Point> exitArea{{8, 8}, {10, 8}, {10, 10}, {8, 10}};
+    const auto exitStage =
+        JPS_Simulation_AddStageExit(simulation, exitArea.data(), exitArea.size(), nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, exitStage);
+    const auto journeyId = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
+    for(const JPS_Point position : {JPS_Point{1, 1}, JPS_Point{1, 3}, JPS_Point{2, 8}}) {
+        JPS_CollisionFreeSpeedModelAgentParameters agent_parameters{
+            position, journeyId, exitStage, 1, 1.2, 0.3};
+        ASSERT_NE(
+            JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr),
+            0);
+    }
+
+    const auto path =
+        (std::filesystem::temp_directory_path() / "jupedsim-trajectory.jps").string();
+    auto writer = JPS_TrajectoryFileWriter_Create(
+        path.c_str(), JPS_TrajectoryStorage_Float64, 0, nullptr);
+    ASSERT_NE(writer, nullptr);
+    JPS_TrajectoryFileWriter_SetMetadata(writer, "fps", "10");
+    const auto geometryIndex = JPS_TrajectoryFileWriter_AddGeometry(writer, 42, "POLYGON EMPTY");
+    std::vector<std::vector<AgentState>> expected{};
+    for(uint64_t frame = 0; frame < 5; ++frame) {
+        ASSERT_TRUE(JPS_TrajectoryFileWriter_WriteSimulation(
+            writer, simulation, frame, geometryIndex, nullptr));
+        expected.push_back(agentStates(simulation));
+        for(size_t iteration = 0; iteration < 10; ++iteration) {
+            ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+        }
+    }
+    ASSERT_TRUE(JPS_TrajectoryFileWriter_Close(writer, nullptr));
+    JPS_TrajectoryFileWriter_Free(writer);
+
+    auto reader = JPS_TrajectoryFileReader_Open(path.c_str(), nullptr);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_EQ(JPS_TrajectoryFileReader_FrameCount(reader), expected.size());
+    ASSERT_EQ(JPS_TrajectoryFileReader_MetadataCount(reader), 1);
+    int64_t hash{};
+    ASSERT_STREQ(JPS_TrajectoryFileReader_Geometry(reader, 0, &hash), "POLYGON EMPTY");
+    ASSERT_EQ(hash, 42);
+    for(size_t index = 0; index < expected.size(); ++index) {
+        const auto frame = JPS_TrajectoryFileReader_Frame(reader, index);
+        ASSERT_EQ(frame.frame, index);
+        ASSERT_EQ(frame.agent_count, expected[index].size());
+        std::vector<uint64_t> ids(frame.agent_count);
+        JPS_TrajectoryFileReader_FrameIds(reader, index, ids.data());
+        const auto xs = static_cast<const double*>(frame.x);
+        const auto ys = static_cast<const double*>(frame.y);
+        for(size_t agent = 0; agent < frame.agent_count; ++agent) {
+            const auto& [id, stage, x, y] = expected[index][agent];
+            ASSERT_EQ(ids[agent], id);
+            ASSERT_EQ(xs[agent], x);
+            ASSERT_EQ(ys[agent], y);
+        }
+    }
+    JPS_TrajectoryFileReader_Free(reader);
+    std::filesystem::remove(path);
+}
+
+TEST_F(SimulationTest, FrameRingBufferPublishesSimulationFrames)
+{
+    std::vector<JPS_Point> exitArea{{8, 8}, {10, 8}, {10, 10}, {8, 10}};
+    const auto exitStage =
+        JPS_Simulation_AddStageExit(simulation, exitArea.data(), exitArea.size(), nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, exitStage);
+    const auto journeyId = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
+    for(const JPS_Point position : {JPS_Point{1, 1}, JPS_Point{1, 3}, JPS_Point{2, 8}}) {
+        JPS_CollisionFreeSpeedModelAgentParameters agent_parameters{
+            position, journeyId, exitStage, 1, 1.2, 0.3};
+        ASSERT_NE(
+            JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr),
+            0);
+    }
+
+    const char* name = "jupedsim-test-publish";
+    auto writer = JPS_FrameRingBufferWriter_Create(name, 4, 2, nullptr);
+    ASSERT_NE(writer, nullptr);
+    JPS_ErrorMessage errorMessage{};
+    ASSERT_FALSE(JPS_FrameRingBufferWriter_PublishSimulation(writer, simulation, 0, &errorMessage));
+    ASSERT_NE(errorMessage, nullptr);
+    JPS_ErrorMessage_Free(errorMessage);
+    JPS_FrameRingBufferWriter_Free(writer);
+
+    writer = JPS_FrameRingBufferWriter_Create(name, 4, 16, nullptr);
+    ASSERT_NE(writer, nullptr);
+    auto reader = JPS_FrameRingBufferReader_Open(name, nullptr);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_EQ(JPS_FrameRingBufferReader_Capacity(reader), 16);
+
+    const auto capacity = JPS_FrameRingBufferReader_Capacity(reader);
+    std::vector<uint64_t> ids(capacity);
+    std::vector<double> xs(capacity);
+    std::vector<double> ys(capacity);
+    std::vector<double> orientationXs(capacity);
+    std::vector<double> orientationYs(capacity);
+    JPS_FrameRingBufferFrame frame{};
+    for(uint64_t frameNumber = 0; frameNumber < 10; ++frameNumber) {
+        for(size_t iteration = 0; iteration < 5; ++iteration) {
+            ASSERT_TRUE(JPS_Simulation_Iterate(simulation, nullptr));
+        }
+        ASSERT_TRUE(
+            JPS_FrameRingBufferWriter_PublishSimulation(writer, simulation, frameNumber, nullptr));
+        ASSERT_TRUE(JPS_FrameRingBufferReader_ReadLatest(
+            reader,
+            &frame,
+            ids.data(),
+            xs.data(),
+            ys.data(),
+            orientationXs.data(),
+            orientationYs.data()));
+        ASSERT_EQ(frame.index, frameNumber);
+        ASSERT_EQ(frame.frame, frameNumber);
+        ASSERT_DOUBLE_EQ(frame.time, JPS_Simulation_ElapsedTime(simulation));
+        const auto expected = agentStates(simulation);
+        ASSERT_EQ(frame.agent_count, expected.size());
+        for(size_t agent = 0; agent < frame.agent_count; ++agent) {
+            const auto& [id, stage, x, y] = expected[agent];
+            ASSERT_EQ(ids[agent], id);
+            ASSERT_EQ(xs[agent], x);
+            ASSERT_EQ(ys[agent], y);
+        }
+    }
+    ASSERT_EQ(JPS_FrameRingBufferReader_PublishedCount(reader), 10);
+    ASSERT_FALSE(JPS_FrameRingBufferReader_Read(
+        reader,
+        0,
+        &frame,
+        ids.data(),
+        xs.data(),
+        ys.data(),
+        orientationXs.data(),
+        orientationYs.data()));
+    ASSERT_TRUE(JPS_FrameRingBufferReader_Read(
+        reader,
+        6,
+        &frame,
+        ids.data(),
+        xs.data(),
+        ys.data(),
+        orientationXs.data(),
+        orientationYs.data()));
+    ASSERT_EQ(frame.frame, 6);
+
+    JPS_FrameRingBufferWriter_Free(writer);
+    JPS_FrameRingBufferReader_Free(reader);
+}
+
+struct EnsembleScenario {
+    JPS_Geometry geometry;
+    JPS_OperationalModel model;
+    size_t failingRun;
+};
+
+static JPS_Simulation createEnsembleScenario(size_t run, void* userdata)
+{
+    const auto scenario = static_cast<const EnsembleScenario*>(userdata);
+    if(run == scenario->failingRun) {
+        return nullptr;
+    }
+    auto simulation = JPS_Simulation_Create(scenario->model, scenario->geometry, 0.01, nullptr);
+    std::vector<JPS_Point> box{{8, 4}, {10, 4}, {10, 6}, {8, 6}};
+    const auto exitStage = JPS_Simulation_AddStageExit(simulation, box.data(), box.size(), nullptr);
+    auto journey = JPS_JourneyDescription_Create();
+    JPS_JourneyDescription_AddStage(journey, exitStage);
+    const auto journeyId = JPS_Simulation_AddJourney(simulation, journey, nullptr);
+    JPS_JourneyDescription_Free(journey);
+
+    JPS_CollisionFreeSpeedModelAgentParameters agent_parameters{};
+    agent_parameters.journeyId = journeyId;
+    agent_parameters.stageId = exitStage;
+    agent_parameters.time_gap = 1;
+    agent_parameters.v0 = 1.2;
+    agent_parameters.radius = 0.2;
+    // Each run has one agent more than the previous one
+    for(size_t index = 0; index <= run; ++index) {
+        agent_parameters.position = JPS_Point{1, 1 + static_cast<double>(index)};
+        JPS_Simulation_AddCollisionFreeSpeedModelAgent(simulation, agent_parameters, nullptr);
+    }
+    return simulation;
+}
+
+TEST_F(SimulationTest, EnsembleRunsAllScenarios)
+{
+    EnsembleScenario scenario{geometry, model, 3};
+    const JPS_EnsembleSettings settings{6, 5000, 3, 100};
+    JPS_ErrorMessage errorMessage{};
+    auto result = JPS_Ensemble_Run(createEnsembleScenario, &scenario, settings, &errorMessage);
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(errorMessage, nullptr);
+    ASSERT_EQ(JPS_EnsembleResult_RunCount(result), 6);
+
+    for(size_t run = 0; run < 6; ++run) {
+        const auto summary = JPS_EnsembleResult_Summary(result, run);
+        const JPS_TrajectorySample* samples{};
+        const auto sampleCount = JPS_EnsembleResult_Trajectory(result, run, &samples);
+        if(run == scenario.failingRun) {
+            ASSERT_FALSE(summary.success);
+            ASSERT_NE(JPS_EnsembleResult_Error(result, run), nullptr);
+            ASSERT_EQ(sampleCount, 0);
+            continue;
+        }
+        ASSERT_TRUE(summary.success);
+        ASSERT_EQ(JPS_EnsembleResult_Error(result, run), nullptr);
+        ASSERT_EQ(summary.agent_count, 0);
+        ASSERT_EQ(summary.removed_agent_count, run + 1);
+        ASSERT_GT(summary.iterations, 0);
+        ASSERT_LT(summary.iterations, 5000);
+        ASSERT_DOUBLE_EQ(summary.elapsed_time, summary.iterations * 0.01);
+        // The first sample contains all agents at their initial position
+        ASSERT_GT(sampleCount, run + 1);
+        ASSERT_EQ(samples[0].iteration, 0);
+        ASSERT_EQ(samples[run].iteration, 0);
+        ASSERT_DOUBLE_EQ(samples[run].position.y, 1 + static_cast<double>(run));
+        ASSERT_EQ(samples[sampleCount - 1].iteration % 100, 0);
+    }
+
+    JPS_EnsembleResult_Free(result);
+}
+
+TEST(RoutingEngine, ComputesWaypointsOfManyPairs)
+{
+    auto builder = JPS_GeometryBuilder_Create();
+    std::vector<JPS_Point> box{{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    JPS_GeometryBuilder_AddAccessibleArea(builder, box.data(), box.size());
+    std::vector<JPS_Point> pillar{{4, 4}, {6, 4}, {6, 6}, {4, 6}};
+    JPS_GeometryBuilder_ExcludeFromAccessibleArea(builder, pillar.data(), pillar.size());
+    auto geometry = JPS_GeometryBuilder_Build(builder, nullptr);
+    JPS_GeometryBuilder_Free(builder);
+    auto engine = JPS_RoutingEngine_Create(geometry);
+
+    // Around the pillar, in line of sight and into the pillar
+    const std::vector<JPS_Point> from{{1, 5}, {1, 1}, {1, 1}};
+    const std::vector<JPS_Point> to{{9, 5}, {9, 1}, {5, 5}};
+    constexpr size_t maxWaypoints = 3;
+    std::vector<double> lengths(from.size());
+    std::vector<JPS_Point> waypoints(from.size() * maxWaypoints);
+    std::vector<size_t> counts(from.size());
+    JPS_ErrorMessage errorMessage{};
+    ASSERT_TRUE(JPS_RoutingEngine_ComputeWaypoints(
+        engine,
+        from.data(),
+        to.data(),
+        from.size(),
+        JPS_RoutingAlgorithm_Polyanya,
+        2,
+        lengths.data(),
+        maxWaypoints,
+        waypoints.data(),
+        counts.data(),
+        &errorMessage));
+    ASSERT_EQ(errorMessage, nullptr);
+
+    ASSERT_EQ(counts[0], 4);
+    ASSERT_NEAR(lengths[0], 2 * std::sqrt(10.) + 2, 1e-9);
+    ASSERT_DOUBLE_EQ(waypoints[0].x, 1);
+    ASSERT_DOUBLE_EQ(waypoints[0].y, 5);
+    ASSERT_EQ(counts[1], 2);
+    ASSERT_DOUBLE_EQ(lengths[1], 8);
+    ASSERT_DOUBLE_EQ(waypoints[maxWaypoints + 1].x, 9);
+    ASSERT_DOUBLE_EQ(waypoints[maxWaypoints + 1].y, 1);
+    ASSERT_EQ(counts[2], 0);
+    ASSERT_TRUE(std::isinf(lengths[2]));
+
+    // Lengths only
+    ASSERT_TRUE(JPS_RoutingEngine_ComputeWaypoints(
+        engine,
+        from.data(),
+        to.data(),
+        from.size(),
+        JPS_RoutingAlgorithm_TriangleAStar,
+        0,
+        lengths.data(),
+        0,
+        nullptr,
+        nullptr,
+        nullptr));
+    ASSERT_DOUBLE_EQ(lengths[1], 8);
+
+    JPS_RoutingEngine_Free(engine);
+    JPS_Geometry_Free(geometry);
+}
+
 TEST(Regression, Bug1028)
 {
 
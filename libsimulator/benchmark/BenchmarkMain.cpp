@@ -2,6 +2,9 @@
 #include <benchmark/benchmark.h>
 
 #include "benchmarkCollisionGeometry.hpp"
+#include "benchmarkGeometryBuilder.hpp"
 #include "benchmarkLineSegment.hpp"
+#include "benchmarkMemory.hpp"
+#include "benchmarkRoutingEngine.hpp"
 
 BENCHMARK_MAIN();
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <benchmark/benchmark.h>
+
+#include "GeometryBuilder.hpp"
+
+#include <cmath>
+
+/// Builds a square room with 'state.range(0)' square obstacles placed on a 1m grid, as produced by
+/// CAD imports with many small obstacles.
+inline void bmBuildWithObstacles(benchmark::State& state)
+{
+    const auto obstacleCount = static_cast<size_t>(state.range(0));
+    const auto obstaclesPerRow = static_cast<size_t>(std::ceil(std::sqrt(obstacleCount)));
+    const auto extent = static_cast<double>(obstaclesPerRow);
+
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea(
+        {{-1, -1}, {extent + 1, -1}, {extent + 1, extent + 1}, {-1, extent + 1}});
+    for(size_t index = 0; index < obstacleCount; ++index) {
+        const auto x = static_cast<double>(index % obstaclesPerRow) + 0.2;
+        const auto y = static_cast<double>(index / obstaclesPerRow) + 0.2;
+        builder.ExcludeFromAccessibleArea({{x, y}, {x + 0.4, y}, {x + 0.4, y + 0.4}, {x, y + 0.4}});
+    }
+
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(builder.Build());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(bmBuildWithObstacles)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity();
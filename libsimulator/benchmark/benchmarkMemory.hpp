@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <benchmark/benchmark.h>
+
+#include "AnticipationVelocityModelBuilder.hpp"
+#include "CollisionFreeSpeedModelBuilder.hpp"
+#include "CollisionFreeSpeedModelV2Builder.hpp"
+#include "GeneralizedCentrifugalForceModelBuilder.hpp"
+#include "GeometryBuilder.hpp"
+#include "Simulation.hpp"
+#include "SocialForceModelBuilder.hpp"
+
+#include <cmath>
+#include <memory>
+
+/// Creates a simulation on a 100m x 100m square with 'agentCount' agents placed on a 1m grid and
+/// reports the heap memory used per agent by agent storage and neighborhood search.
+template <typename ModelBuilder, typename AgentData>
+void bmMemoryPerAgent(benchmark::State& state, ModelBuilder builder, AgentData agentData)
+{
+    const auto agentCount = static_cast<size_t>(state.range(0));
+    const auto agentsPerRow = static_cast<size_t>(std::ceil(std::sqrt(agentCount)));
+
+    MemoryStats stats{};
+    for(auto _ : state) {
+        GeometryBuilder geometryBuilder{};
+        geometryBuilder.AddAccessibleArea({{0, 0}, {100, 0}, {100, 100}, {0, 100}});
+        Simulation simulation(
+            std::make_unique<decltype(builder.Build())>(builder.Build()),
+            SharedGeometry(geometryBuilder.Build()),
+            0.01);
+        const auto stage = simulation.AddStage(WaypointDescription{{99, 99}, 0.5});
+        const auto journey = simulation.AddJourney({{stage, NonTransitionDescription{}}});
+
+        for(size_t index = 0; index < agentCount; ++index) {
+            const Point pos{
+                1.5 + static_cast<double>(index % agentsPerRow),
+                1.5 + static_cast<double>(index / agentsPerRow)};
+            simulation.AddAgent(
+                GenericAgent(GenericAgent::ID::Invalid, journey, stage, pos, {1, 0}, agentData));
+        }
+        simulation.Iterate();
+        stats = simulation.GetMemoryStats();
+    }
+
+    const auto perAgentBytes = stats.agents.bytes + stats.neighborhoodSearch.bytes;
+    state.counters["bytes_per_agent"] =
+        static_cast<double>(perAgentBytes) / static_cast<double>(agentCount);
+    state.counters["agents_bytes"] = static_cast<double>(stats.agents.bytes);
+    state.counters["neighborhood_search_bytes"] =
+        static_cast<double>(stats.neighborhoodSearch.bytes);
+    state.counters["total_bytes"] = static_cast<double>(stats.total.bytes);
+}
+
+BENCHMARK_CAPTURE(
+    bmMemoryPerAgent,
+    collision_free_speed_model,
+    CollisionFreeSpeedModelBuilder(8, 0.1, 5, 0.02),
+    CollisionFreeSpeedModelData{})
+    ->RangeMultiplier(10)
+    ->Range(100, 1000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(
+    bmMemoryPerAgent,
+    collision_free_speed_model_v2,
+    CollisionFreeSpeedModelV2Builder(),
+    CollisionFreeSpeedModelV2Data{8, 0.1, 5, 0.02})
+    ->RangeMultiplier(10)
+    ->Range(100, 1000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(
+    bmMemoryPerAgent,
+    anticipation_velocity_model,
+    AnticipationVelocityModelBuilder(0.3, 42),
+    AnticipationVelocityModelData{8, 0.1})
+    ->RangeMultiplier(10)
+    ->Range(100, 1000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(
+    bmMemoryPerAgent,
+    generalized_centrifugal_force_model,
+    GeneralizedCentrifugalForceModelBuilder(0.3, 0.2, 2, 2, 0.1, 0.1, 3, 3),
+    GeneralizedCentrifugalForceModelData{0, {}, 0, 1, 0.5, 1.2, 0.5, 0.2, 0.2, 0.4})
+    ->RangeMultiplier(10)
+    ->Range(100, 1000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(
+    bmMemoryPerAgent,
+    social_force_model,
+    SocialForceModelBuilder(120000, 240000),
+    SocialForceModelData{{}, 80, 0.8, 0.5, 2000, 2000, 0.08, 0.3})
+    ->RangeMultiplier(10)
+    ->Range(100, 1000)
+    ->Unit(benchmark::kMillisecond);
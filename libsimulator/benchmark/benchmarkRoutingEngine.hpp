@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <benchmark/benchmark.h>
+
+#include "RoutingEngine.hpp"
+#include "buildGeometries.hpp"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+/// Fixed random pairs of routable points, the same for every algorithm
+inline std::vector<std::pair<Point, Point>>
+routablePairs(const RoutingEngine& engine, const CollisionGeometry& geometry, size_t count)
+{
+    const auto& box = geometry.Polygon().outer_boundary().bbox();
+    std::mt19937 gen{1234};
+    std::uniform_real_distribution<double> x{box.xmin(), box.xmax()};
+    std::uniform_real_distribution<double> y{box.ymin(), box.ymax()};
+    const auto randomPoint = [&]() {
+        while(true) {
+            const Point p{x(gen), y(gen)};
+            if(engine.IsRoutable(p)) {
+                return p;
+            }
+        }
+    };
+    std::vector<std::pair<Point, Point>> pairs{};
+    pairs.reserve(count);
+    for(size_t index = 0; index < count; ++index) {
+        const auto from = randomPoint();
+        pairs.emplace_back(from, randomPoint());
+    }
+    return pairs;
+}
+
+template <class... Args>
+void bmComputeAllWaypoints(benchmark::State& state, Args&&... args)
+{
+    auto args_tuple = std::make_tuple(std::move(args)...);
+    const auto algorithm = std::get<RoutingAlgorithm>(args_tuple);
+    const auto regionSize = std::get<double>(args_tuple);
+    const auto geometry = std::move(std::get<CollisionGeometry>(args_tuple));
+    const RoutingEngine engine(geometry.Polygon(), regionSize);
+    const auto pairs = routablePairs(engine, geometry, 100);
+    // Builds the merged mesh of 'RoutingAlgorithm::Polyanya' outside of the measurement
+    engine.ComputeAllWaypoints(pairs[0].first, pairs[0].second, algorithm);
+
+    size_t index = 0;
+    for(auto _ : state) {
+        const auto& [from, to] = pairs[index++ % pairs.size()];
+        benchmark::DoNotOptimize(engine.ComputeAllWaypoints(from, to, algorithm));
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK_CAPTURE(
+    bmComputeAllWaypoints,
+    large_street_network_triangle_a_star,
+    RoutingAlgorithm::TriangleAStar,
+    0.,
+    buildLargeStreetNetwork());
+
+BENCHMARK_CAPTURE(
+    bmComputeAllWaypoints,
+    large_street_network_polyanya,
+    RoutingAlgorithm::Polyanya,
+    0.,
+    buildLargeStreetNetwork());
+
+BENCHMARK_CAPTURE(
+    bmComputeAllWaypoints,
+    large_street_network_hierarchical,
+    RoutingAlgorithm::Hierarchical,
+    50.,
+    buildLargeStreetNetwork());
+
+/// Batches of all pairs, the number of threads is the benchmark argument
+template <class... Args>
+void bmComputeAllWaypointsBatch(benchmark::State& state, Args&&... args)
+{
+    auto args_tuple = std::make_tuple(std::move(args)...);
+    const auto algorithm = std::get<RoutingAlgorithm>(args_tuple);
+    const auto geometry = std::move(std::get<CollisionGeometry>(args_tuple));
+    const RoutingEngine engine(geometry.Polygon());
+    const auto pairs = routablePairs(engine, geometry, 100);
+    std::vector<Point> from{};
+    std::vector<Point> to{};
+    for(const auto& [a, b] : pairs) {
+        from.push_back(a);
+        to.push_back(b);
+    }
+    engine.ComputeAllWaypoints(from[0], to[0], algorithm);
+    std::vector<size_t> waypointCounts(pairs.size());
+    const auto threadCount = static_cast<size_t>(state.range(0));
+
+    for(auto _ : state) {
+        engine.ComputeAllWaypointsBatch(
+            from,
+            to,
+            [&waypointCounts](size_t index, const std::vector<Point>& path) {
+                waypointCounts[index] = path.size();
+            },
+            algorithm,
+            threadCount);
+        benchmark::DoNotOptimize(waypointCounts.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(pairs.size()));
+}
+
+BENCHMARK_CAPTURE(
+    bmComputeAllWaypointsBatch,
+    large_street_network_polyanya,
+    RoutingAlgorithm::Polyanya,
+    buildLargeStreetNetwork())
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime();
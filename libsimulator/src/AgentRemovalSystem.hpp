@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "EventLog.hpp"
 #include "GenericAgent.hpp"
 #include "IteratorPair.hpp"
 #include "StageManager.hpp"
@@ -22,25 +23,28 @@ public:
     void
     Run(std::vector<Agent>& agents,
         std::vector<GenericAgent::ID>& removedAgentIds,
-        StageManager& stageManager) const;
+        StageManager& stageManager,
+        EventLog& eventLog) const;
 };
 
 template <typename Agent>
 void AgentRemovalSystem<Agent>::Run(
     std::vector<Agent>& agents,
     std::vector<GenericAgent::ID>& removedAgentIds,
-    StageManager& stageManager) const
+    StageManager& stageManager,
+    EventLog& eventLog) const
 {
 
     auto iter = std::remove_if(
         std::begin(agents),
         std::end(agents),
-        [&removedAgentIds, &stageManager](const GenericAgent& agent) {
+        [&removedAgentIds, &stageManager, &eventLog](const GenericAgent& agent) {
             auto found =
                 std::find(std::begin(removedAgentIds), std::end(removedAgentIds), agent.id) !=
                 std::end(removedAgentIds);
             if(found) {
-                stageManager.HandleRemoveAgent(agent.stageId);
+                stageManager.HandleRemoveAgent(agent.id, agent.stageId);
+                eventLog.Push(SimulationEventType::AgentRemoved, agent.id, agent.stageId);
             }
             return found;
         });
@@ -76,7 +76,10 @@ OperationalModelUpdate AnticipationVelocityModel::ComputeNewPosition(
 
     // update direction towards the newly calculated direction
     direction = UpdateDirection(ped, direction, dT);
-    direction = HandleWallAvoidance(direction, ped.pos, model.radius, boundary, wallBufferDistance);
+    // Wall avoidance starts at twice the critical wall distance, see 'HandleWallAvoidance'
+    const auto walls =
+        geometry.LineSegmentsInDistanceTo(2 * (wallBufferDistance + model.radius), ped.pos);
+    direction = HandleWallAvoidance(direction, ped.pos, model.radius, walls, wallBufferDistance);
     const auto spacing = std::accumulate(
         std::begin(neighborhood),
         std::end(neighborhood),
@@ -204,6 +207,11 @@ std::unique_ptr<OperationalModel> AnticipationVelocityModel::Clone() const
     return std::make_unique<AnticipationVelocityModel>(*this);
 }
 
+void AnticipationVelocityModel::Seed(uint64_t seed)
+{
+    gen.seed(seed);
+}
+
 double AnticipationVelocityModel::OptimalSpeed(
     const GenericAgent& ped,
     double spacing,
@@ -298,7 +306,7 @@ Point AnticipationVelocityModel::HandleWallAvoidance(
     const Point& direction,
     const Point& agentPosition,
     double agentRadius,
-    const std::vector<LineSegment>& boundary,
+    std::span<const LineSegment> boundary,
     double wallBufferDistance) const
 {
     const double criticalWallDistance = wallBufferDistance + agentRadius;
@@ -306,7 +314,9 @@ Point AnticipationVelocityModel::HandleWallAvoidance(
         2.0 * criticalWallDistance; // Smoothing earlier. The constant is chosen randomly.
 
     auto nearestWallIt = std::min_element(
-        boundary.cbegin(), boundary.cend(), [&agentPosition](const auto& wall1, const auto& wall2) {
+        std::begin(boundary),
+        std::end(boundary),
+        [&agentPosition](const auto& wall1, const auto& wall2) {
             const auto distanceVector1 = agentPosition - wall1.ShortestPoint(agentPosition);
             const auto distanceVector2 = agentPosition - wall2.ShortestPoint(agentPosition);
             return distanceVector1.Norm() < distanceVector2.Norm();
@@ -6,6 +6,7 @@
 #include "OperationalModel.hpp"
 
 #include <random>
+#include <span>
 
 struct GenericAgent;
 
@@ -35,6 +36,7 @@ public:
         const NeighborhoodSearchType& neighborhoodSearch,
         const CollisionGeometry& geometry) const override;
     std::unique_ptr<OperationalModel> Clone() const override;
+    void Seed(uint64_t seed) override;
 
 private:
     double OptimalSpeed(const GenericAgent& ped, double spacing, double time_gap) const;
@@ -49,7 +51,7 @@ private:
         const Point& direction,
         const Point& agentPosition,
         double agentRadius,
-        const std::vector<LineSegment>& boundary,
+        std::span<const LineSegment> boundary,
         double wallBufferDistance) const;
 
     Point
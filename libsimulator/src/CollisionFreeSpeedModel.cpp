@@ -74,9 +74,15 @@ OperationalModelUpdate CollisionFreeSpeedModel::ComputeNewPosition(
             return res + NeighborRepulsion(ped, neighbor);
         });
 
+    const auto& model = std::get<CollisionFreeSpeedModelData>(ped.model);
+    // Only walls exerting a force above 'WALL_FORCE_TOLERANCE' are considered
+    const auto walls = geometry.WallsInInteractionRange(
+        ExponentialWallInteractionRange(
+            strengthGeometryRepulsion, rangeGeometryRepulsion, model.radius),
+        ped.pos);
     const auto boundaryRepulsion = std::accumulate(
-        boundary.cbegin(),
-        boundary.cend(),
+        std::begin(walls),
+        std::end(walls),
         Point(0, 0),
         [this, &ped](const auto& acc, const auto& element) {
             return acc + BoundaryRepulsion(ped, element);
@@ -95,7 +101,6 @@ OperationalModelUpdate CollisionFreeSpeedModel::ComputeNewPosition(
             return std::min(res, GetSpacing(ped, neighbor, direction));
         });
 
-    const auto& model = std::get<CollisionFreeSpeedModelData>(ped.model);
     const auto optimal_speed = OptimalSpeed(ped, spacing, model.timeGap);
     const auto velocity = direction * optimal_speed;
     return CollisionFreeSpeedModelUpdate{ped.pos + velocity * dT, direction};
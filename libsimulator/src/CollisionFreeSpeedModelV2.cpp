@@ -64,9 +64,15 @@ OperationalModelUpdate CollisionFreeSpeedModelV2::ComputeNewPosition(
             return res + NeighborRepulsion(ped, neighbor);
         });
 
+    const auto& model = std::get<CollisionFreeSpeedModelV2Data>(ped.model);
+    // Only walls exerting a force above 'WALL_FORCE_TOLERANCE' are considered
+    const auto walls = geometry.WallsInInteractionRange(
+        ExponentialWallInteractionRange(
+            model.strengthGeometryRepulsion, model.rangeGeometryRepulsion, model.radius),
+        ped.pos);
     const auto boundaryRepulsion = std::accumulate(
-        boundary.cbegin(),
-        boundary.cend(),
+        std::begin(walls),
+        std::end(walls),
         Point(0, 0),
         [this, &ped](const auto& acc, const auto& element) {
             return acc + BoundaryRepulsion(ped, element);
@@ -85,7 +91,6 @@ OperationalModelUpdate CollisionFreeSpeedModelV2::ComputeNewPosition(
             return std::min(res, GetSpacing(ped, neighbor, direction));
         });
 
-    const auto& model = std::get<CollisionFreeSpeedModelV2Data>(ped.model);
     const auto optimal_speed = OptimalSpeed(ped, spacing, model.timeGap);
     const auto velocity = direction * optimal_speed;
     return CollisionFreeSpeedModelV2Update{ped.pos + velocity * dT, direction};
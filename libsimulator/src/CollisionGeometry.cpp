@@ -3,9 +3,9 @@
 
 #include "AABB.hpp"
 #include "GeometricFunctions.hpp"
-#include "IteratorPair.hpp"
 #include "LineSegment.hpp"
 #include "Mathematics.hpp"
+#include "MemoryStats.hpp"
 #include "Point.hpp"
 
 #include <CGAL/Boolean_set_operations_2.h>
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <utility>
 #include <vector>
 
 Cell makeCell(Point p)
@@ -69,11 +70,6 @@ std::set<Cell> cellsFromLineSegment(LineSegment ls)
     return cells;
 }
 
-double dist(LineSegment l, Point p)
-{
-    return l.DistTo(p);
-}
-
 size_t CountLineSegments(const PolyWithHoles& poly)
 {
     auto count = poly.outer_boundary().size();
@@ -97,7 +93,31 @@ void ExtractSegmentsFromPolygon(const Poly& p, std::vector<LineSegment>& segment
     segments.emplace_back(fromPoint_2(boundary.back()), fromPoint_2(boundary.front()));
 }
 
-CollisionGeometry::CollisionGeometry(PolyWithHoles accessibleArea)
+std::tuple<std::vector<Point>, std::vector<std::vector<Point>>>
+AccessibleAreaFromPolygon(const PolyWithHoles& polygon)
+{
+    const auto cvt = [](const auto& c) {
+        std::vector<Point> out{};
+        out.reserve(c.size());
+        std::transform(std::begin(c), std::end(c), std::back_inserter(out), [](auto&& p) {
+            return fromPoint_2(p);
+        });
+        return out;
+    };
+    std::vector<Point> exterior = cvt(polygon.outer_boundary().container());
+    std::vector<std::vector<Point>> holes{};
+    holes.reserve(polygon.holes().size());
+    std::transform(
+        std::begin(polygon.holes()),
+        std::end(polygon.holes()),
+        std::back_inserter(holes),
+        [&cvt](auto&& c) { return cvt(c); });
+    return std::make_tuple(exterior, holes);
+}
+
+CollisionGeometry::CollisionGeometry(
+    PolyWithHoles accessibleArea,
+    const WallQuerySettings& wallQuerySettings)
     : _accessibleAreaPolygon(accessibleArea)
 {
     _segments.reserve(CountLineSegments(accessibleArea));
@@ -119,23 +139,23 @@ CollisionGeometry::CollisionGeometry(PolyWithHoles accessibleArea)
         vec.shrink_to_fit();
     }
 
-    const auto cvt = [](const auto& c) {
-        std::vector<Point> out{};
-        out.reserve(c.size());
-        std::transform(std::begin(c), std::end(c), std::back_inserter(out), [](auto&& p) {
-            return fromPoint_2(p);
-        });
-        return out;
-    };
-    std::vector<Point> exterior = cvt(_accessibleAreaPolygon.outer_boundary().container());
-    std::vector<std::vector<Point>> holes{};
-    holes.reserve(_accessibleAreaPolygon.holes().size());
-    std::transform(
-        std::begin(_accessibleAreaPolygon.holes()),
-        std::end(_accessibleAreaPolygon.holes()),
-        std::back_inserter(holes),
-        [&cvt](auto&& c) { return cvt(c); });
-    _accessibleArea = std::make_tuple(exterior, holes);
+    buildWallQueries(wallQuerySettings);
+    _accessibleArea = AccessibleAreaFromPolygon(_accessibleAreaPolygon);
+}
+
+CollisionGeometry::CollisionGeometry(
+    PolyWithHoles accessibleArea,
+    std::vector<LineSegment> segments,
+    SegmentGrid grid,
+    ApproximateSegmentGrid approximateGrid,
+    const WallQuerySettings& wallQuerySettings)
+    : _accessibleAreaPolygon(std::move(accessibleArea))
+    , _segments(std::move(segments))
+    , _grid(std::move(grid))
+    , _approximateGrid(std::move(approximateGrid))
+    , _accessibleArea(AccessibleAreaFromPolygon(_accessibleAreaPolygon))
+{
+    buildWallQueries(wallQuerySettings);
 }
 
 const std::vector<LineSegment>& CollisionGeometry::LineSegmentsInApproxDistanceTo(Point p) const
@@ -176,12 +196,48 @@ void CollisionGeometry::insertIntoApproximateGrid(const LineSegment& ls)
     }
 }
 
-CollisionGeometry::LineSegmentRange
+std::span<const LineSegment>
 CollisionGeometry::LineSegmentsInDistanceTo(double distance, Point p) const
 {
-    return LineSegmentRange{
-        DistanceQueryIterator<LineSegment>{distance, p, _segments.cbegin(), _segments.cend()},
-        DistanceQueryIterator<LineSegment>{distance, p, _segments.cend(), _segments.cend()}};
+    // Agents are updated in parallel, each thread reuses its own buffer across queries
+    thread_local std::vector<LineSegment> result{};
+    result.clear();
+    _wallGrid.SegmentsInDistanceTo(distance, p, result);
+    return result;
+}
+
+std::span<const LineSegment>
+CollisionGeometry::WallsInInteractionRange(double distance, Point p) const
+{
+    thread_local std::vector<LineSegment> result{};
+    result.clear();
+    if(_wallDistanceField &&
+       distance <= _wallDistanceField->Range() - _wallDistanceField->MissedWallMargin()) {
+        _wallDistanceField->WallsNear(distance, p, result);
+    } else {
+        _wallGrid.SegmentsInDistanceTo(distance, p, result);
+    }
+    return result;
+}
+
+WallQuerySettings CollisionGeometry::WallQueries() const
+{
+    WallQuerySettings settings{};
+    settings.gridCellSize = _wallGrid.CellSize();
+    if(_wallDistanceField) {
+        settings.distanceFieldSpacing = _wallDistanceField->Spacing();
+        settings.distanceFieldRange = _wallDistanceField->Range();
+    }
+    return settings;
+}
+
+void CollisionGeometry::buildWallQueries(const WallQuerySettings& settings)
+{
+    _wallGrid = LineSegmentGrid(_segments, settings.gridCellSize);
+    if(settings.distanceFieldSpacing > 0) {
+        _wallDistanceField.emplace(
+            _segments, settings.distanceFieldSpacing, settings.distanceFieldRange);
+    }
 }
 
 bool CollisionGeometry::IntersectsAny(const LineSegment& linesegment) const
@@ -213,3 +269,20 @@ CollisionGeometry::AccessibleArea() const
 {
     return _accessibleArea;
 }
+
+size_t CollisionGeometry::MemoryFootprint() const
+{
+    using jps::memory::HeapBytes;
+    const auto& [outer, holes] = _accessibleArea;
+    size_t polygonVertices = _accessibleAreaPolygon.outer_boundary().size();
+    for(const auto& hole : _accessibleAreaPolygon.holes()) {
+        polygonVertices += hole.size();
+    }
+    return HeapBytes(_segments) +
+           HeapBytes(_grid, [](const auto& segments) { return HeapBytes(segments); }) +
+           HeapBytes(_approximateGrid, [](const auto& segments) { return HeapBytes(segments); }) +
+           _wallGrid.MemoryFootprint() +
+           (_wallDistanceField ? _wallDistanceField->MemoryFootprint() : 0) + HeapBytes(outer) +
+           HeapBytes(holes) +
+           polygonVertices * sizeof(K::Point_2);
+}
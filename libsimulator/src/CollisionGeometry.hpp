@@ -3,68 +3,39 @@
 
 #include "CfgCgal.hpp"
 #include "HashCombine.hpp"
-#include "IteratorPair.hpp"
 #include "LineSegment.hpp"
+#include "LineSegmentGrid.hpp"
 #include "UniqueID.hpp"
+#include "WallDistanceField.hpp"
 
+#include <optional>
 #include <set>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
 class CollisionGeometry;
 
-double dist(LineSegment l, Point p);
-
-template <typename T>
-class DistanceQueryIterator
-{
-private:
-    using BackingIterator = typename std::vector<T>::const_iterator;
-    double _distance;
-    Point _p;
-    BackingIterator _current;
-    BackingIterator _end;
-
-public:
-    using iterator_category = std::input_iterator_tag;
-    using value_type = T;
-    using difference_type = std::ptrdiff_t;
-    using pointer = T*;
-    using reference = T&;
-    DistanceQueryIterator(double distance, Point p, BackingIterator current, BackingIterator end)
-        : _distance(distance)
-        , _p(p)
-        , _current(std::find_if(
-              current,
-              end,
-              [this](const auto& t) { return dist(t, _p) <= _distance; }))
-        , _end(end)
-    {
-    }
-    ~DistanceQueryIterator() = default;
-    DistanceQueryIterator(const DistanceQueryIterator& other) = default;
-    DistanceQueryIterator& operator=(const DistanceQueryIterator& other) = default;
-
-    bool operator==(const DistanceQueryIterator& other) const { return _current == other._current; }
-
-    bool operator!=(const DistanceQueryIterator& other) const { return !(*this == other); }
-
-    DistanceQueryIterator& operator++()
-    {
-        do {
-            ++_current;
-        } while(_current != _end && dist(*_current, _p) > _distance);
-        return *this;
-    }
-
-    const T& operator*() const { return *_current; }
-};
-
 /// Encodes a cell in the geometry grid.
 /// Cells are defined on the intervalls [min.x, min.x + extend), [min.y, min.y + extend)
 const int CELL_EXTEND = 4;
 using Cell = Point;
 
+/// Default cell size of the grid answering 'CollisionGeometry::LineSegmentsInDistanceTo'
+constexpr double DEFAULT_WALL_GRID_CELL_SIZE = 2.;
+/// Default range of the 'WallDistanceField', covers the wall forces of all models with their
+/// default parameters
+constexpr double DEFAULT_WALL_DISTANCE_FIELD_RANGE = 2.5;
+
+/// Lookup structures built for the wall queries of the operational models
+struct WallQuerySettings {
+    /// Cell size of the grid used by 'CollisionGeometry::LineSegmentsInDistanceTo'
+    double gridCellSize{DEFAULT_WALL_GRID_CELL_SIZE};
+    /// Node spacing of the 'WallDistanceField', 0 builds no field
+    double distanceFieldSpacing{0};
+    double distanceFieldRange{DEFAULT_WALL_DISTANCE_FIELD_RANGE};
+};
+
 /// Checks if two Cells are N8 neighbors. 'a' and 'b' are not considered neighbors if they have the
 /// same coordinates.
 bool IsN8Adjacent(const Cell& a, const Cell& b);
@@ -90,20 +61,36 @@ class CollisionGeometry
 {
 public:
     using ID = jps::UniqueID<CollisionGeometry>;
+    /// Line segments touching each cell
+    using SegmentGrid = std::unordered_map<Cell, std::set<LineSegment>>;
+    /// Line segments within the search radius of each cell
+    using ApproximateSegmentGrid = std::unordered_map<Cell, std::vector<LineSegment>>;
 
 private:
     ID _id{};
     PolyWithHoles _accessibleAreaPolygon;
     std::vector<LineSegment> _segments;
-    std::unordered_map<Cell, std::set<LineSegment>> _grid{};
-    std::unordered_map<Cell, std::vector<LineSegment>> _approximateGrid{};
+    SegmentGrid _grid{};
+    ApproximateSegmentGrid _approximateGrid{};
+    LineSegmentGrid _wallGrid{};
+    std::optional<WallDistanceField> _wallDistanceField{};
     std::tuple<std::vector<Point>, std::vector<std::vector<Point>>> _accessibleArea{};
 
 public:
-    using LineSegmentRange = IteratorPair<DistanceQueryIterator<LineSegment>>;
     /// Do not call constructor drectly use 'GeometryBuilder'
-    /// @param segments line segments constituting the geometry
-    explicit CollisionGeometry(PolyWithHoles accessibleArea);
+    /// @param accessibleArea polygon constituting the geometry
+    /// @param wallQuerySettings lookup structures to build for wall queries
+    explicit CollisionGeometry(
+        PolyWithHoles accessibleArea,
+        const WallQuerySettings& wallQuerySettings = {});
+    /// Restores a geometry with precomputed segments and grids, see 'GeometryCache'. They need
+    /// to be derived from 'accessibleArea' as done by the constructor above.
+    CollisionGeometry(
+        PolyWithHoles accessibleArea,
+        std::vector<LineSegment> segments,
+        SegmentGrid grid,
+        ApproximateSegmentGrid approximateGrid,
+        const WallQuerySettings& wallQuerySettings = {});
     /// Default destructor
     ~CollisionGeometry() = default;
     /// Copyable
@@ -114,12 +101,23 @@ public:
     CollisionGeometry(CollisionGeometry&& other) = default;
     /// Moveable
     CollisionGeometry& operator=(CollisionGeometry&& other) = default;
-    /// Returns an iterator pair to all linesegments <= 'distance' away from 'p'
+    /// Returns all linesegments <= 'distance' away from 'p'
     /// @param distance from reference point
     /// @param p reference point
-    /// @return iterator_pair to all linesegments in range
-    LineSegmentRange LineSegmentsInDistanceTo(double distance, Point p) const;
-
+    /// @return all linesegments in range, each linesegment once. The view is valid until the
+    ///         next call on the same thread.
+    std::span<const LineSegment> LineSegmentsInDistanceTo(double distance, Point p) const;
+
+    /// Returns the walls <= 'distance' away from 'p' the operational models need to consider.
+    /// Without 'WallDistanceField' or for distances exceeding its range these are the walls of
+    /// 'LineSegmentsInDistanceTo'. Otherwise, these are the nearest walls taken from the field,
+    /// see the error bound of 'WallDistanceField'. The view is valid until the next call on the
+    /// same thread.
+    std::span<const LineSegment> WallsInInteractionRange(double distance, Point p) const;
+
+    /// Returns the linesegments near the 'CELL_EXTEND' cell containing 'p', i.e. all linesegments
+    /// up to 4m away from the cell. Prefer 'LineSegmentsInDistanceTo' with the actual interaction
+    /// range, this returns linesegments up to ~10m away.
     const std::vector<LineSegment>& LineSegmentsInApproxDistanceTo(Point p) const;
 
     /// Will perfrom a linesegment intersection versus the whole geometry, i.e. walls and closed
@@ -134,8 +132,24 @@ public:
 
     const PolyWithHoles& Polygon() const { return _accessibleAreaPolygon; }
 
+    const std::vector<LineSegment>& Segments() const { return _segments; }
+
+    const SegmentGrid& Grid() const { return _grid; }
+
+    const ApproximateSegmentGrid& ApproximateGrid() const { return _approximateGrid; }
+
+    const std::optional<WallDistanceField>& WallDistances() const { return _wallDistanceField; }
+
+    /// Settings the wall lookup structures of this geometry were built with
+    WallQuerySettings WallQueries() const;
+
     ID Id() const { return _id; }
 
+    /// Estimated heap memory held by this geometry in bytes, i.e. line segments, all lookup
+    /// grids and the accessible area.
+    size_t MemoryFootprint() const;
+
 private:
     void insertIntoApproximateGrid(const LineSegment& ls);
+    void buildWallQueries(const WallQuerySettings& settings);
 };
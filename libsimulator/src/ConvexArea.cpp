@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "ConvexArea.hpp"
+
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+ConvexArea::ConvexArea(const Polygon& polygon)
+{
+    if(!polygon.IsConvex()) {
+        throw SimulationError("ConvexArea requires a convex polygon.");
+    }
+    // Polygon guarantees CCW ordering, i.e. the inside is left of each edge.
+    const auto points = polygon.Points();
+    bounds = AABB(points);
+    a.reserve(points.size());
+    b.reserve(points.size());
+    c.reserve(points.size());
+    for(size_t index = 0; index < points.size(); ++index) {
+        const auto& from = points[index];
+        const auto& to = points[(index + 1) % points.size()];
+        const auto edge = to - from;
+        a.push_back(edge.y);
+        b.push_back(-edge.x);
+        c.push_back(edge.y * from.x - edge.x * from.y);
+    }
+}
+
+bool ConvexArea::Contains(Point p) const
+{
+    if(!bounds.Inside(p)) {
+        return false;
+    }
+    for(size_t index = 0; index < a.size(); ++index) {
+        if(a[index] * p.x + b[index] * p.y > c[index]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ConvexArea::Contains(
+    std::span<const double> xs,
+    std::span<const double> ys,
+    std::span<uint8_t> inside) const
+{
+    assert(xs.size() == ys.size() && xs.size() == inside.size());
+    const size_t count = xs.size();
+
+    uint8_t anyInside = 0;
+    for(size_t i = 0; i < count; ++i) {
+        const uint8_t inBounds = (xs[i] >= bounds.xmin) & (xs[i] <= bounds.xmax) &
+                                 (ys[i] >= bounds.ymin) & (ys[i] <= bounds.ymax);
+        inside[i] = inBounds;
+        anyInside |= inBounds;
+    }
+    if(anyInside == 0) {
+        return;
+    }
+
+    for(size_t edge = 0; edge < a.size(); ++edge) {
+        const double ea = a[edge];
+        const double eb = b[edge];
+        const double ec = c[edge];
+        for(size_t i = 0; i < count; ++i) {
+            inside[i] &= static_cast<uint8_t>(ea * xs[i] + eb * ys[i] <= ec);
+        }
+    }
+}
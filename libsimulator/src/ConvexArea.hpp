@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "AABB.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// Point containment test for convex polygons.
+/// The polygon is stored as bounding box and as one half-plane 'a * x + b * y <= c' per edge. The
+/// coefficients are stored in separate arrays so that testing many points at once vectorizes.
+/// Points on the boundary are inside.
+class ConvexArea
+{
+    AABB bounds;
+    std::vector<double> a{};
+    std::vector<double> b{};
+    std::vector<double> c{};
+
+public:
+    /// @param polygon needs to be convex
+    explicit ConvexArea(const Polygon& polygon);
+    ~ConvexArea() = default;
+    ConvexArea(const ConvexArea& other) = default;
+    ConvexArea& operator=(const ConvexArea& other) = default;
+    ConvexArea(ConvexArea&& other) = default;
+    ConvexArea& operator=(ConvexArea&& other) = default;
+
+    bool Contains(Point p) const;
+
+    /// Tests all points (xs[i], ys[i]) at once.
+    /// @param xs x-coordinates of the points
+    /// @param ys y-coordinates of the points, same size as 'xs'
+    /// @param inside receives 1 for each point inside the area and 0 otherwise, same size as 'xs'
+    void Contains(
+        std::span<const double> xs,
+        std::span<const double> ys,
+        std::span<uint8_t> inside) const;
+
+    const AABB& Bounds() const { return bounds; }
+};
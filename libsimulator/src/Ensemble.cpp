@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "Ensemble.hpp"
+
+#include "ParallelFor.hpp"
+#include "SimulationError.hpp"
+
+static void recordTrajectory(Simulation& simulation, std::vector<TrajectorySample>& trajectory)
+{
+    const auto iteration = simulation.Iteration();
+    for(const auto& agent : simulation.Agents()) {
+        trajectory.push_back({iteration, agent.id, agent.pos});
+    }
+}
+
+static void runScenario(
+    const ScenarioFactory& factory,
+    const EnsembleSettings& settings,
+    size_t index,
+    EnsembleRun& run)
+{
+    const auto simulation = factory(index);
+    if(!simulation) {
+        throw SimulationError("Scenario factory did not create a simulation for run {}", index);
+    }
+    const auto record = [&]() {
+        if(settings.trajectoryInterval != 0 &&
+           simulation->Iteration() % settings.trajectoryInterval == 0) {
+            recordTrajectory(*simulation, run.trajectory);
+        }
+    };
+
+    record();
+    const auto start = simulation->Iteration();
+    while(simulation->AgentCount() > 0 &&
+          simulation->Iteration() - start < settings.maxIterations) {
+        simulation->Iterate();
+        run.removedAgentCount += simulation->RemovedAgents().size();
+        record();
+    }
+    run.iterations = simulation->Iteration() - start;
+    run.elapsedTime = simulation->ElapsedTime();
+    run.agentCount = simulation->AgentCount();
+}
+
+std::vector<EnsembleRun>
+RunEnsemble(const ScenarioFactory& factory, const EnsembleSettings& settings)
+{
+    std::vector<EnsembleRun> runs(settings.runCount);
+    jps::ParallelFor(settings.runCount, settings.threadCount, [&](size_t index) {
+        auto& run = runs[index];
+        try {
+            runScenario(factory, settings, index, run);
+        } catch(const std::exception& ex) {
+            run.error = ex.what();
+        } catch(...) {
+            run.error = "Unknown internal error.";
+        }
+    });
+    return runs;
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "GenericAgent.hpp"
+#include "Point.hpp"
+#include "Simulation.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct EnsembleSettings {
+    size_t runCount{};
+    /// A run ends after this many iterations or once no agents are left.
+    uint64_t maxIterations{};
+    /// 0 uses one thread per hardware thread.
+    size_t threadCount{};
+    /// Agent positions are recorded every 'trajectoryInterval' iterations, 0 disables recording.
+    uint64_t trajectoryInterval{};
+};
+
+struct TrajectorySample {
+    uint64_t iteration;
+    GenericAgent::ID agentId;
+    Point position;
+};
+
+/// Outcome of a single run of an ensemble.
+struct EnsembleRun {
+    /// Empty if the run completed, otherwise the reason it was aborted.
+    std::string error{};
+    uint64_t iterations{};
+    double elapsedTime{};
+    /// Agents still in the simulation when the run ended.
+    size_t agentCount{};
+    /// Agents removed during the run.
+    size_t removedAgentCount{};
+    std::vector<TrajectorySample> trajectory{};
+};
+
+/// Creates the simulation for the run with the given index. Called concurrently.
+using ScenarioFactory = std::function<std::unique_ptr<Simulation>(size_t)>;
+
+/// Runs 'settings.runCount' independent simulations created by 'factory' in parallel.
+/// Errors in a single run, including the factory throwing, are reported in its 'EnsembleRun' and do
+/// not affect other runs.
+/// @return one entry per run, in the order of the run index
+std::vector<EnsembleRun>
+RunEnsemble(const ScenarioFactory& factory, const EnsembleSettings& settings);
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "GenericAgent.hpp"
+#include "UniqueID.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class BaseStage;
+
+enum class SimulationEventType : uint8_t {
+    /// Agent completed 'previousStageId' or has been switched to another journey and now targets
+    /// 'stageId'
+    StageChanged,
+    /// Agent has been removed from the simulation, 'stageId' is the last stage it targeted
+    AgentRemoved,
+    /// Agent has been assigned a slot in the queue 'stageId'
+    QueueEnqueued,
+    /// Agent has been popped from the queue 'stageId'
+    QueuePopped,
+    /// Agent has been assigned a slot in the waiting set 'stageId'
+    WaitingSetEntered,
+    /// All slots of the waiting set 'stageId' are occupied, 'agentId' took the last slot
+    WaitingSetFull,
+};
+
+struct SimulationEvent {
+    SimulationEventType type{};
+    /// Iteration in which the event occurred. Events caused between iterations, e.g. by adding
+    /// agents or popping a queue, carry the current iteration count.
+    uint64_t iteration{};
+    GenericAgent::ID agentId{GenericAgent::ID::Invalid};
+    jps::UniqueID<BaseStage> stageId{jps::UniqueID<BaseStage>::Invalid};
+    /// Only valid for 'SimulationEventType::StageChanged'
+    jps::UniqueID<BaseStage> previousStageId{jps::UniqueID<BaseStage>::Invalid};
+};
+
+/// Events raised during the simulation that have not been read yet. Recording is disabled by
+/// default, nothing is stored until it is enabled.
+class EventLog
+{
+    /// Events before 'readOffset' have been read already
+    std::vector<SimulationEvent> events{};
+    size_t readOffset{};
+    uint64_t iteration{};
+    bool enabled{false};
+
+public:
+    void SetEnabled(bool on)
+    {
+        enabled = on;
+        if(!enabled) {
+            events.clear();
+            readOffset = 0;
+        }
+    }
+
+    bool Enabled() const { return enabled; }
+
+    /// Sets the iteration stamped on all events pushed from now on.
+    void SetIteration(uint64_t iteration_) { iteration = iteration_; }
+
+    void Push(
+        SimulationEventType type,
+        GenericAgent::ID agentId,
+        jps::UniqueID<BaseStage> stageId,
+        jps::UniqueID<BaseStage> previousStageId = jps::UniqueID<BaseStage>::Invalid)
+    {
+        if(enabled) {
+            events.push_back({type, iteration, agentId, stageId, previousStageId});
+        }
+    }
+
+    /// Number of events not read yet
+    size_t Count() const { return events.size() - readOffset; }
+
+    /// Moves the oldest events into 'buffer' and removes them from the log.
+    /// @return number of events written to 'buffer'
+    size_t Drain(std::span<SimulationEvent> buffer)
+    {
+        const auto count = std::min(buffer.size(), Count());
+        std::copy_n(std::begin(events) + readOffset, count, std::begin(buffer));
+        readOffset += count;
+        // Read events are dropped once they make up half of the log, this keeps draining with a
+        // small buffer linear in the number of events.
+        if(readOffset == events.size()) {
+            events.clear();
+            readOffset = 0;
+        } else if(readOffset > events.size() / 2) {
+            events.erase(std::begin(events), std::begin(events) + readOffset);
+            readOffset = 0;
+        }
+        return count;
+    }
+};
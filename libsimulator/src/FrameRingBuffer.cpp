@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "FrameRingBuffer.hpp"
+
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace
+{
+/// "JPSRING\0" in little endian
+constexpr uint64_t magicValue = 0x00474e495253504a;
+constexpr uint32_t formatVersion = 1;
+constexpr size_t cacheLine = 64;
+/// Attempts of 'ReadLatest' before giving up on a writer that keeps overwriting the latest frame
+constexpr int maxReadAttempts = 16;
+
+static_assert(sizeof(FrameRingBufferSlotHeader) <= cacheLine);
+
+size_t slotSize(uint64_t capacity)
+{
+    const auto size = cacheLine + 5 * sizeof(double) * capacity;
+    return (size + cacheLine - 1) / cacheLine * cacheLine;
+}
+
+size_t regionSize(uint32_t slotCount, uint64_t capacity)
+{
+    if(slotCount == 0) {
+        throw SimulationError("Ring buffer needs at least one slot");
+    }
+    return sizeof(FrameRingBufferHeader) + slotCount * slotSize(capacity);
+}
+
+/// Byte offset of 'column' (0 = ids, 1 = x, ...) within a slot
+size_t columnOffset(uint64_t capacity, size_t column)
+{
+    return cacheLine + column * sizeof(double) * capacity;
+}
+
+void checkBufferSizes(
+    uint64_t capacity,
+    std::span<uint64_t> ids,
+    std::span<double> xs,
+    std::span<double> ys,
+    std::span<double> orientationXs,
+    std::span<double> orientationYs)
+{
+    if(ids.size() < capacity || xs.size() < capacity || ys.size() < capacity ||
+       orientationXs.size() < capacity || orientationYs.size() < capacity) {
+        throw SimulationError("Buffers need to hold at least {} values", capacity);
+    }
+}
+} // namespace
+
+FrameRingBufferWriter::FrameRingBufferWriter(
+    const std::string& name,
+    uint32_t slotCount,
+    uint64_t capacity)
+    : memory(name, regionSize(slotCount, capacity))
+{
+    auto data = memory.Data().data();
+    header = new(data) FrameRingBufferHeader{};
+    header->version = formatVersion;
+    header->slotCount = slotCount;
+    header->capacity = capacity;
+    header->slotSize = slotSize(capacity);
+    for(uint32_t index = 0; index < slotCount; ++index) {
+        new(data + sizeof(FrameRingBufferHeader) + index * header->slotSize)
+            FrameRingBufferSlotHeader{};
+    }
+    // Readers check the magic value first, it marks the header as initialized
+    header->magic.store(magicValue, std::memory_order_release);
+}
+
+void FrameRingBufferWriter::Publish(
+    uint64_t frame,
+    uint64_t geometryVersion,
+    double time,
+    std::span<const uint64_t> ids,
+    std::span<const double> xs,
+    std::span<const double> ys,
+    std::span<const double> orientationXs,
+    std::span<const double> orientationYs)
+{
+    const auto count = ids.size();
+    if(xs.size() != count || ys.size() != count || orientationXs.size() != count ||
+       orientationYs.size() != count) {
+        throw SimulationError("All columns of a frame need to have the same size");
+    }
+    auto slot = beginWrite(frame, geometryVersion, time, count);
+    const auto capacity = header->capacity;
+    if(count > 0) {
+        std::memcpy(slot + columnOffset(capacity, 0), ids.data(), ids.size_bytes());
+        std::memcpy(slot + columnOffset(capacity, 1), xs.data(), xs.size_bytes());
+        std::memcpy(slot + columnOffset(capacity, 2), ys.data(), ys.size_bytes());
+        std::memcpy(
+            slot + columnOffset(capacity, 3), orientationXs.data(), orientationXs.size_bytes());
+        std::memcpy(
+            slot + columnOffset(capacity, 4), orientationYs.data(), orientationYs.size_bytes());
+    }
+    endWrite(slot);
+}
+
+void FrameRingBufferWriter::Publish(
+    uint64_t frame,
+    uint64_t geometryVersion,
+    double time,
+    const std::vector<GenericAgent>& agents)
+{
+    auto slot = beginWrite(frame, geometryVersion, time, agents.size());
+    const auto capacity = header->capacity;
+    auto ids = reinterpret_cast<uint64_t*>(slot + columnOffset(capacity, 0));
+    auto xs = reinterpret_cast<double*>(slot + columnOffset(capacity, 1));
+    auto ys = reinterpret_cast<double*>(slot + columnOffset(capacity, 2));
+    auto orientationXs = reinterpret_cast<double*>(slot + columnOffset(capacity, 3));
+    auto orientationYs = reinterpret_cast<double*>(slot + columnOffset(capacity, 4));
+    for(size_t index = 0; index < agents.size(); ++index) {
+        const auto& agent = agents[index];
+        ids[index] = agent.id.getID();
+        xs[index] = agent.pos.x;
+        ys[index] = agent.pos.y;
+        orientationXs[index] = agent.orientation.x;
+        orientationYs[index] = agent.orientation.y;
+    }
+    endWrite(slot);
+}
+
+std::byte* FrameRingBufferWriter::beginWrite(
+    uint64_t frame,
+    uint64_t geometryVersion,
+    double time,
+    size_t count)
+{
+    if(count > header->capacity) {
+        throw SimulationError(
+            "Frame with {} agents exceeds the ring buffer capacity of {} agents",
+            count,
+            header->capacity);
+    }
+    // Only this writer modifies 'published'
+    const auto index = header->published.load(std::memory_order_relaxed);
+    auto slot = memory.Data().data() + sizeof(FrameRingBufferHeader) +
+                (index % header->slotCount) * header->slotSize;
+    auto slotHeader = reinterpret_cast<FrameRingBufferSlotHeader*>(slot);
+    slotHeader->sequence.store(2 * index + 1, std::memory_order_relaxed);
+    // Readers that see any of the following writes also see the odd sequence
+    std::atomic_thread_fence(std::memory_order_release);
+    slotHeader->frame = frame;
+    slotHeader->geometryVersion = geometryVersion;
+    slotHeader->time = time;
+    slotHeader->agentCount = count;
+    return slot;
+}
+
+void FrameRingBufferWriter::endWrite(std::byte* slot)
+{
+    const auto index = header->published.load(std::memory_order_relaxed);
+    reinterpret_cast<FrameRingBufferSlotHeader*>(slot)->sequence.store(
+        2 * index + 2, std::memory_order_release);
+    header->published.store(index + 1, std::memory_order_release);
+}
+
+FrameRingBufferReader::FrameRingBufferReader(const std::string& name) : memory(name)
+{
+    const auto data = memory.Data();
+    if(data.size() < sizeof(FrameRingBufferHeader)) {
+        throw SimulationError("Shared memory '{}' is not a frame ring buffer", name);
+    }
+    header = reinterpret_cast<const FrameRingBufferHeader*>(data.data());
+    if(header->magic.load(std::memory_order_acquire) != magicValue) {
+        throw SimulationError("Shared memory '{}' is not a frame ring buffer", name);
+    }
+    if(header->version != formatVersion) {
+        throw SimulationError(
+            "Frame ring buffer '{}' has unsupported version {}", name, header->version);
+    }
+    if(header->slotSize != slotSize(header->capacity) ||
+       data.size() < sizeof(FrameRingBufferHeader) + header->slotCount * header->slotSize) {
+        throw SimulationError("Frame ring buffer '{}' is truncated", name);
+    }
+}
+
+std::optional<FrameRingBufferFrame> FrameRingBufferReader::Read(
+    uint64_t index,
+    std::span<uint64_t> ids,
+    std::span<double> xs,
+    std::span<double> ys,
+    std::span<double> orientationXs,
+    std::span<double> orientationYs) const
+{
+    const auto capacity = header->capacity;
+    checkBufferSizes(capacity, ids, xs, ys, orientationXs, orientationYs);
+    if(index >= Published()) {
+        return std::nullopt;
+    }
+    const auto slot = memory.Data().data() + sizeof(FrameRingBufferHeader) +
+                      (index % header->slotCount) * header->slotSize;
+    const auto slotHeader = reinterpret_cast<const FrameRingBufferSlotHeader*>(slot);
+    const auto expected = 2 * index + 2;
+    if(slotHeader->sequence.load(std::memory_order_acquire) != expected) {
+        return std::nullopt;
+    }
+    FrameRingBufferFrame result{
+        index,
+        slotHeader->frame,
+        slotHeader->geometryVersion,
+        slotHeader->time,
+        std::min(slotHeader->agentCount, capacity)};
+    const auto count = result.agentCount;
+    std::memcpy(ids.data(), slot + columnOffset(capacity, 0), count * sizeof(uint64_t));
+    std::memcpy(xs.data(), slot + columnOffset(capacity, 1), count * sizeof(double));
+    std::memcpy(ys.data(), slot + columnOffset(capacity, 2), count * sizeof(double));
+    std::memcpy(orientationXs.data(), slot + columnOffset(capacity, 3), count * sizeof(double));
+    std::memcpy(orientationYs.data(), slot + columnOffset(capacity, 4), count * sizeof(double));
+    // The copies need to complete before the sequence is checked again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(slotHeader->sequence.load(std::memory_order_relaxed) != expected) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+std::optional<FrameRingBufferFrame> FrameRingBufferReader::ReadLatest(
+    std::span<uint64_t> ids,
+    std::span<double> xs,
+    std::span<double> ys,
+    std::span<double> orientationXs,
+    std::span<double> orientationYs) const
+{
+    checkBufferSizes(header->capacity, ids, xs, ys, orientationXs, orientationYs);
+    for(int attempt = 0; attempt < maxReadAttempts; ++attempt) {
+        const auto published = Published();
+        if(published == 0) {
+            return std::nullopt;
+        }
+        const auto frame = Read(published - 1, ids, xs, ys, orientationXs, orientationYs);
+        if(frame) {
+            return frame;
+        }
+    }
+    return std::nullopt;
+}
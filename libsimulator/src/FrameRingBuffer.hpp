@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "GenericAgent.hpp"
+#include "SharedMemory.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/// Ring buffer of agent frames in shared memory, written by one simulation and read by any number
+/// of local processes.
+///
+/// The region starts with a header followed by 'slotCount' slots of equal size. Each slot holds
+/// the frame description followed by the columns id, x, y, orientation x and orientation y with
+/// room for 'capacity' agents. Slots are protected by a sequence lock: the writer sets the
+/// sequence of a slot to 2 * i + 1 before writing the i-th published frame into it and to
+/// 2 * i + 2 afterwards. Readers copy a slot and accept the copy only if the sequence was
+/// 2 * i + 2 before and after copying, so the writer never waits for readers.
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+struct FrameRingBufferHeader {
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint64_t capacity;
+    /// Size of a slot in bytes
+    uint64_t slotSize;
+    /// Number of frames published so far
+    alignas(64) std::atomic<uint64_t> published;
+};
+
+struct FrameRingBufferSlotHeader {
+    std::atomic<uint64_t> sequence;
+    uint64_t frame;
+    uint64_t geometryVersion;
+    double time;
+    uint64_t agentCount;
+};
+
+/// Description of a frame read from a ring buffer.
+struct FrameRingBufferFrame {
+    /// Position of the frame in the order of publishing
+    uint64_t index;
+    uint64_t frame;
+    uint64_t geometryVersion;
+    double time;
+    uint64_t agentCount;
+};
+
+class FrameRingBufferWriter
+{
+    SharedMemory memory;
+    FrameRingBufferHeader* header;
+
+public:
+    /// Creates the shared memory region 'name', replacing an existing region.
+    /// @param slotCount number of frames kept, needs to be greater than 0
+    /// @param capacity maximum number of agents per frame
+    FrameRingBufferWriter(const std::string& name, uint32_t slotCount, uint64_t capacity);
+
+    uint64_t Capacity() const { return header->capacity; }
+
+    /// Publishes a frame, overwriting the oldest frame once all slots are used. All spans need to
+    /// have the same size of at most 'Capacity'.
+    void Publish(
+        uint64_t frame,
+        uint64_t geometryVersion,
+        double time,
+        std::span<const uint64_t> ids,
+        std::span<const double> xs,
+        std::span<const double> ys,
+        std::span<const double> orientationXs,
+        std::span<const double> orientationYs);
+
+    /// Publishes the positions and orientations of 'agents', see above.
+    void Publish(
+        uint64_t frame,
+        uint64_t geometryVersion,
+        double time,
+        const std::vector<GenericAgent>& agents);
+
+private:
+    std::byte* beginWrite(uint64_t frame, uint64_t geometryVersion, double time, size_t count);
+    void endWrite(std::byte* slot);
+};
+
+class FrameRingBufferReader
+{
+    SharedMemory memory;
+    const FrameRingBufferHeader* header;
+
+public:
+    /// Maps the shared memory region 'name' created by a FrameRingBufferWriter.
+    explicit FrameRingBufferReader(const std::string& name);
+
+    uint32_t SlotCount() const { return header->slotCount; }
+    uint64_t Capacity() const { return header->capacity; }
+    uint64_t Published() const { return header->published.load(std::memory_order_acquire); }
+
+    /// Copies the frame published as 'index'-th frame.
+    /// All spans need to hold at least 'Capacity' values.
+    /// @return the frame or nothing if it was not published yet or has already been overwritten
+    std::optional<FrameRingBufferFrame> Read(
+        uint64_t index,
+        std::span<uint64_t> ids,
+        std::span<double> xs,
+        std::span<double> ys,
+        std::span<double> orientationXs,
+        std::span<double> orientationYs) const;
+
+    /// Copies the most recently published frame, see 'Read'.
+    /// @return the frame or nothing if no frame was published yet
+    std::optional<FrameRingBufferFrame> ReadLatest(
+        std::span<uint64_t> ids,
+        std::span<double> xs,
+        std::span<double> ys,
+        std::span<double> orientationXs,
+        std::span<double> orientationYs) const;
+};
@@ -317,11 +317,17 @@ inline Point GeneralizedCentrifugalForceModel::ForceRepRoom(
     const GenericAgent& ped,
     const CollisionGeometry& geometry) const
 {
-    const auto& walls = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
+    // Walls further away than the interaction distance from the ellipse exert no force, see
+    // 'ForceInterpolation'
+    const auto& model = std::get<GeneralizedCentrifugalForceModelData>(ped.model);
+    const Ellipse E{model.Av, model.AMin, model.BMax, model.BMin};
+    const auto ellipseExtent = std::max(E.GetEA(model.speed), E.GetEB(model.speed / model.v0));
+    const auto walls =
+        geometry.WallsInInteractionRange(maxGeometryInteractionDistance + ellipseExtent, ped.pos);
 
     auto f = std::accumulate(
-        walls.cbegin(),
-        walls.cend(),
+        std::begin(walls),
+        std::end(walls),
         Point(0, 0),
         [this, &ped](const auto& acc, const auto& element) {
             return acc + ForceRepWall(ped, element);
@@ -21,6 +21,10 @@ struct GenericAgent {
     jps::UniqueID<Journey> journeyId{jps::UniqueID<Journey>::Invalid};
     jps::UniqueID<BaseStage> stageId{jps::UniqueID<BaseStage>::Invalid};
 
+    // Dense indices of journey and stage, maintained by the simulation
+    size_t journeyOrdinal{};
+    size_t stageOrdinal{};
+
     // This is evaluated by the "operational level"
     Point destination{};
     Point target{};
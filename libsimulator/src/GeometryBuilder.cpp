@@ -3,14 +3,23 @@
 
 #include "CfgCgal.hpp"
 #include "CollisionGeometry.hpp"
+#include "LineSegment.hpp"
+#include "Logger.hpp"
 #include "Point.hpp"
 #include "RoutingEngine.hpp"
 #include "SimulationError.hpp"
+#include "Snapshot.hpp"
+
+#include <CGAL/Boolean_set_operations_2/Gps_polygon_validation.h>
+#include <CGAL/Gps_segment_traits_2.h>
+#include <CGAL/Polygon_set_2.h>
 
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 GeometryBuilder& GeometryBuilder::AddAccessibleArea(const std::vector<Point>& lineLoop)
@@ -25,38 +34,186 @@ GeometryBuilder& GeometryBuilder::ExcludeFromAccessibleArea(const std::vector<Po
     return *this;
 }
 
-CollisionGeometry GeometryBuilder::Build()
+GeometryBuilder& GeometryBuilder::SetSimplificationTolerance(double tolerance)
 {
-    const std::vector<Poly> accessibleListInput{
-        std::begin(_accessibleAreas), std::end(_accessibleAreas)};
-    PolyWithHolesList accessibleList{};
+    if(!(tolerance >= 0)) {
+        throw SimulationError("Simplification tolerance needs to be >= 0, got {}", tolerance);
+    }
+    _simplificationTolerance = tolerance;
+    return *this;
+}
 
-    CGAL::join(
-        std::begin(accessibleListInput),
-        std::end(accessibleListInput),
-        std::back_inserter(accessibleList));
+GeometryBuilder& GeometryBuilder::SetWallGridCellSize(double cellSize)
+{
+    if(!(cellSize > 0)) {
+        throw SimulationError("Wall grid cell size needs to be > 0, got {}", cellSize);
+    }
+    _wallQuerySettings.gridCellSize = cellSize;
+    return *this;
+}
 
-    if(accessibleList.size() != 1) {
-        throw SimulationError("accessible area not connected");
+GeometryBuilder& GeometryBuilder::SetWallDistanceField(double spacing, double range)
+{
+    if(!(spacing > 0) || !(range > 0)) {
+        throw SimulationError(
+            "Wall distance field needs spacing and range > 0, got spacing {} and range {}",
+            spacing,
+            range);
     }
+    _wallQuerySettings.distanceFieldSpacing = spacing;
+    _wallQuerySettings.distanceFieldRange = range;
+    return *this;
+}
 
-    auto accessibleArea = *accessibleList.begin();
+GeometryBuilder& GeometryBuilder::SetRoutingHierarchy(double regionSize)
+{
+    if(!(regionSize >= 0)) {
+        throw SimulationError("Routing region size needs to be >= 0, got {}", regionSize);
+    }
+    _routingRegionSize = regionSize;
+    return *this;
+}
+
+namespace
+{
+/// Removes vertices of a closed ring as long as every removed vertex is within 'tolerance' of the
+/// edge replacing it. Rings that would degenerate are returned unchanged.
+Poly simplifyRing(const Poly& ring, double tolerance)
+{
+    const auto count = ring.size();
+    if(count <= 3) {
+        return ring;
+    }
+    std::vector<Point> points{};
+    points.reserve(count);
+    for(const auto& vertex : ring.container()) {
+        points.emplace_back(vertex.x(), vertex.y());
+    }
+    const auto at = [&points, count](size_t index) { return points[index % count]; };
 
-    const std::vector<Poly> exclusionsListInput{std::begin(_exclusions), std::end(_exclusions)};
-    PolyWithHolesList exclusionsList{};
-    CGAL::join(
-        std::begin(exclusionsListInput),
-        std::end(exclusionsListInput),
-        std::back_inserter(exclusionsList));
+    // Start at the vertex deviating most from its neighbors, it is kept in any case
+    const auto deviation = [&at, count](size_t index) {
+        return LineSegment(at(index + count - 1), at(index + 1)).DistTo(at(index));
+    };
+    size_t start = 0;
+    for(size_t index = 1; index < count; ++index) {
+        if(deviation(index) > deviation(start)) {
+            start = index;
+        }
+    }
+    std::rotate(std::begin(points), std::begin(points) + start, std::end(points));
 
-    for(const auto& ex : exclusionsList) {
-        PolyWithHolesList res{};
-        CGAL::difference(accessibleArea, ex, std::back_inserter(res));
-        if(res.size() != 1) {
+    const auto replaceable = [&at, tolerance](size_t from, size_t to) {
+        const LineSegment edge(at(from), at(to));
+        for(size_t index = from + 1; index < to; ++index) {
+            if(edge.DistTo(at(index)) > tolerance) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    Poly simplified{};
+    simplified.push_back(K::Point_2(points[0].x, points[0].y));
+    size_t anchor = 0;
+    while(anchor < count) {
+        size_t end = anchor + 1;
+        while(end < count && replaceable(anchor, end + 1)) {
+            ++end;
+        }
+        if(end == count) {
+            break;
+        }
+        simplified.push_back(K::Point_2(points[end].x, points[end].y));
+        anchor = end;
+    }
+    return simplified.size() >= 3 ? simplified : ring;
+}
+
+PolyWithHoles simplifyPolygon(const PolyWithHoles& polygon, double tolerance)
+{
+    std::vector<Poly> holes{};
+    holes.reserve(polygon.number_of_holes());
+    for(const auto& hole : polygon.holes()) {
+        holes.push_back(simplifyRing(hole, tolerance));
+    }
+    return PolyWithHoles(
+        simplifyRing(polygon.outer_boundary(), tolerance), std::begin(holes), std::end(holes));
+}
+
+size_t countSegments(const PolyWithHoles& polygon)
+{
+    auto count = polygon.outer_boundary().size();
+    for(const auto& hole : polygon.holes()) {
+        count += hole.size();
+    }
+    return count;
+}
+} // namespace
+
+CollisionGeometry GeometryBuilder::Build() const
+{
+    // Polygon sets unite whole ranges in one divide and conquer pass and subtract all exclusions
+    // in a single overlay, subtracting exclusions one by one is quadratic in their number.
+    using PolySet = CGAL::Polygon_set_2<K>;
+    const std::vector<Poly> accessibleListInput{
+        std::begin(_accessibleAreas), std::end(_accessibleAreas)};
+    PolySet accessibleArea{};
+    accessibleArea.join(std::begin(accessibleListInput), std::end(accessibleListInput));
+
+    if(accessibleArea.number_of_polygons_with_holes() != 1) {
+        throw SimulationError("accessible area not connected");
+    }
+
+    if(!_exclusions.empty()) {
+        const std::vector<Poly> exclusionsListInput{
+            std::begin(_exclusions), std::end(_exclusions)};
+        PolySet exclusions{};
+        exclusions.join(std::begin(exclusionsListInput), std::end(exclusionsListInput));
+        accessibleArea.difference(exclusions);
+        if(accessibleArea.number_of_polygons_with_holes() != 1) {
             throw SimulationError("Exclusion splits accessibleArea");
         }
-        accessibleArea = *res.begin();
     }
 
-    return CollisionGeometry(accessibleArea);
+    PolyWithHolesList accessibleList{};
+    accessibleArea.polygons_with_holes(std::back_inserter(accessibleList));
+    if(_simplificationTolerance == 0) {
+        return CollisionGeometry(accessibleList.front(), _wallQuerySettings);
+    }
+
+    const auto& polygon = accessibleList.front();
+    auto simplified = simplifyPolygon(polygon, _simplificationTolerance);
+    if(!CGAL::is_valid_polygon_with_holes(simplified, CGAL::Gps_segment_traits_2<K>{})) {
+        LOG_WARNING(
+            "Simplification with tolerance {} results in an invalid accessible area, using the "
+            "unsimplified area",
+            _simplificationTolerance);
+        return CollisionGeometry(polygon, _wallQuerySettings);
+    }
+    LOG_INFO(
+        "Simplification with tolerance {} reduced the wall segments from {} to {}",
+        _simplificationTolerance,
+        countSegments(polygon),
+        countSegments(simplified));
+    return CollisionGeometry(std::move(simplified), _wallQuerySettings);
+}
+
+uint64_t GeometryBuilder::Fingerprint() const
+{
+    Fnv1a fnv{};
+    for(const auto* polygons : {&_accessibleAreas, &_exclusions}) {
+        const uint64_t count = polygons->size();
+        fnv.Add(&count, sizeof(count));
+        for(const auto& polygon : *polygons) {
+            fnv.Add(polygon.Points());
+        }
+    }
+    fnv.Add(&_simplificationTolerance, sizeof(_simplificationTolerance));
+    const auto& [gridCellSize, distanceFieldSpacing, distanceFieldRange] = _wallQuerySettings;
+    fnv.Add(&gridCellSize, sizeof(gridCellSize));
+    fnv.Add(&distanceFieldSpacing, sizeof(distanceFieldSpacing));
+    fnv.Add(&distanceFieldRange, sizeof(distanceFieldRange));
+    fnv.Add(&_routingRegionSize, sizeof(_routingRegionSize));
+    return fnv.hash;
 }
@@ -4,12 +4,16 @@
 #include "CollisionGeometry.hpp"
 #include "Polygon.hpp"
 
+#include <cstdint>
 #include <vector>
 
 class GeometryBuilder
 {
     std::vector<Polygon> _accessibleAreas{};
     std::vector<Polygon> _exclusions{};
+    double _simplificationTolerance{0};
+    WallQuerySettings _wallQuerySettings{};
+    double _routingRegionSize{0};
 
 public:
     GeometryBuilder() = default;
@@ -21,5 +25,30 @@ public:
 
     GeometryBuilder& AddAccessibleArea(const std::vector<Point>& lineLoop);
     GeometryBuilder& ExcludeFromAccessibleArea(const std::vector<Point>& lineLoop);
-    CollisionGeometry Build();
+    /// Enables simplification of the built accessible area: vertices are removed as long as the
+    /// simplified boundary stays within 'tolerance' of every removed vertex. This merges collinear
+    /// and nearly collinear wall segments and removes edges shorter than 'tolerance'. If the
+    /// simplified area is no valid polygon the unsimplified area is used. 0 disables it.
+    GeometryBuilder& SetSimplificationTolerance(double tolerance);
+    /// Sets the cell size of the grid answering wall distance queries of the models, see
+    /// 'CollisionGeometry::LineSegmentsInDistanceTo'. Cells of about the interaction range of the
+    /// models perform best.
+    GeometryBuilder& SetWallGridCellSize(double cellSize);
+    /// Enables the 'WallDistanceField' answering the wall queries of the models up to 'range'
+    /// minus its error margin of 'sqrt(2) * spacing', see
+    /// 'CollisionGeometry::WallsInInteractionRange'. Only the nearest walls around each agent are
+    /// considered then, trading accuracy of the wall forces for speed in wall dense geometries.
+    GeometryBuilder& SetWallDistanceField(
+        double spacing,
+        double range = DEFAULT_WALL_DISTANCE_FIELD_RANGE);
+    /// Enables the 'RoutingHierarchy' of the routing engine with regions of about 'regionSize'
+    /// meters, used by 'RoutingAlgorithm::Hierarchical'. The routing engine and its hierarchy are
+    /// then built together with the geometry, see 'SharedGeometry', instead of on first use.
+    /// 0 disables it.
+    GeometryBuilder& SetRoutingHierarchy(double regionSize);
+    double RoutingRegionSize() const { return _routingRegionSize; }
+    CollisionGeometry Build() const;
+    /// Identifies the input polygons, including their order. Builders with equal fingerprints
+    /// build equal geometries, see 'GeometryCache'.
+    uint64_t Fingerprint() const;
 };
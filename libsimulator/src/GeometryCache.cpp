@@ -0,0 +1,280 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "GeometryCache.hpp"
+
+#include "Logger.hpp"
+#include "Mesh.hpp"
+#include "RoutingHierarchy.hpp"
+#include "SimulationError.hpp"
+#include "Snapshot.hpp"
+
+#include <fmt/format.h>
+
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace
+{
+/// "JPSGEOC" followed by a zero byte
+constexpr uint64_t magicValue = 0x00434f454753504aULL;
+constexpr uint32_t formatVersion = 4;
+
+template <typename Grid>
+void writeGrid(
+    SnapshotWriter& writer,
+    const Grid& grid,
+    const std::map<LineSegment, uint64_t>& segmentIndices)
+{
+    writer.Write(static_cast<uint64_t>(grid.size()));
+    std::vector<uint64_t> indices{};
+    for(const auto& [cell, segments] : grid) {
+        indices.clear();
+        for(const auto& segment : segments) {
+            indices.push_back(segmentIndices.at(segment));
+        }
+        writer.Write(cell);
+        writer.WriteArray(indices);
+    }
+}
+
+template <typename Grid, typename Insert>
+Grid readGrid(SnapshotReader& reader, const std::vector<LineSegment>& segments, Insert insert)
+{
+    Grid grid{};
+    const auto cellCount = reader.Read<uint64_t>();
+    grid.reserve(cellCount);
+    for(uint64_t index = 0; index < cellCount; ++index) {
+        const auto cell = reader.Read<Cell>();
+        auto& cellSegments = grid[cell];
+        for(const auto segmentIndex : reader.ReadArray<uint64_t>()) {
+            if(segmentIndex >= segments.size()) {
+                throw SimulationError("Geometry cache entry is corrupt");
+            }
+            insert(cellSegments, segments[segmentIndex]);
+        }
+    }
+    return grid;
+}
+
+Poly polygonFromPoints(const std::vector<Point>& points)
+{
+    Poly polygon{};
+    for(const auto& point : points) {
+        polygon.push_back(K::Point_2(point.x, point.y));
+    }
+    return polygon;
+}
+} // namespace
+
+std::vector<std::byte> SerializeGeometry(uint64_t key, const SharedGeometry& geometry)
+{
+    const auto& collision = geometry.Collision();
+    const auto routing = geometry.Routing();
+    SnapshotWriter writer{};
+    writer.Write(magicValue);
+    writer.Write(formatVersion);
+    writer.Write(key);
+
+    const auto& [boundary, holes] = collision.AccessibleArea();
+    writer.WriteArray(boundary);
+    writer.Write(static_cast<uint64_t>(holes.size()));
+    for(const auto& hole : holes) {
+        writer.WriteArray(hole);
+    }
+
+    const auto& segments = collision.Segments();
+    writer.WriteArray(segments);
+    std::map<LineSegment, uint64_t> segmentIndices{};
+    for(uint64_t index = 0; index < segments.size(); ++index) {
+        segmentIndices.emplace(segments[index], index);
+    }
+    writeGrid(writer, collision.Grid(), segmentIndices);
+    writeGrid(writer, collision.ApproximateGrid(), segmentIndices);
+    const auto wallQueries = collision.WallQueries();
+    writer.Write(wallQueries.gridCellSize);
+    writer.Write(wallQueries.distanceFieldSpacing);
+    writer.Write(wallQueries.distanceFieldRange);
+
+    // CGAL's binary triangulation format is not readable, the text format is written with enough
+    // digits to restore every coordinate exactly.
+    const auto& cdt = routing->Triangulation();
+    std::ostringstream triangulation{};
+    triangulation << std::setprecision(std::numeric_limits<double>::max_digits10) << cdt;
+    const auto text = triangulation.str();
+    writer.WriteArray(std::span<const char>(text.data(), text.size()));
+    // Faces are read back in the order of 'all_face_handles', see CGAL's operator>>
+    std::vector<uint8_t> inDomain{};
+    inDomain.reserve(cdt.tds().number_of_faces());
+    for(const auto face : cdt.all_face_handles()) {
+        inDomain.push_back(face->get_in_domain() ? 1 : 0);
+    }
+    writer.WriteArray(inDomain);
+
+    const auto mesh = routing->MeshData();
+    std::vector<glm::dvec2> vertices{};
+    vertices.reserve(mesh->CountVertices());
+    for(size_t index = 0; index < mesh->CountVertices(); ++index) {
+        vertices.push_back(mesh->Vertex(index));
+    }
+    writer.WriteArray(vertices);
+    writer.Write(static_cast<uint64_t>(mesh->CountPolygons()));
+    for(size_t index = 0; index < mesh->CountPolygons(); ++index) {
+        const auto& polygon = mesh->Polygons(index);
+        writer.WriteArray(polygon.vertices);
+        writer.WriteArray(polygon.neighbors);
+    }
+
+    const auto hierarchy = routing->Hierarchy();
+    writer.Write(static_cast<uint8_t>(hierarchy ? 1 : 0));
+    if(hierarchy) {
+        writer.Write(hierarchy->RegionSize());
+        writer.WriteArray(hierarchy->RegionOfPolygon());
+        writer.WriteArray(hierarchy->PortalDistances());
+    }
+    return writer.Release();
+}
+
+SharedGeometry DeserializeGeometry(uint64_t key, std::span<const std::byte> data)
+{
+    SnapshotReader reader{data};
+    if(reader.Read<uint64_t>() != magicValue) {
+        throw SimulationError("Data is not a geometry cache entry");
+    }
+    if(const auto version = reader.Read<uint32_t>(); version != formatVersion) {
+        throw SimulationError("Geometry cache entry has unsupported version {}", version);
+    }
+    if(const auto storedKey = reader.Read<uint64_t>(); storedKey != key) {
+        throw SimulationError(
+            "Geometry cache entry was written for key {:016x}, expected {:016x}", storedKey, key);
+    }
+
+    const auto boundary = reader.ReadArray<Point>();
+    std::vector<Poly> holes{};
+    const auto holeCount = reader.Read<uint64_t>();
+    for(uint64_t index = 0; index < holeCount; ++index) {
+        holes.push_back(polygonFromPoints(reader.ReadArray<Point>()));
+    }
+    PolyWithHoles polygon{polygonFromPoints(boundary), std::begin(holes), std::end(holes)};
+
+    auto segments = reader.ReadArray<LineSegment>();
+    auto grid = readGrid<CollisionGeometry::SegmentGrid>(
+        reader, segments, [](auto& cell, const auto& segment) { cell.insert(segment); });
+    auto approximateGrid = readGrid<CollisionGeometry::ApproximateSegmentGrid>(
+        reader, segments, [](auto& cell, const auto& segment) { cell.push_back(segment); });
+    WallQuerySettings wallQueries{};
+    wallQueries.gridCellSize = reader.Read<double>();
+    wallQueries.distanceFieldSpacing = reader.Read<double>();
+    wallQueries.distanceFieldRange = reader.Read<double>();
+
+    const auto text = reader.ReadArray<char>();
+    std::istringstream triangulation{std::string(std::begin(text), std::end(text))};
+    CDT cdt{};
+    if(!(triangulation >> cdt)) {
+        throw SimulationError("Geometry cache entry is corrupt");
+    }
+    const auto inDomain = reader.ReadArray<uint8_t>();
+    if(inDomain.size() != cdt.tds().number_of_faces()) {
+        throw SimulationError("Geometry cache entry is corrupt");
+    }
+    size_t faceIndex = 0;
+    for(const auto face : cdt.all_face_handles()) {
+        face->set_in_domain(inDomain[faceIndex++] != 0);
+    }
+
+    auto vertices = reader.ReadArray<glm::dvec2>();
+    std::vector<Mesh::Polygon> meshPolygons(reader.Read<uint64_t>());
+    for(auto& meshPolygon : meshPolygons) {
+        meshPolygon.vertices = reader.ReadArray<size_t>();
+        meshPolygon.neighbors = reader.ReadArray<size_t>();
+    }
+    auto mesh = std::make_unique<Mesh>(std::move(vertices), std::move(meshPolygons));
+
+    std::unique_ptr<const RoutingHierarchy> hierarchy{};
+    if(reader.Read<uint8_t>() != 0) {
+        const auto regionSize = reader.Read<double>();
+        auto regionOfPolygon = reader.ReadArray<uint32_t>();
+        auto portalDistances = reader.ReadArray<float>();
+        hierarchy = std::make_unique<const RoutingHierarchy>(
+            *mesh, regionSize, std::move(regionOfPolygon), std::move(portalDistances));
+    }
+    if(!reader.AtEnd()) {
+        throw SimulationError("Geometry cache entry is corrupt");
+    }
+
+    return SharedGeometry{
+        CollisionGeometry{
+            std::move(polygon),
+            std::move(segments),
+            std::move(grid),
+            std::move(approximateGrid),
+            wallQueries},
+        std::make_unique<const RoutingEngine>(
+            std::move(cdt), std::move(mesh), std::move(hierarchy))};
+}
+
+GeometryCache::GeometryCache(std::filesystem::path directory_) : directory(std::move(directory_))
+{
+    std::error_code error{};
+    std::filesystem::create_directories(directory, error);
+    if(error) {
+        throw SimulationError(
+            "Could not create geometry cache directory '{}': {}",
+            directory.string(),
+            error.message());
+    }
+}
+
+SharedGeometry GeometryCache::Build(const GeometryBuilder& builder) const
+{
+    const auto key = builder.Fingerprint();
+    try {
+        if(auto geometry = Load(key)) {
+            return *geometry;
+        }
+    } catch(const SimulationError& ex) {
+        LOG_WARNING("Rebuilding geometry, cache entry is not usable: {}", ex.what());
+    }
+    SharedGeometry geometry{builder.Build(), builder.RoutingRegionSize()};
+    try {
+        Store(key, geometry);
+    } catch(const SimulationError& ex) {
+        LOG_WARNING("Geometry is not cached: {}", ex.what());
+    }
+    return geometry;
+}
+
+std::optional<SharedGeometry> GeometryCache::Load(uint64_t key) const
+{
+    const auto path = EntryPath(key);
+    if(!std::filesystem::exists(path)) {
+        return std::nullopt;
+    }
+    return DeserializeGeometry(key, ReadSnapshotFile(path.string()));
+}
+
+void GeometryCache::Store(uint64_t key, const SharedGeometry& geometry) const
+{
+    const auto data = SerializeGeometry(key, geometry);
+    // Readers in other processes never see a partially written entry
+    const auto path = EntryPath(key);
+    auto temporary = path;
+    temporary += fmt::format(".{:08x}.tmp", std::random_device{}());
+    WriteSnapshotFile(temporary.string(), data);
+    std::error_code error{};
+    std::filesystem::rename(temporary, path, error);
+    if(error) {
+        const auto message = error.message();
+        std::filesystem::remove(temporary, error);
+        throw SimulationError(
+            "Could not store geometry cache entry '{}': {}", path.string(), message);
+    }
+}
+
+std::filesystem::path GeometryCache::EntryPath(uint64_t key) const
+{
+    return directory / fmt::format("{:016x}.jpsgeo", key);
+}
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "GeometryBuilder.hpp"
+#include "SharedGeometry.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+/// Serializes a built geometry: the accessible area, its line segments, both lookup grids, the
+/// constrained triangulation, the navigation mesh and its routing hierarchy if there is one.
+/// Builds the routing engine of 'geometry' if this did not happen yet.
+/// @param key identifies the inputs the geometry was built from, see 'GeometryBuilder::Fingerprint'
+std::vector<std::byte> SerializeGeometry(uint64_t key, const SharedGeometry& geometry);
+
+/// Restores a geometry written by 'SerializeGeometry' without any polygon set operations or
+/// triangulation. Throws SimulationError if 'data' is not a geometry of this format version or
+/// was written for a different key.
+SharedGeometry DeserializeGeometry(uint64_t key, std::span<const std::byte> data);
+
+/// Directory of serialized geometries, one file per set of input polygons. Any number of
+/// processes can share a cache directory; entries are replaced atomically.
+class GeometryCache
+{
+    std::filesystem::path directory;
+
+public:
+    /// Creates 'directory' if it does not exist.
+    explicit GeometryCache(std::filesystem::path directory);
+
+    /// Loads the geometry built from the inputs of 'builder' or builds and stores it. Unreadable
+    /// entries, e.g. written by another version, are rebuilt. Failing to store the entry is only
+    /// logged, the built geometry is returned regardless.
+    SharedGeometry Build(const GeometryBuilder& builder) const;
+
+    /// @return the geometry stored for 'key' or nothing if there is no entry
+    std::optional<SharedGeometry> Load(uint64_t key) const;
+
+    void Store(uint64_t key, const SharedGeometry& geometry) const;
+
+    std::filesystem::path EntryPath(uint64_t key) const;
+};
@@ -87,6 +87,12 @@ class Transition
 public:
     virtual ~Transition() = default;
     virtual BaseStage* NextStage() = 0;
+    /// Description this transition can be recreated from.
+    virtual TransitionDescription Description() const = 0;
+    /// Writes the state this transition accumulated while simulating, see 'Simulation::Save'.
+    virtual void SaveState(SnapshotWriter&) const {}
+    /// Restores the state written by 'SaveState' into a transition created from 'Description'.
+    virtual void RestoreState(SnapshotReader&) {}
 };
 
 class FixedTransition : public Transition
@@ -98,6 +104,11 @@ public:
     FixedTransition(BaseStage* next_) : next(next_) {};
 
     BaseStage* NextStage() override { return next; }
+
+    TransitionDescription Description() const override
+    {
+        return FixedTransitionDescription(next->Id());
+    }
 };
 
 class RoundRobinTransition : public Transition
@@ -134,6 +145,23 @@ public:
         nextCalled = (nextCalled + 1) % sumWeights;
         return candidate;
     }
+
+    TransitionDescription Description() const override
+    {
+        std::vector<std::tuple<BaseStage::ID, uint64_t>> stages{};
+        stages.reserve(weightedStages.size());
+        for(const auto& [stage, weight] : weightedStages) {
+            stages.emplace_back(stage->Id(), weight);
+        }
+        return RoundRobinTransitionDescription(stages);
+    }
+
+    void SaveState(SnapshotWriter& writer) const override { writer.Write(nextCalled); }
+
+    void RestoreState(SnapshotReader& reader) override
+    {
+        nextCalled = reader.Read<uint64_t>() % sumWeights;
+    }
 };
 
 class LeastTargetedTransition : public Transition
@@ -155,6 +183,16 @@ public:
             [](auto const& a, auto const& b) { return a->CountTargeting() < b->CountTargeting(); });
         return *leastTargeted;
     }
+
+    TransitionDescription Description() const override
+    {
+        std::vector<BaseStage::ID> candidates{};
+        candidates.reserve(targetCandidates.size());
+        for(const auto stage : targetCandidates) {
+            candidates.push_back(stage->Id());
+        }
+        return LeastTargetedTransitionDescription(std::move(candidates));
+    }
 };
 
 struct JourneyNode {
@@ -169,15 +207,46 @@ public:
 
 private:
     ID id{};
+    /// Dense index of this journey in its simulation
+    size_t ordinal{};
     std::map<BaseStage::ID, JourneyNode> stages{};
+    /// Nodes indexed by the ordinal of their stage, nullptr for stages not part of this journey
+    std::vector<const JourneyNode*> nodesByStageOrdinal{};
+
+    /// Restores journeys with their original ids from snapshots
+    friend class Simulation;
 
 public:
     ~Journey() = default;
 
-    Journey(std::map<BaseStage::ID, JourneyNode> stages_) : stages(std::move(stages_)) {}
+    Journey(std::map<BaseStage::ID, JourneyNode> stages_, size_t ordinal_)
+        : ordinal(ordinal_), stages(std::move(stages_))
+    {
+        for(const auto& [_, node] : stages) {
+            const auto stageOrdinal = node.stage->Ordinal();
+            if(stageOrdinal >= nodesByStageOrdinal.size()) {
+                nodesByStageOrdinal.resize(stageOrdinal + 1, nullptr);
+            }
+            nodesByStageOrdinal[stageOrdinal] = &node;
+        }
+    }
 
     ID Id() const { return id; }
 
+    size_t Ordinal() const { return ordinal; }
+
+    /// Looks up the node of a stage by the stage's ordinal.
+    /// Throws SimulationError if the stage is not part of this journey.
+    /// @param stageOrdinal ordinal of a stage that is part of this journey
+    const JourneyNode& Node(size_t stageOrdinal) const
+    {
+        if(stageOrdinal >= nodesByStageOrdinal.size() || !nodesByStageOrdinal[stageOrdinal]) {
+            throw SimulationError(
+                "Stage with ordinal {} is not part of journey {}", stageOrdinal, id.getID());
+        }
+        return *nodesByStageOrdinal[stageOrdinal];
+    }
+
     std::tuple<Point, BaseStage::ID> Target(const GenericAgent& agent) const
     {
         auto& node = stages.at(agent.stageId);
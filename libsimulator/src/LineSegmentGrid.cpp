@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "LineSegmentGrid.hpp"
+
+#include "AABB.hpp"
+#include "MemoryStats.hpp"
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+LineSegmentGrid::LineSegmentGrid(const std::vector<LineSegment>& segments, double cellSize)
+    : _cellSize(cellSize)
+{
+    if(!(cellSize > 0)) {
+        throw SimulationError("Line segment grid cell size needs to be > 0, got {}", cellSize);
+    }
+    if(segments.empty()) {
+        _cellStart = {0};
+        return;
+    }
+    const auto bounds = AABB([&segments]() {
+        std::vector<Point> points{};
+        points.reserve(2 * segments.size());
+        for(const auto& segment : segments) {
+            points.push_back(segment.p1);
+            points.push_back(segment.p2);
+        }
+        return points;
+    }());
+    _origin = bounds.BottomLeft();
+    _columns = static_cast<int64_t>(std::floor((bounds.xmax - bounds.xmin) / _cellSize)) + 1;
+    _rows = static_cast<int64_t>(std::floor((bounds.ymax - bounds.ymin) / _cellSize)) + 1;
+    if(static_cast<double>(_columns) * static_cast<double>(_rows) >
+       static_cast<double>(std::numeric_limits<uint32_t>::max())) {
+        throw SimulationError(
+            "Line segment grid cell size {} is too small for a geometry of {} x {}",
+            cellSize,
+            bounds.xmax - bounds.xmin,
+            bounds.ymax - bounds.ymin);
+    }
+
+    // Calls 'visit' with the index of every cell touched by 'segment'
+    const auto forEachCell = [this](const LineSegment& segment, auto&& visit) {
+        const AABB segmentBounds(segment.p1, segment.p2);
+        for(auto y = row(segmentBounds.ymin); y <= row(segmentBounds.ymax); ++y) {
+            for(auto x = column(segmentBounds.xmin); x <= column(segmentBounds.xmax); ++x) {
+                const Point cellMin{
+                    _origin.x + static_cast<double>(x) * _cellSize,
+                    _origin.y + static_cast<double>(y) * _cellSize};
+                if(AABB(cellMin, cellMin + Point{_cellSize, _cellSize}).Intersects(segment)) {
+                    visit(static_cast<size_t>(y * _columns + x));
+                }
+            }
+        }
+    };
+
+    _cellStart.assign(static_cast<size_t>(_columns * _rows) + 1, 0);
+    std::vector<bool> shared{};
+    shared.reserve(segments.size());
+    for(const auto& segment : segments) {
+        size_t cellCount = 0;
+        forEachCell(segment, [this, &cellCount](size_t cell) {
+            ++_cellStart[cell + 1];
+            ++cellCount;
+        });
+        shared.push_back(cellCount > 1);
+    }
+    for(size_t cell = 1; cell < _cellStart.size(); ++cell) {
+        _cellStart[cell] += _cellStart[cell - 1];
+    }
+    _cellSegments.resize(_cellStart.back());
+    std::vector<uint32_t> fill(std::begin(_cellStart), std::end(_cellStart) - 1);
+    for(size_t index = 0; index < segments.size(); ++index) {
+        const Entry entry{segments[index], shared[index]};
+        forEachCell(segments[index], [this, &fill, &entry](size_t cell) {
+            _cellSegments[fill[cell]++] = entry;
+        });
+    }
+}
+
+void LineSegmentGrid::SegmentsInDistanceTo(
+    double distance,
+    Point p,
+    std::vector<LineSegment>& out) const
+{
+    out.clear();
+    const auto firstColumn = std::max<int64_t>(column(p.x - distance), 0);
+    const auto lastColumn = std::min<int64_t>(column(p.x + distance), _columns - 1);
+    const auto firstRow = std::max<int64_t>(row(p.y - distance), 0);
+    const auto lastRow = std::min<int64_t>(row(p.y + distance), _rows - 1);
+    const auto distanceSquared = distance * distance;
+    // Segments touching several cells are only returned for the first cell they are found in
+    size_t sharedEnd = 0;
+    for(auto y = firstRow; y <= lastRow; ++y) {
+        const auto cellMinY = _origin.y + static_cast<double>(y) * _cellSize;
+        const auto dy = std::max({cellMinY - p.y, 0., p.y - cellMinY - _cellSize});
+        for(auto x = firstColumn; x <= lastColumn; ++x) {
+            const auto cellMinX = _origin.x + static_cast<double>(x) * _cellSize;
+            const auto dx = std::max({cellMinX - p.x, 0., p.x - cellMinX - _cellSize});
+            if(dx * dx + dy * dy > distanceSquared) {
+                continue;
+            }
+            const auto cell = static_cast<size_t>(y * _columns + x);
+            for(auto index = _cellStart[cell]; index < _cellStart[cell + 1]; ++index) {
+                const auto& [segment, shared] = _cellSegments[index];
+                if(segment.DistTo(p) > distance) {
+                    continue;
+                }
+                if(!shared) {
+                    out.push_back(segment);
+                    continue;
+                }
+                // Shared segments are kept at the front of 'out'
+                const auto sharedBegin = std::begin(out);
+                if(std::find(sharedBegin, sharedBegin + sharedEnd, segment) ==
+                   sharedBegin + sharedEnd) {
+                    out.push_back(segment);
+                    std::swap(out[sharedEnd], out.back());
+                    ++sharedEnd;
+                }
+            }
+        }
+    }
+}
+
+size_t LineSegmentGrid::MemoryFootprint() const
+{
+    using jps::memory::HeapBytes;
+    return HeapBytes(_cellStart) + HeapBytes(_cellSegments);
+}
+
+int64_t LineSegmentGrid::column(double x) const
+{
+    return static_cast<int64_t>(std::floor((x - _origin.x) / _cellSize));
+}
+
+int64_t LineSegmentGrid::row(double y) const
+{
+    return static_cast<int64_t>(std::floor((y - _origin.y) / _cellSize));
+}
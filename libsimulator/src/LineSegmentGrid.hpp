@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "LineSegment.hpp"
+#include "Point.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/// Uniform grid over line segments answering exact radius queries.
+/// Each segment is stored in every cell it touches, cells are laid out contiguously so that a query
+/// only reads the cells overlapping the query circle.
+class LineSegmentGrid
+{
+    struct Entry {
+        LineSegment segment;
+        /// The segment touches more than one cell, queries may find it multiple times
+        bool shared;
+    };
+
+    double _cellSize{1};
+    Point _origin{};
+    int64_t _columns{};
+    int64_t _rows{};
+    /// Segments of cell 'i' are _cellSegments[_cellStart[i], _cellStart[i + 1])
+    std::vector<uint32_t> _cellStart{};
+    std::vector<Entry> _cellSegments{};
+
+public:
+    LineSegmentGrid() = default;
+    /// @param segments to store
+    /// @param cellSize edge length of the quadratic cells, needs to be > 0
+    LineSegmentGrid(const std::vector<LineSegment>& segments, double cellSize);
+
+    /// Returns all segments <= 'distance' away from 'p', each segment is returned once.
+    /// @param distance from reference point
+    /// @param p reference point
+    /// @param out receives the segments, previous content is removed
+    void SegmentsInDistanceTo(double distance, Point p, std::vector<LineSegment>& out) const;
+
+    double CellSize() const { return _cellSize; }
+
+    /// Heap memory held by the grid in bytes
+    size_t MemoryFootprint() const;
+
+private:
+    int64_t column(double x) const;
+    int64_t row(double y) const;
+};
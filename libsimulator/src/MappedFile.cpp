@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "MappedFile.hpp"
+
+#include "SimulationError.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path)
+{
+    fileHandle = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if(fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        throw SimulationError("Could not open '{}'", path);
+    }
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(fileHandle, &fileSize);
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if(size == 0) {
+        return;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mappingHandle == nullptr) {
+        CloseHandle(fileHandle);
+        throw SimulationError("Could not map '{}'", path);
+    }
+    data = static_cast<const std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if(data == nullptr) {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        throw SimulationError("Could not map '{}'", path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if(data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+    if(mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if(fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+    }
+}
+#else
+MappedFile::MappedFile(const std::string& path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw SimulationError("Could not open '{}'", path);
+    }
+    struct stat info{};
+    if(fstat(fd, &info) != 0) {
+        close(fd);
+        throw SimulationError("Could not read size of '{}'", path);
+    }
+    size = static_cast<size_t>(info.st_size);
+    if(size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if(mapping == MAP_FAILED) {
+            close(fd);
+            throw SimulationError("Could not map '{}'", path);
+        }
+        data = static_cast<const std::byte*>(mapping);
+    }
+    // The mapping stays valid after closing the descriptor
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if(data != nullptr) {
+        munmap(const_cast<std::byte*>(data), size);
+    }
+}
+#endif
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+/// Read only memory mapping of a whole file. The mapping is released on destruction.
+class MappedFile
+{
+    const std::byte* data{nullptr};
+    size_t size{0};
+#ifdef _WIN32
+    void* fileHandle{nullptr};
+    void* mappingHandle{nullptr};
+#endif
+
+public:
+    /// Throws SimulationError if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) = delete;
+    MappedFile& operator=(MappedFile&& other) = delete;
+
+    std::span<const std::byte> Data() const { return {data, size}; }
+};
@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "MeasurementSystem.hpp"
+
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+
+std::vector<double> GridMeasurement::Density() const
+{
+    std::vector<double> density(counts.size(), 0.0);
+    if(samples == 0) {
+        return density;
+    }
+    const auto area = static_cast<double>(samples) * cellSize * cellSize;
+    for(size_t index = 0; index < counts.size(); ++index) {
+        density[index] = static_cast<double>(counts[index]) / area;
+    }
+    return density;
+}
+
+std::vector<double> GridMeasurement::MeanSpeed() const
+{
+    std::vector<double> speed(counts.size(), std::numeric_limits<double>::quiet_NaN());
+    for(size_t index = 0; index < counts.size(); ++index) {
+        if(counts[index] > 0) {
+            speed[index] = speedSums[index] / static_cast<double>(counts[index]);
+        }
+    }
+    return speed;
+}
+
+size_t MeasurementSystem::AddGrid(const AABB& bounds, double cellSize, double interval, double time)
+{
+    if(!(bounds.xmin < bounds.xmax && bounds.ymin < bounds.ymax)) {
+        throw SimulationError("Measurement grid needs a non empty area");
+    }
+    if(!(cellSize > 0)) {
+        throw SimulationError("Cell size needs to be greater than 0, got {}", cellSize);
+    }
+    if(!(interval > 0)) {
+        throw SimulationError("Sampling interval needs to be greater than 0, got {}", interval);
+    }
+    const auto columns = static_cast<size_t>(std::ceil((bounds.xmax - bounds.xmin) / cellSize));
+    const auto rows = static_cast<size_t>(std::ceil((bounds.ymax - bounds.ymin) / cellSize));
+    AABB gridBounds{};
+    gridBounds.xmin = bounds.xmin;
+    gridBounds.ymin = bounds.ymin;
+    gridBounds.xmax = bounds.xmin + static_cast<double>(columns) * cellSize;
+    gridBounds.ymax = bounds.ymin + static_cast<double>(rows) * cellSize;
+    grids.push_back(GridMeasurement{
+        gridBounds,
+        cellSize,
+        columns,
+        rows,
+        interval,
+        time,
+        0,
+        std::vector<uint64_t>(columns * rows, 0),
+        std::vector<double>(columns * rows, 0.0)});
+    return grids.size() - 1;
+}
+
+size_t MeasurementSystem::AddLine(Point p1, Point p2)
+{
+    if(p1 == p2) {
+        throw SimulationError("Measurement line needs two distinct points");
+    }
+    lines.push_back(LineMeasurement{p1, p2});
+    return lines.size() - 1;
+}
+
+size_t MeasurementSystem::AddArea(const std::vector<Point>& polygon, double interval, double time)
+{
+    if(!(interval > 0)) {
+        throw SimulationError("Sampling interval needs to be greater than 0, got {}", interval);
+    }
+    Polygon poly{polygon};
+    std::optional<ConvexArea> convexArea{};
+    if(poly.IsConvex()) {
+        convexArea.emplace(poly);
+    }
+    const AABB bounds{polygon};
+    areas.push_back(
+        AreaMeasurement{std::move(poly), std::move(convexArea), bounds, interval, time});
+    return areas.size() - 1;
+}
+
+const GridMeasurement& MeasurementSystem::Grid(size_t id) const
+{
+    if(id >= grids.size()) {
+        throw SimulationError("Unknown grid measurement {}", id);
+    }
+    return grids[id];
+}
+
+const LineMeasurement& MeasurementSystem::Line(size_t id) const
+{
+    if(id >= lines.size()) {
+        throw SimulationError("Unknown line measurement {}", id);
+    }
+    return lines[id];
+}
+
+const AreaMeasurement& MeasurementSystem::Area(size_t id) const
+{
+    if(id >= areas.size()) {
+        throw SimulationError("Unknown area measurement {}", id);
+    }
+    return areas[id];
+}
+
+void MeasurementSystem::Prepare(const std::vector<GenericAgent>& agents)
+{
+    previous.resize(agents.size());
+    for(size_t index = 0; index < agents.size(); ++index) {
+        previous[index] = agents[index].pos;
+    }
+}
+
+void MeasurementSystem::Run(double time, double dT, const std::vector<GenericAgent>& agents)
+{
+    xs.resize(agents.size());
+    ys.resize(agents.size());
+    for(size_t index = 0; index < agents.size(); ++index) {
+        xs[index] = agents[index].pos.x;
+        ys[index] = agents[index].pos.y;
+    }
+
+    for(auto& grid : grids) {
+        if(time + timeTolerance >= grid.nextTime) {
+            sampleGrid(grid, dT);
+            while(time + timeTolerance >= grid.nextTime) {
+                grid.nextTime += grid.interval;
+            }
+        }
+    }
+    for(auto& line : lines) {
+        detectCrossings(line, time, dT, agents);
+    }
+    for(auto& area : areas) {
+        if(time + timeTolerance >= area.nextTime) {
+            sampleArea(area, time);
+            while(time + timeTolerance >= area.nextTime) {
+                area.nextTime += area.interval;
+            }
+        }
+    }
+}
+
+void MeasurementSystem::sampleGrid(GridMeasurement& grid, double dT)
+{
+    ++grid.samples;
+    const auto scale = 1.0 / grid.cellSize;
+    for(size_t index = 0; index < xs.size(); ++index) {
+        const auto column = std::floor((xs[index] - grid.bounds.xmin) * scale);
+        const auto row = std::floor((ys[index] - grid.bounds.ymin) * scale);
+        if(column < 0 || row < 0 || column >= static_cast<double>(grid.columns) ||
+           row >= static_cast<double>(grid.rows)) {
+            continue;
+        }
+        const auto cell = static_cast<size_t>(row) * grid.columns + static_cast<size_t>(column);
+        const auto displacement = Point{xs[index], ys[index]} - previous[index];
+        ++grid.counts[cell];
+        grid.speedSums[cell] += displacement.Norm() / dT;
+    }
+}
+
+void MeasurementSystem::sampleArea(AreaMeasurement& area, double time)
+{
+    uint64_t count = 0;
+    if(area.convexArea) {
+        inside.resize(xs.size());
+        area.convexArea->Contains(xs, ys, inside);
+        for(const auto value : inside) {
+            count += value;
+        }
+    } else {
+        for(size_t index = 0; index < xs.size(); ++index) {
+            const Point p{xs[index], ys[index]};
+            if(area.bounds.Inside(p) && area.polygon.IsInside(p)) {
+                ++count;
+            }
+        }
+    }
+    area.times.push_back(time);
+    area.counts.push_back(count);
+}
+
+void MeasurementSystem::detectCrossings(
+    LineMeasurement& line,
+    double time,
+    double dT,
+    const std::vector<GenericAgent>& agents) const
+{
+    const auto direction = line.p2 - line.p1;
+    const auto lengthSquared = direction.ScalarProduct(direction);
+    const auto firstNew = line.crossings.size();
+    for(size_t index = 0; index < agents.size(); ++index) {
+        const auto from = previous[index];
+        const Point to{xs[index], ys[index]};
+        // Points on the line count as left of it, so an agent stopping on the line crosses once.
+        const auto sideFrom = direction.CrossProduct(from - line.p1);
+        const auto sideTo = direction.CrossProduct(to - line.p1);
+        if((sideFrom >= 0) == (sideTo >= 0)) {
+            continue;
+        }
+        const auto fraction = sideFrom / (sideFrom - sideTo);
+        const auto crossing = from + (to - from) * fraction;
+        const auto along = direction.ScalarProduct(crossing - line.p1);
+        if(along < 0 || along > lengthSquared) {
+            continue;
+        }
+        const int8_t crossingDirection = sideTo >= 0 ? 1 : -1;
+        if(crossingDirection > 0) {
+            ++line.forward;
+        } else {
+            ++line.backward;
+        }
+        line.crossings.push_back(
+            LineCrossing{time - dT + fraction * dT, agents[index].id, crossingDirection});
+    }
+    std::sort(
+        std::begin(line.crossings) + static_cast<std::ptrdiff_t>(firstNew),
+        std::end(line.crossings),
+        [](const auto& a, const auto& b) { return a.time < b.time; });
+}
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "AABB.hpp"
+#include "ConvexArea.hpp"
+#include "GenericAgent.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/// Accumulates the number of agents and the sum of their speeds per cell of a regular grid. Each
+/// sample adds all agents inside the grid once.
+struct GridMeasurement {
+    AABB bounds;
+    double cellSize;
+    size_t columns;
+    size_t rows;
+    double interval;
+    double nextTime;
+    uint64_t samples{0};
+    /// Row major, the first cell starts at (xmin, ymin)
+    std::vector<uint64_t> counts{};
+    std::vector<double> speedSums{};
+
+    /// Mean number of agents per square meter in each cell over all samples
+    std::vector<double> Density() const;
+    /// Mean speed in each cell over all agents sampled in that cell, NaN for cells without agents
+    std::vector<double> MeanSpeed() const;
+};
+
+struct LineCrossing {
+    double time;
+    GenericAgent::ID agent;
+    /// 1 if the agent crossed from the right to the left side of the line from p1 to p2, -1
+    /// otherwise
+    int8_t direction;
+};
+
+/// Records every agent crossing the line segment from 'p1' to 'p2'.
+struct LineMeasurement {
+    Point p1;
+    Point p2;
+    uint64_t forward{0};
+    uint64_t backward{0};
+    /// Ordered by time
+    std::vector<LineCrossing> crossings{};
+};
+
+/// Counts the agents inside 'polygon' every 'interval' seconds.
+struct AreaMeasurement {
+    Polygon polygon;
+    /// Set if 'polygon' is convex
+    std::optional<ConvexArea> convexArea;
+    AABB bounds;
+    double interval;
+    double nextTime;
+    std::vector<double> times{};
+    std::vector<uint64_t> counts{};
+};
+
+/// Measures density, speed and flow while the simulation runs, so that common measurements do not
+/// require to write and post-process trajectories. Agent positions are captured before the
+/// operational model moves the agents and evaluated once all agents moved. Measurements are
+/// identified by their index in the order they were added, separately for each kind.
+class MeasurementSystem
+{
+    /// Compensates the accumulated rounding error of the elapsed time when comparing to scheduled
+    /// times.
+    static constexpr double timeTolerance = 1e-9;
+
+    std::vector<GridMeasurement> grids{};
+    std::vector<LineMeasurement> lines{};
+    std::vector<AreaMeasurement> areas{};
+    /// Positions before the operational model ran, indexed like the agents
+    std::vector<Point> previous{};
+    /// Positions after the operational model ran as separate columns
+    std::vector<double> xs{};
+    std::vector<double> ys{};
+    /// Scratch buffer for 'ConvexArea::Contains'
+    std::vector<uint8_t> inside{};
+
+public:
+    MeasurementSystem() = default;
+    ~MeasurementSystem() = default;
+    MeasurementSystem(const MeasurementSystem& other) = delete;
+    MeasurementSystem& operator=(const MeasurementSystem& other) = delete;
+    MeasurementSystem(MeasurementSystem&& other) = delete;
+    MeasurementSystem& operator=(MeasurementSystem&& other) = delete;
+
+    /// @param time of the first sample
+    size_t AddGrid(const AABB& bounds, double cellSize, double interval, double time);
+    size_t AddLine(Point p1, Point p2);
+    /// @param time of the first sample
+    size_t AddArea(const std::vector<Point>& polygon, double interval, double time);
+
+    const GridMeasurement& Grid(size_t id) const;
+    const LineMeasurement& Line(size_t id) const;
+    const AreaMeasurement& Area(size_t id) const;
+
+    bool Empty() const { return grids.empty() && lines.empty() && areas.empty(); }
+
+    /// Captures the agent positions before they are moved.
+    void Prepare(const std::vector<GenericAgent>& agents);
+
+    /// Evaluates all measurements, agents need to be in the same order as in 'Prepare'.
+    /// @param time after the agents moved
+    /// @param dT time the agents moved for
+    void Run(double time, double dT, const std::vector<GenericAgent>& agents);
+
+private:
+    void sampleGrid(GridMeasurement& grid, double dT);
+    void sampleArea(AreaMeasurement& area, double time);
+    void detectCrossings(
+        LineMeasurement& line,
+        double time,
+        double dT,
+        const std::vector<GenericAgent>& agents) const;
+};
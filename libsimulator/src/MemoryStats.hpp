@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+/// Current and peak heap usage of a single subsystem in bytes.
+struct MemoryUsage {
+    size_t bytes{};
+    size_t peakBytes{};
+
+    void Update(size_t current)
+    {
+        bytes = current;
+        peakBytes = std::max(peakBytes, current);
+    }
+};
+
+/// Heap usage of all simulation subsystems.
+/// 'collisionGeometry' and 'routingEngine' refer to the active geometry, 'geometryCache' contains
+/// all geometries (collision geometry and routing engine) that have been used before and are kept
+/// for a potential switch back.
+struct MemoryStats {
+    MemoryUsage agents{};
+    MemoryUsage neighborhoodSearch{};
+    MemoryUsage collisionGeometry{};
+    MemoryUsage routingEngine{};
+    MemoryUsage geometryCache{};
+    MemoryUsage total{};
+
+    void UpdateTotal()
+    {
+        total.Update(
+            agents.bytes + neighborhoodSearch.bytes + collisionGeometry.bytes +
+            routingEngine.bytes + geometryCache.bytes);
+    }
+};
+
+/// Estimates of the heap memory held by standard containers. The estimates assume node based
+/// containers allocate one node per element that holds the element plus the bookkeeping pointers
+/// of libstdc++/libc++. Allocator overhead is not accounted for.
+namespace jps::memory
+{
+template <typename T>
+size_t HeapBytes(const std::vector<T>& vec)
+{
+    return vec.capacity() * sizeof(T);
+}
+
+template <typename T>
+size_t HeapBytes(const std::vector<std::vector<T>>& vec)
+{
+    size_t bytes = vec.capacity() * sizeof(std::vector<T>);
+    for(const auto& inner : vec) {
+        bytes += HeapBytes(inner);
+    }
+    return bytes;
+}
+
+template <typename T>
+size_t HeapBytes(const std::set<T>& set)
+{
+    // Red-black tree node: color, parent, left, right
+    constexpr size_t nodeOverhead = 4 * sizeof(void*);
+    return set.size() * (sizeof(T) + nodeOverhead);
+}
+
+/// @param valueBytes callable returning the heap bytes owned by a mapped value
+template <typename Key, typename Value, typename Hash, typename ValueBytes>
+size_t HeapBytes(const std::unordered_map<Key, Value, Hash>& map, ValueBytes&& valueBytes)
+{
+    // Singly linked node with cached hash code
+    constexpr size_t nodeOverhead = 2 * sizeof(void*);
+    size_t bytes = map.bucket_count() * sizeof(void*) +
+                   map.size() * (sizeof(std::pair<const Key, Value>) + nodeOverhead);
+    for(const auto& [_, value] : map) {
+        bytes += valueBytes(value);
+    }
+    return bytes;
+}
+} // namespace jps::memory
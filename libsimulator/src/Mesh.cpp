@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "Mesh.hpp"
 
+#include "MemoryStats.hpp"
+
 #include <glm/geometric.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
@@ -19,6 +21,7 @@
 #include <queue>
 #include <sstream>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 Mesh::Mesh(const CDT& cdt)
@@ -82,11 +85,28 @@ Mesh::Mesh(const CDT& cdt)
     updateBoundingBoxes();
 };
 
+Mesh::Mesh(std::vector<glm::dvec2> vertices_, std::vector<Polygon> polygons_)
+    : vertices(std::move(vertices_)), polygons(std::move(polygons_))
+{
+    updateBoundingBoxes();
+}
+
 std::unique_ptr<Mesh> Mesh::Clone() const
 {
     return std::make_unique<Mesh>(*this);
 }
 
+size_t Mesh::MemoryFootprint() const
+{
+    using jps::memory::HeapBytes;
+    size_t bytes = HeapBytes(vertices) + HeapBytes(polygons) + HeapBytes(boundingBoxes) +
+                   HeapBytes(gridCellStart) + HeapBytes(gridPolygons);
+    for(const auto& polygon : polygons) {
+        bytes += HeapBytes(polygon.vertices) + HeapBytes(polygon.neighbors);
+    }
+    return bytes;
+}
+
 void Mesh::MergeGreedy()
 {
     mergeDeadEnds();
@@ -527,12 +547,87 @@ void Mesh::updateBoundingBoxes()
 
             return AABB{{xMin, yMin}, {xMax, yMax}};
         });
+    updatePolygonGrid();
+}
+
+void Mesh::updatePolygonGrid()
+{
+    gridCellStart.assign(1, 0);
+    gridPolygons.clear();
+    gridColumns = 0;
+    gridRows = 0;
+    if(boundingBoxes.empty()) {
+        return;
+    }
+    AABB bounds{};
+    double boxArea = 0;
+    for(const auto& box : boundingBoxes) {
+        bounds.xmin = std::min(bounds.xmin, box.xmin);
+        bounds.xmax = std::max(bounds.xmax, box.xmax);
+        bounds.ymin = std::min(bounds.ymin, box.ymin);
+        bounds.ymax = std::max(bounds.ymax, box.ymax);
+        boxArea += (box.xmax - box.xmin) * (box.ymax - box.ymin);
+    }
+    // Cells of the mean bounding box size keep the number of polygons per cell close to a
+    // constant, the cell count is limited to a few times the number of polygons in any case.
+    const auto width = bounds.xmax - bounds.xmin;
+    const auto height = bounds.ymax - bounds.ymin;
+    const auto polygonCount = static_cast<double>(boundingBoxes.size());
+    gridCellSize = std::max(
+        {std::sqrt(boxArea / polygonCount),
+         std::sqrt(width * height / (4 * polygonCount)),
+         std::max(width, height) / (4 * polygonCount),
+         std::numeric_limits<double>::min()});
+    gridOrigin = {bounds.xmin, bounds.ymin};
+    gridColumns = static_cast<size_t>(std::floor(width / gridCellSize)) + 1;
+    gridRows = static_cast<size_t>(std::floor(height / gridCellSize)) + 1;
+
+    const auto column = [this](double x) {
+        return std::min(
+            static_cast<size_t>(std::max((x - gridOrigin.x) / gridCellSize, 0.)), gridColumns - 1);
+    };
+    const auto row = [this](double y) {
+        return std::min(
+            static_cast<size_t>(std::max((y - gridOrigin.y) / gridCellSize, 0.)), gridRows - 1);
+    };
+    // Calls 'visit' with every cell overlapped by the bounding box of polygon 'index'
+    const auto forEachCell = [&](size_t index, auto&& visit) {
+        const auto& box = boundingBoxes[index];
+        for(auto y = row(box.ymin); y <= row(box.ymax); ++y) {
+            for(auto x = column(box.xmin); x <= column(box.xmax); ++x) {
+                visit(y * gridColumns + x);
+            }
+        }
+    };
+
+    gridCellStart.assign(gridColumns * gridRows + 1, 0);
+    for(size_t index = 0; index < boundingBoxes.size(); ++index) {
+        forEachCell(index, [this](size_t cell) { ++gridCellStart[cell + 1]; });
+    }
+    for(size_t cell = 1; cell < gridCellStart.size(); ++cell) {
+        gridCellStart[cell] += gridCellStart[cell - 1];
+    }
+    gridPolygons.resize(gridCellStart.back());
+    std::vector<uint32_t> fill(std::begin(gridCellStart), std::end(gridCellStart) - 1);
+    for(size_t index = 0; index < boundingBoxes.size(); ++index) {
+        forEachCell(index, [this, &fill, index](size_t cell) {
+            gridPolygons[fill[cell]++] = static_cast<uint32_t>(index);
+        });
+    }
 }
 
 size_t Mesh::FindContainingPolygon(const glm::dvec2& p) const
 {
-    for(size_t index = 0; index < polygons.size(); ++index) {
-        if(boundingBoxes[index].Inside({p.x, p.y}) && TriangleContains(index, p)) {
+    const auto x = std::floor((p.x - gridOrigin.x) / gridCellSize);
+    const auto y = std::floor((p.y - gridOrigin.y) / gridCellSize);
+    if(!(x >= 0 && y >= 0 && x < static_cast<double>(gridColumns) &&
+         y < static_cast<double>(gridRows))) {
+        return Polygon::InvalidIndex;
+    }
+    const auto cell = static_cast<size_t>(y) * gridColumns + static_cast<size_t>(x);
+    for(auto entry = gridCellStart[cell]; entry < gridCellStart[cell + 1]; ++entry) {
+        const auto index = gridPolygons[entry];
+        if(boundingBoxes[index].Inside({p.x, p.y}) && PolygonContains(index, p)) {
             return index;
         }
     }
@@ -540,6 +635,18 @@ size_t Mesh::FindContainingPolygon(const glm::dvec2& p) const
     return Polygon::InvalidIndex;
 }
 
+std::vector<size_t> Mesh::FindContainingPolygons(const std::vector<glm::dvec2>& points) const
+{
+    std::vector<size_t> result{};
+    result.reserve(points.size());
+    std::transform(
+        std::begin(points),
+        std::end(points),
+        std::back_inserter(result),
+        [this](const auto& p) { return FindContainingPolygon(p); });
+    return result;
+}
+
 glm::dvec2 Mesh::Vertex(size_t index) const
 {
     return vertices.at(index);
@@ -677,3 +784,16 @@ bool Mesh::TriangleContains(const size_t polygonIndex, glm::dvec2 p) const
     }
     return true;
 }
+
+bool Mesh::PolygonContains(const size_t polygonIndex, glm::dvec2 p) const
+{
+    const auto& indices = polygons[polygonIndex].vertices;
+    for(size_t index = 0; index < indices.size(); ++index) {
+        const auto a = vertices[indices[index]];
+        const auto b = vertices[indices[(index + 1) % indices.size()]];
+        if(cross2D(p - a, b - a) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
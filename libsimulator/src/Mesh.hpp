@@ -7,6 +7,7 @@
 
 #include <glm/vec2.hpp>
 
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <sstream>
@@ -31,9 +32,20 @@ private:
     /// All convex polygons in this Mesh in CCW orientation.
     std::vector<Polygon> polygons{};
     std::vector<AABB> boundingBoxes{};
+    /// Uniform grid over 'boundingBoxes' answering 'FindContainingPolygon', polygons whose
+    /// bounding box overlaps cell 'i' are gridPolygons[gridCellStart[i], gridCellStart[i + 1])
+    /// in ascending order.
+    glm::dvec2 gridOrigin{};
+    double gridCellSize{1};
+    size_t gridColumns{};
+    size_t gridRows{};
+    std::vector<uint32_t> gridCellStart{};
+    std::vector<uint32_t> gridPolygons{};
 
 public:
     explicit Mesh(const CDT& cdt);
+    /// Restores a mesh from its vertices and polygons, see 'GeometryCache'.
+    Mesh(std::vector<glm::dvec2> vertices, std::vector<Polygon> polygons);
     ~Mesh() override = default;
     Mesh(const Mesh& other) = default;
     Mesh& operator=(const Mesh& other) = default;
@@ -44,7 +56,11 @@ public:
     std::vector<glm::vec2> FVertices() const;
     std::vector<uint16_t> TriangleIndices() const;
     std::vector<uint16_t> SegmentIndices() const;
+    /// Returns the index of the polygon containing 'p', the lowest index if 'p' is on a shared
+    /// edge, or 'Polygon::InvalidIndex' if no polygon contains 'p'.
     size_t FindContainingPolygon(const glm::dvec2& p) const;
+    /// 'FindContainingPolygon' for each point of 'points'.
+    std::vector<size_t> FindContainingPolygons(const std::vector<glm::dvec2>& points) const;
     glm::dvec2 Vertex(size_t index) const;
     size_t CountVertices() const { return vertices.size(); }
     size_t CountPolygons() const { return polygons.size(); }
@@ -52,6 +68,11 @@ public:
     const Mesh::Polygon& Polygons(size_t index) const { return polygons.at(index); }
     const AABB& AxisAlignedBoundingBox(size_t index) const { return boundingBoxes.at(index); }
     bool TriangleContains(const size_t, glm::dvec2 p) const;
+    /// Like 'TriangleContains' for convex polygons with any number of vertices, e.g. after
+    /// 'MergeGreedy'.
+    bool PolygonContains(const size_t, glm::dvec2 p) const;
+    /// Estimated heap memory held by this mesh in bytes.
+    size_t MemoryFootprint() const;
 
 private:
     void mergeDeadEnds();
@@ -66,4 +87,5 @@ private:
     double polygonArea(const std::vector<size_t> indices) const;
     void trimEmptyPolygons();
     void updateBoundingBoxes();
+    void updatePolygonGrid();
 };
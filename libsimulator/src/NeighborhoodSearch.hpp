@@ -3,6 +3,7 @@
 
 #include "HashCombine.hpp"
 #include "IteratorPair.hpp"
+#include "MemoryStats.hpp"
 #include "Point.hpp"
 
 #include <algorithm>
@@ -134,4 +135,11 @@ public:
         }
         return result;
     }
+
+    /// Estimated heap memory held by the grid in bytes.
+    size_t MemoryFootprint() const
+    {
+        return jps::memory::HeapBytes(
+            _grid, [](const auto& values) { return jps::memory::HeapBytes(values); });
+    }
 };
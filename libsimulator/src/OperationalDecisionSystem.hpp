@@ -30,6 +30,9 @@ public:
 
     OperationalModelType ModelType() const { return _model->Type(); }
 
+    /// Copy of the model including the state of its random number generator
+    std::unique_ptr<OperationalModel> CloneModel() const { return _model->Clone(); }
+
     void
     Run(double dT,
         double /*t_in_sec*/,
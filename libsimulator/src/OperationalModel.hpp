@@ -8,6 +8,8 @@
 #include "Point.hpp"
 #include "SimulationError.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <optional>
 
 template <typename T>
@@ -73,6 +75,17 @@ void validateConstraint(
     }
 }
 
+/// Wall forces below this value are neglected when collecting the walls an agent interacts with
+constexpr double WALL_FORCE_TOLERANCE = 1e-6;
+
+/// Distance beyond which a wall force 'strength * exp((radius - distance) / range)' is below
+/// 'WALL_FORCE_TOLERANCE'.
+inline double ExponentialWallInteractionRange(double strength, double range, double radius)
+{
+    return radius +
+           range * std::log(std::max(strength, WALL_FORCE_TOLERANCE) / WALL_FORCE_TOLERANCE);
+}
+
 class OperationalModel : public Clonable<OperationalModel>
 {
 public:
@@ -91,4 +104,7 @@ public:
         const GenericAgent& agent,
         const NeighborhoodSearch<GenericAgent>& neighborhoodSearch,
         const CollisionGeometry& geometry) const = 0;
+    /// Restarts the random number generator of stochastic models from 'seed'. Deterministic models
+    /// ignore this.
+    virtual void Seed(uint64_t /*seed*/) {}
 };
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jps
+{
+/// Number of threads used when 0 threads are requested.
+inline size_t DefaultThreadCount()
+{
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/// Calls 'task(index)' for each index in [0, count) on 'threadCount' threads, the calling thread
+/// is one of them. Each thread starts on an equal share of the indices. Threads that run out of
+/// work steal the upper half of the largest remaining share, so uneven task durations still keep
+/// all threads busy.
+///
+/// If tasks throw, all remaining tasks are still executed and the first exception is rethrown
+/// after all threads finished.
+/// @param count number of tasks
+/// @param threadCount number of threads to use, 0 uses 'DefaultThreadCount'
+/// @param task callable taking the index of the task, called concurrently
+template <typename Task>
+void ParallelFor(size_t count, size_t threadCount, Task&& task)
+{
+    if(threadCount == 0) {
+        threadCount = DefaultThreadCount();
+    }
+    threadCount = std::min(threadCount, count);
+    if(threadCount <= 1) {
+        for(size_t index = 0; index < count; ++index) {
+            task(index);
+        }
+        return;
+    }
+
+    struct Share {
+        std::mutex mutex{};
+        size_t begin{};
+        size_t end{};
+    };
+    std::vector<Share> shares(threadCount);
+    for(size_t index = 0; index < threadCount; ++index) {
+        shares[index].begin = count * index / threadCount;
+        shares[index].end = count * (index + 1) / threadCount;
+    }
+
+    std::mutex exceptionMutex{};
+    std::exception_ptr firstException{};
+
+    const auto takeOwn = [&shares](size_t worker, size_t& index) {
+        auto& own = shares[worker];
+        std::scoped_lock lock(own.mutex);
+        if(own.begin == own.end) {
+            return false;
+        }
+        index = own.begin++;
+        return true;
+    };
+
+    const auto steal = [&shares](size_t worker) {
+        size_t begin{};
+        size_t end{};
+        for(size_t attempt = 1; attempt < shares.size() && begin == end; ++attempt) {
+            // Pick the largest share, sizes may change while searching which only affects
+            // the quality of the choice.
+            size_t victim = worker;
+            size_t largest = 0;
+            for(size_t index = 0; index < shares.size(); ++index) {
+                if(index == worker) {
+                    continue;
+                }
+                std::scoped_lock lock(shares[index].mutex);
+                const auto remaining = shares[index].end - shares[index].begin;
+                if(remaining > largest) {
+                    largest = remaining;
+                    victim = index;
+                }
+            }
+            if(victim == worker) {
+                return false;
+            }
+            std::scoped_lock lock(shares[victim].mutex);
+            auto& share = shares[victim];
+            const auto remaining = share.end - share.begin;
+            if(remaining == 0) {
+                continue;
+            }
+            begin = share.end - (remaining + 1) / 2;
+            end = share.end;
+            share.end = begin;
+        }
+        if(begin == end) {
+            return false;
+        }
+        std::scoped_lock lock(shares[worker].mutex);
+        shares[worker].begin = begin;
+        shares[worker].end = end;
+        return true;
+    };
+
+    const auto work = [&](size_t worker) {
+        do {
+            size_t index{};
+            while(takeOwn(worker, index)) {
+                try {
+                    task(index);
+                } catch(...) {
+                    std::scoped_lock lock(exceptionMutex);
+                    if(!firstException) {
+                        firstException = std::current_exception();
+                    }
+                }
+            }
+        } while(steal(worker));
+    };
+
+    std::vector<std::thread> threads{};
+    threads.reserve(threadCount - 1);
+    for(size_t worker = 1; worker < threadCount; ++worker) {
+        threads.emplace_back(work, worker);
+    }
+    work(0);
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    if(firstException) {
+        std::rethrow_exception(firstException);
+    }
+}
+} // namespace jps
@@ -0,0 +1,345 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "PolyanyaSearch.hpp"
+
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+constexpr size_t noIndex = Mesh::InvalidIndex;
+/// Relative tolerance of side tests and absolute tolerance of comparing path lengths
+constexpr double epsilon = 1e-9;
+
+struct SearchNode {
+    /// Node this one was generated from, 'noIndex' for the initial nodes
+    size_t parent;
+    Point root;
+    /// Mesh vertex at 'root', 'noIndex' for the start point
+    size_t rootVertex;
+    /// Interval on the edge from 'rightVertex' to 'leftVertex' as seen from 'root'. For nodes
+    /// reaching the target both are the last turning point before the target.
+    Point left;
+    Point right;
+    size_t leftVertex;
+    size_t rightVertex;
+    /// Polygon behind the interval, 'noIndex' for nodes reaching the target
+    size_t polygon;
+    /// Length of the path up to 'root', or up to the target for nodes reaching it
+    double g;
+    double f;
+};
+
+struct QueueEntry {
+    double f;
+    double g;
+    size_t node;
+
+    /// Orders 'std::priority_queue' by ascending f, preferring longer paths on ties
+    bool operator<(const QueueEntry& other) const
+    {
+        return f > other.f || (f == other.f && g < other.g);
+    }
+};
+
+/// Buffers of a search, kept per thread so repeated queries do not allocate once they grew large
+/// enough
+struct Workspace {
+    std::vector<SearchNode> nodes{};
+    /// Heap ordered by 'QueueEntry::operator<'
+    std::vector<QueueEntry> open{};
+    /// Length of the shortest path to each root vertex found so far
+    std::unordered_map<size_t, double> rootG{};
+};
+
+Workspace& threadWorkspace()
+{
+    thread_local Workspace workspace{};
+    workspace.nodes.clear();
+    workspace.open.clear();
+    workspace.rootG.clear();
+    return workspace;
+}
+
+/// Returns the range of t in [0, 1] where the linear function with 'v0' at 0 and 'v1' at 1 is >= 0.
+/// The range is empty if first > second.
+std::pair<double, double> nonNegativeRange(double v0, double v1)
+{
+    if(v0 >= 0 && v1 >= 0) {
+        return {0., 1.};
+    }
+    if(v0 < 0 && v1 < 0) {
+        return {1., 0.};
+    }
+    const auto t = v0 / (v0 - v1);
+    return v0 >= 0 ? std::pair{0., t} : std::pair{t, 1.};
+}
+
+/// Lower bound of the length of paths from 'root' through the interval ['right', 'left'] to
+/// 'target', exact unless 'root' and 'target' are both on the line through the interval.
+double heuristic(Point root, Point left, Point right, Point target)
+{
+    const auto edge = left - right;
+    const auto lengthSquared = edge.NormSquare();
+    if(lengthSquared == 0) {
+        return Distance(root, right) + Distance(right, target);
+    }
+    const auto rootSide = edge.CrossProduct(root - right);
+    auto targetSide = edge.CrossProduct(target - right);
+    auto mirrored = target;
+    if(rootSide * targetSide > 0) {
+        // Paths through the interval to a target on the side of 'root' have the length of paths
+        // to the target mirrored at the interval
+        const auto foot = right + edge * ((target - right).ScalarProduct(edge) / lengthSquared);
+        mirrored = foot * 2 - target;
+        targetSide = -targetSide;
+    }
+    if(rootSide == targetSide) {
+        return Distance(root, target);
+    }
+    const auto crossing = root + (mirrored - root) * (rootSide / (rootSide - targetSide));
+    const auto s = (crossing - right).ScalarProduct(edge) / lengthSquared;
+    if(s >= 0 && s <= 1) {
+        return Distance(root, mirrored);
+    }
+    return std::min(
+        Distance(root, right) + Distance(right, target),
+        Distance(root, left) + Distance(left, target));
+}
+} // namespace
+
+PolyanyaSearch::PolyanyaSearch(Mesh mesh_)
+    : mesh(std::move(mesh_)), corners(mesh.CountVertices(), false)
+{
+    for(size_t index = 0; index < mesh.CountPolygons(); ++index) {
+        const auto& polygon = mesh.Polygons(index);
+        const auto count = polygon.vertices.size();
+        for(size_t edge = 0; edge < count; ++edge) {
+            if(polygon.neighbors[edge] == noIndex) {
+                corners[polygon.vertices[edge]] = true;
+                corners[polygon.vertices[(edge + 1) % count]] = true;
+            }
+        }
+    }
+}
+
+std::vector<Point> PolyanyaSearch::ComputeAllWaypoints(Point from, Point to) const
+{
+    const auto locate = [this](Point p) {
+        const auto polygon = mesh.FindContainingPolygon({p.x, p.y});
+        if(polygon == noIndex) {
+            throw SimulationError("Point ({}, {}) is outside of accessible area", p.x, p.y);
+        }
+        return polygon;
+    };
+    const auto fromPolygon = locate(from);
+    const auto toPolygon = locate(to);
+    if(fromPolygon == toPolygon) {
+        return {from, to};
+    }
+    const auto vertex = [this](size_t index) {
+        const auto v = mesh.Vertex(index);
+        return Point{v.x, v.y};
+    };
+
+    auto& workspace = threadWorkspace();
+    auto& nodes = workspace.nodes;
+    auto& open = workspace.open;
+    // Paths longer than the shortest found so far to their root vertex are pruned
+    auto& rootG = workspace.rootG;
+    const auto push = [&nodes, &open, to](SearchNode node) {
+        node.f = node.g;
+        if(node.polygon != noIndex) {
+            node.f += heuristic(node.root, node.left, node.right, to);
+        }
+        nodes.push_back(node);
+        open.push_back({node.f, node.g, nodes.size() - 1});
+        std::push_heap(std::begin(open), std::end(open));
+    };
+
+    const auto& start = mesh.Polygons(fromPolygon);
+    for(size_t edge = 0; edge < start.vertices.size(); ++edge) {
+        const auto neighbor = start.neighbors[edge];
+        if(neighbor == noIndex) {
+            continue;
+        }
+        const auto rightVertex = start.vertices[edge];
+        const auto leftVertex = start.vertices[(edge + 1) % start.vertices.size()];
+        push(
+            {noIndex,
+             from,
+             noIndex,
+             vertex(leftVertex),
+             vertex(rightVertex),
+             leftVertex,
+             rightVertex,
+             neighbor,
+             0.,
+             0.});
+    }
+
+    while(!open.empty()) {
+        std::pop_heap(std::begin(open), std::end(open));
+        const auto index = open.back().node;
+        open.pop_back();
+        // Copy, 'nodes' grows while expanding
+        const auto node = nodes[index];
+        if(node.polygon == noIndex) {
+            std::vector<Point> path{to};
+            if(node.left != to) {
+                path.push_back(node.left);
+            }
+            for(auto parent = node.parent; parent != noIndex; parent = nodes[parent].parent) {
+                if(nodes[parent].root != path.back()) {
+                    path.push_back(nodes[parent].root);
+                }
+            }
+            std::reverse(std::begin(path), std::end(path));
+            return path;
+        }
+        if(node.rootVertex != noIndex && node.g > rootG.at(node.rootVertex) + epsilon) {
+            continue;
+        }
+
+        const auto& polygon = mesh.Polygons(node.polygon);
+        const auto count = polygon.vertices.size();
+        size_t entry = 0;
+        while(entry < count && (polygon.vertices[entry] != node.leftVertex ||
+                                polygon.vertices[(entry + 1) % count] != node.rightVertex)) {
+            ++entry;
+        }
+        if(entry == count) {
+            throw SimulationError("Internal Error");
+        }
+
+        // Points p are visible from the root through the interval if
+        // toRight x (p - root) >= 0 and toLeft x (p - root) <= 0
+        const auto toRight = node.right - node.root;
+        const auto toLeft = node.left - node.root;
+        const auto rightScale = toRight.Norm();
+        const auto leftScale = toLeft.Norm();
+
+        if(node.polygon == toPolygon) {
+            const auto toTarget = to - node.root;
+            const auto targetScale = toTarget.Norm();
+            auto via = to;
+            if(toRight.CrossProduct(toTarget) < -epsilon * rightScale * targetScale) {
+                via = node.right;
+            } else if(toLeft.CrossProduct(toTarget) > epsilon * leftScale * targetScale) {
+                via = node.left;
+            }
+            const auto length = node.g + Distance(node.root, via) + Distance(via, to);
+            push({index, to, noIndex, via, via, noIndex, noIndex, noIndex, length, length});
+        }
+
+        // Parts of the polygon not visible from the root are reached by turning at the ends of
+        // the interval, this shortens paths only at vertices touching the boundary
+        const bool turnRight = node.right != node.root && node.rightVertex != noIndex &&
+                               node.right == vertex(node.rightVertex) &&
+                               corners[node.rightVertex];
+        const bool turnLeft = node.left != node.root && node.leftVertex != noIndex &&
+                              node.left == vertex(node.leftVertex) && corners[node.leftVertex];
+        const auto pushTurn = [&](Point root,
+                                  size_t rootVertex,
+                                  Point left,
+                                  Point right,
+                                  size_t leftVertex,
+                                  size_t rightVertex,
+                                  size_t next) {
+            const auto g = node.g + Distance(node.root, root);
+            auto& best = rootG.try_emplace(rootVertex, std::numeric_limits<double>::infinity())
+                             .first->second;
+            if(g > best + epsilon) {
+                return;
+            }
+            best = std::min(best, g);
+            push({index, root, rootVertex, left, right, leftVertex, rightVertex, next, g, 0.});
+        };
+
+        for(size_t offset = 1; offset < count; ++offset) {
+            const auto edge = (entry + offset) % count;
+            const auto neighbor = polygon.neighbors[edge];
+            if(neighbor == noIndex) {
+                continue;
+            }
+            const auto pVertex = polygon.vertices[edge];
+            const auto qVertex = polygon.vertices[(edge + 1) % count];
+            const auto p = vertex(pVertex);
+            const auto q = vertex(qVertex);
+            const auto pointAt = [p, q](double t) {
+                if(t <= 0) {
+                    return p;
+                }
+                if(t >= 1) {
+                    return q;
+                }
+                return p + (q - p) * t;
+            };
+            const auto toP = p - node.root;
+            const auto toQ = q - node.root;
+            const auto snap = [](double value, double scale) {
+                return std::abs(value) <= epsilon * scale ? 0. : value;
+            };
+            const auto rightP = snap(toRight.CrossProduct(toP), rightScale * toP.Norm());
+            const auto rightQ = snap(toRight.CrossProduct(toQ), rightScale * toQ.Norm());
+            const auto leftP = snap(-toLeft.CrossProduct(toP), leftScale * toP.Norm());
+            const auto leftQ = snap(-toLeft.CrossProduct(toQ), leftScale * toQ.Norm());
+
+            // Seen from the root, p is on the right and q on the left of the edge
+            const auto [rightBegin, rightEnd] = nonNegativeRange(rightP, rightQ);
+            const auto [leftBegin, leftEnd] = nonNegativeRange(leftP, leftQ);
+            const auto begin = std::max(rightBegin, leftBegin);
+            const auto end = std::min(rightEnd, leftEnd);
+            if(begin <= end) {
+                push(
+                    {index,
+                     node.root,
+                     node.rootVertex,
+                     pointAt(end),
+                     pointAt(begin),
+                     qVertex,
+                     pVertex,
+                     neighbor,
+                     node.g,
+                     0.});
+            }
+            if(turnRight) {
+                const auto [turnBegin, turnEnd] = nonNegativeRange(-rightP, -rightQ);
+                if(turnBegin <= turnEnd) {
+                    pushTurn(
+                        node.right,
+                        node.rightVertex,
+                        pointAt(turnEnd),
+                        pointAt(turnBegin),
+                        qVertex,
+                        pVertex,
+                        neighbor);
+                }
+            }
+            if(turnLeft) {
+                const auto [turnBegin, turnEnd] = nonNegativeRange(-leftP, -leftQ);
+                if(turnBegin <= turnEnd) {
+                    pushTurn(
+                        node.left,
+                        node.leftVertex,
+                        pointAt(turnEnd),
+                        pointAt(turnBegin),
+                        qVertex,
+                        pVertex,
+                        neighbor);
+                }
+            }
+        }
+    }
+    throw SimulationError(
+        "No path from ({}, {}) to ({}, {}) in the navigation mesh", from.x, from.y, to.x, to.y);
+}
+
+size_t PolyanyaSearch::MemoryFootprint() const
+{
+    return mesh.MemoryFootprint() + corners.capacity() / 8;
+}
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Mesh.hpp"
+#include "Point.hpp"
+
+#include <vector>
+
+/// Optimal any-angle shortest path search on a mesh of convex polygons, see Cui, Harabor, Grastien:
+/// "Compromise-free Pathfinding on a Navigation Mesh" (IJCAI 2017).
+/// Search nodes are intervals on polygon edges together with the last turning point (root) of the
+/// paths reaching them. Paths are taut by construction, no funnel straightening is needed.
+class PolyanyaSearch
+{
+    Mesh mesh;
+    /// Vertices touching the boundary of the mesh, only these can be turning points of paths
+    std::vector<bool> corners{};
+
+public:
+    /// @param mesh convex polygons to search, e.g. after 'Mesh::MergeGreedy'
+    explicit PolyanyaSearch(Mesh mesh);
+
+    /// Returns the shortest path from 'from' to 'to' including both.
+    /// Throws 'SimulationError' if either point is outside of the mesh.
+    std::vector<Point> ComputeAllWaypoints(Point from, Point to) const;
+
+    const Mesh& MeshData() const { return mesh; }
+
+    /// Estimated heap memory held by the search in bytes.
+    size_t MemoryFootprint() const;
+};
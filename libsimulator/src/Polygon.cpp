@@ -6,6 +6,8 @@
 #include <CGAL/enum.h>
 #include <CGAL/number_utils.h>
 
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
 #include <vector>
 
@@ -63,3 +65,14 @@ std::tuple<Point, double> Polygon::ContainingCircle() const
     });
     return {center, distance};
 }
+
+std::vector<Point> Polygon::Points() const
+{
+    std::vector<Point> points{};
+    points.reserve(_polygon.size());
+    std::transform(
+        std::begin(_polygon), std::end(_polygon), std::back_inserter(points), [](const auto& p) {
+            return Point(CGAL::to_double(p.x()), CGAL::to_double(p.y()));
+        });
+    return points;
+}
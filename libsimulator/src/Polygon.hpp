@@ -3,6 +3,9 @@
 
 #include "CfgCgal.hpp"
 #include "Point.hpp"
+
+#include <vector>
+
 class Polygon
 {
     using PolygonType = Poly;
@@ -20,6 +23,8 @@ public:
     bool IsInside(Point p) const;
     Point Centroid() const;
     std::tuple<Point, double> ContainingCircle() const;
+    /// Vertices in CCW order
+    std::vector<Point> Points() const;
 
     operator PolygonType() const { return _polygon; }
 };
@@ -7,6 +7,7 @@
 #include "IteratorPair.hpp"
 #include "LineSegment.hpp"
 #include "Mesh.hpp"
+#include "ParallelFor.hpp"
 #include "SimulationError.hpp"
 
 #include <CGAL/Distance_3/Ray_3_Line_3.h>
@@ -27,6 +28,7 @@
 #include <memory>
 #include <queue>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -36,7 +38,7 @@ RoutingEngine::RoutingEngine()
 {
 }
 
-RoutingEngine::RoutingEngine(const PolyWithHoles& poly)
+RoutingEngine::RoutingEngine(const PolyWithHoles& poly, double regionSize)
 {
     cdt.insert_constraint(
         poly.outer_boundary().vertices_begin(), poly.outer_boundary().vertices_end(), true);
@@ -45,6 +47,17 @@ RoutingEngine::RoutingEngine(const PolyWithHoles& poly)
     }
     CGAL::mark_domain_in_triangulation(cdt);
     mesh = std::make_unique<Mesh>(cdt);
+    if(regionSize > 0) {
+        hierarchy = std::make_shared<const RoutingHierarchy>(*mesh, regionSize);
+    }
+}
+
+RoutingEngine::RoutingEngine(
+    CDT&& triangulation,
+    std::unique_ptr<Mesh> mesh_,
+    std::unique_ptr<const RoutingHierarchy> hierarchy_)
+    : cdt(std::move(triangulation)), mesh(std::move(mesh_)), hierarchy(std::move(hierarchy_))
+{
 }
 
 std::unique_ptr<RoutingEngine> RoutingEngine::Clone() const
@@ -52,51 +65,118 @@ std::unique_ptr<RoutingEngine> RoutingEngine::Clone() const
     auto clone = std::make_unique<RoutingEngine>();
     clone->cdt = cdt;
     clone->mesh = mesh->Clone();
+    clone->hierarchy = hierarchy;
     return clone;
 }
 
-Point RoutingEngine::ComputeWaypoint(Point currentPosition, Point destination)
+Point RoutingEngine::ComputeWaypoint(
+    Point currentPosition,
+    Point destination,
+    RoutingAlgorithm algorithm) const
+{
+    return ComputeAllWaypoints(currentPosition, destination, algorithm)[1];
+}
+
+std::vector<Point> RoutingEngine::ComputeAllWaypoints(
+    Point currentPosition,
+    Point destination,
+    RoutingAlgorithm algorithm) const
+{
+    switch(algorithm) {
+        case RoutingAlgorithm::TriangleAStar:
+            return computeTriangleAStar(currentPosition, destination);
+        case RoutingAlgorithm::Polyanya:
+            return polyanyaSearch().ComputeAllWaypoints(currentPosition, destination);
+        case RoutingAlgorithm::Hierarchical:
+            if(!hierarchy) {
+                return computeTriangleAStar(currentPosition, destination);
+            }
+            return hierarchy->ComputeAllWaypoints(*mesh, currentPosition, destination);
+    }
+    throw SimulationError("Unknown routing algorithm");
+}
+
+void RoutingEngine::ComputeAllWaypointsBatch(
+    std::span<const Point> from,
+    std::span<const Point> to,
+    const PathConsumer& consumer,
+    RoutingAlgorithm algorithm,
+    size_t threadCount) const
+{
+    if(from.size() != to.size()) {
+        throw SimulationError(
+            "Number of start points ({}) and target points ({}) differ", from.size(), to.size());
+    }
+    jps::ParallelFor(from.size(), threadCount, [&](size_t index) {
+        std::vector<Point> path{};
+        try {
+            path = ComputeAllWaypoints(from[index], to[index], algorithm);
+        } catch(const SimulationError&) {
+            path.clear();
+        }
+        consumer(index, path);
+    });
+}
+
+const PolyanyaSearch& RoutingEngine::polyanyaSearch() const
 {
-    return ComputeAllWaypoints(currentPosition, destination)[1];
+    std::call_once(polyanya->built, [this]() {
+        auto merged = mesh->Clone();
+        merged->MergeGreedy();
+        polyanya->search = std::make_unique<const PolyanyaSearch>(std::move(*merged));
+    });
+    return *polyanya->search;
 }
 
 struct SearchState {
     double g_value{};
     double h_value{};
     CDT::Face_handle id{};
-    SearchState* parent{};
+    /// Index of the parent state in 'TriangleAStarWorkspace::states', 'noParent' for the start
+    size_t parent{};
+
+    static constexpr size_t noParent = std::numeric_limits<size_t>::max();
 
     double f_value() const { return g_value + h_value; }
-    bool parents_contain(CDT::Face_handle ancestor_id) const
+};
+
+/// Buffers of a triangle A* search, kept per thread so repeated queries, e.g. from
+/// 'RoutingEngine::ComputeAllWaypointsBatch', do not allocate once they grew large enough
+struct TriangleAStarWorkspace {
+    /// States are never removed during a search, parents refer to them by index
+    std::vector<SearchState> states{};
+    std::vector<size_t> open_states{};
+    std::map<CDT::Face_handle, size_t> closed_states{};
+
+    bool parents_contain(size_t state, CDT::Face_handle ancestor_id) const
     {
-        const SearchState* pivot = this;
-        while(pivot != nullptr) {
-            if(pivot->id == ancestor_id) {
+        for(auto pivot = state; pivot != SearchState::noParent; pivot = states[pivot].parent) {
+            if(states[pivot].id == ancestor_id) {
                 return true;
             }
-            pivot = pivot->parent;
         }
         return false;
     }
-    std::vector<CDT::Face_handle> path() const
+
+    std::vector<CDT::Face_handle> path(size_t state) const
     {
         std::vector<CDT::Face_handle> p{};
         p.reserve(16);
-        const SearchState* pivot = this;
-        while(pivot != nullptr) {
-            p.emplace_back(pivot->id);
-            pivot = pivot->parent;
+        for(auto pivot = state; pivot != SearchState::noParent; pivot = states[pivot].parent) {
+            p.emplace_back(states[pivot].id);
         }
         std::reverse(std::begin(p), std::end(p));
         return p;
     }
 };
 
-bool CompareSearchStatesGt(
-    const std::shared_ptr<SearchState>& a,
-    const std::shared_ptr<SearchState>& b)
+TriangleAStarWorkspace& triangleAStarWorkspace()
 {
-    return a->f_value() > b->f_value();
+    thread_local TriangleAStarWorkspace workspace{};
+    workspace.states.clear();
+    workspace.open_states.clear();
+    workspace.closed_states.clear();
+    return workspace;
 }
 
 double length_of_path(const std::vector<Point>& path)
@@ -108,7 +188,8 @@ double length_of_path(const std::vector<Point>& path)
     return segment_sum;
 }
 
-std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Point destination)
+std::vector<Point>
+RoutingEngine::computeTriangleAStar(Point currentPosition, Point destination) const
 {
     const auto from_pos = CDT::Point{currentPosition.x, currentPosition.y};
     const auto to_pos = CDT::Point{destination.x, destination.y};
@@ -119,28 +200,32 @@ std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Poi
         return std::vector<Point>{currentPosition, destination};
     }
 
-    using SearchStatePtr = std::shared_ptr<SearchState>;
-
-    std::vector<SearchStatePtr> open_states{};
-    open_states.emplace_back(
-        new SearchState{0.0, Distance(currentPosition, destination), from, nullptr});
+    auto& workspace = triangleAStarWorkspace();
+    auto& states = workspace.states;
+    auto& open_states = workspace.open_states;
+    auto& closed_states = workspace.closed_states;
+    const auto compare_states_gt = [&states](size_t a, size_t b) {
+        return states[a].f_value() > states[b].f_value();
+    };
 
-    std::map<CDT::Face_handle, SearchStatePtr> closed_states{};
+    states.push_back(
+        SearchState{0.0, Distance(currentPosition, destination), from, SearchState::noParent});
+    open_states.push_back(0);
 
     std::vector<Point> path{};
     double path_length = std::numeric_limits<double>::infinity();
 
     while(!open_states.empty()) {
-        std::make_heap(std::rbegin(open_states), std::rend(open_states), CompareSearchStatesGt);
-        auto current_state = open_states.back();
+        std::make_heap(std::rbegin(open_states), std::rend(open_states), compare_states_gt);
+        const auto current = open_states.back();
         open_states.pop_back();
-        closed_states.insert(std::make_pair(current_state->id, current_state));
+        closed_states.insert(std::make_pair(states[current].id, current));
 
-        if(current_state->id == to) {
+        if(states[current].id == to) {
             // Unlike in A* this is only a first candidate solution
             // Now compute the actual path length via funnel algorithm
             // store path and length if this variant is the shortest found so far
-            const auto vertex_ids = current_state->path();
+            const auto vertex_ids = workspace.path(current);
             const auto found_path = straightenPath(currentPosition, destination, vertex_ids);
             const double found_path_length = length_of_path(found_path);
             if(found_path_length < path_length) {
@@ -149,7 +234,7 @@ std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Poi
             }
         }
 
-        if(current_state->f_value() >= path_length) {
+        if(states[current].f_value() >= path_length) {
             // This search nodes f-value already excedes our paths length, and since the f-value is
             // underestimation of the path length the excat path cannot be shorter than what we have
             return path;
@@ -157,13 +242,13 @@ std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Poi
 
         // Generate successors
         for(int idx = 0; idx < 3; ++idx) {
-            const auto target = current_state->id->neighbor(idx);
+            const auto target = states[current].id->neighbor(idx);
             if(!target->get_in_domain()) {
                 // Not a neighboring triangle.
                 continue;
             }
             // Do not add search nodes for nodes already in the ancestor list of this path
-            if(current_state->parents_contain(target)) {
+            if(workspace.parents_contain(current, target)) {
                 continue;
             }
 
@@ -171,7 +256,6 @@ std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Poi
             if(closed_states.contains(target)) {
                 continue;
             }
-
             const auto edge = cdt.segment(target, idx);
 
             // For all remaining nodes compute g/h values
@@ -196,13 +280,13 @@ std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Poi
             // by these edges. Thus, if the entry edges of the triangles corresponding to s′ and
             // s form an angle θ, this estimate is calculated as g(s) + rθ. NOTE: Right now this
             // is always g(s) + zero as we asume point size agents (for now)
-            const double g_value_2 = current_state->g_value + 0;
+            const double g_value_2 = states[current].g_value + 0;
 
             //  Another lower bound value for g(s′) is g(s)+(h(s)−h(s′)), or the parent state’s
             //  g-value plus the difference between its h-value and that of the child state.
             //  This is an underes- timate because the Euclidean distance metric used for the
             //  heuristic is consistent.
-            const double g_value_3 = current_state->g_value + current_state->h_value - h_value;
+            const double g_value_3 = states[current].g_value + states[current].h_value - h_value;
 
             const double g_value = std::max(g_value_1, std::max(g_value_2, g_value_3));
 
@@ -217,23 +301,23 @@ std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Poi
             if(auto iter = std::find_if(
                    std::begin(open_states),
                    std::end(open_states),
-                   [t2](const auto& s) { return s->id == t2; });
+                   [t2, &states](size_t s) { return states[s].id == t2; });
                iter != std::end(open_states)) {
-                if(auto& s = *iter; s->g_value > g_value) {
-                    s->g_value = g_value;
-                    s->parent = current_state.get();
+                if(auto& s = states[*iter]; s.g_value > g_value) {
+                    s.g_value = g_value;
+                    s.parent = current;
                 }
 
             } else if(auto iter = closed_states.find(target); iter != std::end(closed_states)) {
-                if(auto& [_, s] = *iter; s->g_value > g_value) {
-                    s->g_value = g_value;
-                    s->parent = current_state.get();
-                    open_states.push_back(s);
-                    closed_states.erase(s->id);
+                if(auto& s = states[iter->second]; s.g_value > g_value) {
+                    s.g_value = g_value;
+                    s.parent = current;
+                    open_states.push_back(iter->second);
+                    closed_states.erase(iter);
                 }
             } else {
-                open_states.emplace_back(
-                    new SearchState{g_value, h_value, target, current_state.get()});
+                states.push_back(SearchState{g_value, h_value, target, current});
+                open_states.push_back(states.size() - 1);
             }
         }
     }
@@ -255,6 +339,17 @@ void RoutingEngine::Update()
 {
 }
 
+size_t RoutingEngine::MemoryFootprint() const
+{
+    // The triangulation data structure stores vertices and faces (including the infinite ones)
+    // in compact containers, constraints are stored as flags inside the faces.
+    const auto& tds = cdt.tds();
+    const size_t cdtBytes = tds.number_of_vertices() * sizeof(CDT::Vertex) +
+                            tds.number_of_faces() * sizeof(CDT::Face);
+    return cdtBytes + (mesh ? sizeof(Mesh) + mesh->MemoryFootprint() : 0) +
+           (hierarchy ? sizeof(RoutingHierarchy) + hierarchy->MemoryFootprint() : 0);
+}
+
 CDT::Face_handle RoutingEngine::find_face(K::Point_2 p) const
 {
     const auto face = cdt.locate(p);
@@ -268,7 +363,10 @@ CDT::Face_handle RoutingEngine::find_face(K::Point_2 p) const
 }
 
 std::vector<Point>
-RoutingEngine::straightenPath(Point from, Point to, const std::vector<CDT::Face_handle>& path)
+RoutingEngine::straightenPath(
+    Point from,
+    Point to,
+    const std::vector<CDT::Face_handle>& path) const
 {
     // TODO(kkratz): Remove the 0.2m edge width adjustment and replace this with p[roper
     // arc-paths from the "Efficient Triangulation-Based Pathfinding" publication
@@ -9,21 +9,58 @@
 #include "LineSegment.hpp"
 #include "Mesh.hpp"
 #include "Point.hpp"
+#include "PolyanyaSearch.hpp"
+#include "RoutingHierarchy.hpp"
 
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <vector>
 
 using LocationID = size_t;
 using Location = std::variant<Point, LocationID>;
 
+/// Search computing the paths of 'RoutingEngine'
+enum class RoutingAlgorithm {
+    /// A* on the triangulation, the found triangles are straightened with a funnel algorithm
+    TriangleAStar,
+    /// Optimal any-angle search on the merged convex navigation mesh, see 'PolyanyaSearch'
+    Polyanya,
+    /// Search on the portals between regions of the triangulation first, then A* in the regions
+    /// along the found path only, see 'RoutingHierarchy'. Same as 'TriangleAStar' for engines
+    /// built without hierarchy.
+    Hierarchical
+};
+
+/// Receives the index of a pair and its path, see 'RoutingEngine::ComputeAllWaypointsBatch'.
+using PathConsumer = std::function<void(size_t, const std::vector<Point>&)>;
+
 class RoutingEngine : public Clonable<RoutingEngine>
 {
+    /// Built on first use of 'RoutingAlgorithm::Polyanya', may happen concurrently on engines
+    /// shared between simulations
+    struct LazyPolyanya {
+        std::once_flag built{};
+        std::unique_ptr<const PolyanyaSearch> search{};
+    };
+
     CDT cdt{};
     std::unique_ptr<Mesh> mesh{};
+    std::unique_ptr<LazyPolyanya> polyanya{std::make_unique<LazyPolyanya>()};
+    /// Immutable, shared with clones
+    std::shared_ptr<const RoutingHierarchy> hierarchy{};
 
 public:
     RoutingEngine();
-    explicit RoutingEngine(const PolyWithHoles& poly);
+    /// @param regionSize builds a 'RoutingHierarchy' with regions of this size if > 0
+    explicit RoutingEngine(const PolyWithHoles& poly, double regionSize = 0);
+    /// Restores a routing engine from its triangulation, mesh and the optional hierarchy of the
+    /// mesh, see 'GeometryCache'.
+    RoutingEngine(
+        CDT&& triangulation,
+        std::unique_ptr<Mesh> mesh,
+        std::unique_ptr<const RoutingHierarchy> hierarchy = nullptr);
     ~RoutingEngine() override = default;
 
     RoutingEngine(const RoutingEngine& other) = delete;
@@ -33,15 +70,39 @@ public:
     RoutingEngine& operator=(RoutingEngine&& other) = default;
 
     std::unique_ptr<RoutingEngine> Clone() const override;
-    Point ComputeWaypoint(Point currentPosition, Point destination);
-    std::vector<Point> ComputeAllWaypoints(Point currentPosition, Point destination);
+    Point ComputeWaypoint(
+        Point currentPosition,
+        Point destination,
+        RoutingAlgorithm algorithm = RoutingAlgorithm::TriangleAStar) const;
+    std::vector<Point> ComputeAllWaypoints(
+        Point currentPosition,
+        Point destination,
+        RoutingAlgorithm algorithm = RoutingAlgorithm::TriangleAStar) const;
+    /// Computes the paths from 'from[index]' to 'to[index]' of all pairs on 'threadCount' threads,
+    /// 0 uses one thread per hardware thread. 'consumer' is called concurrently once per pair, with
+    /// an empty path if the pair cannot be routed, e.g. a point is outside of the accessible area.
+    /// Throws SimulationError if 'from' and 'to' differ in size.
+    void ComputeAllWaypointsBatch(
+        std::span<const Point> from,
+        std::span<const Point> to,
+        const PathConsumer& consumer,
+        RoutingAlgorithm algorithm = RoutingAlgorithm::TriangleAStar,
+        size_t threadCount = 0) const;
     bool IsRoutable(Point p) const;
     void Update();
 
     const Mesh* MeshData() const { return mesh.get(); };
+    const CDT& Triangulation() const { return cdt; }
+    /// Hierarchy of the navigation mesh, nullptr if the engine was built without one
+    const RoutingHierarchy* Hierarchy() const { return hierarchy.get(); }
+    /// Estimated heap memory held by the triangulation, the navigation mesh and its hierarchy in
+    /// bytes.
+    size_t MemoryFootprint() const;
 
 private:
+    const PolyanyaSearch& polyanyaSearch() const;
+    std::vector<Point> computeTriangleAStar(Point currentPosition, Point destination) const;
     CDT::Face_handle find_face(K::Point_2) const;
     std::vector<Point>
-    straightenPath(Point from, Point to, const std::vector<CDT::Face_handle>& path);
+    straightenPath(Point from, Point to, const std::vector<CDT::Face_handle>& path) const;
 };
@@ -0,0 +1,555 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "RoutingHierarchy.hpp"
+
+#include "MemoryStats.hpp"
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <queue>
+
+namespace
+{
+constexpr size_t noIndex = Mesh::InvalidIndex;
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+/// Entry of the open lists, orders 'std::priority_queue' by ascending f
+struct OpenEntry {
+    double f;
+    size_t index;
+
+    bool operator<(const OpenEntry& other) const { return f > other.f; }
+};
+
+Point toPoint(glm::dvec2 v)
+{
+    return {v.x, v.y};
+}
+
+/// Shortest path from 'from' to 'to' through 'portals' (left, right end as seen when walking
+/// through them), see Mononen: "Simple Stupid Funnel Algorithm".
+std::vector<Point>
+straighten(Point from, Point to, const std::vector<std::pair<Point, Point>>& innerPortals)
+{
+    std::vector<std::pair<Point, Point>> portals{};
+    portals.reserve(innerPortals.size() + 2);
+    portals.emplace_back(from, from);
+    portals.insert(std::end(portals), std::begin(innerPortals), std::end(innerPortals));
+    portals.emplace_back(to, to);
+
+    std::vector<Point> path{from};
+    auto apex = from;
+    auto left = from;
+    auto right = from;
+    size_t apexIndex = 0;
+    size_t leftIndex = 0;
+    size_t rightIndex = 0;
+    const auto moveApex = [&](Point newApex, size_t index) {
+        if(newApex != path.back()) {
+            path.push_back(newApex);
+        }
+        apex = left = right = newApex;
+        apexIndex = leftIndex = rightIndex = index;
+    };
+    for(size_t index = 1; index < portals.size(); ++index) {
+        const auto& [nextLeft, nextRight] = portals[index];
+        // Tighten the right side unless it crosses the left one
+        if((right - apex).CrossProduct(nextRight - apex) >= 0) {
+            if(apex == right || (left - apex).CrossProduct(nextRight - apex) < 0) {
+                right = nextRight;
+                rightIndex = index;
+            } else {
+                moveApex(left, leftIndex);
+                index = apexIndex;
+                continue;
+            }
+        }
+        // Tighten the left side unless it crosses the right one
+        if((left - apex).CrossProduct(nextLeft - apex) <= 0) {
+            if(apex == left || (right - apex).CrossProduct(nextLeft - apex) > 0) {
+                left = nextLeft;
+                leftIndex = index;
+            } else {
+                moveApex(right, rightIndex);
+                index = apexIndex;
+                continue;
+            }
+        }
+    }
+    if(to != path.back()) {
+        path.push_back(to);
+    }
+    return path;
+}
+} // namespace
+
+RoutingHierarchy::RoutingHierarchy(const Mesh& mesh, double regionSize_) : regionSize(regionSize_)
+{
+    if(!(regionSize > 0)) {
+        throw SimulationError("Routing region size needs to be > 0, got {}", regionSize);
+    }
+    const auto polygonCount = mesh.CountPolygons();
+    std::vector<std::pair<int64_t, int64_t>> cells{};
+    cells.reserve(polygonCount);
+    for(size_t index = 0; index < polygonCount; ++index) {
+        const auto& vertices = mesh.Polygons(index).vertices;
+        glm::dvec2 centroid{};
+        for(const auto vertex : vertices) {
+            centroid += mesh.Vertex(vertex);
+        }
+        centroid /= static_cast<double>(vertices.size());
+        cells.emplace_back(
+            static_cast<int64_t>(std::floor(centroid.x / regionSize)),
+            static_cast<int64_t>(std::floor(centroid.y / regionSize)));
+    }
+
+    // Regions are the connected components of the polygons of each cell
+    constexpr auto unassigned = std::numeric_limits<uint32_t>::max();
+    regionOfPolygon.assign(polygonCount, unassigned);
+    uint32_t regionCount = 0;
+    std::vector<size_t> stack{};
+    for(size_t seed = 0; seed < polygonCount; ++seed) {
+        if(regionOfPolygon[seed] != unassigned) {
+            continue;
+        }
+        if(regionCount == unassigned) {
+            throw SimulationError("Routing region size {} is too small", regionSize);
+        }
+        regionOfPolygon[seed] = regionCount;
+        stack.push_back(seed);
+        while(!stack.empty()) {
+            const auto polygon = stack.back();
+            stack.pop_back();
+            for(const auto neighbor : mesh.Polygons(polygon).neighbors) {
+                if(neighbor != noIndex && regionOfPolygon[neighbor] == unassigned &&
+                   cells[neighbor] == cells[seed]) {
+                    regionOfPolygon[neighbor] = regionCount;
+                    stack.push_back(neighbor);
+                }
+            }
+        }
+        ++regionCount;
+    }
+
+    buildEdges(mesh);
+    buildPortals(regionCount);
+    computePortalDistances();
+}
+
+RoutingHierarchy::RoutingHierarchy(
+    const Mesh& mesh,
+    double regionSize_,
+    std::vector<uint32_t> regionOfPolygon_,
+    std::vector<float> portalDistances_)
+    : regionSize(regionSize_), regionOfPolygon(std::move(regionOfPolygon_))
+{
+    if(regionOfPolygon.size() != mesh.CountPolygons()) {
+        throw SimulationError("Routing hierarchy does not fit to the navigation mesh");
+    }
+    const auto regionCount =
+        regionOfPolygon.empty()
+            ? size_t{0}
+            : static_cast<size_t>(
+                  *std::max_element(std::begin(regionOfPolygon), std::end(regionOfPolygon))) +
+                  1;
+    buildEdges(mesh);
+    buildPortals(regionCount);
+    if(portalDistances_.size() != regionDistanceStart.back()) {
+        throw SimulationError("Routing hierarchy does not fit to the navigation mesh");
+    }
+    portalDistances = std::move(portalDistances_);
+}
+
+void RoutingHierarchy::buildEdges(const Mesh& mesh)
+{
+    polygonEdgeStart.assign(1, 0);
+    for(size_t index = 0; index < mesh.CountPolygons(); ++index) {
+        polygonEdgeStart.push_back(polygonEdgeStart.back() + mesh.Polygons(index).vertices.size());
+    }
+    polygonEdges.assign(polygonEdgeStart.back(), noIndex);
+    for(size_t index = 0; index < mesh.CountPolygons(); ++index) {
+        const auto& polygon = mesh.Polygons(index);
+        const auto count = polygon.vertices.size();
+        for(size_t edge = 0; edge < count; ++edge) {
+            const auto neighbor = polygon.neighbors[edge];
+            if(neighbor == noIndex) {
+                continue;
+            }
+            const auto first = polygon.vertices[edge];
+            const auto second = polygon.vertices[(edge + 1) % count];
+            if(neighbor < index) {
+                // Shared with a polygon visited before, the neighbor has the vertices reversed
+                const auto& other = mesh.Polygons(neighbor);
+                const auto otherCount = other.vertices.size();
+                for(size_t otherEdge = 0; otherEdge < otherCount; ++otherEdge) {
+                    if(other.vertices[otherEdge] == second &&
+                       other.vertices[(otherEdge + 1) % otherCount] == first) {
+                        polygonEdges[polygonEdgeStart[index] + edge] =
+                            polygonEdges[polygonEdgeStart[neighbor] + otherEdge];
+                    }
+                }
+                continue;
+            }
+            polygonEdges[polygonEdgeStart[index] + edge] = edges.size();
+            edges.push_back(
+                {{index, neighbor},
+                 noIndex,
+                 toPoint((mesh.Vertex(first) + mesh.Vertex(second)) * 0.5)});
+        }
+    }
+}
+
+void RoutingHierarchy::buildPortals(size_t regionCount)
+{
+    std::map<std::pair<uint32_t, uint32_t>, size_t> portalOfRegions{};
+    std::vector<std::vector<size_t>> edgesOfPortal{};
+    for(size_t index = 0; index < edges.size(); ++index) {
+        auto& edge = edges[index];
+        auto first = regionOfPolygon[edge.polygons[0]];
+        auto second = regionOfPolygon[edge.polygons[1]];
+        if(first == second) {
+            continue;
+        }
+        if(first > second) {
+            std::swap(first, second);
+        }
+        const auto [iter, inserted] = portalOfRegions.try_emplace({first, second}, portals.size());
+        if(inserted) {
+            portals.push_back({{first, second}, {}});
+            edgesOfPortal.emplace_back();
+        }
+        edge.portal = iter->second;
+        edgesOfPortal[edge.portal].push_back(index);
+    }
+
+    portalEdgeStart.assign(1, 0);
+    regionPortalStart.assign(regionCount + 1, 0);
+    for(size_t index = 0; index < portals.size(); ++index) {
+        const auto& portalEdgeList = edgesOfPortal[index];
+        portalEdges.insert(std::end(portalEdges), portalEdgeList.begin(), portalEdgeList.end());
+        portalEdgeStart.push_back(portalEdges.size());
+        Point mean{};
+        for(const auto edge : portalEdgeList) {
+            mean += edges[edge].center;
+        }
+        mean = mean / static_cast<double>(portalEdgeList.size());
+        auto& portal = portals[index];
+        portal.center = edges[*std::min_element(
+                                  portalEdgeList.begin(),
+                                  portalEdgeList.end(),
+                                  [this, mean](size_t a, size_t b) {
+                                      return DistanceSquared(edges[a].center, mean) <
+                                             DistanceSquared(edges[b].center, mean);
+                                  })]
+                            .center;
+        for(const auto region : portal.regions) {
+            ++regionPortalStart[region + 1];
+        }
+    }
+    for(size_t region = 1; region < regionPortalStart.size(); ++region) {
+        regionPortalStart[region] += regionPortalStart[region - 1];
+    }
+    regionPortals.resize(regionPortalStart.back());
+    std::vector<size_t> fill(std::begin(regionPortalStart), std::end(regionPortalStart) - 1);
+    for(size_t index = 0; index < portals.size(); ++index) {
+        for(const auto region : portals[index].regions) {
+            regionPortals[fill[region]++] = index;
+        }
+    }
+
+    regionDistanceStart.assign(1, 0);
+    for(size_t region = 0; region < regionCount; ++region) {
+        const auto count = regionPortalStart[region + 1] - regionPortalStart[region];
+        regionDistanceStart.push_back(regionDistanceStart.back() + count * count);
+    }
+}
+
+void RoutingHierarchy::computePortalDistances()
+{
+    portalDistances.assign(regionDistanceStart.back(), std::numeric_limits<float>::infinity());
+    std::vector<std::pair<size_t, double>> seeds{};
+    for(uint32_t region = 0; region < CountRegions(); ++region) {
+        const auto begin = regionPortalStart[region];
+        const auto count = regionPortalStart[region + 1] - begin;
+        for(size_t row = 0; row < count; ++row) {
+            const auto portal = regionPortals[begin + row];
+            seeds.clear();
+            for(auto index = portalEdgeStart[portal]; index < portalEdgeStart[portal + 1];
+                ++index) {
+                seeds.emplace_back(portalEdges[index], 0.);
+            }
+            const auto distances = edgeDistances(region, seeds);
+            for(size_t column = 0; column < count; ++column) {
+                portalDistances[regionDistanceStart[region] + row * count + column] =
+                    static_cast<float>(portalDistance(regionPortals[begin + column], distances));
+            }
+        }
+    }
+}
+
+std::unordered_map<size_t, double> RoutingHierarchy::edgeDistances(
+    uint32_t region,
+    const std::vector<std::pair<size_t, double>>& seeds) const
+{
+    std::unordered_map<size_t, double> distances{};
+    std::priority_queue<OpenEntry> open{};
+    for(const auto& [edge, distance] : seeds) {
+        auto [iter, inserted] = distances.try_emplace(edge, distance);
+        if(inserted || distance < iter->second) {
+            iter->second = distance;
+            open.push({distance, edge});
+        }
+    }
+    while(!open.empty()) {
+        const auto [distance, edge] = open.top();
+        open.pop();
+        if(distance > distances.at(edge)) {
+            continue;
+        }
+        const auto center = edges[edge].center;
+        for(const auto polygon : edges[edge].polygons) {
+            if(regionOfPolygon[polygon] != region) {
+                continue;
+            }
+            for(auto index = polygonEdgeStart[polygon]; index < polygonEdgeStart[polygon + 1];
+                ++index) {
+                const auto next = polygonEdges[index];
+                if(next == noIndex || next == edge) {
+                    continue;
+                }
+                const auto nextDistance = distance + Distance(center, edges[next].center);
+                auto [iter, inserted] = distances.try_emplace(next, nextDistance);
+                if(inserted || nextDistance < iter->second) {
+                    iter->second = nextDistance;
+                    open.push({nextDistance, next});
+                }
+            }
+        }
+    }
+    return distances;
+}
+
+double RoutingHierarchy::portalDistance(
+    size_t portal,
+    const std::unordered_map<size_t, double>& distances) const
+{
+    auto distance = infinity;
+    for(auto index = portalEdgeStart[portal]; index < portalEdgeStart[portal + 1]; ++index) {
+        if(const auto iter = distances.find(portalEdges[index]); iter != std::end(distances)) {
+            distance = std::min(distance, iter->second);
+        }
+    }
+    return distance;
+}
+
+std::vector<Point> RoutingHierarchy::ComputeAllWaypoints(const Mesh& mesh, Point from, Point to)
+    const
+{
+    const auto locate = [&mesh](Point p) {
+        const auto polygon = mesh.FindContainingPolygon({p.x, p.y});
+        if(polygon == noIndex) {
+            throw SimulationError("Point ({}, {}) is outside of accessible area", p.x, p.y);
+        }
+        return polygon;
+    };
+    const auto fromPolygon = locate(from);
+    const auto toPolygon = locate(to);
+    if(fromPolygon == toPolygon) {
+        return {from, to};
+    }
+    const auto fromRegion = regionOfPolygon[fromPolygon];
+    const auto toRegion = regionOfPolygon[toPolygon];
+
+    // Connect both points to the portals of their regions
+    const auto distancesInRegion = [this](uint32_t region, size_t polygon, Point p) {
+        std::vector<std::pair<size_t, double>> seeds{};
+        for(auto index = polygonEdgeStart[polygon]; index < polygonEdgeStart[polygon + 1];
+            ++index) {
+            if(const auto edge = polygonEdges[index]; edge != noIndex) {
+                seeds.emplace_back(edge, Distance(p, edges[edge].center));
+            }
+        }
+        return edgeDistances(region, seeds);
+    };
+    const auto fromDistances = distancesInRegion(fromRegion, fromPolygon, from);
+    const auto toDistances = distancesInRegion(toRegion, toPolygon, to);
+
+    // A* on the portals, index 'portals.size()' is the target
+    const auto target = portals.size();
+    struct Node {
+        double g;
+        size_t parent;
+    };
+    std::unordered_map<size_t, Node> nodes{};
+    std::priority_queue<OpenEntry> open{};
+    const auto relax = [&](size_t portal, double g, size_t parent) {
+        auto [iter, inserted] = nodes.try_emplace(portal, Node{g, parent});
+        if(!inserted && g >= iter->second.g) {
+            return;
+        }
+        iter->second = {g, parent};
+        const auto h = portal == target ? 0. : Distance(portals[portal].center, to);
+        open.push({g + h, portal});
+    };
+    if(fromRegion == toRegion) {
+        auto direct = infinity;
+        for(auto index = polygonEdgeStart[toPolygon]; index < polygonEdgeStart[toPolygon + 1];
+            ++index) {
+            const auto edge = polygonEdges[index];
+            if(const auto iter = fromDistances.find(edge);
+               edge != noIndex && iter != std::end(fromDistances)) {
+                direct = std::min(direct, iter->second + Distance(edges[edge].center, to));
+            }
+        }
+        if(direct < infinity) {
+            relax(target, direct, noIndex);
+        }
+    }
+    for(auto index = regionPortalStart[fromRegion]; index < regionPortalStart[fromRegion + 1];
+        ++index) {
+        const auto portal = regionPortals[index];
+        if(const auto g = portalDistance(portal, fromDistances); g < infinity) {
+            relax(portal, g, noIndex);
+        }
+    }
+    bool found = false;
+    while(!open.empty()) {
+        const auto [f, portal] = open.top();
+        open.pop();
+        if(portal == target) {
+            found = true;
+            break;
+        }
+        const auto g = nodes.at(portal).g;
+        if(f > g + Distance(portals[portal].center, to)) {
+            continue;
+        }
+        for(const auto region : portals[portal].regions) {
+            const auto begin = regionPortalStart[region];
+            const auto count = regionPortalStart[region + 1] - begin;
+            const auto row = static_cast<size_t>(
+                std::lower_bound(
+                    std::begin(regionPortals) + begin,
+                    std::begin(regionPortals) + begin + count,
+                    portal) -
+                std::begin(regionPortals) - begin);
+            const auto* distances = &portalDistances[regionDistanceStart[region] + row * count];
+            for(size_t column = 0; column < count; ++column) {
+                if(column != row && distances[column] < std::numeric_limits<float>::infinity()) {
+                    relax(regionPortals[begin + column], g + distances[column], portal);
+                }
+            }
+            if(region == toRegion) {
+                if(const auto toTarget = portalDistance(portal, toDistances); toTarget < infinity) {
+                    relax(target, g + toTarget, portal);
+                }
+            }
+        }
+    }
+    if(!found) {
+        throw SimulationError(
+            "No path from ({}, {}) to ({}, {}) in the navigation mesh", from.x, from.y, to.x, to.y);
+    }
+
+    // Refine in the regions along the abstract path
+    std::vector<uint32_t> corridor{fromRegion, toRegion};
+    for(auto portal = nodes.at(target).parent; portal != noIndex;
+        portal = nodes.at(portal).parent) {
+        corridor.insert(
+            std::end(corridor),
+            std::begin(portals[portal].regions),
+            std::end(portals[portal].regions));
+    }
+    std::sort(std::begin(corridor), std::end(corridor));
+    corridor.erase(std::unique(std::begin(corridor), std::end(corridor)), std::end(corridor));
+    auto polygons = polygonPath(from, fromPolygon, to, toPolygon, corridor);
+    if(polygons.empty()) {
+        // The distances between portals are measured between edge centers, in rare cases the
+        // corridor misses a connection only usable off the centers
+        polygons = polygonPath(from, fromPolygon, to, toPolygon, {});
+    }
+
+    std::vector<std::pair<Point, Point>> crossings{};
+    crossings.reserve(polygons.size());
+    for(size_t index = 1; index < polygons.size(); ++index) {
+        const auto& polygon = mesh.Polygons(polygons[index - 1]);
+        const auto count = polygon.vertices.size();
+        for(size_t edge = 0; edge < count; ++edge) {
+            if(polygon.neighbors[edge] == polygons[index]) {
+                crossings.emplace_back(
+                    toPoint(mesh.Vertex(polygon.vertices[(edge + 1) % count])),
+                    toPoint(mesh.Vertex(polygon.vertices[edge])));
+                break;
+            }
+        }
+    }
+    return straighten(from, to, crossings);
+}
+
+std::vector<size_t> RoutingHierarchy::polygonPath(
+    Point from,
+    size_t fromPolygon,
+    Point to,
+    size_t toPolygon,
+    const std::vector<uint32_t>& corridor) const
+{
+    struct Node {
+        double g;
+        size_t parent;
+        /// Where the polygon was entered
+        Point entry;
+    };
+    std::unordered_map<size_t, Node> nodes{{fromPolygon, {0., noIndex, from}}};
+    std::priority_queue<OpenEntry> open{};
+    open.push({Distance(from, to), fromPolygon});
+    while(!open.empty()) {
+        const auto [f, polygon] = open.top();
+        open.pop();
+        const auto node = nodes.at(polygon);
+        if(f > node.g + Distance(node.entry, to)) {
+            continue;
+        }
+        if(polygon == toPolygon) {
+            std::vector<size_t> path{};
+            for(auto index = polygon; index != noIndex; index = nodes.at(index).parent) {
+                path.push_back(index);
+            }
+            std::reverse(std::begin(path), std::end(path));
+            return path;
+        }
+        for(auto index = polygonEdgeStart[polygon]; index < polygonEdgeStart[polygon + 1];
+            ++index) {
+            const auto edge = polygonEdges[index];
+            if(edge == noIndex) {
+                continue;
+            }
+            const auto& sides = edges[edge].polygons;
+            const auto next = sides[0] == polygon ? sides[1] : sides[0];
+            const auto center = edges[edge].center;
+            if(!corridor.empty() &&
+               !std::binary_search(
+                   std::begin(corridor), std::end(corridor), regionOfPolygon[next])) {
+                continue;
+            }
+            const auto g = node.g + Distance(node.entry, center);
+            auto [iter, inserted] = nodes.try_emplace(next, Node{g, polygon, center});
+            if(!inserted && g >= iter->second.g) {
+                continue;
+            }
+            iter->second = {g, polygon, center};
+            open.push({g + Distance(center, to), next});
+        }
+    }
+    return {};
+}
+
+size_t RoutingHierarchy::MemoryFootprint() const
+{
+    using jps::memory::HeapBytes;
+    return HeapBytes(regionOfPolygon) + HeapBytes(polygonEdgeStart) + HeapBytes(polygonEdges) +
+           HeapBytes(edges) + HeapBytes(portals) + HeapBytes(portalEdgeStart) +
+           HeapBytes(portalEdges) + HeapBytes(regionPortalStart) + HeapBytes(regionPortals) +
+           HeapBytes(regionDistanceStart) + HeapBytes(portalDistances);
+}
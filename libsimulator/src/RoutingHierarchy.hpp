@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Mesh.hpp"
+#include "Point.hpp"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// Two level abstraction of a navigation mesh for long range queries on large meshes.
+///
+/// The polygons are clustered into regions: the connected parts of the polygons whose centroids
+/// fall into the same cell of a square grid. All mesh edges between two regions form a portal.
+/// Walking distances between the portals of each region are precomputed. Queries first search
+/// the graph of portals, then search only the polygons of the regions along the abstract path
+/// and straighten the result with a funnel algorithm.
+///
+/// The hierarchy does not hold the mesh it was built from, it is passed to every query instead.
+class RoutingHierarchy
+{
+    struct Edge {
+        /// Polygons on both sides of the edge
+        std::array<size_t, 2> polygons;
+        /// Portal containing the edge, 'Mesh::InvalidIndex' for edges inside of a region
+        size_t portal;
+        Point center;
+    };
+
+    struct Portal {
+        std::array<uint32_t, 2> regions;
+        /// Center of the edge of the portal closest to the mean of all its edge centers
+        Point center;
+    };
+
+    double regionSize;
+    std::vector<uint32_t> regionOfPolygon{};
+    /// Edges of polygon 'i' in the order of its vertices start at polygonEdgeStart[i],
+    /// 'Mesh::InvalidIndex' marks walls.
+    std::vector<size_t> polygonEdgeStart{};
+    std::vector<size_t> polygonEdges{};
+    std::vector<Edge> edges{};
+    std::vector<Portal> portals{};
+    /// Edges of portal 'i' are portalEdges[portalEdgeStart[i], portalEdgeStart[i + 1])
+    std::vector<size_t> portalEdgeStart{};
+    std::vector<size_t> portalEdges{};
+    /// Portals of region 'i' in ascending order are
+    /// regionPortals[regionPortalStart[i], regionPortalStart[i + 1])
+    std::vector<size_t> regionPortalStart{};
+    std::vector<size_t> regionPortals{};
+    /// Row major matrix of walking distances between the portals of each region, the matrix of
+    /// region 'i' starts at regionDistanceStart[i]. Portals not connected inside of the region
+    /// are infinitely far apart.
+    std::vector<size_t> regionDistanceStart{};
+    std::vector<float> portalDistances{};
+
+public:
+    /// Builds the hierarchy of 'mesh'.
+    /// @param mesh to abstract, e.g. the triangles of a 'RoutingEngine'
+    /// @param regionSize side length of the grid cells grouping polygons, needs to be > 0
+    RoutingHierarchy(const Mesh& mesh, double regionSize);
+
+    /// Restores a hierarchy from the regions and portal distances of a hierarchy built from
+    /// 'mesh', see 'GeometryCache'. Throws SimulationError if they do not fit to 'mesh'.
+    RoutingHierarchy(
+        const Mesh& mesh,
+        double regionSize,
+        std::vector<uint32_t> regionOfPolygon,
+        std::vector<float> portalDistances);
+
+    /// Returns a path from 'from' to 'to' including both.
+    /// Throws SimulationError if either point is outside of 'mesh' or they are not connected.
+    /// @param mesh the hierarchy was built from
+    std::vector<Point> ComputeAllWaypoints(const Mesh& mesh, Point from, Point to) const;
+
+    double RegionSize() const { return regionSize; }
+    size_t CountRegions() const { return regionPortalStart.size() - 1; }
+    size_t CountPortals() const { return portals.size(); }
+    const std::vector<uint32_t>& RegionOfPolygon() const { return regionOfPolygon; }
+    const std::vector<float>& PortalDistances() const { return portalDistances; }
+
+    /// Heap memory held by the hierarchy in bytes
+    size_t MemoryFootprint() const;
+
+private:
+    void buildEdges(const Mesh& mesh);
+    void buildPortals(size_t regionCount);
+    void computePortalDistances();
+    /// Walking distances from 'seeds' (edge, distance) to the centers of all edges reachable
+    /// through the polygons of 'region', moving between the centers of edges.
+    std::unordered_map<size_t, double>
+    edgeDistances(uint32_t region, const std::vector<std::pair<size_t, double>>& seeds) const;
+    /// Distance from 'portal' to the nearest edge in 'distances', infinity if there is none
+    double portalDistance(size_t portal, const std::unordered_map<size_t, double>& distances) const;
+    /// Polygons from 'from' to 'to' through the regions in 'corridor' (ascending) only, all
+    /// regions if it is empty. Empty if there is no such sequence.
+    std::vector<size_t> polygonPath(
+        Point from,
+        size_t fromPolygon,
+        Point to,
+        size_t toPolygon,
+        const std::vector<uint32_t>& corridor) const;
+};
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CollisionGeometry.hpp"
+#include "RoutingEngine.hpp"
+
+#include <memory>
+#include <mutex>
+
+/// Immutable collision geometry together with the routing engine built from it.
+/// Copies share the underlying data, so any number of simulations can use the same geometry
+/// without copying it. The routing engine is built on first use and then shared as well.
+class SharedGeometry
+{
+    struct Data {
+        explicit Data(CollisionGeometry&& geometry) : collisionGeometry(std::move(geometry)) {}
+        const CollisionGeometry collisionGeometry;
+        std::once_flag routingEngineBuilt{};
+        std::unique_ptr<const RoutingEngine> routingEngine{};
+    };
+    std::shared_ptr<Data> data;
+
+public:
+    explicit SharedGeometry(CollisionGeometry&& geometry)
+        : data(std::make_shared<Data>(std::move(geometry)))
+    {
+    }
+
+    /// Builds the routing engine right away if 'routingRegionSize' > 0, with a 'RoutingHierarchy'
+    /// of regions of this size, see 'GeometryBuilder::SetRoutingHierarchy'.
+    SharedGeometry(CollisionGeometry&& geometry, double routingRegionSize)
+        : data(std::make_shared<Data>(std::move(geometry)))
+    {
+        if(routingRegionSize > 0) {
+            std::call_once(data->routingEngineBuilt, [this, routingRegionSize]() {
+                data->routingEngine =
+                    std::make_unique<RoutingEngine>(Collision().Polygon(), routingRegionSize);
+            });
+        }
+    }
+
+    /// Shares an already built routing engine, e.g. one restored by 'GeometryCache'.
+    SharedGeometry(CollisionGeometry&& geometry, std::unique_ptr<const RoutingEngine> routingEngine)
+        : data(std::make_shared<Data>(std::move(geometry)))
+    {
+        std::call_once(data->routingEngineBuilt, [this, &routingEngine]() {
+            data->routingEngine = std::move(routingEngine);
+        });
+    }
+
+    const CollisionGeometry& Collision() const { return data->collisionGeometry; }
+
+    /// Builds the routing engine if this did not happen yet for any copy of this geometry.
+    /// Safe to be called concurrently.
+    std::shared_ptr<const RoutingEngine> Routing() const
+    {
+        std::call_once(data->routingEngineBuilt, [this]() {
+            data->routingEngine = std::make_unique<RoutingEngine>(Collision().Polygon());
+        });
+        return {data, data->routingEngine.get()};
+    }
+
+    CollisionGeometry::ID Id() const { return Collision().Id(); }
+
+    /// Number of owners of the shared data, including handles returned by 'Routing'.
+    long UseCount() const { return data.use_count(); }
+};
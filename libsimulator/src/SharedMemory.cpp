@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "SharedMemory.hpp"
+
+#include "SimulationError.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+
+#ifdef _WIN32
+SharedMemory::SharedMemory(const std::string& name_, size_t size_)
+    : name(name_), size(size_), owner(true)
+{
+    mappingHandle = CreateFileMappingA(
+        INVALID_HANDLE_VALUE,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+        static_cast<DWORD>(size & 0xFFFFFFFF),
+        name.c_str());
+    if(mappingHandle == nullptr) {
+        throw SimulationError("Could not create shared memory '{}'", name);
+    }
+    data = static_cast<std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_WRITE, 0, 0, size));
+    if(data == nullptr) {
+        CloseHandle(mappingHandle);
+        throw SimulationError("Could not map shared memory '{}'", name);
+    }
+}
+
+SharedMemory::SharedMemory(const std::string& name_) : name(name_)
+{
+    mappingHandle = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    if(mappingHandle == nullptr) {
+        throw SimulationError("Could not open shared memory '{}'", name);
+    }
+    data = static_cast<std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if(data == nullptr) {
+        CloseHandle(mappingHandle);
+        throw SimulationError("Could not map shared memory '{}'", name);
+    }
+    MEMORY_BASIC_INFORMATION info{};
+    VirtualQuery(data, &info, sizeof(info));
+    size = info.RegionSize;
+}
+
+SharedMemory::~SharedMemory()
+{
+    // The mapping object is destroyed once the last process closed its handle
+    UnmapViewOfFile(data);
+    CloseHandle(mappingHandle);
+}
+#else
+namespace
+{
+/// POSIX names need to start with a single slash
+std::string posixName(const std::string& name)
+{
+    return name.starts_with('/') ? name : "/" + name;
+}
+} // namespace
+
+SharedMemory::SharedMemory(const std::string& name_, size_t size_)
+    : name(posixName(name_)), size(size_), owner(true)
+{
+    // Replace a region left behind by a process that did not shut down cleanly, readers that still
+    // map the old region are not affected.
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(fd < 0) {
+        throw SimulationError("Could not create shared memory '{}'", name);
+    }
+    if(ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw SimulationError("Could not resize shared memory '{}' to {} bytes", name, size);
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw SimulationError("Could not map shared memory '{}'", name);
+    }
+    data = static_cast<std::byte*>(mapping);
+}
+
+SharedMemory::SharedMemory(const std::string& name_) : name(posixName(name_))
+{
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if(fd < 0) {
+        throw SimulationError("Could not open shared memory '{}'", name);
+    }
+    struct stat info{};
+    if(fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        throw SimulationError("Shared memory '{}' is empty", name);
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED) {
+        throw SimulationError("Could not map shared memory '{}'", name);
+    }
+    data = static_cast<std::byte*>(mapping);
+}
+
+SharedMemory::~SharedMemory()
+{
+    munmap(data, size);
+    if(owner) {
+        shm_unlink(name.c_str());
+    }
+}
+#endif
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+/// Named shared memory region that other processes on the same machine can map. The creating side
+/// owns the name and removes it on destruction, regions that are still mapped stay valid until they
+/// are unmapped.
+class SharedMemory
+{
+    std::string name;
+    std::byte* data{nullptr};
+    size_t size{0};
+    bool owner{false};
+#ifdef _WIN32
+    void* mappingHandle{nullptr};
+#endif
+
+public:
+    /// Creates a zero initialized, writable region, replacing an existing region with this name.
+    /// Throws SimulationError if the region cannot be created.
+    SharedMemory(const std::string& name, size_t size);
+    /// Maps an existing region read only. Throws SimulationError if the region does not exist.
+    explicit SharedMemory(const std::string& name);
+    ~SharedMemory();
+    SharedMemory(const SharedMemory& other) = delete;
+    SharedMemory& operator=(const SharedMemory& other) = delete;
+    SharedMemory(SharedMemory&& other) = delete;
+    SharedMemory& operator=(SharedMemory&& other) = delete;
+
+    /// Only writable if this instance created the region.
+    std::span<std::byte> Data() const { return {data, size}; }
+};
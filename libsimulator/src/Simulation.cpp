@@ -8,25 +8,23 @@
 #include "Stage.hpp"
 #include "Visitor.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include <variant>
 
 Simulation::Simulation(
     std::unique_ptr<OperationalModel>&& operationalModel,
-    std::unique_ptr<CollisionGeometry>&& geometry,
+    SharedGeometry geometry,
     double dT)
     : _clock(dT), _operationalDecisionSystem(std::move(operationalModel))
 {
-    const auto p = geometry->Polygon();
-    const auto& [tup, res] = geometries.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(geometry->Id()),
-        std::forward_as_tuple(std::move(geometry), std::make_unique<RoutingEngine>(p)));
-    if(!res) {
-        throw SimulationError("Internal error");
-    }
-    _geometry = std::get<0>(tup->second).get();
-    _routingEngine = std::get<1>(tup->second).get();
+    const auto& [iter, _] = geometries.try_emplace(geometry.Id(), std::move(geometry));
+    _geometry = &iter->second.Collision();
+    _routingEngine = iter->second.Routing().get();
+    updateGeometryMemoryStats();
 }
 const SimulationClock& Simulation::Clock() const
 {
@@ -38,29 +36,81 @@ void Simulation::SetTracing(bool status)
     _perfStats.SetEnabled(status);
 };
 
+bool Simulation::SetHardwareCounters(bool status)
+{
+    return _perfStats.SetHardwareCountersEnabled(status);
+};
+
 PerfStats Simulation::GetLastStats() const
 {
     return _perfStats;
 };
 
+MemoryStats Simulation::GetMemoryStats()
+{
+    // Sampled on request only, the neighborhood search footprint walks all grid cells
+    updateAgentMemoryStats(_memoryStats);
+    return _memoryStats;
+}
+
+void Simulation::SetEventRecording(bool on)
+{
+    _eventLog.SetEnabled(on);
+}
+
+void Simulation::SetRoutingAlgorithm(RoutingAlgorithm algorithm)
+{
+    _tacticalDecisionSystem.SetRoutingAlgorithm(algorithm);
+}
+
+RoutingAlgorithm Simulation::GetRoutingAlgorithm() const
+{
+    return _tacticalDecisionSystem.GetRoutingAlgorithm();
+}
+
+size_t Simulation::CountEvents() const
+{
+    return _eventLog.Count();
+}
+
+size_t Simulation::ReadEvents(std::span<SimulationEvent> buffer)
+{
+    return _eventLog.Drain(buffer);
+}
+
 void Simulation::Iterate()
 {
     // LOG_DEBUG("Iteration {} / Time {}s", _clock.Iteration(), _clock.ElapsedTime());
     auto t = _perfStats.TraceIterate();
-    _agentRemovalSystem.Run(_agents, _removedAgentsInLastIteration, _stageManager);
+    _eventLog.SetIteration(_clock.Iteration());
+    _agentRemovalSystem.Run(_agents, _removedAgentsInLastIteration, _stageManager, _eventLog);
+    _stageControllerSystem.Run(_clock.ElapsedTime(), _agents, _stageManager, _eventLog);
     _neighborhoodSearch.Update(_agents);
 
-    _stageSystem.Run(_stageManager, _neighborhoodSearch, *_geometry);
-    _stategicalDecisionSystem.Run(_journeys, _agents, _stageManager);
+    _stageSystem.Run(_stageManager, _neighborhoodSearch, *_geometry, _eventLog);
+    _stategicalDecisionSystem.Run(_journeysByOrdinal, _agents, _stageManager, _eventLog);
     _tacticalDecisionSystem.Run(*_routingEngine, _agents);
+    const bool measuring = !_measurementSystem.Empty();
+    if(measuring) {
+        _measurementSystem.Prepare(_agents);
+    }
     {
         auto t2 = _perfStats.TraceOperationalDecisionSystemRun();
         _operationalDecisionSystem.Run(
             _clock.dT(), _clock.ElapsedTime(), _neighborhoodSearch, *_geometry, _agents);
     }
+    if(measuring) {
+        _measurementSystem.Run(_clock.ElapsedTime() + _clock.dT(), _clock.dT(), _agents);
+    }
     _clock.Advance();
 }
 
+void Simulation::PopQueue(NotifiableQueue& queue, size_t count)
+{
+    _eventLog.SetIteration(_clock.Iteration());
+    queue.Pop(count, _eventLog);
+}
+
 Journey::ID Simulation::AddJourney(const std::map<BaseStage::ID, TransitionDescription>& stages)
 {
     std::map<BaseStage::ID, JourneyNode> nodes;
@@ -130,8 +180,9 @@ Journey::ID Simulation::AddJourney(const std::map<BaseStage::ID, TransitionDescr
                         desc)}};
         });
 
-    auto journey = std::make_unique<Journey>(std::move(nodes));
+    auto journey = std::make_unique<Journey>(std::move(nodes), _journeysByOrdinal.size());
     const auto id = journey->Id();
+    _journeysByOrdinal.push_back(journey.get());
     _journeys.emplace(id, std::move(journey));
     return id;
 }
@@ -174,19 +225,117 @@ BaseStage::ID Simulation::AddStage(const StageDescription stageDescription)
     return _stageManager.AddStage(stageDescription, _removedAgentsInLastIteration);
 }
 
+void Simulation::AddPeriodicQueuePop(
+    BaseStage::ID stageId,
+    double interval,
+    size_t count,
+    double startTime)
+{
+    auto queue = dynamic_cast<NotifiableQueue*>(_stageManager.Stage(stageId));
+    if(queue == nullptr) {
+        throw SimulationError("Stage {} is not a notifiable queue", stageId);
+    }
+    if(interval <= 0) {
+        throw SimulationError("Pop interval needs to be greater than 0, got {}", interval);
+    }
+    if(count == 0) {
+        throw SimulationError("Pop count needs to be greater than 0");
+    }
+    _stageControllerSystem.Add(PeriodicQueuePop{queue, interval, count, startTime});
+}
+
+void Simulation::AddWaitingSetThresholds(
+    BaseStage::ID stageId,
+    size_t deactivateAt,
+    size_t activateAt)
+{
+    auto waitingSet = dynamic_cast<NotifiableWaitingSet*>(_stageManager.Stage(stageId));
+    if(waitingSet == nullptr) {
+        throw SimulationError("Stage {} is not a waiting set", stageId);
+    }
+    if(deactivateAt == 0 || deactivateAt > waitingSet->Slots().size()) {
+        throw SimulationError(
+            "Deactivation threshold needs to be between 1 and the number of waiting positions "
+            "({}), got {}",
+            waitingSet->Slots().size(),
+            deactivateAt);
+    }
+    if(activateAt >= deactivateAt) {
+        throw SimulationError(
+            "Activation threshold needs to be less than the deactivation threshold ({}), got {}",
+            deactivateAt,
+            activateAt);
+    }
+    _stageControllerSystem.Add(WaitingSetThresholds{waitingSet, deactivateAt, activateAt});
+}
+
+size_t Simulation::AddGridMeasurement(const AABB& bounds, double cellSize, double interval)
+{
+    return _measurementSystem.AddGrid(bounds, cellSize, interval, _clock.ElapsedTime());
+}
+
+size_t Simulation::AddLineMeasurement(Point p1, Point p2)
+{
+    return _measurementSystem.AddLine(p1, p2);
+}
+
+size_t Simulation::AddAreaMeasurement(const std::vector<Point>& polygon, double interval)
+{
+    return _measurementSystem.AddArea(polygon, interval, _clock.ElapsedTime());
+}
+
+const GridMeasurement& Simulation::GetGridMeasurement(size_t id) const
+{
+    return _measurementSystem.Grid(id);
+}
+
+const LineMeasurement& Simulation::GetLineMeasurement(size_t id) const
+{
+    return _measurementSystem.Line(id);
+}
+
+const AreaMeasurement& Simulation::GetAreaMeasurement(size_t id) const
+{
+    return _measurementSystem.Area(id);
+}
+
+void Simulation::ScheduleJourneySwitch(
+    double time,
+    Journey::ID from,
+    Journey::ID to,
+    BaseStage::ID toStage)
+{
+    if(_journeys.count(from) == 0) {
+        throw SimulationError("Unknown Journey id {}", from);
+    }
+    const auto toIter = _journeys.find(to);
+    if(toIter == std::end(_journeys)) {
+        throw SimulationError("Unknown Journey id {}", to);
+    }
+    const auto& journey = toIter->second;
+    if(!journey->ContainsStage(toStage)) {
+        throw SimulationError("Stage {} not part of Journey {}", toStage, to);
+    }
+    _stageControllerSystem.Add(
+        ScheduledJourneySwitch{time, from, journey.get(), _stageManager.Stage(toStage)});
+}
+
 GenericAgent::ID Simulation::AddAgent(GenericAgent&& agent)
 {
 
     if(!_geometry->InsideGeometry(agent.pos)) {
         throw SimulationError("Agent {} not inside walkable area", agent.pos);
     }
-    if(_journeys.count(agent.journeyId) == 0) {
+    const auto journeyIter = _journeys.find(agent.journeyId);
+    if(journeyIter == std::end(_journeys)) {
         throw SimulationError("Unknown journey id: {}", agent.journeyId);
     }
 
-    if(!_journeys.at(agent.journeyId)->ContainsStage(agent.stageId)) {
+    if(!journeyIter->second->ContainsStage(agent.stageId)) {
         throw SimulationError("Unknown stage id: {}", agent.stageId);
     }
+    agent.journeyOrdinal = journeyIter->second->Ordinal();
+    agent.stageOrdinal = _stageManager.Stage(agent.stageId)->Ordinal();
 
     if(std::holds_alternative<GeneralizedCentrifugalForceModelData>(agent.model))
         if(agent.orientation.isZeroLength()) {
@@ -197,12 +346,13 @@ GenericAgent::ID Simulation::AddAgent(GenericAgent&& agent)
     agent.orientation = agent.orientation.Normalized();
     _operationalDecisionSystem.ValidateAgent(agent, _neighborhoodSearch, *_geometry);
 
-    _stageManager.HandleNewAgent(agent.stageId);
+    _stageManager.HandleNewAgent(agent.id, agent.stageId);
     _agents.emplace_back(std::move(agent));
     _neighborhoodSearch.AddAgent(_agents.back());
 
     auto v = IteratorPair(std::prev(std::end(_agents)), std::end(_agents));
-    _stategicalDecisionSystem.Run(_journeys, v, _stageManager);
+    _eventLog.SetIteration(_clock.Iteration());
+    _stategicalDecisionSystem.Run(_journeysByOrdinal, v, _stageManager, _eventLog);
     _tacticalDecisionSystem.Run(*_routingEngine, v);
     return _agents.back().id.getID();
 }
@@ -283,8 +433,14 @@ void Simulation::SwitchAgentJourney(
     }
     auto& agent = Agent(agent_id);
     agent.journeyId = journey_id;
-    _stageManager.MigrateAgent(agent.stageId, stage_id);
+    agent.journeyOrdinal = journey->Ordinal();
+    _stageManager.MigrateAgent(agent.id, agent.stageId, stage_id);
+    if(agent.stageId != stage_id) {
+        _eventLog.SetIteration(_clock.Iteration());
+        _eventLog.Push(SimulationEventType::StageChanged, agent.id, stage_id, agent.stageId);
+    }
     agent.stageId = stage_id;
+    agent.stageOrdinal = _stageManager.Stage(stage_id)->Ordinal();
 }
 
 std::vector<GenericAgent::ID> Simulation::AgentsInRange(Point p, double distance)
@@ -330,32 +486,21 @@ StageProxy Simulation::Stage(BaseStage::ID stageId)
 {
     return _stageManager.Stage(stageId)->Proxy(this);
 }
-CollisionGeometry Simulation::Geo() const
+SharedGeometry Simulation::Geo() const
 {
-    return *_geometry;
+    return geometries.at(_geometry->Id());
 }
 
-void Simulation::SwitchGeometry(std::unique_ptr<CollisionGeometry>&& geometry)
+void Simulation::SwitchGeometry(SharedGeometry geometry)
 {
-    ValidateGeometry(geometry);
-    if(const auto& iter = geometries.find(geometry->Id()); iter != std::end(geometries)) {
-        _geometry = std::get<0>(iter->second).get();
-        _routingEngine = std::get<1>(iter->second).get();
-    } else {
-        const auto p = geometry->Polygon();
-        const auto& [tup, res] = geometries.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(geometry->Id()),
-            std::forward_as_tuple(std::move(geometry), std::make_unique<RoutingEngine>(p)));
-        if(!res) {
-            throw SimulationError("Internal error");
-        }
-        _geometry = std::get<0>(tup->second).get();
-        _routingEngine = std::get<1>(tup->second).get();
-    }
+    ValidateGeometry(geometry.Collision());
+    const auto& [iter, _] = geometries.try_emplace(geometry.Id(), std::move(geometry));
+    _geometry = &iter->second.Collision();
+    _routingEngine = iter->second.Routing().get();
+    updateGeometryMemoryStats();
 }
 
-void Simulation::ValidateGeometry(const std::unique_ptr<CollisionGeometry>& geometry) const
+void Simulation::ValidateGeometry(const CollisionGeometry& geometry) const
 {
     std::vector<GenericAgent::ID> faultyAgents;
     for(const auto& agent : _agents) {
@@ -367,7 +512,7 @@ void Simulation::ValidateGeometry(const std::unique_ptr<CollisionGeometry>& geom
             continue;
         }
 
-        if(!geometry->InsideGeometry(agent.pos)) {
+        if(!geometry.InsideGeometry(agent.pos)) {
             faultyAgents.push_back(agent.id);
         }
     }
@@ -377,23 +522,23 @@ void Simulation::ValidateGeometry(const std::unique_ptr<CollisionGeometry>& geom
         for(const auto& [stageId, node] : journey->Stages()) {
 
             if(auto exit = dynamic_cast<Exit*>(node.stage); exit != nullptr) {
-                if(!geometry->InsideGeometry(exit->Position().Centroid())) {
+                if(!geometry.InsideGeometry(exit->Position().Centroid())) {
                     faultyStages.push_back(stageId);
                 }
             } else if(auto waypoint = dynamic_cast<Waypoint*>(node.stage); waypoint != nullptr) {
-                if(!geometry->InsideGeometry(waypoint->Position())) {
+                if(!geometry.InsideGeometry(waypoint->Position())) {
                     faultyStages.push_back(stageId);
                 }
             } else if(auto queue = dynamic_cast<NotifiableQueue*>(node.stage); queue != nullptr) {
                 for(const auto& point : queue->Slots()) {
-                    if(!geometry->InsideGeometry(point)) {
+                    if(!geometry.InsideGeometry(point)) {
                         faultyStages.push_back(stageId);
                     }
                 }
             } else if(auto waitingset = dynamic_cast<NotifiableWaitingSet*>(node.stage);
                       waitingset != nullptr) {
                 for(const auto& point : waitingset->Slots()) {
-                    if(!geometry->InsideGeometry(point)) {
+                    if(!geometry.InsideGeometry(point)) {
                         faultyStages.push_back(stageId);
                     }
                 }
@@ -418,3 +563,282 @@ void Simulation::ValidateGeometry(const std::unique_ptr<CollisionGeometry>& geom
         throw GeometrySwitchError(message.c_str(), faultyAgents, faultyStages);
     }
 }
+
+/// "JPSSNAP" followed by a zero byte
+static constexpr uint64_t snapshotMagic = 0x0050414e5353504aULL;
+static constexpr uint32_t snapshotVersion = 2;
+
+static void writeTransition(SnapshotWriter& writer, const TransitionDescription& description)
+{
+    writer.Write(static_cast<uint8_t>(description.index()));
+    std::visit(
+        overloaded{
+            [](const NonTransitionDescription&) {},
+            [&writer](const FixedTransitionDescription& d) { writer.Write(d.NextId()); },
+            [&writer](const RoundRobinTransitionDescription& d) {
+                writer.Write(static_cast<uint64_t>(d.WeightedStages().size()));
+                for(const auto& [stageId, weight] : d.WeightedStages()) {
+                    writer.Write(stageId);
+                    writer.Write(weight);
+                }
+            },
+            [&writer](const LeastTargetedTransitionDescription& d) {
+                writer.WriteArray(d.TargetCandidates());
+            }},
+        description);
+}
+
+static TransitionDescription readTransition(SnapshotReader& reader)
+{
+    const auto index = reader.Read<uint8_t>();
+    switch(index) {
+        case 0:
+            return NonTransitionDescription{};
+        case 1:
+            return FixedTransitionDescription(reader.ReadId<BaseStage>());
+        case 2: {
+            std::vector<std::tuple<BaseStage::ID, uint64_t>> weightedStages(
+                reader.Read<uint64_t>());
+            for(auto& [stageId, weight] : weightedStages) {
+                stageId = reader.ReadId<BaseStage>();
+                weight = reader.Read<uint64_t>();
+            }
+            return RoundRobinTransitionDescription(weightedStages);
+        }
+        case 3:
+            return LeastTargetedTransitionDescription(reader.ReadIds<BaseStage>());
+        default:
+            throw SimulationError("Snapshot contains unknown transition type {}", index);
+    }
+}
+
+/// Creates a model of the alternative 'index' to dispatch on the type of the stored model data.
+template <size_t Index = 0>
+static GenericAgent::Model modelAlternative(size_t index)
+{
+    if constexpr(Index < std::variant_size_v<GenericAgent::Model>) {
+        if(index == Index) {
+            return GenericAgent::Model{std::in_place_index<Index>};
+        }
+        return modelAlternative<Index + 1>(index);
+    } else {
+        throw SimulationError("Snapshot contains unknown agent model type {}", index);
+    }
+}
+
+std::vector<std::byte> Simulation::SaveSnapshot() const
+{
+    SnapshotWriter writer{};
+    writer.Write(snapshotMagic);
+    writer.Write(snapshotVersion);
+    writer.Write(static_cast<uint8_t>(ModelType()));
+    writer.Write(_clock.dT());
+    writer.Write(GeometryFingerprint(*_geometry));
+    writer.Write(_clock.Iteration());
+
+    _stageManager.Save(writer);
+
+    writer.Write(static_cast<uint64_t>(_journeysByOrdinal.size()));
+    for(const auto journey : _journeysByOrdinal) {
+        writer.Write(journey->Id());
+        writer.Write(static_cast<uint64_t>(journey->Stages().size()));
+        for(const auto& [stageId, node] : journey->Stages()) {
+            writer.Write(stageId);
+            writeTransition(writer, node.transition->Description());
+        }
+        for(const auto& [_, node] : journey->Stages()) {
+            node.transition->SaveState(writer);
+        }
+    }
+
+    // Agents are stored as columns to read them back with a few block copies
+    const auto column = [this](auto&& field) {
+        using T = std::decay_t<decltype(field(_agents.front()))>;
+        std::vector<T> values{};
+        values.reserve(_agents.size());
+        for(const auto& agent : _agents) {
+            values.push_back(field(agent));
+        }
+        return values;
+    };
+    writer.Write(static_cast<uint64_t>(_agents.size()));
+    if(!_agents.empty()) {
+        writer.WriteArray(column([](const auto& a) { return a.id.getID(); }));
+        writer.WriteArray(column([](const auto& a) { return a.journeyId.getID(); }));
+        writer.WriteArray(column([](const auto& a) { return a.stageId.getID(); }));
+        writer.WriteArray(column([](const auto& a) { return uint64_t{a.journeyOrdinal}; }));
+        writer.WriteArray(column([](const auto& a) { return uint64_t{a.stageOrdinal}; }));
+        writer.WriteArray(column([](const auto& a) { return a.destination; }));
+        writer.WriteArray(column([](const auto& a) { return a.target; }));
+        writer.WriteArray(column([](const auto& a) { return a.pos; }));
+        writer.WriteArray(column([](const auto& a) { return a.orientation; }));
+        writer.Write(static_cast<uint8_t>(_agents.front().model.index()));
+        std::visit(
+            [&writer, &column](const auto& first) {
+                using Data = std::decay_t<decltype(first)>;
+                writer.WriteArray(column([](const auto& a) { return std::get<Data>(a.model); }));
+            },
+            _agents.front().model);
+    }
+    writer.WriteArray(_removedAgentsInLastIteration);
+
+    _stageControllerSystem.Save(writer);
+    return writer.Release();
+}
+
+void Simulation::RestoreSnapshot(std::span<const std::byte> snapshot)
+{
+    SnapshotReader reader{snapshot};
+    if(reader.Read<uint64_t>() != snapshotMagic) {
+        throw SimulationError("Data is not a simulation snapshot");
+    }
+    if(const auto version = reader.Read<uint32_t>(); version != snapshotVersion) {
+        throw SimulationError(
+            "Snapshot version {} is not supported, expected version {}", version, snapshotVersion);
+    }
+    if(reader.Read<uint8_t>() != static_cast<uint8_t>(ModelType())) {
+        throw SimulationError("Snapshot was taken with a different operational model");
+    }
+    if(const auto dT = reader.Read<double>(); dT != _clock.dT()) {
+        throw SimulationError("Snapshot was taken with time step {}, not {}", dT, _clock.dT());
+    }
+    if(reader.Read<uint64_t>() != GeometryFingerprint(*_geometry)) {
+        throw SimulationError("Snapshot was taken with a different geometry");
+    }
+    if(!_journeys.empty() || !_agents.empty()) {
+        throw SimulationError(
+            "Snapshots can only be restored into a simulation without journeys and agents");
+    }
+    const auto iteration = reader.Read<uint64_t>();
+
+    _stageManager.Restore(reader, _removedAgentsInLastIteration);
+
+    const auto journeyCount = reader.Read<uint64_t>();
+    for(uint64_t ordinal = 0; ordinal < journeyCount; ++ordinal) {
+        const auto id = reader.ReadId<Journey>();
+        std::map<BaseStage::ID, TransitionDescription> stages{};
+        const auto nodeCount = reader.Read<uint64_t>();
+        for(uint64_t node = 0; node < nodeCount; ++node) {
+            const auto stageId = reader.ReadId<BaseStage>();
+            stages.emplace(stageId, readTransition(reader));
+        }
+        auto journey = _journeys.extract(AddJourney(stages));
+        journey.key() = id;
+        journey.mapped()->id = id;
+        for(const auto& [_, node] : journey.mapped()->Stages()) {
+            node.transition->RestoreState(reader);
+        }
+        if(!_journeys.insert(std::move(journey)).inserted) {
+            throw SimulationError("Snapshot contains journey id {} twice", id);
+        }
+        Journey::ID::Reserve(id.getID());
+    }
+
+    const auto agentCount = reader.Read<uint64_t>();
+    if(agentCount > 0) {
+        const auto ids = reader.ReadIds<GenericAgent>();
+        const auto journeyIds = reader.ReadIds<Journey>();
+        const auto stageIds = reader.ReadIds<BaseStage>();
+        const auto journeyOrdinals = reader.ReadArray<uint64_t>();
+        const auto stageOrdinals = reader.ReadArray<uint64_t>();
+        const auto destinations = reader.ReadArray<Point>();
+        const auto targets = reader.ReadArray<Point>();
+        const auto positions = reader.ReadArray<Point>();
+        const auto orientations = reader.ReadArray<Point>();
+        const auto models = std::visit(
+            [&reader](const auto& prototype) {
+                const auto data = reader.ReadArray<std::decay_t<decltype(prototype)>>();
+                return std::vector<GenericAgent::Model>(std::begin(data), std::end(data));
+            },
+            modelAlternative(reader.Read<uint8_t>()));
+        for(const auto size :
+            {journeyIds.size(),
+             stageIds.size(),
+             journeyOrdinals.size(),
+             stageOrdinals.size(),
+             destinations.size(),
+             targets.size(),
+             positions.size(),
+             orientations.size(),
+             models.size()}) {
+            if(size != agentCount || ids.size() != agentCount) {
+                throw SimulationError("Snapshot contains incomplete agent data");
+            }
+        }
+        if(*std::max_element(std::begin(journeyOrdinals), std::end(journeyOrdinals)) >=
+           _journeysByOrdinal.size()) {
+            throw SimulationError("Snapshot contains agents of unknown journeys");
+        }
+        if(*std::max_element(std::begin(stageOrdinals), std::end(stageOrdinals)) >=
+           _stageManager.CountStages()) {
+            throw SimulationError("Snapshot contains agents of unknown stages");
+        }
+
+        _agents.reserve(agentCount);
+        for(size_t index = 0; index < agentCount; ++index) {
+            auto& agent = _agents.emplace_back(
+                ids[index],
+                journeyIds[index],
+                stageIds[index],
+                positions[index],
+                orientations[index],
+                models[index]);
+            agent.journeyOrdinal = journeyOrdinals[index];
+            agent.stageOrdinal = stageOrdinals[index];
+            agent.destination = destinations[index];
+            agent.target = targets[index];
+            GenericAgent::ID::Reserve(ids[index].getID());
+        }
+    }
+    _removedAgentsInLastIteration = reader.ReadIds<GenericAgent>();
+
+    _stageControllerSystem.Restore(reader, _stageManager, _journeys);
+    if(!reader.AtEnd()) {
+        throw SimulationError("Snapshot contains unexpected trailing data");
+    }
+
+    _clock.SetIteration(iteration);
+    _neighborhoodSearch.Update(_agents);
+    updateAgentMemoryStats(_memoryStats);
+}
+
+std::unique_ptr<Simulation> Simulation::Fork(std::optional<uint64_t> seed) const
+{
+    auto model = _operationalDecisionSystem.CloneModel();
+    if(seed) {
+        model->Seed(*seed);
+    }
+    auto fork = std::make_unique<Simulation>(std::move(model), Geo(), _clock.dT());
+    fork->geometries.insert(std::begin(geometries), std::end(geometries));
+    fork->RestoreSnapshot(SaveSnapshot());
+    fork->SetEventRecording(_eventLog.Enabled());
+    fork->SetRoutingAlgorithm(GetRoutingAlgorithm());
+    fork->updateGeometryMemoryStats();
+    return fork;
+}
+
+void Simulation::updateAgentMemoryStats(MemoryStats& stats) const
+{
+    stats.agents.Update(jps::memory::HeapBytes(_agents));
+    stats.neighborhoodSearch.Update(_neighborhoodSearch.MemoryFootprint());
+    stats.UpdateTotal();
+}
+
+void Simulation::updateGeometryMemoryStats()
+{
+    // The bucket array is attributed to the cache only once geometries other than the active one
+    // are kept.
+    size_t cacheBytes = geometries.size() > 1 ? geometries.bucket_count() * sizeof(void*) : 0;
+    // Geometries shared with other simulations are accounted in each of them.
+    for(const auto& [_, geometry] : geometries) {
+        if(&geometry.Collision() == _geometry) {
+            continue;
+        }
+        cacheBytes += sizeof(CollisionGeometry) + geometry.Collision().MemoryFootprint() +
+                      sizeof(RoutingEngine) + geometry.Routing()->MemoryFootprint();
+    }
+    _memoryStats.collisionGeometry.Update(sizeof(CollisionGeometry) + _geometry->MemoryFootprint());
+    _memoryStats.routingEngine.Update(sizeof(RoutingEngine) + _routingEngine->MemoryFootprint());
+    _memoryStats.geometryCache.Update(cacheBytes);
+    _memoryStats.UpdateTotal();
+}
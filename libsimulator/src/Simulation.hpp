@@ -2,16 +2,22 @@
 #pragma once
 
 #include "AgentRemovalSystem.hpp"
+#include "EventLog.hpp"
 #include "GenericAgent.hpp"
 #include "Journey.hpp"
+#include "MeasurementSystem.hpp"
+#include "MemoryStats.hpp"
 #include "NeighborhoodSearch.hpp"
 #include "OperationalDecisionSystem.hpp"
 #include "OperationalModel.hpp"
 #include "OperationalModelType.hpp"
 #include "Point.hpp"
+#include "SharedGeometry.hpp"
 #include "SimulationClock.hpp"
+#include "Snapshot.hpp"
 #include "Stage.hpp"
 #include "StageDescription.hpp"
+#include "StageControllerSystem.hpp"
 #include "StageManager.hpp"
 #include "StageSystem.hpp"
 #include "StrategicalDesicionSystem.hpp"
@@ -20,7 +26,10 @@
 
 #include <boost/iterator/zip_iterator.hpp>
 
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -33,22 +42,25 @@ class Simulation
     AgentRemovalSystem<GenericAgent> _agentRemovalSystem{};
     StageManager _stageManager{};
     StageSystem _stageSystem{};
+    StageControllerSystem _stageControllerSystem{};
+    MeasurementSystem _measurementSystem{};
     NeighborhoodSearch<GenericAgent> _neighborhoodSearch{2.2};
-    std::unordered_map<
-        CollisionGeometry::ID,
-        std::tuple<std::unique_ptr<CollisionGeometry>, std::unique_ptr<RoutingEngine>>>
-        geometries{};
-    RoutingEngine* _routingEngine;
-    CollisionGeometry* _geometry;
+    std::unordered_map<CollisionGeometry::ID, SharedGeometry> geometries{};
+    const RoutingEngine* _routingEngine;
+    const CollisionGeometry* _geometry;
     std::vector<GenericAgent> _agents;
     std::vector<GenericAgent::ID> _removedAgentsInLastIteration;
     std::unordered_map<Journey::ID, std::unique_ptr<Journey>> _journeys;
+    /// Journeys indexed by their ordinal, see 'GenericAgent::journeyOrdinal'
+    std::vector<const Journey*> _journeysByOrdinal;
     PerfStats _perfStats{};
+    MemoryStats _memoryStats{};
+    EventLog _eventLog{};
 
 public:
     Simulation(
         std::unique_ptr<OperationalModel>&& operationalModel,
-        std::unique_ptr<CollisionGeometry>&& geometry,
+        SharedGeometry geometry,
         double dT);
     Simulation(const Simulation& other) = delete;
     Simulation& operator=(const Simulation& other) = delete;
@@ -57,10 +69,59 @@ public:
     ~Simulation() = default;
     const SimulationClock& Clock() const;
     void SetTracing(bool on);
+    bool SetHardwareCounters(bool on);
     PerfStats GetLastStats() const;
+    /// Estimated heap memory per subsystem. Agent related values are sampled on each call, their
+    /// peaks are the maximum over all calls. Geometry related values are sampled whenever the
+    /// geometry changes.
+    MemoryStats GetMemoryStats();
+    /// Enables / disables recording of events. Disabling discards all unread events.
+    void SetEventRecording(bool on);
+    /// Selects the search computing the paths of all agents, see 'RoutingAlgorithm'.
+    void SetRoutingAlgorithm(RoutingAlgorithm algorithm);
+    RoutingAlgorithm GetRoutingAlgorithm() const;
+    /// Number of recorded events not read yet.
+    size_t CountEvents() const;
+    /// Moves the oldest unread events into 'buffer'.
+    /// @return number of events written to 'buffer'
+    size_t ReadEvents(std::span<SimulationEvent> buffer);
     void Iterate();
     Journey::ID AddJourney(const std::map<BaseStage::ID, TransitionDescription>& stages);
     BaseStage::ID AddStage(const StageDescription stageDescription);
+    /// Pops 'count' agents from the queue 'stageId' every 'interval' seconds, starting at
+    /// 'startTime'.
+    void AddPeriodicQueuePop(
+        BaseStage::ID stageId,
+        double interval,
+        size_t count,
+        double startTime);
+    /// Deactivates the waiting set 'stageId' once 'deactivateAt' agents are waiting and activates
+    /// it again once at most 'activateAt' agents target it, 'activateAt' needs to be less than
+    /// 'deactivateAt'.
+    void AddWaitingSetThresholds(BaseStage::ID stageId, size_t deactivateAt, size_t activateAt);
+    /// Pops 'count' agents from 'queue' between iterations, see 'NotifiableQueueProxy::Pop'.
+    void PopQueue(NotifiableQueue& queue, size_t count);
+    /// Switches all agents following journey 'from' to stage 'toStage' of journey 'to' in the first
+    /// iteration starting at or after 'time'.
+    void ScheduleJourneySwitch(
+        double time,
+        Journey::ID from,
+        Journey::ID to,
+        BaseStage::ID toStage);
+    /// Measures the number of agents per cell and their speed on a grid covering 'bounds' every
+    /// 'interval' seconds, starting with the next iteration.
+    /// @return id of the grid measurement
+    size_t AddGridMeasurement(const AABB& bounds, double cellSize, double interval);
+    /// Records all agents crossing the line segment from 'p1' to 'p2'.
+    /// @return id of the line measurement
+    size_t AddLineMeasurement(Point p1, Point p2);
+    /// Counts the agents inside 'polygon' every 'interval' seconds, starting with the next
+    /// iteration.
+    /// @return id of the area measurement
+    size_t AddAreaMeasurement(const std::vector<Point>& polygon, double interval);
+    const GridMeasurement& GetGridMeasurement(size_t id) const;
+    const LineMeasurement& GetLineMeasurement(size_t id) const;
+    const AreaMeasurement& GetAreaMeasurement(size_t id) const;
     void MarkAgentForRemoval(GenericAgent::ID id);
     const std::vector<GenericAgent::ID>& RemovedAgents() const;
     size_t AgentCount() const;
@@ -79,9 +140,26 @@ public:
     std::vector<GenericAgent>& Agents();
     OperationalModelType ModelType() const;
     StageProxy Stage(BaseStage::ID stageId);
-    CollisionGeometry Geo() const;
-    void SwitchGeometry(std::unique_ptr<CollisionGeometry>&& geometry);
+    /// Active geometry, shares its data with the simulation.
+    SharedGeometry Geo() const;
+    void SwitchGeometry(SharedGeometry geometry);
+    /// Writes the complete state of the simulation into a versioned binary snapshot. Recorded
+    /// events, statistics and the random state of the operational model are not included.
+    std::vector<std::byte> SaveSnapshot() const;
+    /// Restores a snapshot written by 'SaveSnapshot'. This simulation needs to use the same
+    /// operational model, time step and geometry and may not contain any stages, journeys or agents
+    /// yet. Stages, journeys and agents keep their ids. Throws SimulationError if the snapshot does
+    /// not match, the simulation should be discarded if the snapshot is malformed.
+    void RestoreSnapshot(std::span<const std::byte> snapshot);
+    /// Creates an independent copy of this simulation. The copy shares all geometries and routing
+    /// engines and copies the state of agents, stages, journeys and stage controllers. Recorded
+    /// events and statistics are not copied.
+    /// @param seed restarts the random number generator of the copied operational model, without a
+    /// seed the copy continues with the same random numbers as this simulation.
+    std::unique_ptr<Simulation> Fork(std::optional<uint64_t> seed = std::nullopt) const;
 
 private:
-    void ValidateGeometry(const std::unique_ptr<CollisionGeometry>& geometry) const;
+    void ValidateGeometry(const CollisionGeometry& geometry) const;
+    void updateAgentMemoryStats(MemoryStats& stats) const;
+    void updateGeometryMemoryStats();
 };
@@ -13,6 +13,9 @@ public:
 
     void Advance();
 
+    /// Continues counting at 'iteration', used when restoring snapshots.
+    void SetIteration(uint64_t iteration);
+
     double ElapsedTime() const;
 
     uint64_t Iteration() const;
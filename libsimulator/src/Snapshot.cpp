@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "Snapshot.hpp"
+
+#include "CollisionGeometry.hpp"
+
+#include <fstream>
+#include <iterator>
+
+void Fnv1a::Add(const void* data, size_t size)
+{
+    const auto bytes = static_cast<const unsigned char*>(data);
+    for(size_t index = 0; index < size; ++index) {
+        hash = (hash ^ bytes[index]) * 1099511628211ULL;
+    }
+}
+
+void Fnv1a::Add(const std::vector<Point>& points)
+{
+    const uint64_t count = points.size();
+    Add(&count, sizeof(count));
+    for(const auto& point : points) {
+        Add(&point.x, sizeof(point.x));
+        Add(&point.y, sizeof(point.y));
+    }
+}
+
+uint64_t GeometryFingerprint(const CollisionGeometry& geometry)
+{
+    const auto& [boundary, holes] = geometry.AccessibleArea();
+    Fnv1a fnv{};
+    fnv.Add(boundary);
+    for(const auto& hole : holes) {
+        fnv.Add(hole);
+    }
+    return fnv.hash;
+}
+
+std::vector<std::byte> ReadSnapshotFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file) {
+        throw SimulationError("Could not open snapshot file '{}'", path);
+    }
+    const auto size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    std::vector<std::byte> data(size);
+    if(!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size))) {
+        throw SimulationError("Could not read snapshot file '{}'", path);
+    }
+    return data;
+}
+
+void WriteSnapshotFile(const std::string& path, std::span<const std::byte> data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file) {
+        throw SimulationError("Could not open snapshot file '{}'", path);
+    }
+    if(!file.write(
+           reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+        throw SimulationError("Could not write snapshot file '{}'", path);
+    }
+}
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Point.hpp"
+#include "SimulationError.hpp"
+#include "UniqueID.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class CollisionGeometry;
+
+/// Values are written in host byte order, snapshots are not portable between architectures.
+class SnapshotWriter
+{
+    std::vector<std::byte> buffer{};
+
+public:
+    template <typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    template <typename Tag>
+    void Write(const jps::UniqueID<Tag>& id)
+    {
+        Write(id.getID());
+    }
+
+    /// Writes the element count followed by all elements in one block.
+    template <typename T>
+    void WriteArray(std::span<const T> values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write(static_cast<uint64_t>(values.size()));
+        const auto offset = buffer.size();
+        buffer.resize(offset + values.size_bytes());
+        if(!values.empty()) {
+            std::memcpy(buffer.data() + offset, values.data(), values.size_bytes());
+        }
+    }
+
+    template <typename T>
+    void WriteArray(const std::vector<T>& values)
+    {
+        WriteArray(std::span<const T>(values));
+    }
+
+    const std::vector<std::byte>& Data() const { return buffer; }
+
+    std::vector<std::byte> Release() { return std::move(buffer); }
+};
+
+/// Reads values in the order they were written by 'SnapshotWriter'. Throws SimulationError if the
+/// data ends prematurely.
+class SnapshotReader
+{
+    std::span<const std::byte> data;
+    size_t offset{0};
+
+public:
+    explicit SnapshotReader(std::span<const std::byte> data_) : data(data_) {}
+
+    template <typename T>
+    T Read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template <typename Tag>
+    jps::UniqueID<Tag> ReadId()
+    {
+        return {Read<typename jps::UniqueID<Tag>::underlying_type>()};
+    }
+
+    /// Reads an array written by 'SnapshotWriter::WriteArray'. Use 'ReadIds' for arrays of ids,
+    /// their default constructor draws a new id for each element.
+    template <typename T>
+    std::vector<T> ReadArray()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto count = Read<uint64_t>();
+        if(count > (data.size() - offset) / std::max<size_t>(sizeof(T), 1)) {
+            throw SimulationError("Snapshot is truncated");
+        }
+        std::vector<T> values(count);
+        if(count > 0) {
+            std::memcpy(values.data(), take(count * sizeof(T)), count * sizeof(T));
+        }
+        return values;
+    }
+
+    template <typename Tag>
+    std::vector<jps::UniqueID<Tag>> ReadIds()
+    {
+        const auto values = ReadArray<typename jps::UniqueID<Tag>::underlying_type>();
+        std::vector<jps::UniqueID<Tag>> ids{};
+        ids.reserve(values.size());
+        for(const auto value : values) {
+            ids.emplace_back(value);
+        }
+        return ids;
+    }
+
+    bool AtEnd() const { return offset == data.size(); }
+
+private:
+    const std::byte* take(size_t size)
+    {
+        if(data.size() - offset < size) {
+            throw SimulationError("Snapshot is truncated");
+        }
+        const auto begin = data.data() + offset;
+        offset += size;
+        return begin;
+    }
+};
+
+/// FNV-1a, stable across platforms and standard library implementations
+struct Fnv1a {
+    uint64_t hash{14695981039346656037ULL};
+
+    void Add(const void* data, size_t size);
+    /// Adds the number of points followed by their coordinates.
+    void Add(const std::vector<Point>& points);
+};
+
+/// Identifies a geometry by its walkable area. Geometry ids are only unique within a process, the
+/// fingerprint allows to check that a snapshot is restored into the geometry it was taken in.
+uint64_t GeometryFingerprint(const CollisionGeometry& geometry);
+
+std::vector<std::byte> ReadSnapshotFile(const std::string& path);
+
+void WriteSnapshotFile(const std::string& path, std::span<const std::byte> data);
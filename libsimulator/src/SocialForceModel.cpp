@@ -47,11 +47,13 @@ OperationalModelUpdate SocialForceModel::ComputeNewPosition(
         F_rep += AgentForce(ped, neighbor);
     }
     forces += F_rep / model.mass;
-    const auto& walls = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
+    const auto walls = geometry.WallsInInteractionRange(
+        ExponentialWallInteractionRange(model.obstacleScale, model.forceDistance, model.radius),
+        ped.pos);
 
     const auto obstacle_f = std::accumulate(
-        walls.cbegin(),
-        walls.cend(),
+        std::begin(walls),
+        std::end(walls),
         Point(0, 0),
         [this, &ped](const auto& acc, const auto& element) {
             return acc + ObstacleForce(ped, element);
@@ -43,7 +43,7 @@ void NotifiableQueueProxy::Pop(size_t count)
 {
     auto concreteStage = dynamic_cast<NotifiableQueue*>(stage);
     assert(stage);
-    return concreteStage->Pop(count);
+    simulation->PopQueue(*concreteStage, count);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,6 +90,18 @@ bool Waypoint::IsCompleted(const GenericAgent& agent)
     return actual_distance <= distance;
 }
 
+void Waypoint::AreCompleted(
+    std::span<const GenericAgent* const> agents,
+    std::span<uint8_t> completed)
+{
+    // Compare squared distances to avoid a sqrt per agent
+    const double distanceSquared = distance * distance;
+    for(size_t index = 0; index < agents.size(); ++index) {
+        const auto delta = agents[index]->pos - position;
+        completed[index] = delta.x * delta.x + delta.y * delta.y <= distanceSquared;
+    }
+}
+
 Point Waypoint::Target(const GenericAgent&)
 {
     return position;
@@ -100,26 +112,52 @@ StageProxy Waypoint::Proxy(Simulation* simulation)
     return WaypointProxy(simulation, this);
 }
 
+StageDescription Waypoint::Description() const
+{
+    return WaypointDescription{position, distance};
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Exit
 ////////////////////////////////////////////////////////////////////////////////
-Exit::Exit(Polygon area_, std::vector<GenericAgent::ID>& toRemove_)
-    : area(std::move(area_)), toRemove(toRemove_)
+static Polygon validateExitArea(Polygon area)
 {
     if(!area.IsConvex()) {
         throw SimulationError("Exit areas need to be bounded by convex polygons.");
     }
+    return area;
+}
+
+Exit::Exit(Polygon area_, std::vector<GenericAgent::ID>& toRemove_)
+    : area(validateExitArea(std::move(area_))), convexArea(area), toRemove(toRemove_)
+{
 }
 
 bool Exit::IsCompleted(const GenericAgent& agent)
 {
-    const bool hasReachedExit = area.IsInside(agent.pos);
+    const bool hasReachedExit = convexArea.Contains(agent.pos);
     if(hasReachedExit) {
         toRemove.push_back(agent.id);
     }
     return hasReachedExit;
 }
 
+void Exit::AreCompleted(std::span<const GenericAgent* const> agents, std::span<uint8_t> completed)
+{
+    xs.resize(agents.size());
+    ys.resize(agents.size());
+    for(size_t index = 0; index < agents.size(); ++index) {
+        xs[index] = agents[index]->pos.x;
+        ys[index] = agents[index]->pos.y;
+    }
+    convexArea.Contains(xs, ys, completed);
+    for(size_t index = 0; index < agents.size(); ++index) {
+        if(completed[index] != 0) {
+            toRemove.push_back(agents[index]->id);
+        }
+    }
+}
+
 Point Exit::Target(const GenericAgent&)
 {
     return area.Centroid();
@@ -130,6 +168,11 @@ StageProxy Exit::Proxy(Simulation* simulation)
     return ExitProxy(simulation, this);
 }
 
+StageDescription Exit::Description() const
+{
+    return ExitDescription{area};
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// NotifiableWaitingSet
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,8 +186,7 @@ bool NotifiableWaitingSet::IsCompleted(const GenericAgent& agent)
     if(state == WaitingSetState::Active) {
         return false;
     }
-    const auto find_iter = std::find(std::begin(occupants), std::end(occupants), agent.id);
-    if(find_iter != std::end(occupants)) {
+    if(occupantSlots.contains(agent.id)) {
         return true;
     }
     const auto distance = (agent.pos - slots[0]).Norm();
@@ -157,14 +199,11 @@ Point NotifiableWaitingSet::Target(const GenericAgent& agent)
         return slots[0];
     }
 
-    const auto next_slot_index = std::min(occupants.size(), slots.size() - 1);
-
-    for(size_t index = 0; index < next_slot_index; ++index) {
-        if(agent.id == occupants[index]) {
-            return slots[index];
-        }
+    if(const auto iter = occupantSlots.find(agent.id); iter != std::end(occupantSlots)) {
+        return slots[iter->second];
     }
 
+    const auto next_slot_index = std::min(occupants.size(), slots.size() - 1);
     return slots[next_slot_index];
 }
 
@@ -175,6 +214,8 @@ void NotifiableWaitingSet::State(WaitingSetState s)
     }
     if(s == WaitingSetState::Active) {
         occupants.clear();
+        occupantSlots.clear();
+        assignedTargeting = 0;
     }
     state = s;
 }
@@ -184,11 +225,57 @@ WaitingSetState NotifiableWaitingSet::State() const
     return state;
 }
 
+void NotifiableWaitingSet::IncreaseTargeting(GenericAgent::ID agent)
+{
+    BaseStage::IncreaseTargeting(agent);
+    if(occupantSlots.contains(agent)) {
+        ++assignedTargeting;
+    }
+}
+
+void NotifiableWaitingSet::DecreaseTargeting(GenericAgent::ID agent)
+{
+    BaseStage::DecreaseTargeting(agent);
+    if(occupantSlots.contains(agent)) {
+        assert(assignedTargeting >= 1);
+        --assignedTargeting;
+    }
+}
+
+bool NotifiableWaitingSet::HasUnassignedAgents() const
+{
+    return state == WaitingSetState::Active && occupants.size() < slots.size() &&
+           targeting > assignedTargeting;
+}
+
 StageProxy NotifiableWaitingSet::Proxy(Simulation* simulation)
 {
     return NotifiableWaitingSetProxy(simulation, this);
 }
 
+StageDescription NotifiableWaitingSet::Description() const
+{
+    return NotifiableWaitingSetDescription{slots};
+}
+
+void NotifiableWaitingSet::SaveState(SnapshotWriter& writer) const
+{
+    writer.Write(static_cast<uint8_t>(state));
+    writer.Write(static_cast<uint64_t>(assignedTargeting));
+    writer.WriteArray(occupants);
+}
+
+void NotifiableWaitingSet::RestoreState(SnapshotReader& reader)
+{
+    state = static_cast<WaitingSetState>(reader.Read<uint8_t>());
+    assignedTargeting = reader.Read<uint64_t>();
+    occupants = reader.ReadIds<GenericAgent>();
+    occupantSlots.clear();
+    for(size_t slot = 0; slot < occupants.size(); ++slot) {
+        occupantSlots.emplace(occupants[slot], slot);
+    }
+}
+
 const std::vector<GenericAgent::ID>& NotifiableWaitingSet::Occupants() const
 {
     return occupants;
@@ -199,6 +286,7 @@ const std::vector<GenericAgent::ID>& NotifiableWaitingSet::Occupants() const
 ////////////////////////////////////////////////////////////////////////////////
 NotifiableQueue::NotifiableQueue(std::vector<Point> slots_) : slots(std::move(slots_))
 {
+    occupants.reserve(slots.size());
 }
 
 bool NotifiableQueue::IsCompleted(const GenericAgent& agent)
@@ -206,37 +294,94 @@ bool NotifiableQueue::IsCompleted(const GenericAgent& agent)
     const bool completed = exitingThisUpdate.contains(agent.id);
     if(completed) {
         exitingThisUpdate.erase(agent.id);
+        // The agent still targets this stage until it migrates to its next stage.
+        assert(assignedTargeting >= 1);
+        --assignedTargeting;
     }
     return completed;
 }
 
 Point NotifiableQueue::Target(const GenericAgent& agent)
 {
-
-    if(const auto index_opt = IndexInContainer(occupants, agent.id); index_opt) {
-        return slots[*index_opt];
+    if(const auto iter = occupantSlots.find(agent.id); iter != std::end(occupantSlots)) {
+        return slots[iter->second - popped];
     }
 
     const auto next_target_index = std::min(occupants.size(), slots.size() - 1);
     return slots[next_target_index];
 }
 
-void NotifiableQueue::Pop(size_t count)
+void NotifiableQueue::Pop(size_t count, EventLog& eventLog)
 {
     for(size_t counter = 0; counter < count; ++counter) {
         if(occupants.empty()) {
             return;
         }
         exitingThisUpdate.insert(occupants.front());
+        eventLog.Push(SimulationEventType::QueuePopped, occupants.front(), id);
+        occupantSlots.erase(occupants.front());
         occupants.erase(std::begin(occupants));
+        ++popped;
+    }
+}
+
+void NotifiableQueue::IncreaseTargeting(GenericAgent::ID agent)
+{
+    BaseStage::IncreaseTargeting(agent);
+    if(occupantSlots.contains(agent) || exitingThisUpdate.contains(agent)) {
+        ++assignedTargeting;
     }
 }
 
+void NotifiableQueue::DecreaseTargeting(GenericAgent::ID agent)
+{
+    BaseStage::DecreaseTargeting(agent);
+    if(occupantSlots.contains(agent) || exitingThisUpdate.contains(agent)) {
+        assert(assignedTargeting >= 1);
+        --assignedTargeting;
+    }
+}
+
+bool NotifiableQueue::HasUnassignedAgents() const
+{
+    return occupants.size() < slots.size() && targeting > assignedTargeting;
+}
+
 StageProxy NotifiableQueue::Proxy(Simulation* simulation)
 {
     return NotifiableQueueProxy(simulation, this);
 }
 
+StageDescription NotifiableQueue::Description() const
+{
+    return NotifiableQueueDescription{slots};
+}
+
+void NotifiableQueue::SaveState(SnapshotWriter& writer) const
+{
+    writer.Write(static_cast<uint64_t>(popped));
+    writer.Write(static_cast<uint64_t>(assignedTargeting));
+    writer.WriteArray(occupants);
+    // Sorted to write the same snapshot for the same state
+    std::vector<GenericAgent::ID> exiting(
+        std::begin(exitingThisUpdate), std::end(exitingThisUpdate));
+    std::sort(std::begin(exiting), std::end(exiting));
+    writer.WriteArray(exiting);
+}
+
+void NotifiableQueue::RestoreState(SnapshotReader& reader)
+{
+    popped = reader.Read<uint64_t>();
+    assignedTargeting = reader.Read<uint64_t>();
+    occupants = reader.ReadIds<GenericAgent>();
+    occupantSlots.clear();
+    for(size_t index = 0; index < occupants.size(); ++index) {
+        occupantSlots.emplace(occupants[index], popped + index);
+    }
+    const auto exiting = reader.ReadIds<GenericAgent>();
+    exitingThisUpdate = {std::begin(exiting), std::end(exiting)};
+}
+
 const std::vector<GenericAgent::ID>& NotifiableQueue::Occupants() const
 {
     return occupants;
@@ -2,18 +2,25 @@
 #pragma once
 
 #include "CollisionGeometry.hpp"
+#include "ConvexArea.hpp"
+#include "EventLog.hpp"
 #include "GenericAgent.hpp"
 #include "GeometricFunctions.hpp"
 #include "Logger.hpp"
 #include "NeighborhoodSearch.hpp"
 #include "Point.hpp"
 #include "Polygon.hpp"
+#include "Snapshot.hpp"
+#include "StageDescription.hpp"
 #include "UniqueID.hpp"
 #include "Util.hpp"
 
 #include <algorithm>
 #include <iterator>
 #include <limits>
+#include <optional>
+#include <span>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -101,17 +108,38 @@ public:
 
 protected:
     ID id;
+    /// Dense index of this stage in its StageManager
+    size_t ordinal{0};
     size_t targeting{0};
 
+    friend class StageManager;
+
 public:
     virtual ~BaseStage() = default;
     virtual bool IsCompleted(const GenericAgent& agent) = 0;
+    /// Evaluates 'IsCompleted' for all agents at once.
+    /// @param agents to test, all targeting this stage
+    /// @param completed receives 1 for each completed agent and 0 otherwise, same size as 'agents'
+    virtual void
+    AreCompleted(std::span<const GenericAgent* const> agents, std::span<uint8_t> completed)
+    {
+        for(size_t index = 0; index < agents.size(); ++index) {
+            completed[index] = IsCompleted(*agents[index]);
+        }
+    }
     virtual Point Target(const GenericAgent& agent) = 0;
     virtual StageProxy Proxy(Simulation* simulation_) = 0;
+    /// Description this stage can be recreated from.
+    virtual StageDescription Description() const = 0;
+    /// Writes the state this stage accumulated while simulating, see 'StageManager::Save'.
+    virtual void SaveState(SnapshotWriter&) const {}
+    /// Restores the state written by 'SaveState' into a stage created from 'Description'.
+    virtual void RestoreState(SnapshotReader&) {}
     ID Id() const { return id; }
+    size_t Ordinal() const { return ordinal; }
     size_t CountTargeting() const { return targeting; }
-    void IncreaseTargeting() { targeting = targeting + 1; }
-    void DecreaseTargeting()
+    virtual void IncreaseTargeting(GenericAgent::ID) { targeting = targeting + 1; }
+    virtual void DecreaseTargeting(GenericAgent::ID)
     {
         assert(targeting >= 1);
         targeting = targeting - 1;
@@ -139,8 +167,11 @@ public:
     Waypoint(Point position_, double distance_);
     ~Waypoint() override = default;
     bool IsCompleted(const GenericAgent& agent) override;
+    void AreCompleted(std::span<const GenericAgent* const> agents, std::span<uint8_t> completed)
+        override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    StageDescription Description() const override;
     Point Position() const { return position; };
 };
 
@@ -148,21 +179,88 @@ public:
 class Exit : public BaseStage
 {
     Polygon area;
+    ConvexArea convexArea;
     std::vector<GenericAgent::ID>& toRemove;
+    /// Scratch buffers for 'AreCompleted'
+    std::vector<double> xs{};
+    std::vector<double> ys{};
 
 public:
     Exit(Polygon area, std::vector<GenericAgent::ID>& toRemove_);
     ~Exit() override = default;
     bool IsCompleted(const GenericAgent& agent) override;
+    void AreCompleted(std::span<const GenericAgent* const> agents, std::span<uint8_t> completed)
+        override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    StageDescription Description() const override;
     Polygon Position() const { return area; };
 };
 
+/// Assigns agents to the free slots starting at 'firstFreeSlot' in order. Each slot is given to the
+/// closest agent within 2m that has line of sight to the slot and is accepted by 'isCandidate'.
+/// Stops at the first slot no agent can be assigned to. Neighbors are queried once for all
+/// consecutive slots that are within 2m of the slot the query was made for.
+template <typename T, typename IsCandidate, typename Assign>
+void AssignSlots(
+    const std::vector<Point>& slots,
+    size_t firstFreeSlot,
+    const NeighborhoodSearch<T>& neighborhoodSearch,
+    const CollisionGeometry& geometry,
+    IsCandidate&& isCandidate,
+    Assign&& assign)
+{
+    constexpr double slotRange = 2;
+    std::vector<T> candidates{};
+    std::optional<Point> queryCenter{};
+
+    for(size_t index = firstFreeSlot; index < slots.size(); ++index) {
+        const auto slot_pos = slots[index];
+        if(!queryCenter || (slot_pos - *queryCenter).Norm() > slotRange) {
+            queryCenter = slot_pos;
+            candidates = neighborhoodSearch.GetNeighboringAgents(slot_pos, 2 * slotRange);
+            candidates.erase(
+                std::remove_if(
+                    std::begin(candidates),
+                    std::end(candidates),
+                    [&isCandidate](const auto& agent) { return !isCandidate(agent); }),
+                std::end(candidates));
+        }
+
+        const auto& boundary = geometry.LineSegmentsInApproxDistanceTo(slot_pos);
+        auto occupant = std::end(candidates);
+        double min_distance = std::numeric_limits<double>::max();
+        for(auto iter = std::begin(candidates); iter != std::end(candidates); ++iter) {
+            const auto distance = (iter->pos - slot_pos).Norm();
+            if(distance > slotRange || distance >= min_distance) {
+                continue;
+            }
+            const auto slot_to_agent = LineSegment(slot_pos, iter->pos);
+            const bool hasLineOfSight = std::none_of(
+                boundary.cbegin(), boundary.cend(), [&slot_to_agent](const auto& boundary_segment) {
+                    return intersects(slot_to_agent, boundary_segment);
+                });
+            if(hasLineOfSight) {
+                min_distance = distance;
+                occupant = iter;
+            }
+        }
+        if(occupant == std::end(candidates)) {
+            return;
+        }
+        assign(occupant->id);
+        candidates.erase(occupant);
+    }
+}
+
 class NotifiableWaitingSet : public BaseStage
 {
     std::vector<Point> slots;
     std::vector<GenericAgent::ID> occupants{};
+    /// Slot index of each occupant
+    std::unordered_map<GenericAgent::ID, size_t> occupantSlots{};
+    /// Number of targeting agents that occupy a slot
+    size_t assignedTargeting{0};
     WaitingSetState state{WaitingSetState::Active};
 
 public:
@@ -171,8 +269,16 @@ public:
     bool IsCompleted(const GenericAgent& agent) override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    StageDescription Description() const override;
+    void SaveState(SnapshotWriter& writer) const override;
+    void RestoreState(SnapshotReader& reader) override;
+    void IncreaseTargeting(GenericAgent::ID agent) override;
+    void DecreaseTargeting(GenericAgent::ID agent) override;
     void State(WaitingSetState s);
     WaitingSetState State() const;
+    /// @return true if agents target this stage that have not been assigned a slot yet and a slot
+    /// is available for them.
+    bool HasUnassignedAgents() const;
     template <typename T>
     void Update(const NeighborhoodSearch<T>& neighborhoodSearch, const CollisionGeometry& geometry);
     const std::vector<GenericAgent::ID>& Occupants() const;
@@ -187,54 +293,23 @@ void NotifiableWaitingSet::Update(
     if(state == WaitingSetState::Inactive) {
         return;
     }
-    const auto count_occupants = occupants.size();
-    if(count_occupants == slots.size()) {
+    if(occupants.size() == slots.size()) {
         return;
     }
 
-    for(size_t index = count_occupants; index < slots.size(); ++index) {
-        const auto slot_pos = slots[index];
-        const auto& boundary = geometry.LineSegmentsInApproxDistanceTo(slot_pos);
-        auto candidates = neighborhoodSearch.GetNeighboringAgents(slot_pos, 2);
-        candidates.erase(
-            std::remove_if(
-                std::begin(candidates),
-                std::end(candidates),
-                [&slot_pos, &boundary](const auto& neighbor) {
-                    const auto agent_to_neighbor = LineSegment(slot_pos, neighbor.pos);
-                    if(std::find_if(
-                           boundary.cbegin(),
-                           boundary.cend(),
-                           [&agent_to_neighbor](const auto& boundary_segment) {
-                               return intersects(agent_to_neighbor, boundary_segment);
-                           }) != boundary.end()) {
-                        return true;
-                    }
-
-                    return false;
-                }),
-            std::end(candidates));
-
-        GenericAgent::ID occupant = GenericAgent::ID::Invalid;
-        double min_distance = std::numeric_limits<double>::max();
-        for(const auto& agent : candidates) {
-            if(agent.stageId == id) {
-                if(std::find(std::begin(occupants), std::end(occupants), agent.id) ==
-                   std::end(occupants)) {
-                    const auto distance = (agent.pos - slots[index]).Norm();
-                    if(distance < min_distance) {
-                        min_distance = distance;
-                        occupant = agent.id;
-                    }
-                }
-            }
-        }
-        if(occupant != GenericAgent::ID::Invalid) {
+    AssignSlots(
+        slots,
+        occupants.size(),
+        neighborhoodSearch,
+        geometry,
+        [this](const auto& agent) {
+            return agent.stageId == id && !occupantSlots.contains(agent.id);
+        },
+        [this](GenericAgent::ID occupant) {
+            occupantSlots.emplace(occupant, occupants.size());
             occupants.push_back(occupant);
-        } else {
-            return;
-        }
-    }
+            ++assignedTargeting;
+        });
 }
 
 class NotifiableQueue : public BaseStage
@@ -243,7 +318,13 @@ class NotifiableQueue : public BaseStage
 private:
     std::vector<Point> slots;
     std::vector<GenericAgent::ID> occupants{};
-    std::set<GenericAgent::ID> exitingThisUpdate{};
+    /// Position in the queue of each occupant, counted from creation of the queue. Subtract
+    /// 'popped' to get the slot index.
+    std::unordered_map<GenericAgent::ID, size_t> occupantSlots{};
+    size_t popped{0};
+    std::unordered_set<GenericAgent::ID> exitingThisUpdate{};
+    /// Number of targeting agents that occupy a slot or are exiting
+    size_t assignedTargeting{0};
 
 public:
     NotifiableQueue(std::vector<Point> slots_);
@@ -251,9 +332,18 @@ public:
     bool IsCompleted(const GenericAgent& agent) override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    StageDescription Description() const override;
+    void SaveState(SnapshotWriter& writer) const override;
+    void RestoreState(SnapshotReader& reader) override;
+    void IncreaseTargeting(GenericAgent::ID agent) override;
+    void DecreaseTargeting(GenericAgent::ID agent) override;
+    /// @return true if agents target this stage that have not been assigned a slot yet and a slot
+    /// is available for them.
+    bool HasUnassignedAgents() const;
     template <typename T>
     void Update(const NeighborhoodSearch<T>& neighborhoodSearch, const CollisionGeometry& geometry);
-    void Pop(size_t count);
+    /// Releases the first 'count' occupants and records a 'QueuePopped' event for each.
+    void Pop(size_t count, EventLog& eventLog);
     const std::vector<GenericAgent::ID>& Occupants() const;
     const std::vector<Point>& Slots() const { return slots; };
 };
@@ -263,53 +353,24 @@ void NotifiableQueue::Update(
     const NeighborhoodSearch<T>& neighborhoodSearch,
     const CollisionGeometry& geometry)
 {
-    const auto count_occupants = occupants.size();
-    if(count_occupants == slots.size()) {
+    if(occupants.size() == slots.size()) {
         return;
     }
 
-    for(size_t index = count_occupants; index < slots.size(); ++index) {
-        const auto slot_pos = slots[index];
-        const auto& boundary = geometry.LineSegmentsInApproxDistanceTo(slot_pos);
-        auto candidates = neighborhoodSearch.GetNeighboringAgents(slot_pos, 2);
-        candidates.erase(
-            std::remove_if(
-                std::begin(candidates),
-                std::end(candidates),
-                [&slot_pos, &boundary](const auto& neighbor) {
-                    const auto agent_to_neighbor = LineSegment(slot_pos, neighbor.pos);
-                    if(std::find_if(
-                           boundary.cbegin(),
-                           boundary.cend(),
-                           [&agent_to_neighbor](const auto& boundary_segment) {
-                               return intersects(agent_to_neighbor, boundary_segment);
-                           }) != boundary.end()) {
-                        return true;
-                    }
-
-                    return false;
-                }),
-            std::end(candidates));
-
-        GenericAgent::ID occupant = GenericAgent::ID::Invalid;
-        double min_distance = std::numeric_limits<double>::max();
-        for(const auto& agent : candidates) {
-            if(agent.stageId != id || Contains(occupants, agent.id) ||
-               exitingThisUpdate.contains(agent.id)) {
-                continue;
-            }
-            const auto distance = (agent.pos - slots[index]).Norm();
-            if(distance < min_distance) {
-                min_distance = distance;
-                occupant = agent.id;
-            }
-        }
-        if(occupant != GenericAgent::ID::Invalid) {
-            occupants.emplace_back(occupant);
-        } else {
-            return;
-        }
-    }
+    AssignSlots(
+        slots,
+        occupants.size(),
+        neighborhoodSearch,
+        geometry,
+        [this](const auto& agent) {
+            return agent.stageId == id && !occupantSlots.contains(agent.id) &&
+                   !exitingThisUpdate.contains(agent.id);
+        },
+        [this](GenericAgent::ID occupant) {
+            occupantSlots.emplace(occupant, popped + occupants.size());
+            occupants.push_back(occupant);
+            ++assignedTargeting;
+        });
 }
 
 class DirectSteering : public BaseStage
@@ -323,4 +384,5 @@ public:
     {
         return DirectSteeringProxy(simulation, this);
     };
+    StageDescription Description() const override { return DirectSteeringDescription{}; }
 };
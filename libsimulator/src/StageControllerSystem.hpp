@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "EventLog.hpp"
+#include "GenericAgent.hpp"
+#include "Journey.hpp"
+#include "Snapshot.hpp"
+#include "Stage.hpp"
+#include "StageManager.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/// Pops 'count' agents from 'queue' every 'interval' seconds, pops falling due within the same
+/// iteration are combined.
+struct PeriodicQueuePop {
+    NotifiableQueue* queue;
+    double interval;
+    size_t count;
+    double nextTime;
+};
+
+/// Deactivates 'waitingSet' once 'deactivateAt' agents are waiting and activates it again once at
+/// most 'activateAt' agents target it.
+struct WaitingSetThresholds {
+    NotifiableWaitingSet* waitingSet;
+    size_t deactivateAt;
+    size_t activateAt;
+};
+
+/// Switches all agents following journey 'from' to stage 'toStage' of journey 'to' at 'time'.
+struct ScheduledJourneySwitch {
+    double time;
+    Journey::ID from;
+    const Journey* to;
+    BaseStage* toStage;
+};
+
+/// Applies rules to stages that would otherwise need to be driven from outside the simulation
+/// between iterations, e.g. serving a queue at a fixed rate.
+class StageControllerSystem
+{
+    /// Compensates the accumulated rounding error of the elapsed time when comparing to scheduled
+    /// times.
+    static constexpr double timeTolerance = 1e-9;
+
+    std::vector<PeriodicQueuePop> queuePops{};
+    std::vector<WaitingSetThresholds> waitingSetThresholds{};
+    /// Ordered by time
+    std::vector<ScheduledJourneySwitch> journeySwitches{};
+
+public:
+    StageControllerSystem() = default;
+    ~StageControllerSystem() = default;
+    StageControllerSystem(const StageControllerSystem& other) = delete;
+    StageControllerSystem& operator=(const StageControllerSystem& other) = delete;
+    StageControllerSystem(StageControllerSystem&& other) = delete;
+    StageControllerSystem& operator=(StageControllerSystem&& other) = delete;
+
+    void Add(PeriodicQueuePop pop) { queuePops.push_back(pop); }
+
+    void Add(WaitingSetThresholds thresholds) { waitingSetThresholds.push_back(thresholds); }
+
+    void Add(ScheduledJourneySwitch journeySwitch)
+    {
+        const auto iter = std::upper_bound(
+            std::begin(journeySwitches),
+            std::end(journeySwitches),
+            journeySwitch.time,
+            [](double time, const auto& other) { return time < other.time; });
+        journeySwitches.insert(iter, journeySwitch);
+    }
+
+    void
+    Run(double time,
+        std::vector<GenericAgent>& agents,
+        StageManager& stageManager,
+        EventLog& eventLog)
+    {
+        for(auto& pop : queuePops) {
+            // Intervals shorter than the time step fall due several times per iteration
+            size_t due = 0;
+            while(time + timeTolerance >= pop.nextTime) {
+                ++due;
+                pop.nextTime += pop.interval;
+            }
+            if(due > 0) {
+                pop.queue->Pop(due * pop.count, eventLog);
+            }
+        }
+
+        for(const auto& thresholds : waitingSetThresholds) {
+            auto waitingSet = thresholds.waitingSet;
+            if(waitingSet->State() == WaitingSetState::Active) {
+                if(waitingSet->Occupants().size() >= thresholds.deactivateAt) {
+                    waitingSet->State(WaitingSetState::Inactive);
+                }
+            } else if(waitingSet->CountTargeting() <= thresholds.activateAt) {
+                waitingSet->State(WaitingSetState::Active);
+            }
+        }
+
+        const auto due = std::find_if(
+            std::begin(journeySwitches), std::end(journeySwitches), [time](const auto& s) {
+                return time + timeTolerance < s.time;
+            });
+        for(auto iter = std::begin(journeySwitches); iter != due; ++iter) {
+            switchJourney(*iter, agents, stageManager, eventLog);
+        }
+        journeySwitches.erase(std::begin(journeySwitches), due);
+    }
+
+    /// Writes all rules including their progress, stages and journeys are referenced by id.
+    void Save(SnapshotWriter& writer) const
+    {
+        writer.Write(static_cast<uint64_t>(queuePops.size()));
+        for(const auto& pop : queuePops) {
+            writer.Write(pop.queue->Id());
+            writer.Write(pop.interval);
+            writer.Write(static_cast<uint64_t>(pop.count));
+            writer.Write(pop.nextTime);
+        }
+        writer.Write(static_cast<uint64_t>(waitingSetThresholds.size()));
+        for(const auto& thresholds : waitingSetThresholds) {
+            writer.Write(thresholds.waitingSet->Id());
+            writer.Write(static_cast<uint64_t>(thresholds.deactivateAt));
+            writer.Write(static_cast<uint64_t>(thresholds.activateAt));
+        }
+        writer.Write(static_cast<uint64_t>(journeySwitches.size()));
+        for(const auto& journeySwitch : journeySwitches) {
+            writer.Write(journeySwitch.time);
+            writer.Write(journeySwitch.from);
+            writer.Write(journeySwitch.to->Id());
+            writer.Write(journeySwitch.toStage->Id());
+        }
+    }
+
+    /// Restores the rules written by 'Save', replacing all existing rules.
+    void Restore(
+        SnapshotReader& reader,
+        const StageManager& stageManager,
+        const std::unordered_map<Journey::ID, std::unique_ptr<Journey>>& journeys)
+    {
+        queuePops.resize(reader.Read<uint64_t>());
+        for(auto& pop : queuePops) {
+            pop.queue = stageAs<NotifiableQueue>(stageManager, reader.ReadId<BaseStage>());
+            pop.interval = reader.Read<double>();
+            pop.count = reader.Read<uint64_t>();
+            pop.nextTime = reader.Read<double>();
+        }
+        waitingSetThresholds.resize(reader.Read<uint64_t>());
+        for(auto& thresholds : waitingSetThresholds) {
+            thresholds.waitingSet =
+                stageAs<NotifiableWaitingSet>(stageManager, reader.ReadId<BaseStage>());
+            thresholds.deactivateAt = reader.Read<uint64_t>();
+            thresholds.activateAt = reader.Read<uint64_t>();
+        }
+        journeySwitches.resize(reader.Read<uint64_t>());
+        for(auto& journeySwitch : journeySwitches) {
+            journeySwitch.time = reader.Read<double>();
+            journeySwitch.from = reader.ReadId<Journey>();
+            const auto to = journeys.find(reader.ReadId<Journey>());
+            if(to == std::end(journeys)) {
+                throw SimulationError("Snapshot references an unknown journey");
+            }
+            journeySwitch.to = to->second.get();
+            journeySwitch.toStage = stageManager.Stage(reader.ReadId<BaseStage>());
+        }
+    }
+
+private:
+    template <typename StageType>
+    static StageType* stageAs(const StageManager& stageManager, BaseStage::ID id)
+    {
+        auto stage = dynamic_cast<StageType*>(stageManager.Stage(id));
+        if(stage == nullptr) {
+            throw SimulationError("Snapshot references stage {} with a different type", id);
+        }
+        return stage;
+    }
+
+    static void switchJourney(
+        const ScheduledJourneySwitch& journeySwitch,
+        std::vector<GenericAgent>& agents,
+        StageManager& stageManager,
+        EventLog& eventLog)
+    {
+        for(auto& agent : agents) {
+            if(agent.journeyId != journeySwitch.from) {
+                continue;
+            }
+            stageManager.MigrateAgent(
+                agent.id, *stageManager.StageByOrdinal(agent.stageOrdinal), *journeySwitch.toStage);
+            if(agent.stageId != journeySwitch.toStage->Id()) {
+                eventLog.Push(
+                    SimulationEventType::StageChanged,
+                    agent.id,
+                    journeySwitch.toStage->Id(),
+                    agent.stageId);
+            }
+            agent.journeyId = journeySwitch.to->Id();
+            agent.journeyOrdinal = journeySwitch.to->Ordinal();
+            agent.stageId = journeySwitch.toStage->Id();
+            agent.stageOrdinal = journeySwitch.toStage->Ordinal();
+        }
+    }
+};
@@ -1 +1,78 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
+#include "StageManager.hpp"
+
+#include "Visitor.hpp"
+
+#include <cstdint>
+#include <variant>
+
+static void writeDescription(SnapshotWriter& writer, const StageDescription& description)
+{
+    writer.Write(static_cast<uint8_t>(description.index()));
+    std::visit(
+        overloaded{
+            [](const DirectSteeringDescription&) {},
+            [&writer](const WaypointDescription& d) {
+                writer.Write(d.position);
+                writer.Write(d.distance);
+            },
+            [&writer](const ExitDescription& d) { writer.WriteArray(d.polygon.Points()); },
+            [&writer](const NotifiableWaitingSetDescription& d) { writer.WriteArray(d.slots); },
+            [&writer](const NotifiableQueueDescription& d) { writer.WriteArray(d.slots); }},
+        description);
+}
+
+static StageDescription readDescription(SnapshotReader& reader)
+{
+    const auto index = reader.Read<uint8_t>();
+    switch(index) {
+        case 0:
+            return DirectSteeringDescription{};
+        case 1: {
+            const auto position = reader.Read<Point>();
+            return WaypointDescription{position, reader.Read<double>()};
+        }
+        case 2:
+            return ExitDescription{Polygon(reader.ReadArray<Point>())};
+        case 3:
+            return NotifiableWaitingSetDescription{reader.ReadArray<Point>()};
+        case 4:
+            return NotifiableQueueDescription{reader.ReadArray<Point>()};
+        default:
+            throw SimulationError("Snapshot contains unknown stage type {}", index);
+    }
+}
+
+void StageManager::Save(SnapshotWriter& writer) const
+{
+    writer.Write(static_cast<uint64_t>(stagesByOrdinal.size()));
+    for(const auto stage : stagesByOrdinal) {
+        writer.Write(stage->Id());
+        writeDescription(writer, stage->Description());
+        writer.Write(static_cast<uint64_t>(stage->targeting));
+        stage->SaveState(writer);
+    }
+}
+
+void StageManager::Restore(
+    SnapshotReader& reader,
+    std::vector<GenericAgent::ID>& removedAgentsInLastIteration)
+{
+    if(!stages.empty()) {
+        throw SimulationError("Snapshots can only be restored into a simulation without stages");
+    }
+    const auto count = reader.Read<uint64_t>();
+    for(uint64_t ordinal = 0; ordinal < count; ++ordinal) {
+        const auto id = reader.ReadId<BaseStage>();
+        const auto createdId = AddStage(readDescription(reader), removedAgentsInLastIteration);
+        auto node = stages.extract(createdId);
+        node.key() = id;
+        node.mapped()->id = id;
+        node.mapped()->targeting = reader.Read<uint64_t>();
+        node.mapped()->RestoreState(reader);
+        if(!stages.insert(std::move(node)).inserted) {
+            throw SimulationError("Snapshot contains stage id {} twice", id);
+        }
+        BaseStage::ID::Reserve(id.getID());
+    }
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "Snapshot.hpp"
 #include "Stage.hpp"
 #include "StageDescription.hpp"
 #include "Visitor.hpp"
@@ -10,6 +11,11 @@ class StageManager
 {
 private:
     std::unordered_map<BaseStage::ID, std::unique_ptr<BaseStage>> stages;
+    /// All stages indexed by their ordinal
+    std::vector<BaseStage*> stagesByOrdinal{};
+    /// Stages that need to be updated each iteration, typed on creation
+    std::vector<NotifiableWaitingSet*> waitingSets{};
+    std::vector<NotifiableQueue*> queues{};
 
 public:
     StageManager() {}
@@ -32,11 +38,15 @@ public:
                     const ExitDescription& d) -> std::unique_ptr<BaseStage> {
                     return std::make_unique<Exit>(d.polygon, removedAgentsInLastIteration);
                 },
-                [](const NotifiableWaitingSetDescription& d) -> std::unique_ptr<BaseStage> {
-                    return std::make_unique<NotifiableWaitingSet>(d.slots);
+                [this](const NotifiableWaitingSetDescription& d) -> std::unique_ptr<BaseStage> {
+                    auto waitingSet = std::make_unique<NotifiableWaitingSet>(d.slots);
+                    waitingSets.push_back(waitingSet.get());
+                    return waitingSet;
                 },
-                [](const NotifiableQueueDescription& d) -> std::unique_ptr<BaseStage> {
-                    return std::make_unique<NotifiableQueue>(d.slots);
+                [this](const NotifiableQueueDescription& d) -> std::unique_ptr<BaseStage> {
+                    auto queue = std::make_unique<NotifiableQueue>(d.slots);
+                    queues.push_back(queue.get());
+                    return queue;
                 },
                 [](const DirectSteeringDescription&) -> std::unique_ptr<BaseStage> {
                     return std::make_unique<DirectSteering>();
@@ -46,19 +56,33 @@ public:
             throw SimulationError("Internal error, stage id already in use.");
         }
         const auto id = stage->Id();
+        stage->ordinal = stagesByOrdinal.size();
+        stagesByOrdinal.push_back(stage.get());
         stages.emplace(id, std::move(stage));
 
         return id;
     }
 
-    void MigrateAgent(BaseStage::ID prevTarget, BaseStage::ID newTarget)
+    void MigrateAgent(GenericAgent::ID agent, BaseStage::ID prevTarget, BaseStage::ID newTarget)
     {
-        stages.at(newTarget)->IncreaseTargeting();
-        stages.at(prevTarget)->DecreaseTargeting();
+        MigrateAgent(agent, *stages.at(prevTarget), *stages.at(newTarget));
     }
 
-    void HandleNewAgent(BaseStage::ID stageId) { stages.at(stageId)->IncreaseTargeting(); }
-    void HandleRemoveAgent(BaseStage::ID stageId) { stages.at(stageId)->DecreaseTargeting(); }
+    void MigrateAgent(GenericAgent::ID agent, BaseStage& prevTarget, BaseStage& newTarget)
+    {
+        newTarget.IncreaseTargeting(agent);
+        prevTarget.DecreaseTargeting(agent);
+    }
+
+    void HandleNewAgent(GenericAgent::ID agent, BaseStage::ID stageId)
+    {
+        stages.at(stageId)->IncreaseTargeting(agent);
+    }
+
+    void HandleRemoveAgent(GenericAgent::ID agent, BaseStage::ID stageId)
+    {
+        stages.at(stageId)->DecreaseTargeting(agent);
+    }
 
     BaseStage* Stage(BaseStage::ID stageId) const
     {
@@ -78,10 +102,26 @@ public:
         return iter->second.get();
     }
 
+    BaseStage* StageByOrdinal(size_t ordinal) const { return stagesByOrdinal[ordinal]; }
+
+    size_t CountStages() const { return stagesByOrdinal.size(); }
+
     std::unordered_map<BaseStage::ID, std::unique_ptr<BaseStage>>& Stages() { return stages; }
 
     const std::unordered_map<BaseStage::ID, std::unique_ptr<BaseStage>>& Stages() const
     {
         return stages;
     }
+
+    const std::vector<NotifiableWaitingSet*>& NotifiableWaitingSets() const { return waitingSets; }
+
+    const std::vector<NotifiableQueue*>& NotifiableQueues() const { return queues; }
+
+    /// Writes all stages in ordinal order.
+    void Save(SnapshotWriter& writer) const;
+
+    /// Recreates the stages written by 'Save' with their original ids and ordinals.
+    /// Requires that no stages have been added yet.
+    void
+    Restore(SnapshotReader& reader, std::vector<GenericAgent::ID>& removedAgentsInLastIteration);
 };
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "CollisionGeometry.hpp"
+#include "EventLog.hpp"
 #include "Stage.hpp"
 #include "StageManager.hpp"
 
@@ -19,15 +20,36 @@ public:
     void
     Run(StageManager& stageManager,
         const NeighborhoodSearch<GenericAgent>& neighborhoodSearch,
-        const CollisionGeometry& geometry)
+        const CollisionGeometry& geometry,
+        EventLog& eventLog)
     {
-        for(auto& [_, stage] : stageManager.Stages()) {
-            if(auto* updatable_stage = dynamic_cast<NotifiableWaitingSet*>(stage.get());
-               updatable_stage != nullptr) {
-                updatable_stage->Update(neighborhoodSearch, geometry);
-            } else if(auto* updatable_stage = dynamic_cast<NotifiableQueue*>(stage.get());
-                      updatable_stage != nullptr) {
-                updatable_stage->Update(neighborhoodSearch, geometry);
+        // Stages only need to search for new occupants while agents that have not been assigned
+        // a slot are targeting them.
+        for(auto* waitingSet : stageManager.NotifiableWaitingSets()) {
+            if(!waitingSet->HasUnassignedAgents()) {
+                continue;
+            }
+            const auto& occupants = waitingSet->Occupants();
+            const auto previousCount = occupants.size();
+            waitingSet->Update(neighborhoodSearch, geometry);
+            for(size_t index = previousCount; index < occupants.size(); ++index) {
+                eventLog.Push(
+                    SimulationEventType::WaitingSetEntered, occupants[index], waitingSet->Id());
+            }
+            if(occupants.size() > previousCount && occupants.size() == waitingSet->Slots().size()) {
+                eventLog.Push(
+                    SimulationEventType::WaitingSetFull, occupants.back(), waitingSet->Id());
+            }
+        }
+        for(auto* queue : stageManager.NotifiableQueues()) {
+            if(!queue->HasUnassignedAgents()) {
+                continue;
+            }
+            const auto& occupants = queue->Occupants();
+            const auto previousCount = occupants.size();
+            queue->Update(neighborhoodSearch, geometry);
+            for(size_t index = previousCount; index < occupants.size(); ++index) {
+                eventLog.Push(SimulationEventType::QueueEnqueued, occupants[index], queue->Id());
             }
         }
     }
@@ -1,17 +1,26 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "EventLog.hpp"
 #include "Journey.hpp"
 #include "Stage.hpp"
 #include "StageManager.hpp"
 
-#include <memory>
-#include <tuple>
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 
 class StrategicalDecisionSystem
 {
+    /// Agents grouped by the stage they target, indexed by stage ordinal. Buffers are reused
+    /// between runs.
+    struct StageGroup {
+        std::vector<const GenericAgent*> agents{};
+        std::vector<size_t> indices{};
+        std::vector<uint8_t> completed{};
+    };
+    std::vector<StageGroup> groups{};
+    std::vector<uint8_t> completed{};
+
 public:
     StrategicalDecisionSystem() = default;
     ~StrategicalDecisionSystem() = default;
@@ -20,16 +29,65 @@ public:
     StrategicalDecisionSystem(StrategicalDecisionSystem&& other) = delete;
     StrategicalDecisionSystem& operator=(StrategicalDecisionSystem&& other) = delete;
 
+    /// @param journeys all journeys indexed by their ordinal
     void
-    Run(const std::unordered_map<Journey::ID, std::unique_ptr<Journey>>& journeys,
+    Run(const std::vector<const Journey*>& journeys,
         auto&& agents,
-        StageManager& stageManager) const
+        StageManager& stageManager,
+        EventLog& eventLog)
     {
+        // Completion is evaluated per stage for all agents targeting it at once. Transitions are
+        // evaluated afterwards in agent order, as they may depend on the order of migrations.
+        evaluateCompletion(agents, stageManager);
+
+        size_t index = 0;
         for(auto& agent : agents) {
-            const auto [target, id] = journeys.at(agent.journeyId)->Target(agent);
-            agent.target = target;
-            stageManager.MigrateAgent(agent.stageId, id);
-            agent.stageId = id;
+            const auto& node = journeys[agent.journeyOrdinal]->Node(agent.stageOrdinal);
+            auto stage = node.stage;
+            if(completed[index++] != 0) {
+                auto next = node.transition->NextStage();
+                if(next != stage) {
+                    stageManager.MigrateAgent(agent.id, *stage, *next);
+                    eventLog.Push(
+                        SimulationEventType::StageChanged, agent.id, next->Id(), stage->Id());
+                    agent.stageId = next->Id();
+                    agent.stageOrdinal = next->Ordinal();
+                    stage = next;
+                }
+            }
+            agent.target = stage->Target(agent);
+        }
+    }
+
+private:
+    void evaluateCompletion(auto&& agents, StageManager& stageManager)
+    {
+        groups.resize(stageManager.CountStages());
+        for(auto& group : groups) {
+            group.agents.clear();
+            group.indices.clear();
+        }
+
+        size_t index = 0;
+        for(const auto& agent : agents) {
+            auto& group = groups[agent.stageOrdinal];
+            group.agents.push_back(&agent);
+            group.indices.push_back(index++);
+        }
+
+        // Groups are independent of each other, only 'completed' is shared and written at
+        // disjoint indices.
+        completed.resize(index);
+        for(size_t ordinal = 0; ordinal < groups.size(); ++ordinal) {
+            auto& group = groups[ordinal];
+            if(group.agents.empty()) {
+                continue;
+            }
+            group.completed.resize(group.agents.size());
+            stageManager.StageByOrdinal(ordinal)->AreCompleted(group.agents, group.completed);
+            for(size_t member = 0; member < group.indices.size(); ++member) {
+                completed[group.indices[member]] = group.completed[member];
+            }
         }
     }
 };
@@ -7,6 +7,8 @@
 
 class TacticalDecisionSystem
 {
+    RoutingAlgorithm _routingAlgorithm{RoutingAlgorithm::TriangleAStar};
+
 public:
     TacticalDecisionSystem() = default;
     ~TacticalDecisionSystem() = default;
@@ -15,11 +17,15 @@ public:
     TacticalDecisionSystem(TacticalDecisionSystem&& other) = delete;
     TacticalDecisionSystem& operator=(TacticalDecisionSystem&& other) = delete;
 
-    void Run(RoutingEngine& routingEngine, auto&& agents) const
+    void SetRoutingAlgorithm(RoutingAlgorithm algorithm) { _routingAlgorithm = algorithm; }
+
+    RoutingAlgorithm GetRoutingAlgorithm() const { return _routingAlgorithm; }
+
+    void Run(const RoutingEngine& routingEngine, auto&& agents) const
     {
         for(auto& agent : agents) {
             const auto dest = agent.target;
-            agent.destination = routingEngine.ComputeWaypoint(agent.pos, dest);
+            agent.destination = routingEngine.ComputeWaypoint(agent.pos, dest, _routingAlgorithm);
         }
     }
 };
@@ -1,27 +1,193 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "Tracing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
 #include <optional>
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
 namespace cr = std::chrono;
 
-Trace::Trace(uint64_t& _t) : startedAt(cr::high_resolution_clock::now()), t(_t)
+////////////////////////////////////////////////////////////////////////////////
+/// HardwareCounters
+////////////////////////////////////////////////////////////////////////////////
+#if defined(__linux__)
+static int openCounter(uint64_t config)
 {
+    perf_event_attr attr{};
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    // Only count user space of this thread so that this works with the default
+    // 'perf_event_paranoid' setting of most distributions.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+/// Reads a counter opened by 'openCounter', scaled up if it only ran part of the time it was
+/// enabled because the kernel multiplexed it with other events.
+static uint64_t readCounter(int fd)
+{
+    struct {
+        uint64_t value;
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+    } data{};
+    if(fd < 0 || read(fd, &data, sizeof(data)) != sizeof(data) || data.timeRunning == 0) {
+        return 0;
+    }
+    if(data.timeRunning == data.timeEnabled) {
+        return data.value;
+    }
+    return static_cast<uint64_t>(
+        static_cast<double>(data.value) * static_cast<double>(data.timeEnabled) /
+        static_cast<double>(data.timeRunning));
+}
+
+namespace
+{
+/// perf_event file descriptors of the owning thread, closed when the thread exits
+struct ThreadCounters {
+    std::array<int, 4> fds{
+        openCounter(PERF_COUNT_HW_CPU_CYCLES),
+        openCounter(PERF_COUNT_HW_INSTRUCTIONS),
+        openCounter(PERF_COUNT_HW_CACHE_MISSES),
+        openCounter(PERF_COUNT_HW_BRANCH_MISSES)};
+
+    ThreadCounters() = default;
+    ~ThreadCounters()
+    {
+        for(const auto fd : fds) {
+            if(fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+    ThreadCounters(const ThreadCounters& other) = delete;
+    ThreadCounters& operator=(const ThreadCounters& other) = delete;
+    ThreadCounters(ThreadCounters&& other) = delete;
+    ThreadCounters& operator=(ThreadCounters&& other) = delete;
+};
+
+const ThreadCounters& threadCounters()
+{
+    thread_local const ThreadCounters counters{};
+    return counters;
+}
+} // namespace
+
+HardwareCounters::HardwareCounters()
+{
+    const auto& fds = threadCounters().fds;
+    available = std::any_of(std::begin(fds), std::end(fds), [](auto fd) { return fd >= 0; });
+}
+
+HardwareCounters::~HardwareCounters()
+{
+}
+
+HardwareCounterValues HardwareCounters::Read() const
+{
+    const auto& fds = threadCounters().fds;
+    return {readCounter(fds[0]), readCounter(fds[1]), readCounter(fds[2]), readCounter(fds[3])};
+}
+#else
+HardwareCounters::HardwareCounters()
+{
+}
+
+HardwareCounters::~HardwareCounters()
+{
+}
+
+HardwareCounterValues HardwareCounters::Read() const
+{
+    return {};
+}
+#endif
+
+bool HardwareCounters::Available() const
+{
+    return available;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Trace
+////////////////////////////////////////////////////////////////////////////////
+Trace::Trace(
+    uint64_t& _t,
+    const HardwareCounters* _counters,
+    HardwareCounterValues* _counterValues)
+    : startedAt(cr::high_resolution_clock::now())
+    , t(_t)
+    , counters(_counters)
+    , counterValues(_counterValues)
+{
+    if(counters) {
+        countersAtStart = counters->Read();
+    }
+}
+
+Trace::~Trace()
+{
+    if(counters) {
+        const auto now = counters->Read();
+        *counterValues = HardwareCounterValues{
+            now.cycles - countersAtStart.cycles,
+            now.instructions - countersAtStart.instructions,
+            now.cacheMisses - countersAtStart.cacheMisses,
+            now.branchMisses - countersAtStart.branchMisses};
+    }
+    const auto now = cr::high_resolution_clock::now();
+    t = cr::duration_cast<cr::microseconds>(now - startedAt).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// PerfStats
+////////////////////////////////////////////////////////////////////////////////
+bool PerfStats::SetHardwareCountersEnabled(bool status)
+{
+    if(!status) {
+        hardwareCounters.reset();
+        iterate_counters = {};
+        op_dec_system_run_counters = {};
+        return false;
+    }
+    if(!hardwareCounters) {
+        hardwareCounters = std::make_shared<HardwareCounters>();
+    }
+    if(!hardwareCounters->Available()) {
+        hardwareCounters.reset();
+        return false;
+    }
+    return true;
 }
 
-std::optional<Trace> PerfStats::trace(uint64_t& v)
+std::optional<Trace> PerfStats::trace(uint64_t& v, HardwareCounterValues& c)
 {
     if(enabled) {
-        return std::optional<Trace>{std::in_place, v};
+        return std::optional<Trace>{std::in_place, v, hardwareCounters.get(), &c};
     } else {
         return std::nullopt;
     }
 }
 std::optional<Trace> PerfStats::TraceIterate()
 {
-    return trace(iterate_duration);
+    return trace(iterate_duration, iterate_counters);
 }
 
 std::optional<Trace> PerfStats::TraceOperationalDecisionSystemRun()
 {
-    return trace(op_dec_system_run_duration);
+    return trace(op_dec_system_run_duration, op_dec_system_run_counters);
 }
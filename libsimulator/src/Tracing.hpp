@@ -1,21 +1,57 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <memory>
 #include <optional>
 
+/// Values of the hardware performance counters sampled over one traced span.
+/// All values are zero if hardware counters are disabled or not available.
+struct HardwareCounterValues {
+    uint64_t cycles{};
+    uint64_t instructions{};
+    uint64_t cacheMisses{};
+    uint64_t branchMisses{};
+};
+
+/// Reads the hardware performance counters for cycles, instructions, cache misses and branch
+/// misses. perf events count a single thread, so each thread opens its own counters on its first
+/// read and closes them when it exits. Counters are only available on Linux and only if the kernel
+/// permits access, i.e. depending on '/proc/sys/kernel/perf_event_paranoid'. If a counter cannot be
+/// opened it will always read as zero. Values of counters the kernel multiplexed are scaled to the
+/// full time they were enabled.
+class HardwareCounters
+{
+    /// Whether a counter could be opened on the thread that created this object
+    bool available{false};
+
+public:
+    HardwareCounters();
+    ~HardwareCounters();
+    HardwareCounters(const HardwareCounters& other) = delete;
+    HardwareCounters& operator=(const HardwareCounters& other) = delete;
+    HardwareCounters(HardwareCounters&& other) = delete;
+    HardwareCounters& operator=(HardwareCounters&& other) = delete;
+
+    /// @return true if at least one counter could be opened.
+    bool Available() const;
+    /// Reads the current absolute counter values of the calling thread.
+    HardwareCounterValues Read() const;
+};
+
 class Trace
 {
     std::chrono::high_resolution_clock::time_point startedAt;
     uint64_t& t;
+    const HardwareCounters* counters;
+    HardwareCounterValues* counterValues;
+    HardwareCounterValues countersAtStart{};
 
 public:
-    Trace(uint64_t& _t);
-    ~Trace()
-    {
-        const auto now = std::chrono::high_resolution_clock::now();
-        t = std::chrono::duration_cast<std::chrono::microseconds>(now - startedAt).count();
-    }
+    Trace(uint64_t& _t, const HardwareCounters* _counters, HardwareCounterValues* _counterValues);
+    ~Trace();
     Trace(const Trace& other) = delete;
     Trace& operator=(const Trace& other) = delete;
     Trace(Trace&& other) = delete;
@@ -26,15 +62,27 @@ class PerfStats
 {
     uint64_t iterate_duration{};
     uint64_t op_dec_system_run_duration{};
+    HardwareCounterValues iterate_counters{};
+    HardwareCounterValues op_dec_system_run_counters{};
     bool enabled{false};
+    std::shared_ptr<HardwareCounters> hardwareCounters{};
 
 public:
     std::optional<Trace> TraceIterate();
     std::optional<Trace> TraceOperationalDecisionSystemRun();
     void SetEnabled(bool status) { enabled = status; };
+    /// Enables / disables sampling of hardware counters for each traced span.
+    /// @return true if hardware counters are available after this call.
+    bool SetHardwareCountersEnabled(bool status);
+    bool HardwareCountersEnabled() const { return hardwareCounters != nullptr; }
     uint64_t IterationDuration() const { return iterate_duration; };
     uint64_t OpDecSystemRunDuration() const { return op_dec_system_run_duration; };
+    const HardwareCounterValues& IterationCounters() const { return iterate_counters; };
+    const HardwareCounterValues& OpDecSystemRunCounters() const
+    {
+        return op_dec_system_run_counters;
+    };
 
 private:
-    std::optional<Trace> trace(uint64_t& v);
+    std::optional<Trace> trace(uint64_t& v, HardwareCounterValues& c);
 };
@@ -0,0 +1,366 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "TrajectoryFile.hpp"
+
+#include "SimulationError.hpp"
+#include "Snapshot.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+/// "JPSTRAJ" followed by a zero byte
+static constexpr uint64_t headerMagic = 0x004a41525453504aULL;
+/// "JPSTEND" followed by a zero byte
+static constexpr uint64_t trailerMagic = 0x00444e455453504aULL;
+static constexpr uint32_t formatVersion = 1;
+/// Magic, version, storage, quantization step and a reserved field
+static constexpr size_t headerSize = 32;
+/// Footer offset and magic
+static constexpr size_t trailerSize = 16;
+
+static size_t valueSize(TrajectoryStorage storage)
+{
+    switch(storage) {
+        case TrajectoryStorage::Float64:
+            return sizeof(double);
+        case TrajectoryStorage::Float32:
+            return sizeof(float);
+        case TrajectoryStorage::Quantized:
+            return sizeof(int32_t);
+    }
+    throw SimulationError("Unknown trajectory storage {}", static_cast<uint32_t>(storage));
+}
+
+static size_t alignTo8(size_t size)
+{
+    return (size + 7) & ~size_t{7};
+}
+
+static void writeString(SnapshotWriter& writer, const std::string& value)
+{
+    writer.WriteArray(std::span<const char>(value.data(), value.size()));
+}
+
+static std::string readString(SnapshotReader& reader)
+{
+    const auto chars = reader.ReadArray<char>();
+    return {std::begin(chars), std::end(chars)};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// TrajectoryFileWriter
+////////////////////////////////////////////////////////////////////////////////
+TrajectoryFileWriter::TrajectoryFileWriter(
+    const std::string& path,
+    TrajectoryStorage storage_,
+    double quantizationStep_)
+    : storage(storage_), quantizationStep(quantizationStep_)
+{
+    valueSize(storage);
+    if(storage == TrajectoryStorage::Quantized && !(quantizationStep > 0)) {
+        throw SimulationError(
+            "Quantization step needs to be greater than 0, got {}", quantizationStep);
+    }
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if(!out) {
+        throw SimulationError("Could not open trajectory file '{}'", path);
+    }
+    const auto storageValue = static_cast<uint32_t>(storage);
+    const uint64_t reserved = 0;
+    write(&headerMagic, sizeof(headerMagic));
+    write(&formatVersion, sizeof(formatVersion));
+    write(&storageValue, sizeof(storageValue));
+    write(&quantizationStep, sizeof(quantizationStep));
+    write(&reserved, sizeof(reserved));
+}
+
+void TrajectoryFileWriter::SetMetadata(const std::string& key, const std::string& value)
+{
+    const auto iter = std::find_if(
+        std::begin(metadata), std::end(metadata), [&key](const auto& entry) {
+            return entry.first == key;
+        });
+    if(iter != std::end(metadata)) {
+        iter->second = value;
+    } else {
+        metadata.emplace_back(key, value);
+    }
+}
+
+uint64_t TrajectoryFileWriter::AddGeometry(int64_t hash, const std::string& wkt)
+{
+    const auto iter = std::find_if(
+        std::begin(geometries), std::end(geometries), [hash](const auto& geometry) {
+            return geometry.hash == hash;
+        });
+    if(iter != std::end(geometries)) {
+        return std::distance(std::begin(geometries), iter);
+    }
+    geometries.push_back({hash, wkt});
+    return geometries.size() - 1;
+}
+
+void TrajectoryFileWriter::WriteFrame(
+    uint64_t frame,
+    uint64_t geometry,
+    std::span<const uint64_t> ids,
+    std::span<const double> xs,
+    std::span<const double> ys,
+    std::span<const double> orientationXs,
+    std::span<const double> orientationYs)
+{
+    if(!out.is_open()) {
+        throw SimulationError("Trajectory file is already closed");
+    }
+    const auto count = ids.size();
+    if(xs.size() != count || ys.size() != count || orientationXs.size() != count ||
+       orientationYs.size() != count) {
+        throw SimulationError("All columns of a frame need to have the same size");
+    }
+    if(geometry >= geometries.size()) {
+        throw SimulationError("Unknown geometry index {}", geometry);
+    }
+    if(!frames.empty() && frame <= frames.back().frame) {
+        throw SimulationError(
+            "Frames need to be written in ascending order, frame {} follows frame {}",
+            frame,
+            frames.back().frame);
+    }
+
+    order.resize(count);
+    std::iota(std::begin(order), std::end(order), size_t{0});
+    std::sort(std::begin(order), std::end(order), [&ids](size_t a, size_t b) {
+        return ids[a] < ids[b];
+    });
+
+    block.clear();
+    const auto append = [this](const void* data, size_t size) {
+        const auto blockOffset = block.size();
+        block.resize(blockOffset + size);
+        std::memcpy(block.data() + blockOffset, data, size);
+    };
+    const uint64_t agentCount = count;
+    append(&agentCount, sizeof(agentCount));
+    // Patched once the ids are encoded
+    append(&agentCount, sizeof(agentCount));
+    uint64_t previousId = 0;
+    for(const auto index : order) {
+        uint64_t delta = ids[index] - previousId;
+        previousId = ids[index];
+        do {
+            auto byte = static_cast<std::byte>(delta & 0x7f);
+            delta >>= 7;
+            if(delta != 0) {
+                byte |= std::byte{0x80};
+            }
+            block.push_back(byte);
+        } while(delta != 0);
+    }
+    const uint64_t idBytes = block.size() - 2 * sizeof(uint64_t);
+    std::memcpy(block.data() + sizeof(uint64_t), &idBytes, sizeof(idBytes));
+    block.resize(alignTo8(block.size()));
+
+    for(const auto column : {xs, ys, orientationXs, orientationYs}) {
+        for(const auto index : order) {
+            const auto value = column[index];
+            switch(storage) {
+                case TrajectoryStorage::Float64:
+                    append(&value, sizeof(value));
+                    break;
+                case TrajectoryStorage::Float32: {
+                    const auto single = static_cast<float>(value);
+                    append(&single, sizeof(single));
+                    break;
+                }
+                case TrajectoryStorage::Quantized: {
+                    const auto steps = std::round(value / quantizationStep);
+                    if(!(std::abs(steps) <= std::numeric_limits<int32_t>::max())) {
+                        throw SimulationError(
+                            "Value {} can not be quantized with step {}", value, quantizationStep);
+                    }
+                    const auto quantized = static_cast<int32_t>(steps);
+                    append(&quantized, sizeof(quantized));
+                    break;
+                }
+            }
+        }
+        block.resize(alignTo8(block.size()));
+    }
+
+    frames.push_back({frame, offset, geometry});
+    write(block.data(), block.size());
+}
+
+void TrajectoryFileWriter::Close()
+{
+    if(!out.is_open()) {
+        return;
+    }
+    SnapshotWriter footer{};
+    footer.Write(static_cast<uint64_t>(metadata.size()));
+    for(const auto& [key, value] : metadata) {
+        writeString(footer, key);
+        writeString(footer, value);
+    }
+    footer.Write(static_cast<uint64_t>(geometries.size()));
+    for(const auto& geometry : geometries) {
+        footer.Write(geometry.hash);
+        writeString(footer, geometry.wkt);
+    }
+    footer.WriteArray(frames);
+
+    const uint64_t footerOffset = offset;
+    write(footer.Data().data(), footer.Data().size());
+    write(&footerOffset, sizeof(footerOffset));
+    write(&trailerMagic, sizeof(trailerMagic));
+    out.close();
+    if(!out) {
+        throw SimulationError("Could not write trajectory file");
+    }
+}
+
+void TrajectoryFileWriter::write(const void* data, size_t size)
+{
+    if(!out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size))) {
+        throw SimulationError("Could not write trajectory file");
+    }
+    offset += size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// TrajectoryFileReader
+////////////////////////////////////////////////////////////////////////////////
+TrajectoryFileReader::TrajectoryFileReader(const std::string& path) : file(path)
+{
+    const auto data = file.Data();
+    if(data.size() < headerSize + trailerSize) {
+        throw SimulationError("'{}' is not a trajectory file", path);
+    }
+    SnapshotReader header{data.first(headerSize)};
+    if(header.Read<uint64_t>() != headerMagic) {
+        throw SimulationError("'{}' is not a trajectory file", path);
+    }
+    if(const auto fileVersion = header.Read<uint32_t>(); fileVersion != formatVersion) {
+        throw SimulationError(
+            "Trajectory file version {} is not supported, expected version {}",
+            fileVersion,
+            formatVersion);
+    }
+    storage = static_cast<TrajectoryStorage>(header.Read<uint32_t>());
+    valueSize(storage);
+    quantizationStep = header.Read<double>();
+
+    SnapshotReader trailer{data.last(trailerSize)};
+    const auto footerOffset = trailer.Read<uint64_t>();
+    if(trailer.Read<uint64_t>() != trailerMagic || footerOffset < headerSize ||
+       footerOffset > data.size() - trailerSize) {
+        throw SimulationError("Trajectory file '{}' is incomplete", path);
+    }
+
+    SnapshotReader footer{data.subspan(footerOffset, data.size() - trailerSize - footerOffset)};
+    metadata.resize(footer.Read<uint64_t>());
+    for(auto& [key, value] : metadata) {
+        key = readString(footer);
+        value = readString(footer);
+    }
+    geometries.resize(footer.Read<uint64_t>());
+    for(auto& geometry : geometries) {
+        geometry.hash = footer.Read<int64_t>();
+        geometry.wkt = readString(footer);
+    }
+    frames = footer.ReadArray<TrajectoryFrameIndexEntry>();
+
+    const auto columnBytes = valueSize(storage);
+    for(const auto& entry : frames) {
+        if(entry.offset % 8 != 0 || entry.offset > footerOffset ||
+           entry.geometry >= geometries.size()) {
+            throw SimulationError("Trajectory file '{}' is corrupted", path);
+        }
+        const auto available = footerOffset - entry.offset;
+        SnapshotReader block{data.subspan(entry.offset, available)};
+        const auto agentCount = block.Read<uint64_t>();
+        const auto idBytes = block.Read<uint64_t>();
+        // Both counts are bounded by the available bytes before computing the block size, so a
+        // corrupted count cannot wrap the size around.
+        if(idBytes > available || agentCount > available / (4 * columnBytes) ||
+           alignTo8(2 * sizeof(uint64_t) + idBytes) + 4 * alignTo8(agentCount * columnBytes) >
+               available) {
+            throw SimulationError("Trajectory file '{}' is corrupted", path);
+        }
+    }
+}
+
+TrajectoryFrameView TrajectoryFileReader::Frame(size_t index) const
+{
+    const auto& entry = frames.at(index);
+    const auto block = file.Data().data() + entry.offset;
+    uint64_t agentCount{};
+    uint64_t idBytes{};
+    std::memcpy(&agentCount, block, sizeof(agentCount));
+    std::memcpy(&idBytes, block + sizeof(agentCount), sizeof(idBytes));
+    const auto columnSize = alignTo8(agentCount * valueSize(storage));
+    const auto columns = block + alignTo8(2 * sizeof(uint64_t) + idBytes);
+    return {
+        entry.frame,
+        entry.geometry,
+        agentCount,
+        storage,
+        columns,
+        columns + columnSize,
+        columns + 2 * columnSize,
+        columns + 3 * columnSize};
+}
+
+void TrajectoryFileReader::Ids(size_t index, std::span<uint64_t> ids) const
+{
+    const auto& entry = frames.at(index);
+    const auto block = file.Data().data() + entry.offset;
+    uint64_t agentCount{};
+    uint64_t idBytes{};
+    std::memcpy(&agentCount, block, sizeof(agentCount));
+    std::memcpy(&idBytes, block + sizeof(agentCount), sizeof(idBytes));
+    if(ids.size() < agentCount) {
+        throw SimulationError("Buffer too small for {} ids", agentCount);
+    }
+    auto encoded = block + 2 * sizeof(uint64_t);
+    const auto end = encoded + idBytes;
+    uint64_t id = 0;
+    for(uint64_t agent = 0; agent < agentCount; ++agent) {
+        uint64_t delta = 0;
+        for(int shift = 0; encoded != end; shift += 7) {
+            const auto byte = std::to_integer<uint64_t>(*encoded++);
+            delta |= (byte & 0x7f) << shift;
+            if((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        id += delta;
+        ids[agent] = id;
+    }
+}
+
+void TrajectoryFileReader::Decode(const void* column, size_t count, std::span<double> values) const
+{
+    if(values.size() < count) {
+        throw SimulationError("Buffer too small for {} values", count);
+    }
+    switch(storage) {
+        case TrajectoryStorage::Float64:
+            std::memcpy(values.data(), column, count * sizeof(double));
+            break;
+        case TrajectoryStorage::Float32: {
+            const auto singles = static_cast<const float*>(column);
+            std::copy(singles, singles + count, std::begin(values));
+            break;
+        }
+        case TrajectoryStorage::Quantized: {
+            const auto steps = static_cast<const int32_t*>(column);
+            std::transform(steps, steps + count, std::begin(values), [this](int32_t step) {
+                return step * quantizationStep;
+            });
+            break;
+        }
+    }
+}
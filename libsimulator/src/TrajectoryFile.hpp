@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Columnar trajectory file format.
+///
+/// A file starts with a fixed size header followed by one block per frame and ends with a footer
+/// and a trailer. Each frame block holds the agent ids, sorted and delta encoded as LEB128
+/// varints, followed by the columns x, y, orientation x and orientation y. Columns start at 8 byte
+/// aligned offsets so they can be used in place from a memory mapping. The footer holds the
+/// metadata key value pairs, the geometries as WKT and the frame index. The trailer at the very
+/// end of the file points to the footer.
+
+/// Representation of the coordinate columns in a trajectory file
+enum class TrajectoryStorage : uint32_t {
+    /// IEEE 754 double, lossless
+    Float64 = 0,
+    /// IEEE 754 float, about 7 significant digits
+    Float32 = 1,
+    /// Signed 32 bit integer multiples of a fixed step
+    Quantized = 2,
+};
+
+struct TrajectoryFrameIndexEntry {
+    uint64_t frame;
+    /// Offset of the frame block from the start of the file
+    uint64_t offset;
+    /// Index into the geometries of the file
+    uint64_t geometry;
+};
+
+struct TrajectoryGeometry {
+    int64_t hash;
+    std::string wkt;
+};
+
+/// Writes a trajectory file front to back. Frames are written immediately, the footer is written
+/// by 'Close'. A file that was not closed cannot be read.
+class TrajectoryFileWriter
+{
+    std::ofstream out;
+    TrajectoryStorage storage;
+    double quantizationStep;
+    uint64_t offset{0};
+    std::vector<std::pair<std::string, std::string>> metadata{};
+    std::vector<TrajectoryGeometry> geometries{};
+    std::vector<TrajectoryFrameIndexEntry> frames{};
+    /// Scratch buffers reused for each frame
+    std::vector<size_t> order{};
+    std::vector<std::byte> block{};
+
+public:
+    /// @param quantizationStep distance represented by one unit in 'TrajectoryStorage::Quantized',
+    /// ignored otherwise
+    TrajectoryFileWriter(
+        const std::string& path,
+        TrajectoryStorage storage,
+        double quantizationStep);
+    ~TrajectoryFileWriter() = default;
+    TrajectoryFileWriter(const TrajectoryFileWriter& other) = delete;
+    TrajectoryFileWriter& operator=(const TrajectoryFileWriter& other) = delete;
+    TrajectoryFileWriter(TrajectoryFileWriter&& other) = delete;
+    TrajectoryFileWriter& operator=(TrajectoryFileWriter&& other) = delete;
+
+    /// Sets 'key' to 'value', replacing an existing value.
+    void SetMetadata(const std::string& key, const std::string& value);
+
+    /// @return index of the geometry, an existing index if a geometry with 'hash' was added before
+    uint64_t AddGeometry(int64_t hash, const std::string& wkt);
+
+    /// Appends a frame. Frame numbers need to be ascending. All spans need to have the same size,
+    /// agents may be in any order.
+    void WriteFrame(
+        uint64_t frame,
+        uint64_t geometry,
+        std::span<const uint64_t> ids,
+        std::span<const double> xs,
+        std::span<const double> ys,
+        std::span<const double> orientationXs,
+        std::span<const double> orientationYs);
+
+    /// Writes the footer and closes the file.
+    void Close();
+
+private:
+    void write(const void* data, size_t size);
+};
+
+/// Columns of a single frame. The coordinate columns point into the mapped file and hold values
+/// of type 'storage'.
+struct TrajectoryFrameView {
+    uint64_t frame;
+    uint64_t geometry;
+    uint64_t agentCount;
+    TrajectoryStorage storage;
+    const void* x;
+    const void* y;
+    const void* orientationX;
+    const void* orientationY;
+};
+
+/// Reads a trajectory file through a read only memory mapping.
+class TrajectoryFileReader
+{
+    MappedFile file;
+    TrajectoryStorage storage;
+    double quantizationStep;
+    std::vector<std::pair<std::string, std::string>> metadata{};
+    std::vector<TrajectoryGeometry> geometries{};
+    std::vector<TrajectoryFrameIndexEntry> frames{};
+
+public:
+    explicit TrajectoryFileReader(const std::string& path);
+
+    TrajectoryStorage ValueStorage() const { return storage; }
+    double QuantizationStep() const { return quantizationStep; }
+    const std::vector<std::pair<std::string, std::string>>& Metadata() const { return metadata; }
+    const std::vector<TrajectoryGeometry>& Geometries() const { return geometries; }
+    const std::vector<TrajectoryFrameIndexEntry>& Frames() const { return frames; }
+
+    /// @param index of the frame in the file, not the frame number
+    TrajectoryFrameView Frame(size_t index) const;
+
+    /// Decodes the agent ids of a frame into 'ids', sorted ascending.
+    /// @param ids needs to hold 'TrajectoryFrameView::agentCount' elements
+    void Ids(size_t index, std::span<uint64_t> ids) const;
+
+    /// Converts a coordinate column of any storage to double.
+    /// @param values needs to hold 'TrajectoryFrameView::agentCount' elements
+    void Decode(const void* column, size_t count, std::span<double> values) const;
+};
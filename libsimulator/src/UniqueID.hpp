@@ -53,6 +53,15 @@ public:
 
     ~UniqueID() noexcept = default;
 
+    /// Ensures that ids created afterwards are greater than 'id'. Used when objects are restored
+    /// with the ids they were created with.
+    static void Reserve(Integer id) noexcept
+    {
+        auto current = uid_counter.load();
+        while(current < id && !uid_counter.compare_exchange_weak(current, id)) {
+        }
+    }
+
     Integer getID() const noexcept { return m_value; }
 
     bool operator==(const UniqueID& p_other) const noexcept { return m_value == p_other.m_value; };
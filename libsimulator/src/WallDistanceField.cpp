@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "WallDistanceField.hpp"
+
+#include "AABB.hpp"
+#include "MemoryStats.hpp"
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+WallDistanceField::WallDistanceField(std::vector<LineSegment> walls, double spacing, double range)
+    : _spacing(spacing), _range(range), _walls(std::move(walls))
+{
+    if(!(spacing > 0) || !(range > 0)) {
+        throw SimulationError(
+            "Wall distance field needs spacing and range > 0, got spacing {} and range {}",
+            spacing,
+            range);
+    }
+    if(_walls.size() >= noWall) {
+        throw SimulationError("Too many walls for a wall distance field: {}", _walls.size());
+    }
+    if(_walls.empty()) {
+        return;
+    }
+
+    // Walls meeting at a corner are about equally near to positions around the corner
+    _connected.assign(_walls.size(), {noWall, noWall});
+    std::vector<std::pair<Point, size_t>> corners{};
+    corners.reserve(2 * _walls.size());
+    for(size_t index = 0; index < _walls.size(); ++index) {
+        corners.emplace_back(_walls[index].p1, 2 * index);
+        corners.emplace_back(_walls[index].p2, 2 * index + 1);
+    }
+    std::sort(std::begin(corners), std::end(corners), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    for(size_t index = 1; index < corners.size(); ++index) {
+        const auto& [corner, end] = corners[index];
+        const auto& [previousCorner, previousEnd] = corners[index - 1];
+        if(corner == previousCorner) {
+            _connected[end / 2][end % 2] = static_cast<uint32_t>(previousEnd / 2);
+            _connected[previousEnd / 2][previousEnd % 2] = static_cast<uint32_t>(end / 2);
+        }
+    }
+
+    std::vector<Point> endPoints{};
+    endPoints.reserve(2 * _walls.size());
+    for(const auto& wall : _walls) {
+        endPoints.push_back(wall.p1);
+        endPoints.push_back(wall.p2);
+    }
+    const AABB bounds(endPoints);
+    _origin = bounds.BottomLeft() - Point{range, range};
+    _columns =
+        static_cast<int64_t>(std::ceil((bounds.xmax - bounds.xmin + 2 * range) / spacing)) + 1;
+    _rows = static_cast<int64_t>(std::ceil((bounds.ymax - bounds.ymin + 2 * range) / spacing)) + 1;
+    if(static_cast<double>(_columns) * static_cast<double>(_rows) >
+       static_cast<double>(std::numeric_limits<uint32_t>::max())) {
+        throw SimulationError(
+            "Wall distance field spacing {} is too small for a geometry of {} x {}",
+            spacing,
+            bounds.xmax - bounds.xmin,
+            bounds.ymax - bounds.ymin);
+    }
+
+    // Every wall updates the nodes within 'range' of its bounding box
+    _nearest.assign(static_cast<size_t>(_columns * _rows), noWall);
+    std::vector<float> nearestDistance(_nearest.size(), std::numeric_limits<float>::max());
+    for(uint32_t index = 0; index < _walls.size(); ++index) {
+        const auto& wall = _walls[index];
+        const AABB wallBounds(wall.p1, wall.p2);
+        const auto firstColumn =
+            static_cast<int64_t>(std::floor((wallBounds.xmin - range - _origin.x) / spacing));
+        const auto lastColumn =
+            static_cast<int64_t>(std::ceil((wallBounds.xmax + range - _origin.x) / spacing));
+        const auto firstRow =
+            static_cast<int64_t>(std::floor((wallBounds.ymin - range - _origin.y) / spacing));
+        const auto lastRow =
+            static_cast<int64_t>(std::ceil((wallBounds.ymax + range - _origin.y) / spacing));
+        for(auto y = std::max<int64_t>(firstRow, 0); y <= std::min(lastRow, _rows - 1); ++y) {
+            for(auto x = std::max<int64_t>(firstColumn, 0); x <= std::min(lastColumn, _columns - 1);
+                ++x) {
+                const Point node{
+                    _origin.x + static_cast<double>(x) * spacing,
+                    _origin.y + static_cast<double>(y) * spacing};
+                const auto distance = wall.DistTo(node);
+                const auto nodeIndex = static_cast<size_t>(y * _columns + x);
+                if(distance <= range && distance < nearestDistance[nodeIndex]) {
+                    nearestDistance[nodeIndex] = static_cast<float>(distance);
+                    _nearest[nodeIndex] = index;
+                }
+            }
+        }
+    }
+}
+
+void WallDistanceField::WallsNear(double distance, Point p, std::vector<LineSegment>& out) const
+{
+    out.clear();
+    const auto x = static_cast<int64_t>(std::floor((p.x - _origin.x) / _spacing));
+    const auto y = static_cast<int64_t>(std::floor((p.y - _origin.y) / _spacing));
+    if(x < 0 || y < 0 || x + 1 >= _columns || y + 1 >= _rows) {
+        // The grid extends 'range' beyond all walls
+        return;
+    }
+    const auto node = static_cast<size_t>(y * _columns + x);
+    const auto columns = static_cast<size_t>(_columns);
+    // Nearest walls of the four nodes and the walls connected to them
+    std::array<uint32_t, 12> candidates{};
+    size_t candidateCount = 0;
+    const auto addCandidate = [&candidates, &candidateCount](uint32_t wall) {
+        const auto end = std::begin(candidates) + candidateCount;
+        if(wall != noWall && std::find(std::begin(candidates), end, wall) == end) {
+            candidates[candidateCount++] = wall;
+        }
+    };
+    const std::array<uint32_t, 4> nearestOfNodes{
+        _nearest[node], _nearest[node + 1], _nearest[node + columns], _nearest[node + columns + 1]};
+    for(const auto nearest : nearestOfNodes) {
+        if(nearest == noWall) {
+            continue;
+        }
+        addCandidate(nearest);
+        addCandidate(_connected[nearest][0]);
+        addCandidate(_connected[nearest][1]);
+    }
+    for(size_t index = 0; index < candidateCount; ++index) {
+        const auto& wall = _walls[candidates[index]];
+        if(wall.DistTo(p) <= distance) {
+            out.push_back(wall);
+        }
+    }
+}
+
+double WallDistanceField::MissedWallMargin() const
+{
+    return std::sqrt(2.) * _spacing;
+}
+
+size_t WallDistanceField::MemoryFootprint() const
+{
+    using jps::memory::HeapBytes;
+    return HeapBytes(_walls) + HeapBytes(_connected) + HeapBytes(_nearest);
+}
@@ -1,6 +1,9 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "CollisionGeometry.hpp"
+#include "GeometryBuilder.hpp"
 #include "LineSegment.hpp"
+#include "SharedGeometry.hpp"
+#include "SimulationError.hpp"
 
 #include "gtest/gtest.h"
 #include <fmt/format.h>
@@ -325,3 +328,47 @@ TEST_F(LongDiagonalRectangle, CellsWithTwoLSMiddle)
         ASSERT_EQ(actual, expected);
     }
 }
+
+TEST(SharedGeometry, CopiesShareCollisionGeometryAndRoutingEngine)
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea({{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+    const SharedGeometry geometry(builder.Build());
+    const SharedGeometry copy = geometry;
+
+    ASSERT_EQ(&geometry.Collision(), &copy.Collision());
+    ASSERT_EQ(geometry.Id(), copy.Id());
+
+    const auto routingEngine = copy.Routing();
+    ASSERT_EQ(geometry.Routing().get(), routingEngine.get());
+    ASSERT_TRUE(routingEngine->IsRoutable({5, 5}));
+}
+
+TEST(GeometryBuilder, SimplificationMergesCollinearWallsAndRemovesShortWalls)
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea(
+        {{0, 0},
+         {5, 0},
+         {10, 0},
+         {10, 2},
+         {10.004, 2.001},
+         {10, 2.002},
+         {10, 10},
+         {5, 10.001},
+         {0, 10}});
+    builder.ExcludeFromAccessibleArea({{4, 4}, {5, 4}, {6, 4}, {6, 6}, {4, 6}});
+    ASSERT_EQ(builder.Build().Segments().size(), 14);
+
+    builder.SetSimplificationTolerance(0.01);
+    const auto geometry = builder.Build();
+    ASSERT_EQ(geometry.Segments().size(), 8);
+    const auto& [outer, holes] = geometry.AccessibleArea();
+    ASSERT_EQ(outer.size(), 4);
+    ASSERT_EQ(holes.size(), 1);
+    ASSERT_EQ(holes[0].size(), 4);
+    ASSERT_TRUE(geometry.InsideGeometry({9.9, 2.001}));
+    ASSERT_FALSE(geometry.InsideGeometry({5, 5}));
+
+    ASSERT_THROW(builder.SetSimplificationTolerance(-1), SimulationError);
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "ConvexArea.hpp"
+#include "Polygon.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+TEST(ConvexArea, CannotConstructFromNonConvexPolygon)
+{
+    const Polygon polygon({{0, 0}, {2, 0}, {1, 1}, {2, 2}, {0, 2}});
+    ASSERT_THROW(const ConvexArea area(polygon), SimulationError);
+}
+
+TEST(ConvexArea, ContainsMatchesPolygon)
+{
+    // CW input, Polygon reorders to CCW
+    const Polygon polygon({{0, 0}, {-1, 2}, {1, 4}, {3, 3}, {3, 0}});
+    const ConvexArea area(polygon);
+
+    std::vector<double> xs{};
+    std::vector<double> ys{};
+    for(double x = -2; x <= 4; x += 0.25) {
+        for(double y = -1; y <= 5; y += 0.25) {
+            xs.push_back(x);
+            ys.push_back(y);
+        }
+    }
+    std::vector<uint8_t> inside(xs.size());
+    area.Contains(xs, ys, inside);
+
+    for(size_t index = 0; index < xs.size(); ++index) {
+        const Point p{xs[index], ys[index]};
+        ASSERT_EQ(area.Contains(p), polygon.IsInside(p)) << fmt::format("{}", p);
+        ASSERT_EQ(inside[index] != 0, polygon.IsInside(p)) << fmt::format("{}", p);
+    }
+}
+
+TEST(ConvexArea, BatchWithAllPointsOutsideBounds)
+{
+    const ConvexArea area(Polygon({{0, 0}, {1, 0}, {1, 1}, {0, 1}}));
+    std::vector<double> xs{5, -5, 0.5};
+    std::vector<double> ys{0.5, 0.5, 3};
+    std::vector<uint8_t> inside(xs.size(), 1);
+    area.Contains(xs, ys, inside);
+    ASSERT_EQ(inside, std::vector<uint8_t>({0, 0, 0}));
+}
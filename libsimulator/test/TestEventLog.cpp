@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "EventLog.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+TEST(EventLog, RecordsOnlyWhenEnabled)
+{
+    EventLog log{};
+    log.Push(SimulationEventType::AgentRemoved, GenericAgent::ID{1}, jps::UniqueID<BaseStage>{2});
+    ASSERT_EQ(log.Count(), 0);
+
+    log.SetEnabled(true);
+    log.SetIteration(7);
+    log.Push(SimulationEventType::AgentRemoved, GenericAgent::ID{1}, jps::UniqueID<BaseStage>{2});
+    ASSERT_EQ(log.Count(), 1);
+    std::array<SimulationEvent, 2> buffer{};
+    ASSERT_EQ(log.Drain(buffer), 1);
+    ASSERT_EQ(buffer[0].iteration, 7);
+    ASSERT_EQ(buffer[0].agentId, GenericAgent::ID{1});
+
+    log.Push(SimulationEventType::AgentRemoved, GenericAgent::ID{1}, jps::UniqueID<BaseStage>{2});
+    log.SetEnabled(false);
+    ASSERT_EQ(log.Count(), 0);
+}
+
+TEST(EventLog, DrainsInOrderWithSmallBuffers)
+{
+    EventLog log{};
+    log.SetEnabled(true);
+    uint64_t next = 0;
+    const auto push = [&log, &next](size_t count) {
+        for(size_t index = 0; index < count; ++index) {
+            log.SetIteration(next++);
+            log.Push(
+                SimulationEventType::StageChanged,
+                GenericAgent::ID{1},
+                jps::UniqueID<BaseStage>{2});
+        }
+    };
+
+    push(10);
+    std::vector<uint64_t> read{};
+    std::array<SimulationEvent, 3> buffer{};
+    // Interleave pushing and reading to compact the log while unread events are left
+    for(size_t round = 0; round < 4; ++round) {
+        const auto count = log.Drain(buffer);
+        for(size_t index = 0; index < count; ++index) {
+            read.push_back(buffer[index].iteration);
+        }
+        push(2);
+    }
+    ASSERT_EQ(log.Count(), next - read.size());
+    while(const auto count = log.Drain(buffer)) {
+        for(size_t index = 0; index < count; ++index) {
+            read.push_back(buffer[index].iteration);
+        }
+    }
+    ASSERT_EQ(log.Count(), 0);
+    ASSERT_EQ(read.size(), next);
+    for(size_t index = 0; index < read.size(); ++index) {
+        ASSERT_EQ(read[index], index);
+    }
+}
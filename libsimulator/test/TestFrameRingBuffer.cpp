@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "FrameRingBuffer.hpp"
+
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+std::string bufferName(const std::string& test)
+{
+    return "jupedsim-test-" + test;
+}
+
+struct Columns {
+    std::vector<uint64_t> ids;
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<double> orientationXs;
+    std::vector<double> orientationYs;
+
+    explicit Columns(size_t size)
+        : ids(size), xs(size), ys(size), orientationXs(size), orientationYs(size)
+    {
+    }
+};
+
+void publish(FrameRingBufferWriter& writer, uint64_t frame, size_t count)
+{
+    std::vector<uint64_t> ids{};
+    std::vector<double> values{};
+    for(size_t index = 0; index < count; ++index) {
+        ids.push_back(index + 1);
+        values.push_back(static_cast<double>(frame) + 0.5 * static_cast<double>(index));
+    }
+    writer.Publish(frame, 7, 0.1 * static_cast<double>(frame), ids, values, values, values, values);
+}
+} // namespace
+
+TEST(FrameRingBuffer, ReaderSeesPublishedFrames)
+{
+    const auto name = bufferName("read");
+    FrameRingBufferWriter writer{name, 4, 8};
+    FrameRingBufferReader reader{name};
+    ASSERT_EQ(reader.SlotCount(), 4);
+    ASSERT_EQ(reader.Capacity(), 8);
+
+    Columns columns{reader.Capacity()};
+    ASSERT_FALSE(reader.ReadLatest(
+        columns.ids, columns.xs, columns.ys, columns.orientationXs, columns.orientationYs));
+
+    publish(writer, 10, 3);
+    publish(writer, 20, 2);
+    const auto latest = reader.ReadLatest(
+        columns.ids, columns.xs, columns.ys, columns.orientationXs, columns.orientationYs);
+    ASSERT_TRUE(latest);
+    ASSERT_EQ(latest->index, 1);
+    ASSERT_EQ(latest->frame, 20);
+    ASSERT_EQ(latest->geometryVersion, 7);
+    ASSERT_DOUBLE_EQ(latest->time, 2.0);
+    ASSERT_EQ(latest->agentCount, 2);
+    ASSERT_EQ(columns.ids[1], 2);
+    ASSERT_DOUBLE_EQ(columns.xs[1], 20.5);
+
+    const auto first = reader.Read(
+        0, columns.ids, columns.xs, columns.ys, columns.orientationXs, columns.orientationYs);
+    ASSERT_TRUE(first);
+    ASSERT_EQ(first->frame, 10);
+    ASSERT_EQ(first->agentCount, 3);
+    ASSERT_DOUBLE_EQ(columns.orientationYs[2], 11.0);
+}
+
+TEST(FrameRingBuffer, OverwrittenFramesCannotBeRead)
+{
+    const auto name = bufferName("overwrite");
+    FrameRingBufferWriter writer{name, 2, 4};
+    FrameRingBufferReader reader{name};
+    for(uint64_t frame = 0; frame < 5; ++frame) {
+        publish(writer, frame, 1);
+    }
+    ASSERT_EQ(reader.Published(), 5);
+
+    Columns columns{reader.Capacity()};
+    const auto read = [&](uint64_t index) {
+        return reader.Read(
+            index,
+            columns.ids,
+            columns.xs,
+            columns.ys,
+            columns.orientationXs,
+            columns.orientationYs);
+    };
+    ASSERT_FALSE(read(2));
+    ASSERT_TRUE(read(3));
+    ASSERT_TRUE(read(4));
+    ASSERT_FALSE(read(5));
+}
+
+TEST(FrameRingBuffer, RejectsFramesExceedingCapacity)
+{
+    const auto name = bufferName("capacity");
+    FrameRingBufferWriter writer{name, 2, 2};
+    ASSERT_THROW(publish(writer, 0, 3), SimulationError);
+    FrameRingBufferReader reader{name};
+    ASSERT_EQ(reader.Published(), 0);
+
+    Columns columns{1};
+    ASSERT_THROW(
+        reader.ReadLatest(
+            columns.ids, columns.xs, columns.ys, columns.orientationXs, columns.orientationYs),
+        SimulationError);
+}
+
+TEST(FrameRingBuffer, ReaderRequiresExistingBuffer)
+{
+    const auto name = bufferName("missing");
+    {
+        FrameRingBufferWriter writer{name, 1, 1};
+    }
+    ASSERT_THROW(FrameRingBufferReader{name}, SimulationError);
+}
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "GeometryCache.hpp"
+
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+void addCorridorWithPillar(GeometryBuilder& builder)
+{
+    builder.AddAccessibleArea({{0, 0}, {10, 0}, {10, 4}, {0, 4}});
+    builder.AddAccessibleArea({{8, 0}, {20, 0}, {20, 10}, {8, 10}});
+    builder.ExcludeFromAccessibleArea({{12, 4}, {14, 4}, {14, 6}, {12, 6}});
+}
+
+std::filesystem::path cacheDirectory(const std::string& test)
+{
+    const auto path = std::filesystem::temp_directory_path() / ("jupedsim-geometry-cache-" + test);
+    std::filesystem::remove_all(path);
+    return path;
+}
+} // namespace
+
+TEST(GeometryCache, RestoresBuiltGeometry)
+{
+    GeometryBuilder builder{};
+    addCorridorWithPillar(builder);
+    const SharedGeometry built{builder.Build()};
+    const auto restored =
+        DeserializeGeometry(builder.Fingerprint(), SerializeGeometry(builder.Fingerprint(), built));
+
+    ASSERT_NE(restored.Id(), built.Id());
+    ASSERT_EQ(restored.Collision().AccessibleArea(), built.Collision().AccessibleArea());
+    ASSERT_EQ(restored.Collision().Segments(), built.Collision().Segments());
+    ASSERT_EQ(restored.Collision().Grid(), built.Collision().Grid());
+    ASSERT_EQ(restored.Collision().ApproximateGrid(), built.Collision().ApproximateGrid());
+    ASSERT_TRUE(restored.Collision().InsideGeometry({1, 1}));
+    ASSERT_FALSE(restored.Collision().InsideGeometry({13, 5}));
+
+    const auto builtRouting = built.Routing();
+    const auto restoredRouting = restored.Routing();
+    ASSERT_EQ(
+        restoredRouting->MeshData()->CountPolygons(), builtRouting->MeshData()->CountPolygons());
+    ASSERT_EQ(
+        restoredRouting->ComputeAllWaypoints({1, 1}, {18, 9}),
+        builtRouting->ComputeAllWaypoints({1, 1}, {18, 9}));
+    ASSERT_FALSE(restoredRouting->IsRoutable({13, 5}));
+}
+
+TEST(GeometryCache, RestoresRoutingHierarchy)
+{
+    GeometryBuilder builder{};
+    addCorridorWithPillar(builder);
+    builder.SetRoutingHierarchy(4);
+    const SharedGeometry built{builder.Build(), builder.RoutingRegionSize()};
+    const auto restored =
+        DeserializeGeometry(builder.Fingerprint(), SerializeGeometry(builder.Fingerprint(), built));
+
+    const auto* builtHierarchy = built.Routing()->Hierarchy();
+    const auto* restoredHierarchy = restored.Routing()->Hierarchy();
+    ASSERT_NE(builtHierarchy, nullptr);
+    ASSERT_NE(restoredHierarchy, nullptr);
+    ASSERT_EQ(restoredHierarchy->RegionOfPolygon(), builtHierarchy->RegionOfPolygon());
+    ASSERT_EQ(restoredHierarchy->PortalDistances(), builtHierarchy->PortalDistances());
+    ASSERT_EQ(
+        restored.Routing()->ComputeAllWaypoints({1, 1}, {18, 9}, RoutingAlgorithm::Hierarchical),
+        built.Routing()->ComputeAllWaypoints({1, 1}, {18, 9}, RoutingAlgorithm::Hierarchical));
+
+    GeometryBuilder withoutHierarchy{};
+    addCorridorWithPillar(withoutHierarchy);
+    ASSERT_NE(builder.Fingerprint(), withoutHierarchy.Fingerprint());
+}
+
+TEST(GeometryCache, RejectsEntriesOfOtherInputs)
+{
+    GeometryBuilder builder{};
+    addCorridorWithPillar(builder);
+    GeometryBuilder other{};
+    other.AddAccessibleArea({{0, 0}, {10, 0}, {10, 4}, {0, 4}});
+    ASSERT_NE(builder.Fingerprint(), other.Fingerprint());
+
+    const auto data = SerializeGeometry(builder.Fingerprint(), SharedGeometry{builder.Build()});
+    ASSERT_THROW(DeserializeGeometry(other.Fingerprint(), data), SimulationError);
+    ASSERT_THROW(
+        DeserializeGeometry(builder.Fingerprint(), std::span(data).first(data.size() / 2)),
+        SimulationError);
+}
+
+TEST(GeometryCache, StoresEntryOnFirstBuild)
+{
+    const auto directory = cacheDirectory("store");
+    GeometryBuilder builder{};
+    addCorridorWithPillar(builder);
+    const GeometryCache cache{directory};
+    const auto path = cache.EntryPath(builder.Fingerprint());
+
+    ASSERT_FALSE(cache.Load(builder.Fingerprint()));
+    const auto built = cache.Build(builder);
+    ASSERT_TRUE(std::filesystem::exists(path));
+    const std::filesystem::directory_iterator entries{directory};
+    ASSERT_EQ(std::distance(begin(entries), end(entries)), 1);
+
+    const auto loaded = cache.Build(builder);
+    ASSERT_NE(loaded.Id(), built.Id());
+    ASSERT_EQ(loaded.Collision().AccessibleArea(), built.Collision().AccessibleArea());
+
+    std::ofstream(path, std::ios::trunc) << "not a geometry";
+    ASSERT_THROW(cache.Load(builder.Fingerprint()), SimulationError);
+    const auto rebuilt = cache.Build(builder);
+    ASSERT_EQ(rebuilt.Collision().AccessibleArea(), built.Collision().AccessibleArea());
+    ASSERT_TRUE(cache.Load(builder.Fingerprint()));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(GeometryCache, BuildsGeometryIfEntryCannotBeStored)
+{
+    const auto directory = cacheDirectory("unwritable");
+    GeometryBuilder builder{};
+    addCorridorWithPillar(builder);
+    const GeometryCache cache{directory};
+    std::filesystem::remove_all(directory);
+
+    const SharedGeometry expected{builder.Build()};
+    ASSERT_THROW(cache.Store(builder.Fingerprint(), expected), SimulationError);
+    const auto built = cache.Build(builder);
+    ASSERT_EQ(built.Collision().AccessibleArea(), expected.Collision().AccessibleArea());
+    ASSERT_FALSE(std::filesystem::exists(directory));
+}
@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "Journey.hpp"
+#include "StageManager.hpp"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -84,6 +85,7 @@ TEST(LeastTargetedTransition, NextIsCorrect)
         MOCK_METHOD(bool, IsCompleted, (const GenericAgent& agent), (override));
         MOCK_METHOD(Point, Target, (const GenericAgent& agent), (override));
         MOCK_METHOD(StageProxy, Proxy, (Simulation * simulation_), (override));
+        MOCK_METHOD(StageDescription, Description, (), (const, override));
         void SetTargeting(size_t targeting_) { targeting = targeting_; }
     };
 
@@ -111,3 +113,34 @@ TEST(LeastTargetedTransition, NextIsCorrect)
     mockstage3.SetTargeting(2);
     ASSERT_EQ(&mockstage3, sut.NextStage());
 }
+
+TEST(Journey, NodesAreIndexedByStageOrdinal)
+{
+    std::vector<GenericAgent::ID> removedAgents{};
+    StageManager stageManager{};
+    const auto unused = stageManager.AddStage(WaypointDescription{{0, 0}, 1}, removedAgents);
+    const auto first = stageManager.AddStage(WaypointDescription{{1, 0}, 1}, removedAgents);
+    const auto second = stageManager.AddStage(WaypointDescription{{2, 0}, 1}, removedAgents);
+
+    ASSERT_EQ(stageManager.CountStages(), 3);
+    ASSERT_EQ(stageManager.Stage(unused)->Ordinal(), 0);
+    ASSERT_EQ(stageManager.Stage(first)->Ordinal(), 1);
+    ASSERT_EQ(stageManager.Stage(second)->Ordinal(), 2);
+    ASSERT_EQ(stageManager.StageByOrdinal(2), stageManager.Stage(second));
+
+    auto secondStage = stageManager.Stage(second);
+    std::map<BaseStage::ID, JourneyNode> nodes{};
+    nodes.emplace(
+        first,
+        JourneyNode{stageManager.Stage(first), std::make_unique<FixedTransition>(secondStage)});
+    nodes.emplace(
+        second, JourneyNode{secondStage, std::make_unique<FixedTransition>(secondStage)});
+    Journey sut(std::move(nodes), 4);
+
+    ASSERT_EQ(sut.Ordinal(), 4);
+    ASSERT_EQ(sut.Node(1).stage->Id(), first);
+    ASSERT_EQ(sut.Node(2).stage->Id(), second);
+    ASSERT_EQ(sut.Node(1).transition->NextStage(), secondStage);
+    ASSERT_THROW(sut.Node(0), SimulationError);
+    ASSERT_THROW(sut.Node(3), SimulationError);
+}
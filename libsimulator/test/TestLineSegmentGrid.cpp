@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "LineSegmentGrid.hpp"
+
+#include "LineSegment.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(LineSegmentGrid, MatchesBruteForceQuery)
+{
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<double> coordinate{-20, 20};
+    std::vector<LineSegment> segments{};
+    for(int index = 0; index < 200; ++index) {
+        segments.emplace_back(
+            Point{coordinate(gen), coordinate(gen)}, Point{coordinate(gen), coordinate(gen)});
+    }
+    // Axis aligned segments on cell borders
+    segments.emplace_back(Point{-4, -4}, Point{4, -4});
+    segments.emplace_back(Point{2, -10}, Point{2, 10});
+
+    for(const double cellSize : {0.5, 2., 7.}) {
+        const LineSegmentGrid grid{segments, cellSize};
+        std::vector<LineSegment> found{};
+        for(int query = 0; query < 100; ++query) {
+            const Point p{coordinate(gen) * 1.2, coordinate(gen) * 1.2};
+            const double distance = query % 10;
+            std::vector<LineSegment> expected{};
+            std::copy_if(
+                std::begin(segments),
+                std::end(segments),
+                std::back_inserter(expected),
+                [&](const auto& segment) { return segment.DistTo(p) <= distance; });
+            std::sort(std::begin(expected), std::end(expected));
+
+            grid.SegmentsInDistanceTo(distance, p, found);
+            std::sort(std::begin(found), std::end(found));
+            ASSERT_EQ(found, expected) << "cell size " << cellSize << " query " << query;
+        }
+    }
+}
+
+TEST(LineSegmentGrid, QueriesOutsideOfTheGrid)
+{
+    const LineSegmentGrid grid{{LineSegment{{0, 0}, {1, 0}}}, 1};
+    std::vector<LineSegment> found{LineSegment{{5, 5}, {6, 6}}};
+    grid.SegmentsInDistanceTo(1, {10, 10}, found);
+    ASSERT_TRUE(found.empty());
+    grid.SegmentsInDistanceTo(2, {-2, 0}, found);
+    ASSERT_EQ(found.size(), 1);
+
+    const LineSegmentGrid empty{{}, 1};
+    empty.SegmentsInDistanceTo(100, {0, 0}, found);
+    ASSERT_TRUE(found.empty());
+}
+
+TEST(LineSegmentGrid, RejectsInvalidCellSize)
+{
+    ASSERT_THROW((LineSegmentGrid{{LineSegment{{0, 0}, {1, 0}}}, 0}), SimulationError);
+    ASSERT_THROW((LineSegmentGrid{{LineSegment{{0, 0}, {1, 0}}}, -1}), SimulationError);
+}
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "MeasurementSystem.hpp"
+
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+GenericAgent makeAgent(Point pos)
+{
+    return GenericAgent{
+        GenericAgent::ID::Invalid, {}, {}, pos, {1, 0}, CollisionFreeSpeedModelData{}};
+}
+
+/// Moves each agent by 'offset' within one iteration of length 'dT' ending at 'time'.
+void step(
+    MeasurementSystem& system,
+    std::vector<GenericAgent>& agents,
+    Point offset,
+    double time,
+    double dT)
+{
+    system.Prepare(agents);
+    for(auto& agent : agents) {
+        agent.pos += offset;
+    }
+    system.Run(time, dT, agents);
+}
+} // namespace
+
+TEST(MeasurementSystem, GridAccumulatesDensityAndSpeed)
+{
+    MeasurementSystem system{};
+    AABB bounds{};
+    bounds.xmin = 0;
+    bounds.ymin = 0;
+    bounds.xmax = 4;
+    bounds.ymax = 2;
+    const auto id = system.AddGrid(bounds, 2, 0.5, 0);
+    std::vector<GenericAgent> agents{makeAgent({0.5, 0.5}), makeAgent({0.5, 1.0})};
+
+    step(system, agents, {0.1, 0}, 0.1, 0.1);
+    step(system, agents, {0.1, 0}, 0.2, 0.1);
+
+    const auto& grid = system.Grid(id);
+    ASSERT_EQ(grid.columns, 2);
+    ASSERT_EQ(grid.rows, 1);
+    ASSERT_EQ(grid.samples, 1);
+    const auto density = grid.Density();
+    ASSERT_DOUBLE_EQ(density[0], 0.5);
+    ASSERT_DOUBLE_EQ(density[1], 0.0);
+    const auto speed = grid.MeanSpeed();
+    ASSERT_NEAR(speed[0], 1.0, 1e-12);
+    ASSERT_TRUE(std::isnan(speed[1]));
+}
+
+TEST(MeasurementSystem, LineCountsCrossingsByDirection)
+{
+    MeasurementSystem system{};
+    const auto id = system.AddLine({1, -1}, {1, 1});
+    std::vector<GenericAgent> agents{makeAgent({0.5, 0}), makeAgent({0.5, 5})};
+
+    step(system, agents, {1, 0}, 1, 1);
+    step(system, agents, {-1, 0}, 2, 1);
+    step(system, agents, {-1, 0}, 3, 1);
+
+    const auto& line = system.Line(id);
+    ASSERT_EQ(line.forward, 1);
+    ASSERT_EQ(line.backward, 1);
+    ASSERT_EQ(line.crossings.size(), 2);
+    ASSERT_EQ(line.crossings[0].agent, agents[0].id);
+    ASSERT_EQ(line.crossings[0].direction, -1);
+    ASSERT_DOUBLE_EQ(line.crossings[0].time, 0.5);
+    ASSERT_EQ(line.crossings[1].direction, 1);
+    ASSERT_DOUBLE_EQ(line.crossings[1].time, 1.5);
+}
+
+TEST(MeasurementSystem, AreaCountsAgentsInConvexAndConcavePolygons)
+{
+    MeasurementSystem system{};
+    const auto convex = system.AddArea({{0, 0}, {2, 0}, {2, 2}, {0, 2}}, 1, 0);
+    const auto concave = system.AddArea({{0, 0}, {2, 0}, {2, 2}, {1, 1}, {0, 2}}, 1, 0);
+    std::vector<GenericAgent> agents{makeAgent({0.5, 0.5}), makeAgent({1, 1.5})};
+
+    step(system, agents, {0, 0}, 0.5, 0.5);
+    step(system, agents, {0, 0}, 1.0, 0.5);
+
+    const auto& convexArea = system.Area(convex);
+    ASSERT_EQ(convexArea.times, (std::vector<double>{0.5, 1.0}));
+    ASSERT_EQ(convexArea.counts, (std::vector<uint64_t>{2, 2}));
+    ASSERT_EQ(system.Area(concave).counts, (std::vector<uint64_t>{1, 1}));
+}
+
+TEST(MeasurementSystem, RejectsInvalidParameters)
+{
+    MeasurementSystem system{};
+    AABB bounds{};
+    bounds.xmin = 0;
+    bounds.ymin = 0;
+    bounds.xmax = 1;
+    bounds.ymax = 1;
+    ASSERT_THROW(system.AddGrid(bounds, 0, 1, 0), SimulationError);
+    ASSERT_THROW(system.AddGrid(bounds, 1, 0, 0), SimulationError);
+    ASSERT_THROW(system.AddLine({1, 1}, {1, 1}), SimulationError);
+    ASSERT_THROW(system.Grid(0), SimulationError);
+}
@@ -5,6 +5,9 @@
 #include <glm/vec2.hpp>
 #include <gtest/gtest.h>
 
+#include <random>
+#include <vector>
+
 class SingleTriangeMesh : public ::testing::Test
 {
 public:
@@ -81,3 +84,41 @@ TEST_F(DoubleBottleNeckMesh, RegressionInContains)
         m->FindContainingPolygon({26.690912185191067, 4.94908998002494}),
         Mesh::Polygon::InvalidIndex);
 }
+
+TEST_F(DoubleBottleNeckMesh, FindContainingPolygonMatchesLinearScan)
+{
+    const auto linearScan = [](const Mesh& mesh, glm::dvec2 p) {
+        for(size_t index = 0; index < mesh.CountPolygons(); ++index) {
+            if(mesh.AxisAlignedBoundingBox(index).Inside({p.x, p.y}) &&
+               mesh.PolygonContains(index, p)) {
+                return index;
+            }
+        }
+        return Mesh::Polygon::InvalidIndex;
+    };
+
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<double> x{-2, 30};
+    std::uniform_real_distribution<double> y{-2, 12};
+    std::vector<glm::dvec2> points{};
+    for(int index = 0; index < 1000; ++index) {
+        points.emplace_back(x(gen), y(gen));
+    }
+    // Mesh vertices lie on shared edges
+    for(size_t index = 0; index < m->CountVertices(); ++index) {
+        points.push_back(m->Vertex(index));
+    }
+
+    for(const bool merged : {false, true}) {
+        if(merged) {
+            m->MergeGreedy();
+        }
+        const auto found = m->FindContainingPolygons(points);
+        ASSERT_EQ(found.size(), points.size());
+        for(size_t index = 0; index < points.size(); ++index) {
+            ASSERT_EQ(found[index], linearScan(*m, points[index]))
+                << "merged " << merged << " point " << index;
+            ASSERT_EQ(found[index], m->FindContainingPolygon(points[index]));
+        }
+    }
+}
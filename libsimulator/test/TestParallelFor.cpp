@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "ParallelFor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(ParallelFor, RunsEachTaskExactlyOnce)
+{
+    for(const size_t threadCount : {0, 1, 3, 8}) {
+        std::vector<std::atomic<int>> calls(97);
+        jps::ParallelFor(calls.size(), threadCount, [&calls](size_t index) {
+            // Uneven durations force threads to steal work
+            if(index % 10 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ++calls[index];
+        });
+        for(const auto& count : calls) {
+            ASSERT_EQ(count, 1);
+        }
+    }
+}
+
+TEST(ParallelFor, RethrowsAfterAllTasksRan)
+{
+    std::atomic<size_t> calls{0};
+    ASSERT_THROW(
+        jps::ParallelFor(
+            20,
+            4,
+            [&calls](size_t index) {
+                ++calls;
+                if(index == 3) {
+                    throw std::runtime_error("failed");
+                }
+            }),
+        std::runtime_error);
+    ASSERT_EQ(calls, 20);
+}
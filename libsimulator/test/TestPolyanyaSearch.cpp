@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "CfgCgal.hpp"
+#include "PolyanyaSearch.hpp"
+#include "RoutingEngine.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace
+{
+Poly square(double xmin, double ymin, double xmax, double ymax)
+{
+    const std::vector<K::Point_2> points{{xmin, ymin}, {xmax, ymin}, {xmax, ymax}, {xmin, ymax}};
+    return Poly{points.begin(), points.end()};
+}
+
+double pathLength(const std::vector<Point>& path)
+{
+    double length = 0;
+    for(size_t index = 1; index < path.size(); ++index) {
+        length += Distance(path[index - 1], path[index]);
+    }
+    return length;
+}
+} // namespace
+
+class PillarHall : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        // 20 x 20 hall with a 3 x 3 grid of 2 x 2 pillars
+        PolyWithHoles hall(square(0, 0, 20, 20));
+        for(const auto x : {4., 9., 14.}) {
+            for(const auto y : {4., 9., 14.}) {
+                auto pillar = square(x, y, x + 2, y + 2);
+                pillar.reverse_orientation();
+                hall.add_hole(pillar);
+            }
+        }
+        engine = std::make_unique<RoutingEngine>(hall);
+    }
+
+protected:
+    std::unique_ptr<RoutingEngine> engine{};
+};
+
+TEST_F(PillarHall, PathAroundPillarIsOptimal)
+{
+    const auto path = engine->ComputeAllWaypoints({1, 5}, {8, 5}, RoutingAlgorithm::Polyanya);
+    ASSERT_EQ(path.size(), 4);
+    EXPECT_EQ(path.front(), Point(1, 5));
+    EXPECT_EQ(path.back(), Point(8, 5));
+    EXPECT_NEAR(pathLength(path), std::sqrt(10.) + 2 + std::sqrt(5.), 1e-9);
+}
+
+TEST_F(PillarHall, VisibleTargetIsReachedDirectly)
+{
+    const auto path = engine->ComputeAllWaypoints({1, 1}, {19, 3}, RoutingAlgorithm::Polyanya);
+    EXPECT_EQ(path, (std::vector<Point>{{1, 1}, {19, 3}}));
+}
+
+TEST_F(PillarHall, PathsAreNotLongerThanTriangleAStar)
+{
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<double> dist{0, 20};
+    const auto randomPoint = [&]() {
+        while(true) {
+            const Point p{dist(gen), dist(gen)};
+            if(engine->IsRoutable(p)) {
+                return p;
+            }
+        }
+    };
+    for(size_t pair = 0; pair < 200; ++pair) {
+        const auto from = randomPoint();
+        const auto to = randomPoint();
+        const auto polyanya = engine->ComputeAllWaypoints(from, to, RoutingAlgorithm::Polyanya);
+        const auto aStar = engine->ComputeAllWaypoints(from, to, RoutingAlgorithm::TriangleAStar);
+        ASSERT_EQ(polyanya.front(), from);
+        ASSERT_EQ(polyanya.back(), to);
+        EXPECT_LE(pathLength(polyanya), pathLength(aStar) + 1e-9);
+    }
+}
+
+TEST_F(PillarHall, BatchMatchesSingleQueries)
+{
+    std::mt19937 gen{7};
+    std::uniform_real_distribution<double> dist{0, 20};
+    std::vector<Point> from{};
+    std::vector<Point> to{};
+    for(size_t pair = 0; pair < 100; ++pair) {
+        from.emplace_back(dist(gen), dist(gen));
+        to.emplace_back(dist(gen), dist(gen));
+    }
+    std::mutex mutex{};
+    std::vector<std::vector<Point>> paths(from.size());
+    std::vector<size_t> calls(from.size(), 0);
+    engine->ComputeAllWaypointsBatch(
+        from,
+        to,
+        [&](size_t index, const std::vector<Point>& path) {
+            std::scoped_lock lock(mutex);
+            paths[index] = path;
+            ++calls[index];
+        },
+        RoutingAlgorithm::Polyanya,
+        4);
+
+    for(size_t index = 0; index < from.size(); ++index) {
+        ASSERT_EQ(calls[index], 1);
+        if(!engine->IsRoutable(from[index]) || !engine->IsRoutable(to[index])) {
+            EXPECT_TRUE(paths[index].empty());
+            continue;
+        }
+        EXPECT_EQ(
+            paths[index],
+            engine->ComputeAllWaypoints(from[index], to[index], RoutingAlgorithm::Polyanya));
+    }
+}
+
+TEST_F(PillarHall, PointsOutsideOfMeshThrow)
+{
+    EXPECT_THROW(
+        engine->ComputeAllWaypoints({5, 5}, {1, 1}, RoutingAlgorithm::Polyanya), SimulationError);
+    EXPECT_THROW(
+        engine->ComputeAllWaypoints({1, 1}, {21, 1}, RoutingAlgorithm::Polyanya), SimulationError);
+}
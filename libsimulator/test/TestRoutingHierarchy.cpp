@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "CfgCgal.hpp"
+#include "RoutingEngine.hpp"
+#include "RoutingHierarchy.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+Poly square(double xmin, double ymin, double xmax, double ymax)
+{
+    const std::vector<K::Point_2> points{{xmin, ymin}, {xmax, ymin}, {xmax, ymax}, {xmin, ymax}};
+    return Poly{points.begin(), points.end()};
+}
+
+double pathLength(const std::vector<Point>& path)
+{
+    double length = 0;
+    for(size_t index = 1; index < path.size(); ++index) {
+        length += Distance(path[index - 1], path[index]);
+    }
+    return length;
+}
+} // namespace
+
+class PillarField : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        // 60 x 60 field with a 12 x 12 grid of 2 x 2 pillars
+        PolyWithHoles field(square(0, 0, 60, 60));
+        for(int x = 0; x < 12; ++x) {
+            for(int y = 0; y < 12; ++y) {
+                auto pillar = square(5. * x + 2, 5. * y + 2, 5. * x + 4, 5. * y + 4);
+                pillar.reverse_orientation();
+                field.add_hole(pillar);
+            }
+        }
+        engine = std::make_unique<RoutingEngine>(field, 10.);
+        single = std::make_unique<RoutingEngine>(field, 100.);
+    }
+
+    Point randomPoint()
+    {
+        std::uniform_real_distribution<double> dist{0, 60};
+        while(true) {
+            const Point p{dist(gen), dist(gen)};
+            if(engine->IsRoutable(p)) {
+                return p;
+            }
+        }
+    }
+
+protected:
+    std::unique_ptr<RoutingEngine> engine{};
+    /// Hierarchy with a single region covering the field
+    std::unique_ptr<RoutingEngine> single{};
+    std::mt19937 gen{42};
+};
+
+TEST_F(PillarField, RegionsFollowRegionSize)
+{
+    ASSERT_NE(engine->Hierarchy(), nullptr);
+    // At least one region per 10 x 10 cell, at least one portal between neighboring cells
+    EXPECT_GE(engine->Hierarchy()->CountRegions(), 6 * 6);
+    EXPECT_GE(engine->Hierarchy()->CountPortals(), 2 * 6 * 5);
+
+    ASSERT_NE(single->Hierarchy(), nullptr);
+    EXPECT_EQ(single->Hierarchy()->CountRegions(), 1);
+    EXPECT_EQ(single->Hierarchy()->CountPortals(), 0);
+    const auto path = single->ComputeAllWaypoints({1, 1}, {59, 59}, RoutingAlgorithm::Hierarchical);
+    EXPECT_EQ(path.front(), Point(1, 1));
+    EXPECT_EQ(path.back(), Point(59, 59));
+}
+
+TEST_F(PillarField, PathsAreCloseToShortestPaths)
+{
+    double hierarchicalLength = 0;
+    double shortestLength = 0;
+    for(size_t pair = 0; pair < 200; ++pair) {
+        const auto from = randomPoint();
+        const auto to = randomPoint();
+        const auto hierarchical =
+            engine->ComputeAllWaypoints(from, to, RoutingAlgorithm::Hierarchical);
+        const auto shortest = engine->ComputeAllWaypoints(from, to, RoutingAlgorithm::Polyanya);
+        ASSERT_EQ(hierarchical.front(), from);
+        ASSERT_EQ(hierarchical.back(), to);
+        EXPECT_GE(pathLength(hierarchical), pathLength(shortest) - 1e-9);
+        hierarchicalLength += pathLength(hierarchical);
+        shortestLength += pathLength(shortest);
+    }
+    EXPECT_LE(hierarchicalLength, 1.05 * shortestLength);
+}
+
+TEST_F(PillarField, RestoredHierarchyFindsSamePaths)
+{
+    const auto* built = engine->Hierarchy();
+    const RoutingHierarchy restored(
+        *engine->MeshData(),
+        built->RegionSize(),
+        built->RegionOfPolygon(),
+        built->PortalDistances());
+    for(size_t pair = 0; pair < 20; ++pair) {
+        const auto from = randomPoint();
+        const auto to = randomPoint();
+        EXPECT_EQ(
+            restored.ComputeAllWaypoints(*engine->MeshData(), from, to),
+            built->ComputeAllWaypoints(*engine->MeshData(), from, to));
+    }
+    EXPECT_THROW(
+        RoutingHierarchy(*engine->MeshData(), 10., built->RegionOfPolygon(), {}), SimulationError);
+}
+
+TEST_F(PillarField, PointsOutsideOfMeshThrow)
+{
+    EXPECT_THROW(
+        engine->ComputeAllWaypoints({3, 3}, {1, 1}, RoutingAlgorithm::Hierarchical),
+        SimulationError);
+    EXPECT_THROW(RoutingHierarchy(*engine->MeshData(), 0.), SimulationError);
+}
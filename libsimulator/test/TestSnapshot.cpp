@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "Snapshot.hpp"
+
+#include "GenericAgent.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+TEST(Snapshot, ReadsValuesInWriteOrder)
+{
+    SnapshotWriter writer{};
+    writer.Write(uint8_t{7});
+    writer.Write(2.5);
+    writer.Write(GenericAgent::ID{42});
+    writer.WriteArray(std::vector<Point>{{1, 2}, {3, 4}});
+    writer.WriteArray(std::vector<GenericAgent::ID>{5, 6});
+    writer.WriteArray(std::vector<double>{});
+
+    SnapshotReader reader{writer.Data()};
+    ASSERT_EQ(reader.Read<uint8_t>(), 7);
+    ASSERT_EQ(reader.Read<double>(), 2.5);
+    ASSERT_EQ(reader.ReadId<GenericAgent>(), GenericAgent::ID{42});
+    ASSERT_EQ(reader.ReadArray<Point>(), (std::vector<Point>{{1, 2}, {3, 4}}));
+    ASSERT_EQ(reader.ReadIds<GenericAgent>(), (std::vector<GenericAgent::ID>{5, 6}));
+    ASSERT_TRUE(reader.ReadArray<double>().empty());
+    ASSERT_TRUE(reader.AtEnd());
+}
+
+TEST(Snapshot, ThrowsOnTruncatedData)
+{
+    SnapshotWriter writer{};
+    writer.WriteArray(std::vector<double>{1, 2, 3});
+    auto data = writer.Release();
+    data.pop_back();
+
+    SnapshotReader reader{data};
+    ASSERT_THROW(reader.ReadArray<double>(), SimulationError);
+}
@@ -59,3 +59,44 @@ TEST_F(StagesTests, NotifiableWaitingSetTargetIsCorrect)
         ASSERT_EQ(target, waitingPoints.back());
     }
 }
+
+TEST_F(StagesTests, NotifiableQueueOnlyNeedsUpdateWithUnassignedAgents)
+{
+    std::vector<Point> slots = {{-9, -9}, {-8, -9}, {-7, -9}};
+    NotifiableQueue queue(slots);
+    ASSERT_FALSE(queue.HasUnassignedAgents());
+
+    std::vector<GenericAgent> agents{};
+    for(const auto& pos : std::vector<Point>{{-9, -8.5}, {-8, -8.5}}) {
+        agents.emplace_back(
+            GenericAgent::ID::Invalid,
+            Journey::ID::Invalid,
+            queue.Id(),
+            pos,
+            Point{},
+            CollisionFreeSpeedModelData{});
+        neighborhoodSearch.AddAgent(agents.back());
+        queue.IncreaseTargeting(agents.back().id);
+    }
+    ASSERT_TRUE(queue.HasUnassignedAgents());
+
+    // Both agents are assigned with a single update
+    queue.Update(neighborhoodSearch, *collisionGeometry);
+    ASSERT_EQ(queue.Occupants().size(), 2);
+    ASSERT_EQ(queue.Target(agents[0]), slots[0]);
+    ASSERT_EQ(queue.Target(agents[1]), slots[1]);
+    ASSERT_FALSE(queue.HasUnassignedAgents());
+
+    // Popped agents remain assigned until they leave the stage
+    EventLog eventLog{};
+    queue.Pop(1, eventLog);
+    ASSERT_EQ(queue.Target(agents[1]), slots[0]);
+    ASSERT_FALSE(queue.HasUnassignedAgents());
+    ASSERT_TRUE(queue.IsCompleted(agents[0]));
+    queue.DecreaseTargeting(agents[0].id);
+    ASSERT_FALSE(queue.HasUnassignedAgents());
+
+    // Agents leaving the stage after being assigned do not count as unassigned
+    queue.DecreaseTargeting(agents[1].id);
+    ASSERT_FALSE(queue.HasUnassignedAgents());
+}
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "TrajectoryFile.hpp"
+
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<double> decode(const TrajectoryFileReader& reader, const void* column, size_t count)
+{
+    std::vector<double> values(count);
+    reader.Decode(column, count, values);
+    return values;
+}
+
+std::string tempPath(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+} // namespace
+
+class TrajectoryFileRoundTrip : public ::testing::TestWithParam<TrajectoryStorage>
+{
+};
+
+TEST_P(TrajectoryFileRoundTrip, ReadsFramesSortedById)
+{
+    const auto path = tempPath("jupedsim-trajectory-file-test.jps");
+    {
+        TrajectoryFileWriter writer{path, GetParam(), 0.001};
+        writer.SetMetadata("fps", "10");
+        writer.SetMetadata("fps", "25");
+        const auto geometry = writer.AddGeometry(-17, "POLYGON ((0 0, 1 0, 1 1, 0 0))");
+        ASSERT_EQ(writer.AddGeometry(-17, "ignored"), geometry);
+        const std::vector<uint64_t> ids{1000000, 3, 7};
+        const std::vector<double> xs{1.5, -2.25, 3.125};
+        const std::vector<double> ys{0.5, 0.75, -100.0};
+        const std::vector<double> orientationXs{1, 0, -1};
+        const std::vector<double> orientationYs{0, 1, 0};
+        writer.WriteFrame(0, geometry, ids, xs, ys, orientationXs, orientationYs);
+        writer.WriteFrame(4, geometry, {}, {}, {}, {}, {});
+        writer.Close();
+    }
+
+    const TrajectoryFileReader reader{path};
+    ASSERT_EQ(reader.ValueStorage(), GetParam());
+    ASSERT_EQ(reader.Metadata().size(), 1);
+    ASSERT_EQ(reader.Metadata()[0].first, "fps");
+    ASSERT_EQ(reader.Metadata()[0].second, "25");
+    ASSERT_EQ(reader.Geometries().size(), 1);
+    ASSERT_EQ(reader.Geometries()[0].hash, -17);
+    ASSERT_EQ(reader.Geometries()[0].wkt, "POLYGON ((0 0, 1 0, 1 1, 0 0))");
+    ASSERT_EQ(reader.Frames().size(), 2);
+
+    const auto frame = reader.Frame(0);
+    ASSERT_EQ(frame.frame, 0);
+    ASSERT_EQ(frame.geometry, 0);
+    ASSERT_EQ(frame.agentCount, 3);
+    std::vector<uint64_t> ids(frame.agentCount);
+    reader.Ids(0, ids);
+    ASSERT_EQ(ids, (std::vector<uint64_t>{3, 7, 1000000}));
+    ASSERT_EQ(decode(reader, frame.x, 3), (std::vector<double>{-2.25, 3.125, 1.5}));
+    ASSERT_EQ(decode(reader, frame.y, 3), (std::vector<double>{0.75, -100.0, 0.5}));
+    ASSERT_EQ(decode(reader, frame.orientationX, 3), (std::vector<double>{0, -1, 1}));
+    ASSERT_EQ(decode(reader, frame.orientationY, 3), (std::vector<double>{1, 0, 0}));
+
+    const auto emptyFrame = reader.Frame(1);
+    ASSERT_EQ(emptyFrame.frame, 4);
+    ASSERT_EQ(emptyFrame.agentCount, 0);
+    std::filesystem::remove(path);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TrajectoryFile,
+    TrajectoryFileRoundTrip,
+    ::testing::Values(
+        TrajectoryStorage::Float64,
+        TrajectoryStorage::Float32,
+        TrajectoryStorage::Quantized));
+
+TEST(TrajectoryFile, ColumnsAreAligned)
+{
+    const auto path = tempPath("jupedsim-trajectory-file-aligned.jps");
+    {
+        TrajectoryFileWriter writer{path, TrajectoryStorage::Float64, 0};
+        const auto geometry = writer.AddGeometry(0, "");
+        const std::vector<uint64_t> ids{1, 200, 70000};
+        const std::vector<double> values{1, 2, 3};
+        writer.WriteFrame(0, geometry, ids, values, values, values, values);
+        writer.WriteFrame(1, geometry, ids, values, values, values, values);
+        writer.Close();
+    }
+    const TrajectoryFileReader reader{path};
+    for(size_t index = 0; index < reader.Frames().size(); ++index) {
+        const auto frame = reader.Frame(index);
+        for(const auto column : {frame.x, frame.y, frame.orientationX, frame.orientationY}) {
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(column) % alignof(double), 0);
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(TrajectoryFile, RejectsUnclosedFile)
+{
+    const auto path = tempPath("jupedsim-trajectory-file-unclosed.jps");
+    {
+        TrajectoryFileWriter writer{path, TrajectoryStorage::Float32, 0};
+        const auto geometry = writer.AddGeometry(0, "");
+        const std::vector<uint64_t> ids{1};
+        const std::vector<double> values{1};
+        writer.WriteFrame(0, geometry, ids, values, values, values, values);
+    }
+    ASSERT_THROW(TrajectoryFileReader{path}, SimulationError);
+    std::filesystem::remove(path);
+}
+
+TEST(TrajectoryFile, RejectsAgentCountBeyondFileSize)
+{
+    const auto path = tempPath("jupedsim-trajectory-file-agent-count.jps");
+    {
+        TrajectoryFileWriter writer{path, TrajectoryStorage::Float64, 0};
+        const auto geometry = writer.AddGeometry(0, "");
+        const std::vector<uint64_t> ids{1};
+        const std::vector<double> values{1};
+        writer.WriteFrame(0, geometry, ids, values, values, values, values);
+        writer.Close();
+    }
+    const auto offset = TrajectoryFileReader{path}.Frames().front().offset;
+    {
+        // 2^61 agents with 8 byte values wrap the column size around to zero
+        const uint64_t agentCount = uint64_t{1} << 61;
+        std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(&agentCount), sizeof(agentCount));
+    }
+    ASSERT_THROW(TrajectoryFileReader{path}, SimulationError);
+    std::filesystem::remove(path);
+}
+
+TEST(TrajectoryFile, RejectsValuesOutsideQuantizedRange)
+{
+    const auto path = tempPath("jupedsim-trajectory-file-range.jps");
+    TrajectoryFileWriter writer{path, TrajectoryStorage::Quantized, 1e-6};
+    const auto geometry = writer.AddGeometry(0, "");
+    const std::vector<uint64_t> ids{1};
+    const std::vector<double> values{1e6};
+    ASSERT_THROW(
+        writer.WriteFrame(0, geometry, ids, values, values, values, values), SimulationError);
+    std::filesystem::remove(path);
+}
+
+TEST(TrajectoryFile, RejectsFramesOutOfOrder)
+{
+    const auto path = tempPath("jupedsim-trajectory-file-order.jps");
+    TrajectoryFileWriter writer{path, TrajectoryStorage::Float64, 0};
+    const auto geometry = writer.AddGeometry(0, "");
+    writer.WriteFrame(3, geometry, {}, {}, {}, {}, {});
+    ASSERT_THROW(writer.WriteFrame(3, geometry, {}, {}, {}, {}, {}), SimulationError);
+    ASSERT_THROW(writer.WriteFrame(2, geometry, {}, {}, {}, {}, {}), SimulationError);
+    std::filesystem::remove(path);
+}
@@ -20,6 +20,17 @@ TEST(UniqueId, CanBeConstructedFromUnderlyingType)
     ASSERT_EQ(first_sentinel.getID() + 1, second_sentinel.getID());
 }
 
+TEST(UniqueId, ReserveSkipsRestoredIDs)
+{
+    struct Tag;
+    const jps::UniqueID<Tag> before{};
+    jps::UniqueID<Tag>::Reserve(before.getID() + 100);
+    ASSERT_EQ(jps::UniqueID<Tag>{}.getID(), before.getID() + 101);
+    // Reserving an id below the counter has no effect
+    jps::UniqueID<Tag>::Reserve(before.getID());
+    ASSERT_EQ(jps::UniqueID<Tag>{}.getID(), before.getID() + 102);
+}
+
 TEST(UniqueId, DefaultConstructedIDsAreNotIdentical)
 {
     const auto first = jps::UniqueID<void>{};
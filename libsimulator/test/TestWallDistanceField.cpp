@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "WallDistanceField.hpp"
+
+#include "CollisionGeometry.hpp"
+#include "LineSegment.hpp"
+#include "OperationalModel.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+TEST(WallDistanceField, MissedWallsAreWithinErrorBound)
+{
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<double> coordinate{-10, 10};
+    std::vector<LineSegment> walls{};
+    for(int index = 0; index < 100; ++index) {
+        const Point start{coordinate(gen), coordinate(gen)};
+        walls.emplace_back(start, start + Point{coordinate(gen), coordinate(gen)} * 0.2);
+    }
+
+    for(const double spacing : {0.05, 0.2, 0.5}) {
+        const double range = 2.5;
+        const WallDistanceField field{walls, spacing, range};
+        const double distance = range - field.MissedWallMargin();
+        std::vector<LineSegment> found{};
+        for(int query = 0; query < 500; ++query) {
+            const Point p{coordinate(gen) * 1.2, coordinate(gen) * 1.2};
+            field.WallsNear(distance, p, found);
+
+            double nearestFound = distance;
+            for(const auto& wall : found) {
+                ASSERT_LE(wall.DistTo(p), distance);
+                ASSERT_EQ(std::count(std::begin(found), std::end(found), wall), 1);
+                nearestFound = std::min(nearestFound, wall.DistTo(p));
+            }
+            double nearest = std::numeric_limits<double>::max();
+            for(const auto& wall : walls) {
+                nearest = std::min(nearest, wall.DistTo(p));
+                if(wall.DistTo(p) <= distance &&
+                   std::find(std::begin(found), std::end(found), wall) == std::end(found)) {
+                    ASSERT_GE(wall.DistTo(p), nearestFound - field.MissedWallMargin())
+                        << "spacing " << spacing << " query " << query;
+                }
+            }
+            // The nearest wall is always found up to the error margin
+            if(nearest <= distance) {
+                ASSERT_FALSE(found.empty());
+                ASSERT_LE(nearestFound, nearest + field.MissedWallMargin());
+            }
+        }
+    }
+}
+
+TEST(WallDistanceField, WallForceErrorOnReferenceGeometry)
+{
+    // Room with a pillar, a zigzag wall with acute corners, a free standing wall and a corridor
+    // just wide enough for an agent
+    const std::vector<Point> room{{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    const std::vector<Point> pillar{{4, 4}, {6, 4}, {6, 6}, {4, 6}};
+    const std::vector<Point> zigzag{{1, 1}, {2, 2.5}, {3, 1}, {4, 2.5}, {5, 1}};
+    std::vector<LineSegment> walls{};
+    for(const auto* loop : {&room, &pillar}) {
+        for(size_t index = 0; index < loop->size(); ++index) {
+            walls.emplace_back((*loop)[index], (*loop)[(index + 1) % loop->size()]);
+        }
+    }
+    for(size_t index = 1; index < zigzag.size(); ++index) {
+        walls.emplace_back(zigzag[index - 1], zigzag[index]);
+    }
+    walls.emplace_back(Point{2, 8}, Point{8, 8});
+    walls.emplace_back(Point{6, 1}, Point{9, 1});
+    walls.emplace_back(Point{6, 1.5}, Point{9, 1.5});
+
+    // Wall force of the collision free speed model with its default parameters
+    const double strength = 5;
+    const double range = 0.02;
+    const double radius = 0.2;
+    const double interactionRange = ExponentialWallInteractionRange(strength, range, radius);
+    const auto force = [&](Point p, const auto& segments) {
+        Point sum{};
+        for(const auto& wall : segments) {
+            const auto [dist, direction] = (wall.ShortestPoint(p) - p).NormAndNormalized();
+            if(dist <= interactionRange) {
+                sum += direction * -strength * std::exp((radius - dist) / range);
+            }
+        }
+        return sum;
+    };
+
+    // Error bound stated in the documentation of 'WallDistanceField', the desired direction the
+    // wall force is added to has length 1
+    const double maxForceError = 0.2;
+    for(const double spacing : {0.05, 0.1, 0.2}) {
+        const WallDistanceField field{walls, spacing, DEFAULT_WALL_DISTANCE_FIELD_RANGE};
+        std::vector<LineSegment> found{};
+        double maxError = 0;
+        for(double x = 0.01; x < 10; x += 0.02) {
+            for(double y = 0.01; y < 10; y += 0.02) {
+                const Point p{x, y};
+                const auto insidePillar = x > 4 && x < 6 && y > 4 && y < 6;
+                const auto overlapsWall = std::any_of(
+                    std::begin(walls), std::end(walls), [&](const auto& wall) {
+                        return wall.DistTo(p) < radius;
+                    });
+                if(insidePillar || overlapsWall) {
+                    continue;
+                }
+                field.WallsNear(interactionRange, p, found);
+                maxError = std::max(maxError, (force(p, found) - force(p, walls)).Norm());
+            }
+        }
+        ASSERT_LE(maxError, maxForceError) << "spacing " << spacing;
+    }
+}
+
+TEST(WallDistanceField, QueriesOutsideOfTheField)
+{
+    const WallDistanceField field{{LineSegment{{0, 0}, {1, 0}}}, 0.1, 1};
+    std::vector<LineSegment> found{LineSegment{{5, 5}, {6, 6}}};
+    field.WallsNear(0.5, {10, 10}, found);
+    ASSERT_TRUE(found.empty());
+    field.WallsNear(0.5, {0.5, 0.6}, found);
+    ASSERT_TRUE(found.empty());
+    field.WallsNear(0.5, {0.5, 0.3}, found);
+    ASSERT_EQ(found.size(), 1);
+
+    const WallDistanceField empty{{}, 0.1, 1};
+    empty.WallsNear(0.5, {0, 0}, found);
+    ASSERT_TRUE(found.empty());
+}
+
+TEST(WallDistanceField, RejectsInvalidParameters)
+{
+    ASSERT_THROW((WallDistanceField{{LineSegment{{0, 0}, {1, 0}}}, 0, 1}), SimulationError);
+    ASSERT_THROW((WallDistanceField{{LineSegment{{0, 0}, {1, 0}}}, 0.1, -1}), SimulationError);
+}
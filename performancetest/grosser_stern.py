@@ -44417,6 +44417,11 @@ def parse_args():
         default=100 * 60 * 15,
         help="number of iterations to run",
     )
+    ap.add_argument(
+        "--hardware-counters",
+        action="store_true",
+        help="sample hardware performance counters (Linux only)",
+    )
     return ap.parse_args()
 
 
@@ -44442,7 +44447,8 @@ def main():
             output_file=pathlib.Path(
                 f"{jps.get_build_info().git_commit_hash}_grosser_stern.sqlite"
             ),
-        )
+        ),
+        hardware_counters=args.hardware_counters,
     )
     simulation = jps.Simulation(
         model=jps.CollisionFreeSpeedModel(),
@@ -180,6 +180,23 @@ def parse_args():
         default=100 * 60 * 15,
         help="number of iterations to run",
     )
+    ap.add_argument(
+        "--hardware-counters",
+        action="store_true",
+        help="sample hardware performance counters (Linux only)",
+    )
+    ap.add_argument(
+        "--routing-algorithm",
+        choices=[algorithm.name.lower() for algorithm in jps.RoutingAlgorithm],
+        default=jps.RoutingAlgorithm.TRIANGLE_A_STAR.name.lower(),
+        help="path search used to route the agents",
+    )
+    ap.add_argument(
+        "--routing-region-size",
+        type=float,
+        default=0,
+        help="region size (in m) of the routing hierarchy, 0 disables it",
+    )
     return ap.parse_args()
 
 
@@ -205,13 +222,20 @@ def main():
             output_file=pathlib.Path(
                 f"{jps.get_build_info().git_commit_hash}_large_street_network.sqlite"
             ),
-        )
+        ),
+        hardware_counters=args.hardware_counters,
     )
     simulation = jps.Simulation(
         model=jps.CollisionFreeSpeedModel(),
-        geometry=geometries["large_street_network"],
+        geometry=jps.build_geometry(
+            geometries["large_street_network"],
+            routing_region_size=args.routing_region_size,
+        ),
         trajectory_writer=stats_writer,
     )
+    simulation.set_routing_algorithm(
+        jps.RoutingAlgorithm[args.routing_algorithm.upper()]
+    )
 
     journey, (start_stage, waiting_area, queue) = create_journey(simulation)
     spawners = [
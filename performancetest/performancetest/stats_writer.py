@@ -18,13 +18,19 @@ class StatsWriter(jps.TrajectoryWriter):
         self,
         trajectory_writer: jps.SqliteTrajectoryWriter,
         description: str = "N/A",
+        hardware_counters: bool = False,
     ):
         self._trajectory_writer = trajectory_writer
         self._description = description
+        self._hardware_counters = hardware_counters
+        self._hardware_counters_available = False
         self._con = trajectory_writer._con
 
     def begin_writing(self, simulation) -> None:
         simulation.set_tracing(True)
+        self._hardware_counters_available = simulation.set_hardware_counters(
+            self._hardware_counters
+        )
         self._trajectory_writer.begin_writing(simulation)
         self._recreate_table()
         self.write_metadata()
@@ -51,7 +57,15 @@ class StatsWriter(jps.TrajectoryWriter):
             "   frame INTEGER NOT NULL,"
             "   iteration_loop_us INTEGER NOT NULL,"
             "   operational_level_us INTEGER NOT NULL,"
-            "   agent_count INTEGER NOT NULL)"
+            "   agent_count INTEGER NOT NULL,"
+            "   iteration_loop_cycles INTEGER NOT NULL,"
+            "   iteration_loop_instructions INTEGER NOT NULL,"
+            "   iteration_loop_cache_misses INTEGER NOT NULL,"
+            "   iteration_loop_branch_misses INTEGER NOT NULL,"
+            "   operational_level_cycles INTEGER NOT NULL,"
+            "   operational_level_instructions INTEGER NOT NULL,"
+            "   operational_level_cache_misses INTEGER NOT NULL,"
+            "   operational_level_branch_misses INTEGER NOT NULL)"
         )
         cur.close()
 
@@ -69,6 +83,10 @@ class StatsWriter(jps.TrajectoryWriter):
             "INSERT INTO metadata VALUES(?, ?)",
             ("description", self._description),
         )
+        cur.execute(
+            "INSERT INTO metadata VALUES(?, ?)",
+            ("hardware_counters", int(self._hardware_counters_available)),
+        )
 
     def write_stats(self, simulation):
         iteration = simulation.iteration_count()
@@ -77,12 +95,22 @@ class StatsWriter(jps.TrajectoryWriter):
         frame_idx = iteration / self.every_nth_frame()
         stats = simulation.get_last_trace()
         agent_count = simulation.agent_count()
+        iteration_counters = stats.iteration_counters
+        operational_level_counters = stats.operational_level_counters
         self._con.cursor().execute(
-            "INSERT INTO perf_statistics VALUES(?,?,?,?)",
+            "INSERT INTO perf_statistics VALUES(?,?,?,?,?,?,?,?,?,?,?,?)",
             (
                 frame_idx,
                 stats.iteration_duration,
                 stats.operational_level_duration,
                 agent_count,
+                iteration_counters.cycles,
+                iteration_counters.instructions,
+                iteration_counters.cache_misses,
+                iteration_counters.branch_misses,
+                operational_level_counters.cycles,
+                operational_level_counters.instructions,
+                operational_level_counters.cache_misses,
+                operational_level_counters.branch_misses,
             ),
         )
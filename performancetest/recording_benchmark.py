@@ -0,0 +1,140 @@
+#! /usr/bin/env python3
+
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import argparse
+import pathlib
+import sqlite3
+import tempfile
+import time
+
+import numpy as np
+
+import jupedsim as jps
+from jupedsim.sqlite_serialization import (
+    DATABASE_VERSION,
+    create_database_tables,
+)
+
+
+def parse_args():
+    ap = argparse.ArgumentParser(
+        description="Compares the ways to read a recording"
+    )
+    ap.add_argument(
+        "--frames",
+        "-f",
+        type=int,
+        default=10000,
+        help="number of frames in the recording",
+    )
+    ap.add_argument(
+        "--agents",
+        "-a",
+        type=int,
+        default=100,
+        help="number of agents in each frame",
+    )
+    return ap.parse_args()
+
+
+def write_recording(path: pathlib.Path, frames: int, agents: int) -> None:
+    rng = np.random.default_rng(0)
+    geo = "GEOMETRYCOLLECTION (POLYGON ((0 0, 100 0, 100 100, 0 100, 0 0)))"
+    con = sqlite3.connect(path, isolation_level=None)
+    cur = con.cursor()
+    cur.execute("BEGIN")
+    create_database_tables(cur)
+    cur.executemany(
+        "INSERT INTO metadata VALUES(?, ?)",
+        (
+            ("version", DATABASE_VERSION),
+            ("fps", 25),
+            ("xmin", 0),
+            ("xmax", 100),
+            ("ymin", 0),
+            ("ymax", 100),
+        ),
+    )
+    cur.execute("INSERT INTO geometry VALUES(?, ?)", (hash(geo), geo))
+    ids = np.arange(1, agents + 1)
+    for frame in range(frames):
+        xs, ys = rng.uniform(0, 100, (2, agents))
+        cur.executemany(
+            "INSERT INTO trajectory_data VALUES(?, ?, ?, ?, ?, ?)",
+            zip(
+                [frame] * agents,
+                ids.tolist(),
+                xs.tolist(),
+                ys.tolist(),
+                [1.0] * agents,
+                [0.0] * agents,
+            ),
+        )
+        cur.execute("INSERT INTO frame_data VALUES(?, ?)", (frame, hash(geo)))
+    cur.execute("COMMIT")
+    con.close()
+
+
+def measure(name: str, function) -> None:
+    start = time.perf_counter()
+    rows = function()
+    duration = time.perf_counter() - start
+    print(f"{name:<44} {duration:>8.3f}s {rows / duration:>14,.0f} rows/s")
+
+
+def main():
+    args = parse_args()
+    with tempfile.TemporaryDirectory() as directory:
+        sqlite_file = pathlib.Path(directory) / "recording.sqlite"
+        columnar_file = pathlib.Path(directory) / "recording.jps"
+        write_recording(sqlite_file, args.frames, args.agents)
+        jps.convert_sqlite_to_columnar(sqlite_file, columnar_file)
+        print(f"{args.frames} frames with {args.agents} agents")
+
+        recording = jps.Recording(str(sqlite_file))
+        measure(
+            "Recording.frame per frame",
+            lambda: sum(
+                len(recording.frame(index).agents)
+                for index in range(args.frames)
+            ),
+        )
+        measure(
+            "Recording.frames",
+            lambda: len(recording.frames(0, args.frames)),
+        )
+        measure(
+            "Recording.agent_trajectory per agent",
+            lambda: sum(
+                len(recording.agent_trajectory(agent_id))
+                for agent_id in recording.agent_ids()
+            ),
+        )
+        measure(
+            "Recording.agent_trajectories",
+            lambda: sum(
+                len(trajectory)
+                for trajectory in recording.agent_trajectories().values()
+            ),
+        )
+
+        reader = jps.ColumnarTrajectoryReader(columnar_file)
+        measure(
+            "ColumnarTrajectoryReader.frame per frame",
+            lambda: sum(len(frame.id) for frame in reader),
+        )
+        measure(
+            "ColumnarTrajectoryReader.frames",
+            lambda: len(reader.frames(0, args.frames)),
+        )
+        measure(
+            "ColumnarTrajectoryReader.agent_trajectories",
+            lambda: sum(
+                len(trajectory)
+                for trajectory in reader.agent_trajectories().values()
+            ),
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -18,6 +18,9 @@ void init_transition(py::module_& m);
 void init_journey(py::module_& m);
 void init_stage(py::module_& m);
 void init_simulation(py::module_& m);
+void init_ensemble(py::module_& m);
+void init_trajectory_file(py::module_& m);
+void init_frame_ring_buffer(py::module_& m);
 
 PYBIND11_MODULE(py_jupedsim, m)
 {
@@ -36,4 +39,7 @@ PYBIND11_MODULE(py_jupedsim, m)
     init_journey(m);
     init_stage(m);
     init_simulation(m);
+    init_ensemble(m);
+    init_trajectory_file(m);
+    init_frame_ring_buffer(m);
 }
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "wrapper.hpp"
+
+#include <jupedsim/jupedsim.h>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace
+{
+struct ScenarioFactory {
+    py::function factory;
+    /// Error raised by 'factory' per run, only accessed while holding the GIL
+    std::vector<std::string> errors{};
+};
+
+JPS_Simulation createScenario(size_t run, void* userdata)
+{
+    auto scenarioFactory = static_cast<ScenarioFactory*>(userdata);
+    py::gil_scoped_acquire gil{};
+    try {
+        auto simulation = scenarioFactory->factory(run);
+        // The ensemble takes ownership of the simulation
+        return std::exchange(simulation.cast<JPS_Simulation_Wrapper&>().handle, nullptr);
+    } catch(const std::exception& ex) {
+        scenarioFactory->errors[run] = ex.what();
+    }
+    return nullptr;
+}
+} // namespace
+
+void init_ensemble(py::module_& m)
+{
+    m.def(
+        "run_ensemble",
+        [](py::function factory,
+           size_t runCount,
+           uint64_t maxIterations,
+           size_t threadCount,
+           uint64_t trajectoryInterval) {
+            ScenarioFactory scenarioFactory{std::move(factory), std::vector<std::string>(runCount)};
+            const JPS_EnsembleSettings settings{
+                runCount, maxIterations, threadCount, trajectoryInterval};
+            JPS_ErrorMessage errorMsg{};
+            JPS_EnsembleResult result{};
+            {
+                py::gil_scoped_release release{};
+                result = JPS_Ensemble_Run(createScenario, &scenarioFactory, settings, &errorMsg);
+            }
+            if(!result) {
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            }
+
+            py::list runs{};
+            for(size_t run = 0; run < JPS_EnsembleResult_RunCount(result); ++run) {
+                const auto summary = JPS_EnsembleResult_Summary(result, run);
+                const char* error = JPS_EnsembleResult_Error(result, run);
+                // Prefer the Python error over the generic error for a missing simulation
+                if(!scenarioFactory.errors[run].empty()) {
+                    error = scenarioFactory.errors[run].c_str();
+                }
+                const JPS_TrajectorySample* samples{};
+                const auto count = JPS_EnsembleResult_Trajectory(result, run, &samples);
+                py::array_t<uint64_t> iterations(count);
+                py::array_t<uint64_t> agentIds(count);
+                py::array_t<double> xs(count);
+                py::array_t<double> ys(count);
+                auto iterationsView = iterations.mutable_unchecked<1>();
+                auto agentIdsView = agentIds.mutable_unchecked<1>();
+                auto xsView = xs.mutable_unchecked<1>();
+                auto ysView = ys.mutable_unchecked<1>();
+                for(size_t index = 0; index < count; ++index) {
+                    const auto idx = static_cast<py::ssize_t>(index);
+                    iterationsView(idx) = samples[index].iteration;
+                    agentIdsView(idx) = samples[index].agent_id;
+                    xsView(idx) = samples[index].position.x;
+                    ysView(idx) = samples[index].position.y;
+                }
+                runs.append(py::make_tuple(
+                    error ? py::object(py::str(error)) : py::object(py::none()),
+                    summary.iterations,
+                    summary.elapsed_time,
+                    summary.agent_count,
+                    summary.removed_agent_count,
+                    iterations,
+                    agentIds,
+                    xs,
+                    ys));
+            }
+            JPS_EnsembleResult_Free(result);
+            return runs;
+        },
+        py::arg("factory"),
+        py::arg("run_count"),
+        py::arg("max_iterations"),
+        py::arg("thread_count"),
+        py::arg("trajectory_interval"));
+}
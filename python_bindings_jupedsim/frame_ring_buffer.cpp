@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "wrapper.hpp"
+
+#include <jupedsim/jupedsim.h>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace py = pybind11;
+
+namespace
+{
+[[noreturn]] void throwError(JPS_ErrorMessage errorMsg)
+{
+    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+    JPS_ErrorMessage_Free(errorMsg);
+    throw std::runtime_error{msg};
+}
+
+using DoubleColumn = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+/// Copies a frame into new arrays, 'read' is called with the destination buffers.
+template <typename ReadFunction>
+std::optional<py::tuple> readFrame(const JPS_FrameRingBufferReader_Wrapper& w, ReadFunction read)
+{
+    const auto capacity = static_cast<py::ssize_t>(JPS_FrameRingBufferReader_Capacity(w.handle));
+    py::array_t<uint64_t> ids(capacity);
+    py::array_t<double> xs(capacity);
+    py::array_t<double> ys(capacity);
+    py::array_t<double> orientationXs(capacity);
+    py::array_t<double> orientationYs(capacity);
+    JPS_FrameRingBufferFrame frame{};
+    if(!read(
+           &frame,
+           ids.mutable_data(),
+           xs.mutable_data(),
+           ys.mutable_data(),
+           orientationXs.mutable_data(),
+           orientationYs.mutable_data())) {
+        return std::nullopt;
+    }
+    const py::slice agents(0, static_cast<py::ssize_t>(frame.agent_count), 1);
+    return py::make_tuple(
+        frame.index,
+        frame.frame,
+        frame.geometry_version,
+        frame.time,
+        ids[agents],
+        xs[agents],
+        ys[agents],
+        orientationXs[agents],
+        orientationYs[agents]);
+}
+} // namespace
+
+void init_frame_ring_buffer(py::module_& m)
+{
+    py::class_<JPS_FrameRingBufferWriter_Wrapper>(m, "FrameRingBufferWriter")
+        .def(
+            py::init([](const std::string& name, uint32_t slots, size_t capacity) {
+                JPS_ErrorMessage errorMsg{};
+                auto writer =
+                    JPS_FrameRingBufferWriter_Create(name.c_str(), slots, capacity, &errorMsg);
+                if(!writer) {
+                    throwError(errorMsg);
+                }
+                return std::make_unique<JPS_FrameRingBufferWriter_Wrapper>(writer);
+            }),
+            py::arg("name"),
+            py::arg("slots"),
+            py::arg("capacity"))
+        .def(
+            "publish",
+            [](JPS_FrameRingBufferWriter_Wrapper& w,
+               uint64_t frame,
+               uint64_t geometryVersion,
+               double time,
+               py::array_t<uint64_t, py::array::c_style | py::array::forcecast> ids,
+               DoubleColumn xs,
+               DoubleColumn ys,
+               DoubleColumn orientationXs,
+               DoubleColumn orientationYs) {
+                const auto count = static_cast<size_t>(ids.size());
+                for(const auto& column : {xs, ys, orientationXs, orientationYs}) {
+                    if(column.ndim() != 1 || static_cast<size_t>(column.size()) != count) {
+                        throw std::runtime_error{
+                            "All columns of a frame need to be one dimensional and of equal size"};
+                    }
+                }
+                JPS_ErrorMessage errorMsg{};
+                if(!JPS_FrameRingBufferWriter_Publish(
+                       w.handle,
+                       frame,
+                       geometryVersion,
+                       time,
+                       count,
+                       ids.data(),
+                       xs.data(),
+                       ys.data(),
+                       orientationXs.data(),
+                       orientationYs.data(),
+                       &errorMsg)) {
+                    throwError(errorMsg);
+                }
+            },
+            py::arg("frame"),
+            py::arg("geometry_version"),
+            py::arg("time"),
+            py::arg("ids"),
+            py::arg("x"),
+            py::arg("y"),
+            py::arg("orientation_x"),
+            py::arg("orientation_y"))
+        .def(
+            "publish_simulation",
+            [](JPS_FrameRingBufferWriter_Wrapper& w,
+               JPS_Simulation_Wrapper& simulation,
+               uint64_t frame) {
+                JPS_ErrorMessage errorMsg{};
+                if(!JPS_FrameRingBufferWriter_PublishSimulation(
+                       w.handle, simulation.handle, frame, &errorMsg)) {
+                    throwError(errorMsg);
+                }
+            },
+            py::arg("simulation"),
+            py::arg("frame"));
+    py::class_<JPS_FrameRingBufferReader_Wrapper>(m, "FrameRingBufferReader")
+        .def(
+            py::init([](const std::string& name) {
+                JPS_ErrorMessage errorMsg{};
+                auto reader = JPS_FrameRingBufferReader_Open(name.c_str(), &errorMsg);
+                if(!reader) {
+                    throwError(errorMsg);
+                }
+                return std::make_unique<JPS_FrameRingBufferReader_Wrapper>(reader);
+            }),
+            py::arg("name"))
+        .def_property_readonly(
+            "capacity",
+            [](const JPS_FrameRingBufferReader_Wrapper& w) {
+                return JPS_FrameRingBufferReader_Capacity(w.handle);
+            })
+        .def(
+            "published_count",
+            [](const JPS_FrameRingBufferReader_Wrapper& w) {
+                return JPS_FrameRingBufferReader_PublishedCount(w.handle);
+            })
+        .def(
+            "read",
+            [](const JPS_FrameRingBufferReader_Wrapper& w, uint64_t index) {
+                return readFrame(w, [&w, index](auto... buffers) {
+                    return JPS_FrameRingBufferReader_Read(w.handle, index, buffers...);
+                });
+            },
+            py::arg("index"))
+        .def("read_latest", [](const JPS_FrameRingBufferReader_Wrapper& w) {
+            return readFrame(w, [&w](auto... buffers) {
+                return JPS_FrameRingBufferReader_ReadLatest(w.handle, buffers...);
+            });
+        });
+}
@@ -51,6 +51,56 @@ void init_geometry(py::module_& m)
                 JPS_GeometryBuilder_ExcludeFromAccessibleArea(w.handle, pts.data(), pts.size());
             },
             "Add areas where agents can not move (obstacles)")
+        .def(
+            "set_simplification_tolerance",
+            [](const JPS_GeometryBuilder_Wrapper& w, double tolerance) {
+                JPS_ErrorMessage errorMsg{};
+                if(!JPS_GeometryBuilder_SetSimplificationTolerance(
+                       w.handle, tolerance, &errorMsg)) {
+                    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                    JPS_ErrorMessage_Free(errorMsg);
+                    throw std::runtime_error{msg};
+                }
+            },
+            py::arg("tolerance"),
+            "Merge nearly collinear walls and remove walls shorter than 'tolerance'")
+        .def(
+            "set_wall_grid_cell_size",
+            [](const JPS_GeometryBuilder_Wrapper& w, double cellSize) {
+                JPS_ErrorMessage errorMsg{};
+                if(!JPS_GeometryBuilder_SetWallGridCellSize(w.handle, cellSize, &errorMsg)) {
+                    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                    JPS_ErrorMessage_Free(errorMsg);
+                    throw std::runtime_error{msg};
+                }
+            },
+            py::arg("cell_size"),
+            "Cell size of the grid used to find walls near agents")
+        .def(
+            "set_wall_distance_field",
+            [](const JPS_GeometryBuilder_Wrapper& w, double spacing, double range) {
+                JPS_ErrorMessage errorMsg{};
+                if(!JPS_GeometryBuilder_SetWallDistanceField(w.handle, spacing, range, &errorMsg)) {
+                    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                    JPS_ErrorMessage_Free(errorMsg);
+                    throw std::runtime_error{msg};
+                }
+            },
+            py::arg("spacing"),
+            py::arg("range"),
+            "Use only the nearest walls around agents for the wall forces")
+        .def(
+            "set_routing_hierarchy",
+            [](const JPS_GeometryBuilder_Wrapper& w, double region_size) {
+                JPS_ErrorMessage errorMsg{};
+                if(!JPS_GeometryBuilder_SetRoutingHierarchy(w.handle, region_size, &errorMsg)) {
+                    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                    JPS_ErrorMessage_Free(errorMsg);
+                    throw std::runtime_error{msg};
+                }
+            },
+            py::arg("region_size"),
+            "Build a routing hierarchy with regions of about this size, 0 disables it")
         .def(
             "build",
             [](const JPS_GeometryBuilder_Wrapper& w) {
@@ -63,5 +113,20 @@ void init_geometry(py::module_& m)
                 JPS_ErrorMessage_Free(errorMsg);
                 throw std::runtime_error{msg};
             },
-            "Geometry builder");
+            "Geometry builder")
+        .def(
+            "build_cached",
+            [](const JPS_GeometryBuilder_Wrapper& w, const std::string& cacheDirectory) {
+                JPS_ErrorMessage errorMsg{};
+                auto result =
+                    JPS_GeometryBuilder_BuildCached(w.handle, cacheDirectory.c_str(), &errorMsg);
+                if(result) {
+                    return std::make_unique<JPS_Geometry_Wrapper>(result);
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::arg("cache_directory"),
+            "Geometry builder reusing geometries stored in 'cache_directory'");
 }
@@ -5,16 +5,26 @@
 #include <cstddef>
 #include <jupedsim/jupedsim.h>
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <tuple>
 #include <vector>
 
 namespace py = pybind11;
 
+using PointArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Points of the arrays are passed without conversion
+static_assert(sizeof(JPS_Point) == 2 * sizeof(double));
+
 void init_routing(py::module_& m)
 {
     py::class_<JPS_RoutingEngine_Wrapper>(m, "RoutingEngine")
@@ -42,11 +52,84 @@ void init_routing(py::module_& m)
                 JPS_Path_Free(waypoints);
                 return result;
             })
+        .def(
+            "compute_waypoints_batch",
+            [](const JPS_RoutingEngine_Wrapper& w,
+               PointArray from,
+               PointArray to,
+               JPS_RoutingAlgorithm algorithm,
+               size_t threadCount,
+               size_t maxWaypoints) {
+                for(const auto& points : {from, to}) {
+                    if(points.ndim() != 2 || points.shape(1) != 2) {
+                        throw std::runtime_error{"Points need to be an array of shape (n, 2)"};
+                    }
+                }
+                if(from.shape(0) != to.shape(0)) {
+                    throw std::runtime_error{"Number of start and target points differ"};
+                }
+                const auto count = from.shape(0);
+                const auto stride = static_cast<py::ssize_t>(maxWaypoints);
+                py::array_t<double> lengths(count);
+                py::array_t<double> waypoints({count, stride, py::ssize_t{2}});
+                py::array_t<size_t> waypointCounts(count);
+                JPS_ErrorMessage errorMsg{};
+                bool success{};
+                {
+                    py::gil_scoped_release release{};
+                    success = JPS_RoutingEngine_ComputeWaypoints(
+                        w.handle,
+                        reinterpret_cast<const JPS_Point*>(from.data()),
+                        reinterpret_cast<const JPS_Point*>(to.data()),
+                        static_cast<size_t>(count),
+                        algorithm,
+                        threadCount,
+                        lengths.mutable_data(),
+                        maxWaypoints,
+                        reinterpret_cast<JPS_Point*>(waypoints.mutable_data()),
+                        waypointCounts.mutable_data(),
+                        &errorMsg);
+                }
+                if(!success) {
+                    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                    JPS_ErrorMessage_Free(errorMsg);
+                    throw std::runtime_error{msg};
+                }
+                return py::make_tuple(lengths, waypoints, waypointCounts);
+            },
+            py::kw_only(),
+            py::arg("frm"),
+            py::arg("to"),
+            py::arg("algorithm"),
+            py::arg("thread_count"),
+            py::arg("max_waypoints"))
         .def(
             "is_routable",
             [](const JPS_RoutingEngine_Wrapper& w, std::tuple<double, double> p) {
                 return JPS_RoutingEngine_IsRoutable(w.handle, intoJPS_Point(p));
             })
+        .def(
+            "find_containing_polygons",
+            [](const JPS_RoutingEngine_Wrapper& w,
+               const std::vector<std::tuple<double, double>>& points) {
+                const auto jpsPoints = intoJPS_Point(points);
+                std::vector<size_t> indices(jpsPoints.size());
+                JPS_RoutingEngine_FindContainingPolygons(
+                    w.handle, jpsPoints.data(), jpsPoints.size(), indices.data());
+                std::vector<std::optional<size_t>> result{};
+                result.reserve(indices.size());
+                std::transform(
+                    std::begin(indices),
+                    std::end(indices),
+                    std::back_inserter(result),
+                    [](const auto index) -> std::optional<size_t> {
+                        if(index == std::numeric_limits<size_t>::max()) {
+                            return std::nullopt;
+                        }
+                        return index;
+                    });
+                return result;
+            })
         .def("mesh", [](const JPS_RoutingEngine_Wrapper& w) {
             auto mesh = JPS_RoutingEngine_Mesh(w.handle);
             using Pt = std::tuple<double, double>;
@@ -5,13 +5,20 @@
 #include <Unreachable.hpp>
 #include <jupedsim/jupedsim.h>
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <optional>
+
 namespace py = pybind11;
 
 void init_simulation(py::module_& m)
 {
+    py::enum_<JPS_RoutingAlgorithm>(m, "RoutingAlgorithm")
+        .value("TriangleAStar", JPS_RoutingAlgorithm_TriangleAStar)
+        .value("Polyanya", JPS_RoutingAlgorithm_Polyanya)
+        .value("Hierarchical", JPS_RoutingAlgorithm_Hierarchical);
     py::class_<JPS_OperationalModel_Wrapper>(m, "OperationalModel");
     py::class_<JPS_Simulation_Wrapper>(m, "Simulation")
         .def(
@@ -204,16 +211,21 @@ void init_simulation(py::module_& m)
             })
         .def(
             "iterate",
-            [](const JPS_Simulation_Wrapper& simulation) {
+            [](const JPS_Simulation_Wrapper& simulation, uint64_t count) {
                 JPS_ErrorMessage errorMsg{};
-                bool iterate_ok = JPS_Simulation_Iterate(simulation.handle, &errorMsg);
+                bool iterate_ok = JPS_Simulation_IterateN(
+                    simulation.handle, count, 0, nullptr, nullptr, &errorMsg);
                 if(iterate_ok) {
                     return;
                 }
                 auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
                 JPS_ErrorMessage_Free(errorMsg);
                 throw std::runtime_error{msg};
-            })
+            },
+            py::arg("count") = 1,
+            // Python threads keep running while the simulation steps. Log callbacks reacquire the
+            // GIL when they are invoked.
+            py::call_guard<py::gil_scoped_release>())
         .def(
             "switch_agent_journey",
             [](const JPS_Simulation_Wrapper& w,
@@ -234,6 +246,70 @@ void init_simulation(py::module_& m)
             py::arg("agent_id"),
             py::arg("journey_id"),
             py::arg("stage_id"))
+        .def(
+            "add_periodic_queue_pop",
+            [](JPS_Simulation_Wrapper& w,
+               JPS_StageId stageId,
+               double interval,
+               size_t count,
+               double startTime) {
+                JPS_ErrorMessage errorMsg{};
+                auto result = JPS_Simulation_AddPeriodicQueuePop(
+                    w.handle, stageId, interval, count, startTime, &errorMsg);
+                if(result) {
+                    return;
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::kw_only(),
+            py::arg("stage_id"),
+            py::arg("interval"),
+            py::arg("count"),
+            py::arg("start_time"))
+        .def(
+            "add_waiting_set_thresholds",
+            [](JPS_Simulation_Wrapper& w,
+               JPS_StageId stageId,
+               size_t deactivateAt,
+               size_t activateAt) {
+                JPS_ErrorMessage errorMsg{};
+                auto result = JPS_Simulation_AddWaitingSetThresholds(
+                    w.handle, stageId, deactivateAt, activateAt, &errorMsg);
+                if(result) {
+                    return;
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::kw_only(),
+            py::arg("stage_id"),
+            py::arg("deactivate_at"),
+            py::arg("activate_at"))
+        .def(
+            "schedule_journey_switch",
+            [](JPS_Simulation_Wrapper& w,
+               double time,
+               JPS_JourneyId fromJourneyId,
+               JPS_JourneyId toJourneyId,
+               JPS_StageId toStageId) {
+                JPS_ErrorMessage errorMsg{};
+                auto result = JPS_Simulation_ScheduleJourneySwitch(
+                    w.handle, time, fromJourneyId, toJourneyId, toStageId, &errorMsg);
+                if(result) {
+                    return;
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::kw_only(),
+            py::arg("time"),
+            py::arg("from_journey_id"),
+            py::arg("to_journey_id"),
+            py::arg("to_stage_id"))
         .def(
             "agent_count",
             [](JPS_Simulation_Wrapper& simulation) {
@@ -352,9 +428,190 @@ void init_simulation(py::module_& m)
             [](JPS_Simulation_Wrapper& w, bool status) {
                 JPS_Simulation_SetTracing(w.handle, status);
             })
+        .def(
+            "set_hardware_counters",
+            [](JPS_Simulation_Wrapper& w, bool status) {
+                return JPS_Simulation_SetHardwareCounters(w.handle, status);
+            })
         .def(
             "get_last_trace",
             [](JPS_Simulation_Wrapper& w) { return JPS_Simulation_GetTrace(w.handle); })
+        .def(
+            "get_memory_stats",
+            [](const JPS_Simulation_Wrapper& w) { return JPS_Simulation_GetMemoryStats(w.handle); })
+        .def(
+            "set_event_recording",
+            [](JPS_Simulation_Wrapper& w, bool status) {
+                JPS_Simulation_SetEventRecording(w.handle, status);
+            })
+        .def(
+            "set_routing_algorithm",
+            [](JPS_Simulation_Wrapper& w, JPS_RoutingAlgorithm algorithm) {
+                JPS_Simulation_SetRoutingAlgorithm(w.handle, algorithm);
+            })
+        .def(
+            "get_routing_algorithm",
+            [](const JPS_Simulation_Wrapper& w) {
+                return JPS_Simulation_GetRoutingAlgorithm(w.handle);
+            })
+        .def(
+            "event_count",
+            [](const JPS_Simulation_Wrapper& w) { return JPS_Simulation_EventCount(w.handle); })
+        .def(
+            "read_events",
+            [](JPS_Simulation_Wrapper& w) {
+                std::vector<JPS_Event> events(JPS_Simulation_EventCount(w.handle));
+                const auto count = JPS_Simulation_ReadEvents(
+                    w.handle, events.data(), events.size());
+                py::array_t<uint8_t> types(count);
+                py::array_t<uint64_t> iterations(count);
+                py::array_t<uint64_t> agentIds(count);
+                py::array_t<uint64_t> stageIds(count);
+                py::array_t<uint64_t> previousStageIds(count);
+                auto typesView = types.mutable_unchecked<1>();
+                auto iterationsView = iterations.mutable_unchecked<1>();
+                auto agentIdsView = agentIds.mutable_unchecked<1>();
+                auto stageIdsView = stageIds.mutable_unchecked<1>();
+                auto previousStageIdsView = previousStageIds.mutable_unchecked<1>();
+                for(size_t index = 0; index < count; ++index) {
+                    const auto idx = static_cast<py::ssize_t>(index);
+                    typesView(idx) = static_cast<uint8_t>(events[index].type);
+                    iterationsView(idx) = events[index].iteration;
+                    agentIdsView(idx) = events[index].agent_id;
+                    stageIdsView(idx) = events[index].stage_id;
+                    previousStageIdsView(idx) = events[index].previous_stage_id;
+                }
+                return py::make_tuple(types, iterations, agentIds, stageIds, previousStageIds);
+            })
+        .def(
+            "add_grid_measurement",
+            [](JPS_Simulation_Wrapper& w,
+               std::tuple<double, double> min,
+               std::tuple<double, double> max,
+               double cellSize,
+               double interval) {
+                JPS_ErrorMessage errorMsg{};
+                size_t id{};
+                if(JPS_Simulation_AddGridMeasurement(
+                       w.handle,
+                       intoJPS_Point(min),
+                       intoJPS_Point(max),
+                       cellSize,
+                       interval,
+                       &id,
+                       &errorMsg)) {
+                    return id;
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::kw_only(),
+            py::arg("min"),
+            py::arg("max"),
+            py::arg("cell_size"),
+            py::arg("interval"))
+        .def(
+            "read_grid_measurement",
+            [](const JPS_Simulation_Wrapper& w, size_t id) {
+                JPS_ErrorMessage errorMsg{};
+                JPS_GridMeasurement grid{};
+                if(!JPS_Simulation_GetGridMeasurement(w.handle, id, &grid, &errorMsg)) {
+                    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                    JPS_ErrorMessage_Free(errorMsg);
+                    throw std::runtime_error{msg};
+                }
+                const auto rows = static_cast<py::ssize_t>(grid.rows);
+                const auto columns = static_cast<py::ssize_t>(grid.columns);
+                py::array_t<double> density({rows, columns});
+                py::array_t<double> speed({rows, columns});
+                JPS_Simulation_ReadGridMeasurement(
+                    w.handle, id, density.mutable_data(), speed.mutable_data(), nullptr);
+                return py::make_tuple(
+                    intoTuple(grid.origin), grid.cell_size, grid.samples, density, speed);
+            })
+        .def(
+            "add_line_measurement",
+            [](JPS_Simulation_Wrapper& w,
+               std::tuple<double, double> p1,
+               std::tuple<double, double> p2) {
+                JPS_ErrorMessage errorMsg{};
+                size_t id{};
+                if(JPS_Simulation_AddLineMeasurement(
+                       w.handle, intoJPS_Point(p1), intoJPS_Point(p2), &id, &errorMsg)) {
+                    return id;
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::kw_only(),
+            py::arg("p1"),
+            py::arg("p2"))
+        .def(
+            "read_line_measurement",
+            [](const JPS_Simulation_Wrapper& w, size_t id) {
+                JPS_ErrorMessage errorMsg{};
+                uint64_t forward{};
+                uint64_t backward{};
+                if(!JPS_Simulation_GetLineMeasurement(
+                       w.handle, id, &forward, &backward, &errorMsg)) {
+                    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                    JPS_ErrorMessage_Free(errorMsg);
+                    throw std::runtime_error{msg};
+                }
+                std::vector<JPS_LineCrossing> crossings(forward + backward);
+                JPS_Simulation_ReadLineMeasurement(w.handle, id, crossings.data(), nullptr);
+                const auto count = static_cast<py::ssize_t>(crossings.size());
+                py::array_t<double> times(count);
+                py::array_t<uint64_t> agentIds(count);
+                py::array_t<int8_t> directions(count);
+                auto timesView = times.mutable_unchecked<1>();
+                auto agentIdsView = agentIds.mutable_unchecked<1>();
+                auto directionsView = directions.mutable_unchecked<1>();
+                for(py::ssize_t index = 0; index < count; ++index) {
+                    const auto& crossing = crossings[static_cast<size_t>(index)];
+                    timesView(index) = crossing.time;
+                    agentIdsView(index) = crossing.agent_id;
+                    directionsView(index) = crossing.direction;
+                }
+                return py::make_tuple(forward, backward, times, agentIds, directions);
+            })
+        .def(
+            "add_area_measurement",
+            [](JPS_Simulation_Wrapper& w,
+               const std::vector<std::tuple<double, double>>& polygon,
+               double interval) {
+                const auto points = intoJPS_Point(polygon);
+                JPS_ErrorMessage errorMsg{};
+                size_t id{};
+                if(JPS_Simulation_AddAreaMeasurement(
+                       w.handle, points.data(), points.size(), interval, &id, &errorMsg)) {
+                    return id;
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::kw_only(),
+            py::arg("polygon"),
+            py::arg("interval"))
+        .def(
+            "read_area_measurement",
+            [](const JPS_Simulation_Wrapper& w, size_t id) {
+                JPS_ErrorMessage errorMsg{};
+                size_t samples{};
+                if(!JPS_Simulation_GetAreaMeasurement(w.handle, id, &samples, &errorMsg)) {
+                    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                    JPS_ErrorMessage_Free(errorMsg);
+                    throw std::runtime_error{msg};
+                }
+                py::array_t<double> times(static_cast<py::ssize_t>(samples));
+                py::array_t<uint64_t> counts(static_cast<py::ssize_t>(samples));
+                JPS_Simulation_ReadAreaMeasurement(
+                    w.handle, id, times.mutable_data(), counts.mutable_data(), nullptr);
+                return py::make_tuple(times, counts);
+            })
         .def(
             "get_geometry",
             [](const JPS_Simulation_Wrapper& w) {
@@ -372,5 +629,43 @@ void init_simulation(py::module_& m)
                 throw std::runtime_error{msg};
             }
             return success;
-        });
+        })
+        .def(
+            "save_snapshot",
+            [](const JPS_Simulation_Wrapper& w, const std::string& path) {
+                JPS_ErrorMessage errorMsg{};
+                if(JPS_Simulation_SaveSnapshot(w.handle, path.c_str(), &errorMsg)) {
+                    return;
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::arg("path"))
+        .def(
+            "load_snapshot",
+            [](JPS_Simulation_Wrapper& w, const std::string& path) {
+                JPS_ErrorMessage errorMsg{};
+                if(JPS_Simulation_LoadSnapshot(w.handle, path.c_str(), &errorMsg)) {
+                    return;
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::arg("path"))
+        .def(
+            "fork",
+            [](const JPS_Simulation_Wrapper& w, std::optional<uint64_t> seed) {
+                JPS_ErrorMessage errorMsg{};
+                auto clone = seed ? JPS_Simulation_CloneWithSeed(w.handle, *seed, &errorMsg)
+                                  : JPS_Simulation_Clone(w.handle, &errorMsg);
+                if(clone) {
+                    return std::make_unique<JPS_Simulation_Wrapper>(clone);
+                }
+                auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+                JPS_ErrorMessage_Free(errorMsg);
+                throw std::runtime_error{msg};
+            },
+            py::arg("seed") = py::none());
 }
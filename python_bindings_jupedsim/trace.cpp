@@ -8,13 +8,46 @@ namespace py = pybind11;
 
 void init_trace(py::module_& m)
 {
+    py::class_<JPS_HardwareCounters>(m, "HardwareCounters")
+        .def_readonly("cycles", &JPS_HardwareCounters::cycles)
+        .def_readonly("instructions", &JPS_HardwareCounters::instructions)
+        .def_readonly("cache_misses", &JPS_HardwareCounters::cache_misses)
+        .def_readonly("branch_misses", &JPS_HardwareCounters::branch_misses)
+        .def("__repr__", [](const JPS_HardwareCounters& c) {
+            return fmt::format(
+                "HardwareCounters( Cycles: {:d}, Instructions: {:d}, CacheMisses: {:d}, "
+                "BranchMisses: {:d})",
+                c.cycles,
+                c.instructions,
+                c.cache_misses,
+                c.branch_misses);
+        });
     py::class_<JPS_Trace>(m, "Trace")
         .def_readonly("iteration_duration", &JPS_Trace::iteration_duration)
         .def_readonly("operational_level_duration", &JPS_Trace::operational_level_duration)
+        .def_readonly("iteration_counters", &JPS_Trace::iteration_counters)
+        .def_readonly("operational_level_counters", &JPS_Trace::operational_level_counters)
         .def("__repr__", [](const JPS_Trace& t) {
             return fmt::format(
                 "Trace( Iteration: {:d}us, OperationalLevel {:d}us)",
                 t.iteration_duration,
                 t.operational_level_duration);
         });
+    py::class_<JPS_MemoryUsage>(m, "MemoryUsage")
+        .def_readonly("bytes", &JPS_MemoryUsage::bytes)
+        .def_readonly("peak_bytes", &JPS_MemoryUsage::peak_bytes)
+        .def("__repr__", [](const JPS_MemoryUsage& u) {
+            return fmt::format("MemoryUsage( Bytes: {:d}, PeakBytes: {:d})", u.bytes, u.peak_bytes);
+        });
+    py::class_<JPS_MemoryStats>(m, "MemoryStats")
+        .def_readonly("agents", &JPS_MemoryStats::agents)
+        .def_readonly("neighborhood_search", &JPS_MemoryStats::neighborhood_search)
+        .def_readonly("collision_geometry", &JPS_MemoryStats::collision_geometry)
+        .def_readonly("routing_engine", &JPS_MemoryStats::routing_engine)
+        .def_readonly("geometry_cache", &JPS_MemoryStats::geometry_cache)
+        .def_readonly("total", &JPS_MemoryStats::total)
+        .def("__repr__", [](const JPS_MemoryStats& s) {
+            return fmt::format(
+                "MemoryStats( Total: {:d}B, PeakTotal: {:d}B)", s.total.bytes, s.total.peak_bytes);
+        });
 }
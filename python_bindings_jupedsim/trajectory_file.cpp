@@ -0,0 +1,283 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "wrapper.hpp"
+
+#include <jupedsim/jupedsim.h>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace
+{
+[[noreturn]] void throwError(JPS_ErrorMessage errorMsg)
+{
+    auto msg = std::string(JPS_ErrorMessage_GetMessage(errorMsg));
+    JPS_ErrorMessage_Free(errorMsg);
+    throw std::runtime_error{msg};
+}
+
+using DoubleColumn = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+/// Wraps a coordinate column without copying, 'owner' keeps the mapping alive.
+py::array columnView(
+    const JPS_TrajectoryFileReader_Wrapper& w,
+    py::handle owner,
+    const void* column,
+    size_t count)
+{
+    const auto size = static_cast<py::ssize_t>(count);
+    py::array view{};
+    switch(JPS_TrajectoryFileReader_Storage(w.handle)) {
+        case JPS_TrajectoryStorage_Float64:
+            view = py::array_t<double>(size, static_cast<const double*>(column), owner);
+            break;
+        case JPS_TrajectoryStorage_Float32:
+            view = py::array_t<float>(size, static_cast<const float*>(column), owner);
+            break;
+        case JPS_TrajectoryStorage_Quantized: {
+            py::array_t<double> values(size);
+            JPS_TrajectoryFileReader_DecodeColumn(
+                w.handle, column, count, values.mutable_data());
+            return values;
+        }
+    }
+    // The mapping is read only
+    view.attr("setflags")(py::arg("write") = false);
+    return view;
+}
+} // namespace
+
+void init_trajectory_file(py::module_& m)
+{
+    py::enum_<JPS_TrajectoryStorage>(m, "TrajectoryStorage")
+        .value("Float64", JPS_TrajectoryStorage_Float64)
+        .value("Float32", JPS_TrajectoryStorage_Float32)
+        .value("Quantized", JPS_TrajectoryStorage_Quantized);
+    py::class_<JPS_TrajectoryFileWriter_Wrapper>(m, "TrajectoryFileWriter")
+        .def(
+            py::init([](const std::string& path,
+                        JPS_TrajectoryStorage storage,
+                        double quantizationStep) {
+                JPS_ErrorMessage errorMsg{};
+                auto writer = JPS_TrajectoryFileWriter_Create(
+                    path.c_str(), storage, quantizationStep, &errorMsg);
+                if(!writer) {
+                    throwError(errorMsg);
+                }
+                return std::make_unique<JPS_TrajectoryFileWriter_Wrapper>(writer);
+            }),
+            py::arg("path"),
+            py::arg("storage"),
+            py::arg("quantization_step"))
+        .def(
+            "set_metadata",
+            [](JPS_TrajectoryFileWriter_Wrapper& w,
+               const std::string& key,
+               const std::string& value) {
+                JPS_TrajectoryFileWriter_SetMetadata(w.handle, key.c_str(), value.c_str());
+            },
+            py::arg("key"),
+            py::arg("value"))
+        .def(
+            "add_geometry",
+            [](JPS_TrajectoryFileWriter_Wrapper& w, int64_t hash, const std::string& wkt) {
+                return JPS_TrajectoryFileWriter_AddGeometry(w.handle, hash, wkt.c_str());
+            },
+            py::arg("hash"),
+            py::arg("wkt"))
+        .def(
+            "write_frame",
+            [](JPS_TrajectoryFileWriter_Wrapper& w,
+               uint64_t frame,
+               uint64_t geometry,
+               py::array_t<uint64_t, py::array::c_style | py::array::forcecast> ids,
+               DoubleColumn xs,
+               DoubleColumn ys,
+               DoubleColumn orientationXs,
+               DoubleColumn orientationYs) {
+                const auto count = static_cast<size_t>(ids.size());
+                for(const auto& column : {xs, ys, orientationXs, orientationYs}) {
+                    if(column.ndim() != 1 || static_cast<size_t>(column.size()) != count) {
+                        throw std::runtime_error{
+                            "All columns of a frame need to be one dimensional and of equal size"};
+                    }
+                }
+                JPS_ErrorMessage errorMsg{};
+                if(!JPS_TrajectoryFileWriter_WriteFrame(
+                       w.handle,
+                       frame,
+                       geometry,
+                       count,
+                       ids.data(),
+                       xs.data(),
+                       ys.data(),
+                       orientationXs.data(),
+                       orientationYs.data(),
+                       &errorMsg)) {
+                    throwError(errorMsg);
+                }
+            },
+            py::arg("frame"),
+            py::arg("geometry"),
+            py::arg("ids"),
+            py::arg("x"),
+            py::arg("y"),
+            py::arg("orientation_x"),
+            py::arg("orientation_y"))
+        .def(
+            "write_simulation",
+            [](JPS_TrajectoryFileWriter_Wrapper& w,
+               JPS_Simulation_Wrapper& simulation,
+               uint64_t frame,
+               uint64_t geometry) {
+                JPS_ErrorMessage errorMsg{};
+                if(!JPS_TrajectoryFileWriter_WriteSimulation(
+                       w.handle, simulation.handle, frame, geometry, &errorMsg)) {
+                    throwError(errorMsg);
+                }
+            },
+            py::arg("simulation"),
+            py::arg("frame"),
+            py::arg("geometry"))
+        .def("close", [](JPS_TrajectoryFileWriter_Wrapper& w) {
+            JPS_ErrorMessage errorMsg{};
+            if(!JPS_TrajectoryFileWriter_Close(w.handle, &errorMsg)) {
+                throwError(errorMsg);
+            }
+        });
+    py::class_<JPS_TrajectoryFileReader_Wrapper>(m, "TrajectoryFileReader")
+        .def(
+            py::init([](const std::string& path) {
+                JPS_ErrorMessage errorMsg{};
+                auto reader = JPS_TrajectoryFileReader_Open(path.c_str(), &errorMsg);
+                if(!reader) {
+                    throwError(errorMsg);
+                }
+                return std::make_unique<JPS_TrajectoryFileReader_Wrapper>(reader);
+            }),
+            py::arg("path"))
+        .def_property_readonly(
+            "storage",
+            [](const JPS_TrajectoryFileReader_Wrapper& w) {
+                return JPS_TrajectoryFileReader_Storage(w.handle);
+            })
+        .def_property_readonly(
+            "quantization_step",
+            [](const JPS_TrajectoryFileReader_Wrapper& w) {
+                return JPS_TrajectoryFileReader_QuantizationStep(w.handle);
+            })
+        .def(
+            "frame_count",
+            [](const JPS_TrajectoryFileReader_Wrapper& w) {
+                return JPS_TrajectoryFileReader_FrameCount(w.handle);
+            })
+        .def(
+            "metadata",
+            [](const JPS_TrajectoryFileReader_Wrapper& w) {
+                py::dict metadata{};
+                for(size_t index = 0; index < JPS_TrajectoryFileReader_MetadataCount(w.handle);
+                    ++index) {
+                    const char* key{};
+                    const char* value{};
+                    JPS_TrajectoryFileReader_Metadata(w.handle, index, &key, &value);
+                    metadata[py::str(key)] = py::str(value);
+                }
+                return metadata;
+            })
+        .def(
+            "geometries",
+            [](const JPS_TrajectoryFileReader_Wrapper& w) {
+                py::list geometries{};
+                for(size_t index = 0; index < JPS_TrajectoryFileReader_GeometryCount(w.handle);
+                    ++index) {
+                    int64_t hash{};
+                    const auto wkt = JPS_TrajectoryFileReader_Geometry(w.handle, index, &hash);
+                    geometries.append(py::make_tuple(hash, py::str(wkt)));
+                }
+                return geometries;
+            })
+        .def(
+            "frame_numbers",
+            [](const JPS_TrajectoryFileReader_Wrapper& w) {
+                const auto count = JPS_TrajectoryFileReader_FrameCount(w.handle);
+                py::array_t<int64_t> frames(static_cast<py::ssize_t>(count));
+                auto framesView = frames.mutable_unchecked<1>();
+                for(size_t index = 0; index < count; ++index) {
+                    framesView(static_cast<py::ssize_t>(index)) =
+                        JPS_TrajectoryFileReader_Frame(w.handle, index).frame;
+                }
+                return frames;
+            })
+        .def(
+            "read_frames",
+            [](const JPS_TrajectoryFileReader_Wrapper& w, size_t first, size_t last) {
+                last = std::min(last, JPS_TrajectoryFileReader_FrameCount(w.handle));
+                first = std::min(first, last);
+                size_t rowCount = 0;
+                for(size_t index = first; index < last; ++index) {
+                    rowCount += JPS_TrajectoryFileReader_Frame(w.handle, index).agent_count;
+                }
+                const auto size = static_cast<py::ssize_t>(rowCount);
+                py::array_t<int64_t> frames(size);
+                py::array_t<int64_t> ids(size);
+                py::array_t<double> xs(size);
+                py::array_t<double> ys(size);
+                py::array_t<double> orientationXs(size);
+                py::array_t<double> orientationYs(size);
+                std::vector<uint64_t> frameIds{};
+                size_t offset = 0;
+                for(size_t index = first; index < last; ++index) {
+                    const auto frame = JPS_TrajectoryFileReader_Frame(w.handle, index);
+                    const auto count = frame.agent_count;
+                    frameIds.resize(count);
+                    JPS_TrajectoryFileReader_FrameIds(w.handle, index, frameIds.data());
+                    std::fill_n(frames.mutable_data() + offset, count, frame.frame);
+                    std::copy(
+                        std::begin(frameIds), std::end(frameIds), ids.mutable_data() + offset);
+                    JPS_TrajectoryFileReader_DecodeColumn(
+                        w.handle, frame.x, count, xs.mutable_data() + offset);
+                    JPS_TrajectoryFileReader_DecodeColumn(
+                        w.handle, frame.y, count, ys.mutable_data() + offset);
+                    JPS_TrajectoryFileReader_DecodeColumn(
+                        w.handle,
+                        frame.orientation_x,
+                        count,
+                        orientationXs.mutable_data() + offset);
+                    JPS_TrajectoryFileReader_DecodeColumn(
+                        w.handle,
+                        frame.orientation_y,
+                        count,
+                        orientationYs.mutable_data() + offset);
+                    offset += count;
+                }
+                return py::make_tuple(frames, ids, xs, ys, orientationXs, orientationYs);
+            },
+            py::arg("first"),
+            py::arg("last"))
+        .def(
+            "frame",
+            [](py::object self, size_t index) {
+                const auto& w = self.cast<const JPS_TrajectoryFileReader_Wrapper&>();
+                if(index >= JPS_TrajectoryFileReader_FrameCount(w.handle)) {
+                    throw py::index_error{"Frame index out of range"};
+                }
+                const auto frame = JPS_TrajectoryFileReader_Frame(w.handle, index);
+                py::array_t<uint64_t> ids(static_cast<py::ssize_t>(frame.agent_count));
+                JPS_TrajectoryFileReader_FrameIds(w.handle, index, ids.mutable_data());
+                return py::make_tuple(
+                    frame.frame,
+                    frame.geometry,
+                    ids,
+                    columnView(w, self, frame.x, frame.agent_count),
+                    columnView(w, self, frame.y, frame.agent_count),
+                    columnView(w, self, frame.orientation_x, frame.agent_count),
+                    columnView(w, self, frame.orientation_y, frame.agent_count));
+            },
+            py::arg("index"));
+}
@@ -52,6 +52,10 @@ OWNED_WRAPPER(JPS_WaitingSetProxy);
 OWNED_WRAPPER(JPS_WaypointProxy);
 OWNED_WRAPPER(JPS_ExitProxy);
 OWNED_WRAPPER(JPS_DirectSteeringProxy);
+OWNED_WRAPPER(JPS_TrajectoryFileWriter);
+OWNED_WRAPPER(JPS_TrajectoryFileReader);
+OWNED_WRAPPER(JPS_FrameRingBufferWriter);
+OWNED_WRAPPER(JPS_FrameRingBufferReader);
 WRAPPER(JPS_Agent);
 WRAPPER(JPS_GeneralizedCentrifugalForceModelState);
 WRAPPER(JPS_CollisionFreeSpeedModelState);
@@ -1,6 +1,14 @@
 # SPDX-License-Identifier: LGPL-3.0-or-later
 
 from jupedsim.agent import Agent
+from jupedsim.columnar_serialization import (
+    ColumnarFrame,
+    ColumnarTrajectoryReader,
+    ColumnarTrajectoryWriter,
+    TrajectoryStorage,
+    convert_columnar_to_sqlite,
+    convert_sqlite_to_columnar,
+)
 from jupedsim.distributions import (
     AgentNumberError,
     IncorrectParameterError,
@@ -13,8 +21,11 @@ from jupedsim.distributions import (
     distribute_in_circles_by_number,
     distribute_until_filled,
 )
+from jupedsim.ensemble import EnsembleRun, EnsembleTrajectory, run_ensemble
+from jupedsim.events import Events, EventType
 from jupedsim.geometry import Geometry
-from jupedsim.internal.tracing import Trace
+from jupedsim.geometry_utils import build_geometry
+from jupedsim.internal.tracing import MemoryStats, Trace
 from jupedsim.journey import JourneyDescription, Transition
 from jupedsim.library import (
     BuildInfo,
@@ -24,6 +35,16 @@ from jupedsim.library import (
     set_info_callback,
     set_warning_callback,
 )
+from jupedsim.live_frames import (
+    LiveFrame,
+    LiveFramePublisher,
+    LiveFrameReader,
+)
+from jupedsim.measurements import (
+    AreaMeasurement,
+    GridMeasurement,
+    LineMeasurement,
+)
 from jupedsim.models.anticipation_velocity_model import (
     AnticipationVelocityModel,
     AnticipationVelocityModelAgentParameters,
@@ -49,8 +70,14 @@ from jupedsim.models.social_force import (
     SocialForceModelAgentParameters,
     SocialForceModelState,
 )
-from jupedsim.recording import Recording, RecordingAgent, RecordingFrame
-from jupedsim.routing import RoutingEngine
+from jupedsim.recording import (
+    AgentTrajectory,
+    Recording,
+    RecordingAgent,
+    RecordingFrame,
+    RecordingFrames,
+)
+from jupedsim.routing import PathBatch, RoutingAlgorithm, RoutingEngine
 from jupedsim.serialization import TrajectoryWriter
 from jupedsim.simulation import Simulation
 from jupedsim.sqlite_serialization import SqliteTrajectoryWriter
@@ -82,25 +109,44 @@ Id of the compiler used to build the native portion of this module.
 
 __all__ = [
     "Agent",
+    "AgentTrajectory",
+    "AreaMeasurement",
     "AgentNumberError",
     "BuildInfo",
+    "ColumnarFrame",
+    "ColumnarTrajectoryReader",
+    "ColumnarTrajectoryWriter",
+    "EnsembleRun",
+    "EnsembleTrajectory",
+    "Events",
+    "EventType",
     "ExitStage",
     "GeneralizedCentrifugalForceModelAgentParameters",
     "GeneralizedCentrifugalForceModel",
     "GeneralizedCentrifugalForceModelState",
     "Geometry",
+    "GridMeasurement",
     "IncorrectParameterError",
     "JourneyDescription",
+    "LineMeasurement",
+    "LiveFrame",
+    "LiveFramePublisher",
+    "LiveFrameReader",
+    "MemoryStats",
     "NegativeValueError",
     "NotifiableQueueStage",
     "OverlappingCirclesError",
+    "PathBatch",
     "Recording",
     "RecordingAgent",
     "RecordingFrame",
+    "RecordingFrames",
+    "RoutingAlgorithm",
     "RoutingEngine",
     "Simulation",
     "SqliteTrajectoryWriter",
     "Trace",
+    "TrajectoryStorage",
     "TrajectoryWriter",
     "Transition",
     "CollisionFreeSpeedModelAgentParameters",
@@ -121,6 +167,9 @@ __all__ = [
     "__commit__",
     "__compiler__",
     "__version__",
+    "build_geometry",
+    "convert_columnar_to_sqlite",
+    "convert_sqlite_to_columnar",
     "distribute_by_density",
     "distribute_by_number",
     "distribute_by_percentage",
@@ -128,6 +177,7 @@ __all__ = [
     "distribute_in_circles_by_number",
     "distribute_until_filled",
     "get_build_info",
+    "run_ensemble",
     "set_debug_callback",
     "set_error_callback",
     "set_info_callback",
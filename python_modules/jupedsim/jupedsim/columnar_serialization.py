@@ -0,0 +1,365 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""Columnar trajectory files
+
+A columnar trajectory file stores each frame as one block holding the agent
+ids followed by the x, y and orientation columns. Ids are delta encoded,
+coordinates can be stored as float64, float32 or quantized to a fixed step.
+An index at the end of the file allows random access to every frame and the
+file is read through a memory mapping, so frames are handed out as NumPy views
+without copying.
+"""
+
+import sqlite3
+from dataclasses import dataclass
+from enum import Enum
+from pathlib import Path
+from typing import Iterator
+
+import numpy as np
+import numpy.typing as npt
+from shapely import from_wkt
+
+import jupedsim.native as py_jps
+from jupedsim.recording import AgentTrajectory, RecordingFrames
+from jupedsim.serialization import TrajectoryWriter
+from jupedsim.simulation import Simulation
+from jupedsim.sqlite_serialization import (
+    DATABASE_VERSION,
+    create_database_tables,
+    update_database_to_latest_version,
+)
+
+
+class TrajectoryStorage(Enum):
+    """Representation of coordinates in a columnar trajectory file."""
+
+    FLOAT64 = py_jps.TrajectoryStorage.Float64
+    """Lossless 64 bit floating point values."""
+    FLOAT32 = py_jps.TrajectoryStorage.Float32
+    """32 bit floating point values, about 7 significant digits."""
+    QUANTIZED = py_jps.TrajectoryStorage.Quantized
+    """32 bit integer multiples of a fixed quantization step."""
+
+
+@dataclass
+class ColumnarFrame:
+    """A single frame of a columnar trajectory file.
+
+    All arrays have one entry per agent, ordered by agent id. The coordinate
+    arrays are read only views into the file unless the file uses
+    :attr:`TrajectoryStorage.QUANTIZED`.
+    """
+
+    frame: int
+    geometry_hash: int
+    id: npt.NDArray[np.uint64]
+    x: npt.NDArray[np.floating]
+    y: npt.NDArray[np.floating]
+    orientation_x: npt.NDArray[np.floating]
+    orientation_y: npt.NDArray[np.floating]
+
+
+class ColumnarTrajectoryWriter(TrajectoryWriter):
+    """Write trajectory data into a columnar trajectory file.
+
+    The file is only readable after :func:`close` has been called, the writer
+    can be used as a context manager to ensure this.
+    """
+
+    def __init__(
+        self,
+        *,
+        output_file: Path,
+        every_nth_frame: int = 4,
+        storage: TrajectoryStorage = TrajectoryStorage.FLOAT64,
+        quantization_step: float = 0.001,
+    ) -> None:
+        """ColumnarTrajectoryWriter constructor
+
+        Args:
+            output_file: name of the output file.
+                Note: the file will not be written until the first call to
+                :func:`begin_writing`
+            every_nth_frame: indicates interval between writes, 1 means every
+                frame, 5 every 5th
+            storage: representation of the coordinates in the file
+            quantization_step: distance in meters represented by one unit if
+                ``storage`` is :attr:`TrajectoryStorage.QUANTIZED`
+        """
+        if every_nth_frame < 1:
+            raise TrajectoryWriter.Exception("'every_nth_frame' has to be > 0")
+        self._output_file = output_file
+        self._every_nth_frame = every_nth_frame
+        self._storage = storage
+        self._quantization_step = quantization_step
+        self._writer = None
+        self._geometries: dict[int, int] = {}
+        self._bounds = [
+            float("inf"),
+            float("inf"),
+            float("-inf"),
+            float("-inf"),
+        ]
+
+    def __enter__(self) -> "ColumnarTrajectoryWriter":
+        return self
+
+    def __exit__(self, *args) -> None:
+        self.close()
+
+    def begin_writing(self, simulation: Simulation) -> None:
+        """Create the file and write the meta information."""
+        fps = 1 / simulation.delta_time() / self._every_nth_frame
+        try:
+            self._writer = py_jps.TrajectoryFileWriter(
+                str(self._output_file),
+                self._storage.value,
+                self._quantization_step,
+            )
+        except RuntimeError as e:
+            raise TrajectoryWriter.Exception(f"Error creating file: {e}")
+        self._writer.set_metadata("fps", str(fps))
+
+    def write_iteration_state(self, simulation: Simulation) -> None:
+        """Write the agents of the current iteration as one frame."""
+        if self._writer is None:
+            raise TrajectoryWriter.Exception("File not opened.")
+
+        iteration = simulation.iteration_count()
+        if iteration % self.every_nth_frame() != 0:
+            return
+        frame = iteration // self.every_nth_frame()
+
+        geo_wkt = simulation.get_geometry().as_wkt()
+        geometry = self._add_geometry(hash(geo_wkt), geo_wkt)
+        try:
+            self._writer.write_simulation(simulation._obj, frame, geometry)
+        except RuntimeError as e:
+            raise TrajectoryWriter.Exception(f"Error writing to file: {e}")
+
+    def every_nth_frame(self) -> int:
+        return self._every_nth_frame
+
+    def close(self) -> None:
+        """Write the frame index and close the file.
+
+        Calling close more than once has no effect.
+        """
+        if self._writer is None:
+            return
+        xmin, ymin, xmax, ymax = self._bounds
+        for key, value in (
+            ("xmin", xmin),
+            ("ymin", ymin),
+            ("xmax", xmax),
+            ("ymax", ymax),
+        ):
+            self._writer.set_metadata(key, str(value))
+        try:
+            self._writer.close()
+        except RuntimeError as e:
+            raise TrajectoryWriter.Exception(f"Error writing to file: {e}")
+        self._writer = None
+
+    def _add_geometry(self, geo_hash: int, geo_wkt: str) -> int:
+        if geo_hash not in self._geometries:
+            xmin, ymin, xmax, ymax = from_wkt(geo_wkt).bounds
+            self._bounds = [
+                min(xmin, self._bounds[0]),
+                min(ymin, self._bounds[1]),
+                max(xmax, self._bounds[2]),
+                max(ymax, self._bounds[3]),
+            ]
+            self._geometries[geo_hash] = self._writer.add_geometry(
+                geo_hash, geo_wkt
+            )
+        return self._geometries[geo_hash]
+
+
+class ColumnarTrajectoryReader:
+    """Provides access to a columnar trajectory file.
+
+    The file is memory mapped, frames are read on access.
+    """
+
+    def __init__(self, input_file: Path) -> None:
+        self._reader = py_jps.TrajectoryFileReader(str(input_file))
+        self._geometries = self._reader.geometries()
+        self._frame_numbers = self._reader.frame_numbers()
+
+    @property
+    def storage(self) -> TrajectoryStorage:
+        """Representation of the coordinates in the file."""
+        return TrajectoryStorage(self._reader.storage)
+
+    @property
+    def metadata(self) -> dict[str, str]:
+        """Meta information of the file, e.g. ``fps``."""
+        return self._reader.metadata()
+
+    @property
+    def fps(self) -> float:
+        """How many frames are stored per second."""
+        return float(self.metadata["fps"])
+
+    @property
+    def geometries(self) -> dict[int, str]:
+        """Geometries referenced by the frames as WKT, keyed by hash."""
+        return dict(self._geometries)
+
+    @property
+    def num_frames(self) -> int:
+        """Number of frames in the file."""
+        return self._reader.frame_count()
+
+    def frame(self, index: int) -> ColumnarFrame:
+        """Access a single frame.
+
+        Arguments:
+            index: position of the frame in the file, not the frame number.
+
+        Returns:
+            A single frame.
+        """
+        frame, geometry, ids, x, y, ori_x, ori_y = self._reader.frame(index)
+        return ColumnarFrame(
+            frame, self._geometries[geometry][0], ids, x, y, ori_x, ori_y
+        )
+
+    def frames(self, start: int, stop: int) -> RecordingFrames:
+        """Access all frames with a frame number in [start, stop) at once.
+
+        Arguments:
+            start: first frame number to read.
+            stop: frame number after the last frame to read.
+
+        Returns:
+            The agent data of all frames in the range as columns.
+        """
+        first, last = np.searchsorted(self._frame_numbers, [start, stop])
+        return RecordingFrames(*self._reader.read_frames(first, last))
+
+    def agent_trajectories(self) -> dict[int, AgentTrajectory]:
+        """Access the data of all agents at once.
+
+        Returns:
+            Data of each agent keyed by agent id.
+        """
+        return RecordingFrames(
+            *self._reader.read_frames(0, self.num_frames)
+        ).agent_trajectories()
+
+    def __len__(self) -> int:
+        return self.num_frames
+
+    def __iter__(self) -> Iterator[ColumnarFrame]:
+        for index in range(self.num_frames):
+            yield self.frame(index)
+
+
+def convert_sqlite_to_columnar(
+    input_file: Path,
+    output_file: Path,
+    *,
+    storage: TrajectoryStorage = TrajectoryStorage.FLOAT64,
+    quantization_step: float = 0.001,
+) -> None:
+    """Convert a sqlite trajectory file into a columnar trajectory file.
+
+    Arguments:
+        input_file: sqlite file as written by
+            :class:`~jupedsim.sqlite_serialization.SqliteTrajectoryWriter`.
+            Files of older versions are updated in place.
+        output_file: columnar file to write, an existing file is replaced.
+        storage: representation of the coordinates in ``output_file``
+        quantization_step: distance in meters represented by one unit if
+            ``storage`` is :attr:`TrajectoryStorage.QUANTIZED`
+    """
+    con = sqlite3.connect(input_file, isolation_level=None)
+    try:
+        update_database_to_latest_version(con)
+        cur = con.cursor()
+        writer = py_jps.TrajectoryFileWriter(
+            str(output_file), storage.value, quantization_step
+        )
+        for key, value in cur.execute(
+            "SELECT key, value FROM metadata WHERE key != 'version'"
+        ).fetchall():
+            writer.set_metadata(key, str(value))
+        geometries = {
+            geo_hash: writer.add_geometry(geo_hash, wkt)
+            for geo_hash, wkt in cur.execute(
+                "SELECT hash, wkt FROM geometry"
+            ).fetchall()
+        }
+        frames = cur.execute(
+            "SELECT frame, geometry_hash FROM frame_data ORDER BY frame ASC"
+        ).fetchall()
+        for frame, geo_hash in frames:
+            rows = np.array(
+                cur.execute(
+                    "SELECT id, pos_x, pos_y, ori_x, ori_y FROM trajectory_data "
+                    "WHERE frame == (?) ORDER BY id ASC",
+                    (frame,),
+                ).fetchall(),
+                dtype=np.float64,
+            ).reshape(-1, 5)
+            writer.write_frame(
+                int(frame),
+                geometries[geo_hash],
+                rows[:, 0].astype(np.uint64),
+                rows[:, 1],
+                rows[:, 2],
+                rows[:, 3],
+                rows[:, 4],
+            )
+        writer.close()
+    finally:
+        con.close()
+
+
+def convert_columnar_to_sqlite(input_file: Path, output_file: Path) -> None:
+    """Convert a columnar trajectory file into a sqlite trajectory file.
+
+    The written file can be read by :class:`~jupedsim.recording.Recording`.
+
+    Arguments:
+        input_file: columnar file to read.
+        output_file: sqlite file to write, existing trajectory tables are
+            replaced.
+    """
+    reader = ColumnarTrajectoryReader(input_file)
+    con = sqlite3.connect(output_file, isolation_level=None)
+    cur = con.cursor()
+    try:
+        cur.execute("BEGIN")
+        create_database_tables(cur)
+        cur.executemany(
+            "INSERT INTO metadata VALUES(?, ?)",
+            [("version", DATABASE_VERSION)] + list(reader.metadata.items()),
+        )
+        cur.executemany(
+            "INSERT INTO geometry VALUES(?, ?)", reader.geometries.items()
+        )
+        for frame in reader:
+            cur.executemany(
+                "INSERT INTO trajectory_data VALUES(?, ?, ?, ?, ?, ?)",
+                zip(
+                    [frame.frame] * len(frame.id),
+                    frame.id.tolist(),
+                    frame.x.tolist(),
+                    frame.y.tolist(),
+                    frame.orientation_x.tolist(),
+                    frame.orientation_y.tolist(),
+                ),
+            )
+            cur.execute(
+                "INSERT INTO frame_data VALUES(?, ?)",
+                (frame.frame, frame.geometry_hash),
+            )
+        cur.execute("COMMIT")
+    except sqlite3.Error as e:
+        cur.execute("ROLLBACK")
+        raise TrajectoryWriter.Exception(f"Error writing to database: {e}")
+    finally:
+        con.close()
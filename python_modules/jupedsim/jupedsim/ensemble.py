@@ -0,0 +1,136 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+from dataclasses import dataclass
+from typing import Any, Callable, Generic, Sequence, TypeVar
+
+import numpy as np
+import numpy.typing as npt
+
+import jupedsim.native as py_jps
+from jupedsim.simulation import Simulation
+
+T = TypeVar("T")
+
+
+@dataclass
+class EnsembleTrajectory:
+    """Agent positions recorded during a run as columns.
+
+    All arrays have the same length, the i-th entry of each array belongs to
+    the i-th sample. Samples are ordered by iteration.
+    """
+
+    iteration: npt.NDArray[np.uint64]
+    """Iteration each position was recorded at."""
+    agent_id: npt.NDArray[np.uint64]
+    """Agent each position belongs to."""
+    x: npt.NDArray[np.float64]
+    """x coordinate of each position."""
+    y: npt.NDArray[np.float64]
+    """y coordinate of each position."""
+
+    def __len__(self) -> int:
+        return len(self.iteration)
+
+
+@dataclass
+class EnsembleRun(Generic[T]):
+    """Outcome of a single run of an ensemble."""
+
+    parameters: T
+    """Parameter set the simulation of this run was created from."""
+    error: str | None
+    """Reason the run was aborted, None if it completed."""
+    iteration_count: int
+    """Number of iterations performed."""
+    elapsed_time: float
+    """Simulated time in seconds when the run ended."""
+    agent_count: int
+    """Agents still in the simulation when the run ended."""
+    removed_agent_count: int
+    """Agents removed during the run."""
+    trajectory: EnsembleTrajectory | None
+    """Recorded agent positions, None if recording was disabled."""
+
+
+def run_ensemble(
+    scenario: Callable[[T], Simulation],
+    parameter_sets: Sequence[T],
+    *,
+    max_iterations: int,
+    thread_count: int = 0,
+    every_nth_frame: int | None = None,
+) -> list[EnsembleRun[T]]:
+    """Runs one simulation per parameter set in parallel.
+
+    ``scenario`` is called once per parameter set and has to return a fully
+    set up :class:`~jupedsim.simulation.Simulation`. The simulations are then
+    iterated on native threads without holding the GIL, only the calls to
+    ``scenario`` are serialized. Create the geometry once with
+    :func:`~jupedsim.build_geometry` and pass it to all simulations, they then
+    share it instead of building it again.
+
+    .. note ::
+        The simulations returned by ``scenario`` are consumed by the ensemble
+        and cannot be used afterwards. Trajectory writers of these simulations
+        are not called, use ``every_nth_frame`` to record trajectories.
+
+    Arguments:
+        scenario: Creates the simulation for a parameter set. Called from
+            different threads.
+        parameter_sets: One entry per run.
+        max_iterations: A run ends after this many iterations or once no agents
+            are left.
+        thread_count: Number of threads to use, 0 uses one thread per
+            hardware thread.
+        every_nth_frame: Record agent positions every n-th iteration, None
+            disables recording.
+
+    Returns:
+        One :class:`EnsembleRun` per parameter set, in the same order. If
+        ``scenario`` raised for a parameter set, the message is stored in the
+        ``error`` of that run and the other runs are not affected.
+
+    Raises:
+        ValueError: if ``every_nth_frame`` is not positive.
+        RuntimeError: if the ensemble could not be run at all.
+    """
+
+    def create(run: int) -> Any:
+        return scenario(parameter_sets[run])._obj
+
+    if every_nth_frame is not None and every_nth_frame <= 0:
+        raise ValueError("every_nth_frame has to be a positive number")
+
+    runs = py_jps.run_ensemble(
+        create,
+        len(parameter_sets),
+        max_iterations,
+        thread_count,
+        every_nth_frame or 0,
+    )
+    return [
+        EnsembleRun(
+            parameters=parameters,
+            error=error,
+            iteration_count=iteration_count,
+            elapsed_time=elapsed_time,
+            agent_count=agent_count,
+            removed_agent_count=removed_agent_count,
+            trajectory=(
+                EnsembleTrajectory(iteration=iteration, agent_id=agent_id, x=x, y=y)
+                if every_nth_frame is not None
+                else None
+            ),
+        )
+        for parameters, (
+            error,
+            iteration_count,
+            elapsed_time,
+            agent_count,
+            removed_agent_count,
+            iteration,
+            agent_id,
+            x,
+            y,
+        ) in zip(parameter_sets, runs)
+    ]
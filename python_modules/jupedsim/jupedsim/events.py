@@ -0,0 +1,53 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+from dataclasses import dataclass
+from enum import IntEnum
+
+import numpy as np
+import numpy.typing as npt
+
+
+class EventType(IntEnum):
+    """Kind of an event recorded during the simulation."""
+
+    STAGE_CHANGED = 0
+    """Agent completed ``previous_stage_id`` or has been switched to another
+    journey and now targets ``stage_id``."""
+    AGENT_REMOVED = 1
+    """Agent has been removed, ``stage_id`` is the last stage it targeted."""
+    QUEUE_ENQUEUED = 2
+    """Agent has been assigned a slot in the queue ``stage_id``."""
+    QUEUE_POPPED = 3
+    """Agent has been popped from the queue ``stage_id``."""
+    WAITING_SET_ENTERED = 4
+    """Agent has been assigned a slot in the waiting set ``stage_id``."""
+    WAITING_SET_FULL = 5
+    """All slots of the waiting set ``stage_id`` are occupied, ``agent_id``
+    took the last slot."""
+
+
+@dataclass
+class Events:
+    """Events recorded during the simulation as columns.
+
+    All arrays have the same length, the i-th entry of each array belongs to
+    the i-th event. Events are ordered by the time they occurred. Select
+    events of a kind with a mask, e.g.
+    ``events.agent_id[events.type == EventType.AGENT_REMOVED]``.
+    """
+
+    type: npt.NDArray[np.uint8]
+    """Kind of each event, see :class:`EventType`."""
+    iteration: npt.NDArray[np.uint64]
+    """Iteration count at the beginning of the iteration the event occurred in.
+    Events caused between iterations, e.g. by adding agents or popping a
+    queue, carry the current iteration count."""
+    agent_id: npt.NDArray[np.uint64]
+    """Agent each event refers to."""
+    stage_id: npt.NDArray[np.uint64]
+    """Stage each event refers to."""
+    previous_stage_id: npt.NDArray[np.uint64]
+    """Stage the agent left, only set for :attr:`EventType.STAGE_CHANGED`
+    otherwise 0."""
+
+    def __len__(self) -> int:
+        return len(self.type)
@@ -1,4 +1,5 @@
 # SPDX-License-Identifier: LGPL-3.0-or-later
+from pathlib import Path
 from typing import Any, List, Optional, Tuple
 
 import shapely
@@ -19,7 +20,16 @@ class GeometryError(Exception):
         self.message = message
 
 
-def _geometry_from_wkt(wkt_input: str) -> Geometry:
+def _geometry_from_wkt(
+    wkt_input: str,
+    *,
+    cache_directory: Optional[Path] = None,
+    simplification_tolerance: float = 0,
+    wall_grid_cell_size: Optional[float] = None,
+    wall_distance_field_spacing: Optional[float] = None,
+    wall_distance_field_range: float = 2.5,
+    routing_region_size: float = 0,
+) -> Geometry:
     geometry_collection = None
     try:
         wkt_type = shapely.from_wkt(wkt_input)
@@ -41,7 +51,17 @@ def _geometry_from_wkt(wkt_input: str) -> Geometry:
             ) from exc
 
     polygons = _polygons_from_geometry_collection(geometry_collection)
-    return Geometry(_internal_build_geometry(polygons))
+    return Geometry(
+        _internal_build_geometry(
+            polygons,
+            cache_directory,
+            simplification_tolerance,
+            wall_grid_cell_size,
+            wall_distance_field_spacing,
+            wall_distance_field_range,
+            routing_region_size,
+        )
+    )
 
 
 def _geometry_from_shapely(
@@ -51,18 +71,53 @@ def _geometry_from_shapely(
         | shapely.GeometryCollection
         | shapely.MultiPoint
     ),
+    *,
+    cache_directory: Optional[Path] = None,
+    simplification_tolerance: float = 0,
+    wall_grid_cell_size: Optional[float] = None,
+    wall_distance_field_spacing: Optional[float] = None,
+    wall_distance_field_range: float = 2.5,
+    routing_region_size: float = 0,
 ) -> Geometry:
     polygons = _polygons_from_geometry_collection(
         shapely.GeometryCollection([geometry_input])
     )
-    return Geometry(_internal_build_geometry(polygons))
+    return Geometry(
+        _internal_build_geometry(
+            polygons,
+            cache_directory,
+            simplification_tolerance,
+            wall_grid_cell_size,
+            wall_distance_field_spacing,
+            wall_distance_field_range,
+            routing_region_size,
+        )
+    )
 
 
 def _geometry_from_coordinates(
-    coordinates: List[Tuple], *, excluded_areas: Optional[List[Tuple]] = None
+    coordinates: List[Tuple],
+    *,
+    excluded_areas: Optional[List[Tuple]] = None,
+    cache_directory: Optional[Path] = None,
+    simplification_tolerance: float = 0,
+    wall_grid_cell_size: Optional[float] = None,
+    wall_distance_field_spacing: Optional[float] = None,
+    wall_distance_field_range: float = 2.5,
+    routing_region_size: float = 0,
 ) -> Geometry:
     polygon = shapely.Polygon(coordinates, holes=excluded_areas)
-    return Geometry(_internal_build_geometry([polygon]))
+    return Geometry(
+        _internal_build_geometry(
+            [polygon],
+            cache_directory,
+            simplification_tolerance,
+            wall_grid_cell_size,
+            wall_distance_field_spacing,
+            wall_distance_field_range,
+            routing_region_size,
+        )
+    )
 
 
 def _polygons_from_geometry_collection(
@@ -107,19 +162,36 @@ def _polygons_from_geometry_collection(
 
 def _internal_build_geometry(
     polygons: List[shapely.Polygon],
+    cache_directory: Optional[Path] = None,
+    simplification_tolerance: float = 0,
+    wall_grid_cell_size: Optional[float] = None,
+    wall_distance_field_spacing: Optional[float] = None,
+    wall_distance_field_range: float = 2.5,
+    routing_region_size: float = 0,
 ) -> py_jps.Geometry:
     geo_builder = py_jps.GeometryBuilder()
+    geo_builder.set_simplification_tolerance(simplification_tolerance)
+    if wall_grid_cell_size is not None:
+        geo_builder.set_wall_grid_cell_size(wall_grid_cell_size)
+    if wall_distance_field_spacing is not None:
+        geo_builder.set_wall_distance_field(
+            wall_distance_field_spacing, wall_distance_field_range
+        )
+    geo_builder.set_routing_hierarchy(routing_region_size)
 
     for polygon in polygons:
         geo_builder.add_accessible_area(polygon.exterior.coords[:-1])
         for hole in polygon.interiors:
             geo_builder.exclude_from_accessible_area(hole.coords[:-1])
+    if cache_directory is not None:
+        return geo_builder.build_cached(str(cache_directory))
     return geo_builder.build()
 
 
 def build_geometry(
     geometry: (
-        list[tuple[float, float]]
+        Geometry
+        | list[tuple[float, float]]
         | shapely.GeometryCollection
         | shapely.Polygon
         | shapely.MultiPolygon
@@ -137,6 +209,8 @@ def build_geometry(
     Arguments:
         geometry: Data to create the geometry out of. Data may be supplied as:
 
+            * :class:`~jupedsim.geometry.Geometry`, returned as is. Simulations created from the same :class:`~jupedsim.geometry.Geometry` share its data instead of building it again.
+
             * list of 2d points describing the outer boundary, holes may be added with use of `excluded_areas` kw-argument
 
             * :class:`~shapely.GeometryCollection` consisting only out of :class:`Polygons <shapely.Polygon>`, :class:`MultiPolygons <shapely.MultiPolygon>` and :class:`MultiPoints <shapely.MultiPoint>`
@@ -153,17 +227,74 @@ def build_geometry(
         excluded_areas: describes exclusions
             from the walkable area. Only use this argument if `geometry` was
             provided as list[tuple[float, float]].
+        cache_directory: directory to store built geometries in. Building
+            a geometry from the same polygons again loads it from there,
+            including its navigation mesh, instead of computing it. The
+            directory can be shared between processes.
+        simplification_tolerance: merges collinear and nearly collinear
+            walls and removes walls shorter than this tolerance (in m). The
+            simplified walls deviate at most this much from the original
+            ones, 0 (default) keeps the walls as given.
+        wall_grid_cell_size: cell size (in m) of the grid the models use to
+            find walls within their interaction range, defaults to 2 m.
+            Cells of about the interaction range perform best.
+        wall_distance_field_spacing: enables a precomputed field of the
+            nearest walls with this point spacing (in m). The wall forces
+            of the collision free speed models, the social force model and
+            the generalized centrifugal force model then only consider the
+            nearest walls around each agent. Ignored walls are at least
+            sqrt(2) * spacing farther away than the nearest considered wall.
+            Disabled by default.
+        wall_distance_field_range: distance (in m) from the walls covered
+            by the wall distance field, defaults to 2.5 m. Interaction
+            ranges above range - sqrt(2) * spacing use the exact search.
+        routing_region_size: builds a routing hierarchy of the navigation
+            mesh with regions of about this size (in m) together with the
+            geometry, used by :attr:`RoutingAlgorithm.HIERARCHICAL`. Speeds
+            up long range routing in very large geometries. 0 (default)
+            disables it.
     """
-    if isinstance(geometry, str):
-        return _geometry_from_wkt(geometry)
+    cache_directory = kwargs.get("cache_directory")
+    simplification_tolerance = kwargs.get("simplification_tolerance", 0)
+    wall_grid_cell_size = kwargs.get("wall_grid_cell_size")
+    wall_distance_field_spacing = kwargs.get("wall_distance_field_spacing")
+    wall_distance_field_range = kwargs.get("wall_distance_field_range", 2.5)
+    routing_region_size = kwargs.get("routing_region_size", 0)
+    if isinstance(geometry, Geometry):
+        return geometry
+    elif isinstance(geometry, str):
+        return _geometry_from_wkt(
+            geometry,
+            cache_directory=cache_directory,
+            simplification_tolerance=simplification_tolerance,
+            wall_grid_cell_size=wall_grid_cell_size,
+            wall_distance_field_spacing=wall_distance_field_spacing,
+            wall_distance_field_range=wall_distance_field_range,
+            routing_region_size=routing_region_size,
+        )
     elif (
         isinstance(geometry, shapely.GeometryCollection)
         or isinstance(geometry, shapely.Polygon)
         or isinstance(geometry, shapely.MultiPolygon)
         or isinstance(geometry, shapely.MultiPoint)
     ):
-        return _geometry_from_shapely(geometry)
+        return _geometry_from_shapely(
+            geometry,
+            cache_directory=cache_directory,
+            simplification_tolerance=simplification_tolerance,
+            wall_grid_cell_size=wall_grid_cell_size,
+            wall_distance_field_spacing=wall_distance_field_spacing,
+            wall_distance_field_range=wall_distance_field_range,
+            routing_region_size=routing_region_size,
+        )
     else:
         return _geometry_from_coordinates(
-            geometry, excluded_areas=kwargs.get("excluded_areas")
+            geometry,
+            excluded_areas=kwargs.get("excluded_areas"),
+            cache_directory=cache_directory,
+            simplification_tolerance=simplification_tolerance,
+            wall_grid_cell_size=wall_grid_cell_size,
+            wall_distance_field_spacing=wall_distance_field_spacing,
+            wall_distance_field_range=wall_distance_field_range,
+            routing_region_size=routing_region_size,
         )
@@ -34,5 +34,77 @@ class Trace:
 
         return self._obj.operational_level_duration
 
+    @property
+    def iteration_counters(self):
+        """Hardware counters sampled over one simulation iteration.
+
+        Returns:
+             Cycles, instructions, cache misses and branch misses of one
+             simulation iteration. All values are zero if hardware counters
+             are not enabled or not available.
+        """
+        return self._obj.iteration_counters
+
+    @property
+    def operational_level_counters(self):
+        """Hardware counters sampled over the operational level.
+
+        Returns:
+             Cycles, instructions, cache misses and branch misses of the
+             operational level of one simulation iteration. All values are
+             zero if hardware counters are not enabled or not available.
+        """
+        return self._obj.operational_level_counters
+
+    def __str__(self) -> str:
+        return self._obj.__repr__()
+
+
+class MemoryStats:
+    """Estimated heap memory usage of a simulation per subsystem.
+
+    Each subsystem is reported as an object with the attributes ``bytes``
+    (current usage) and ``peak_bytes`` (highest usage observed so far).
+
+    .. important::
+
+        This is indented for internal usage. We will not guarantee that this API will
+        stable and available in any release. It might be changed on any update, regardless of
+        a major/minor/patch update.
+    """
+
+    def __init__(self, obj: py_jps.MemoryStats) -> None:
+        self._obj = obj
+
+    @property
+    def agents(self):
+        """Memory used to store the agents."""
+        return self._obj.agents
+
+    @property
+    def neighborhood_search(self):
+        """Memory used by the grid to look up neighboring agents."""
+        return self._obj.neighborhood_search
+
+    @property
+    def collision_geometry(self):
+        """Memory used by the active collision geometry."""
+        return self._obj.collision_geometry
+
+    @property
+    def routing_engine(self):
+        """Memory used by triangulation and navigation mesh of the active routing engine."""
+        return self._obj.routing_engine
+
+    @property
+    def geometry_cache(self):
+        """Memory used by previously active geometries kept for switching back."""
+        return self._obj.geometry_cache
+
+    @property
+    def total(self):
+        """Sum of all subsystems."""
+        return self._obj.total
+
     def __str__(self) -> str:
         return self._obj.__repr__()
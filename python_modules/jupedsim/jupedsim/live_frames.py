@@ -0,0 +1,157 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""Live frames for local viewers
+
+A running simulation publishes its agents into a ring buffer in named shared
+memory. Viewers on the same machine open the buffer by name and read the most
+recent frames while the simulation continues, publishing never waits for a
+viewer. Only the id of the active geometry is published, a viewer detects
+geometry switches by a change of :attr:`LiveFrame.geometry_version`.
+"""
+
+from dataclasses import dataclass
+
+import numpy as np
+import numpy.typing as npt
+
+import jupedsim.native as py_jps
+from jupedsim.serialization import TrajectoryWriter
+from jupedsim.simulation import Simulation
+
+
+@dataclass
+class LiveFrame:
+    """A single frame read from a live frame buffer.
+
+    All arrays have one entry per agent and are copies owned by the frame.
+    """
+
+    index: int
+    """Position of the frame in the order of publishing."""
+    frame: int
+    geometry_version: int
+    time: float
+    id: npt.NDArray[np.uint64]
+    x: npt.NDArray[np.float64]
+    y: npt.NDArray[np.float64]
+    orientation_x: npt.NDArray[np.float64]
+    orientation_y: npt.NDArray[np.float64]
+
+
+class LiveFramePublisher(TrajectoryWriter):
+    """Publish frames of a simulation into a live frame buffer.
+
+    The buffer is removed once :func:`close` has been called, the publisher
+    can be used as a context manager to ensure this.
+    """
+
+    def __init__(
+        self,
+        *,
+        name: str,
+        every_nth_frame: int = 1,
+        slots: int = 8,
+        capacity: int = 10000,
+    ) -> None:
+        """LiveFramePublisher constructor
+
+        Args:
+            name: name of the shared memory, an existing buffer with the same
+                name is replaced.
+                Note: the buffer will not be created until the first call to
+                :func:`begin_writing`
+            every_nth_frame: indicates interval between writes, 1 means every
+                frame, 5 every 5th
+            slots: number of frames kept in the buffer
+            capacity: maximum number of agents per frame
+        """
+        if every_nth_frame < 1:
+            raise TrajectoryWriter.Exception("'every_nth_frame' has to be > 0")
+        self._name = name
+        self._every_nth_frame = every_nth_frame
+        self._slots = slots
+        self._capacity = capacity
+        self._writer = None
+
+    def __enter__(self) -> "LiveFramePublisher":
+        return self
+
+    def __exit__(self, *args) -> None:
+        self.close()
+
+    def begin_writing(self, simulation: Simulation) -> None:
+        """Create the shared memory buffer."""
+        try:
+            self._writer = py_jps.FrameRingBufferWriter(
+                self._name, self._slots, self._capacity
+            )
+        except RuntimeError as e:
+            raise TrajectoryWriter.Exception(f"Error creating buffer: {e}")
+
+    def write_iteration_state(self, simulation: Simulation) -> None:
+        """Publish the agents of the current iteration as one frame."""
+        if self._writer is None:
+            raise TrajectoryWriter.Exception("Buffer not created.")
+
+        iteration = simulation.iteration_count()
+        if iteration % self.every_nth_frame() != 0:
+            return
+        frame = iteration // self.every_nth_frame()
+        try:
+            self._writer.publish_simulation(simulation._obj, frame)
+        except RuntimeError as e:
+            raise TrajectoryWriter.Exception(f"Error publishing frame: {e}")
+
+    def every_nth_frame(self) -> int:
+        return self._every_nth_frame
+
+    def close(self) -> None:
+        """Remove the shared memory buffer.
+
+        Readers that already opened the buffer can still read it. Calling
+        close more than once has no effect.
+        """
+        self._writer = None
+
+
+class LiveFrameReader:
+    """Reads frames from a live frame buffer, possibly of another process."""
+
+    def __init__(self, name: str) -> None:
+        """LiveFrameReader constructor
+
+        Args:
+            name: name of the shared memory as passed to
+                :class:`LiveFramePublisher`
+        """
+        self._reader = py_jps.FrameRingBufferReader(name)
+
+    @property
+    def capacity(self) -> int:
+        """Maximum number of agents per frame."""
+        return self._reader.capacity
+
+    def published_count(self) -> int:
+        """Number of frames published so far, including overwritten ones."""
+        return self._reader.published_count()
+
+    def read(self, index: int) -> LiveFrame | None:
+        """Read a frame by its position in the order of publishing.
+
+        Arguments:
+            index: position of the frame, starting at 0.
+
+        Returns:
+            The frame or None if it was not published yet or has already been
+            overwritten.
+        """
+        frame = self._reader.read(index)
+        return LiveFrame(*frame) if frame is not None else None
+
+    def read_latest(self) -> LiveFrame | None:
+        """Read the most recently published frame.
+
+        Returns:
+            The frame or None if no frame was published yet.
+        """
+        frame = self._reader.read_latest()
+        return LiveFrame(*frame) if frame is not None else None
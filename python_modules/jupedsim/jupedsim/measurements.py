@@ -0,0 +1,70 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+from dataclasses import dataclass
+
+import numpy as np
+import numpy.typing as npt
+
+
+@dataclass
+class GridMeasurement:
+    """Density and speed fields measured on a regular grid.
+
+    The fields are averaged over all samples taken so far. Both arrays have
+    the shape ``(rows, columns)``, ``density[0, 0]`` is the cell at
+    ``origin``, rows grow along the y-axis.
+    """
+
+    origin: tuple[float, float]
+    """Lower left corner of the first cell."""
+    cell_size: float
+    """Edge length of the square cells in meters."""
+    samples: int
+    """Number of samples taken so far."""
+    density: npt.NDArray[np.float64]
+    """Mean number of agents per square meter in each cell."""
+    speed: npt.NDArray[np.float64]
+    """Mean speed in meters per second of the agents sampled in each cell,
+    NaN for cells no agent was sampled in."""
+
+
+@dataclass
+class LineMeasurement:
+    """Agents that crossed a measurement line.
+
+    The arrays have one entry per crossing, ordered by time.
+    """
+
+    forward: int
+    """Number of crossings from the right to the left side of the line."""
+    backward: int
+    """Number of crossings from the left to the right side of the line."""
+    time: npt.NDArray[np.float64]
+    """Time in seconds of each crossing, interpolated within the iteration."""
+    agent_id: npt.NDArray[np.uint64]
+    """Agent of each crossing."""
+    direction: npt.NDArray[np.int8]
+    """1 for forward and -1 for backward crossings."""
+
+    def flow(self, start: float, stop: float) -> float:
+        """Net number of agents crossing forward per second.
+
+        Arguments:
+            start: begin of the time span in seconds
+            stop: end of the time span in seconds, needs to be greater than
+                ``start``
+
+        Returns:
+            Net flow in agents per second within [start, stop).
+        """
+        mask = (self.time >= start) & (self.time < stop)
+        return float(self.direction[mask].sum()) / (stop - start)
+
+
+@dataclass
+class AreaMeasurement:
+    """Number of agents inside a polygon over time."""
+
+    time: npt.NDArray[np.float64]
+    """Time in seconds of each sample."""
+    count: npt.NDArray[np.uint64]
+    """Number of agents inside the polygon at each sample."""
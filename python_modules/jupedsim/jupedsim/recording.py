@@ -2,6 +2,8 @@
 import sqlite3
 from dataclasses import dataclass
 
+import numpy as np
+import numpy.typing as npt
 import shapely
 
 from jupedsim.internal.aabb import AABB
@@ -25,6 +27,95 @@ class RecordingFrame:
     agents: list[RecordingAgent]
 
 
+@dataclass
+class AgentTrajectory:
+    """Recorded data of a single agent as columns, ordered by frame."""
+
+    id: int
+    frame: npt.NDArray[np.int64]
+    x: npt.NDArray[np.float64]
+    y: npt.NDArray[np.float64]
+    orientation_x: npt.NDArray[np.float64]
+    orientation_y: npt.NDArray[np.float64]
+
+    def __len__(self) -> int:
+        return len(self.frame)
+
+
+@dataclass
+class RecordingFrames:
+    """Agent data of a range of frames as columns.
+
+    All arrays have the same length, the i-th entry of each array belongs to
+    the i-th row. Rows are ordered by frame and agent id.
+    """
+
+    frame: npt.NDArray[np.int64]
+    """Frame each row belongs to."""
+    id: npt.NDArray[np.int64]
+    """Agent each row belongs to."""
+    x: npt.NDArray[np.float64]
+    y: npt.NDArray[np.float64]
+    orientation_x: npt.NDArray[np.float64]
+    orientation_y: npt.NDArray[np.float64]
+
+    def __len__(self) -> int:
+        return len(self.frame)
+
+    def agent_trajectories(self) -> dict[int, AgentTrajectory]:
+        """Splits the rows into one trajectory per agent.
+
+        Returns:
+            Data of each agent keyed by agent id.
+
+        """
+        order = np.lexsort((self.frame, self.id))
+        ids = self.id[order]
+        columns = [
+            column[order]
+            for column in (
+                self.frame,
+                self.x,
+                self.y,
+                self.orientation_x,
+                self.orientation_y,
+            )
+        ]
+        agent_ids, starts = np.unique(ids, return_index=True)
+        stops = np.append(starts[1:], len(ids))
+        return {
+            int(agent_id): AgentTrajectory(
+                int(agent_id), *(column[begin:end] for column in columns)
+            )
+            for agent_id, begin, end in zip(agent_ids, starts, stops)
+        }
+
+
+_ROW_DTYPE = np.dtype(
+    [
+        ("frame", np.int64),
+        ("id", np.int64),
+        ("x", np.float64),
+        ("y", np.float64),
+        ("orientation_x", np.float64),
+        ("orientation_y", np.float64),
+    ]
+)
+
+
+def _read_rows(cursor: sqlite3.Cursor) -> np.ndarray:
+    # Rows are converted while iterating, no Python object is kept per row
+    return np.fromiter(cursor, dtype=_ROW_DTYPE)
+
+
+def _column(rows: np.ndarray, name: str) -> np.ndarray:
+    return np.ascontiguousarray(rows[name])
+
+
+def _frames_from_rows(rows: np.ndarray) -> RecordingFrames:
+    return RecordingFrames(*(_column(rows, name) for name in _ROW_DTYPE.names))
+
+
 class Recording:
     __supported_database_version = 2
     """Provides access to a simulation recording in a sqlite database"""
@@ -35,6 +126,7 @@ class Recording:
         )
         update_database_to_latest_version(self.db)
         self._check_version_compatible()
+        self._has_agent_index = False
 
     def frame(self, index: int) -> RecordingFrame:
         """Access a single frame of the recording.
@@ -58,6 +150,86 @@ class Recording:
         )
         return RecordingFrame(index, res.fetchall())
 
+    def frames(self, start: int, stop: int) -> RecordingFrames:
+        """Access all frames in [start, stop) at once.
+
+        Reads the whole range with a single query, this is much faster than
+        calling :func:`frame` for each frame.
+
+        Arguments:
+            start: first frame to read.
+            stop: frame after the last frame to read.
+
+        Returns:
+            The agent data of all frames in the range as columns.
+
+        """
+        cur = self.db.cursor()
+        rows = _read_rows(
+            cur.execute(
+                "SELECT frame, id, pos_x, pos_y, ori_x, ori_y FROM trajectory_data "
+                "WHERE frame >= (?) AND frame < (?) ORDER BY frame ASC, id ASC",
+                (start, stop),
+            )
+        )
+        return _frames_from_rows(rows)
+
+    def agent_ids(self) -> npt.NDArray[np.int64]:
+        """Ids of all agents in this recording, ascending."""
+        self._ensure_agent_index()
+        cur = self.db.cursor()
+        rows = cur.execute(
+            "SELECT DISTINCT id FROM trajectory_data ORDER BY id ASC"
+        )
+        return np.fromiter((row[0] for row in rows), dtype=np.int64)
+
+    def agent_trajectory(self, agent_id: int) -> AgentTrajectory:
+        """Access all recorded data of a single agent.
+
+        On first use an index on the agent ids is added to the database if it
+        is writable, otherwise each call scans the whole recording.
+
+        Arguments:
+            agent_id: id of the agent.
+
+        Returns:
+            Data of the agent in all frames it was recorded in.
+
+        """
+        self._ensure_agent_index()
+        cur = self.db.cursor()
+        rows = _read_rows(
+            cur.execute(
+                "SELECT frame, id, pos_x, pos_y, ori_x, ori_y FROM trajectory_data "
+                "WHERE id == (?) ORDER BY frame ASC",
+                (int(agent_id),),
+            )
+        )
+        return AgentTrajectory(
+            agent_id,
+            *(_column(rows, name) for name in _ROW_DTYPE.names if name != "id"),
+        )
+
+    def agent_trajectories(self) -> dict[int, AgentTrajectory]:
+        """Access the recorded data of all agents at once.
+
+        Reads the recording with a single query, this is much faster than
+        calling :func:`agent_trajectory` for each agent.
+
+        Returns:
+            Data of each agent keyed by agent id.
+
+        """
+        cur = self.db.cursor()
+        # Reading in table order and sorting in NumPy is faster than reading
+        # in index order
+        rows = _read_rows(
+            cur.execute(
+                "SELECT frame, id, pos_x, pos_y, ori_x, ori_y FROM trajectory_data"
+            )
+        )
+        return _frames_from_rows(rows).agent_trajectories()
+
     def geometry(self) -> shapely.GeometryCollection:
         """Access this recordings' geometry.
 
@@ -115,6 +287,18 @@ class Recording:
         res = cur.execute("SELECT value from metadata WHERE key == 'fps'")
         return float(res.fetchone()[0])
 
+    def _ensure_agent_index(self) -> None:
+        if self._has_agent_index:
+            return
+        try:
+            self.db.execute(
+                "CREATE INDEX IF NOT EXISTS id_frame_idx ON trajectory_data(id, frame)"
+            )
+        except sqlite3.OperationalError:
+            # Read only databases are queried without the index
+            pass
+        self._has_agent_index = True
+
     def _check_version_compatible(self) -> None:
         cur = self.db.cursor()
         res = cur.execute("SELECT value FROM metadata WHERE key == 'version'")
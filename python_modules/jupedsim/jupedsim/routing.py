@@ -1,13 +1,52 @@
 # SPDX-License-Identifier: LGPL-3.0-or-later
 
+from dataclasses import dataclass
+from enum import Enum
 from typing import Any
 
+import numpy as np
+import numpy.typing as npt
 import shapely
 
 import jupedsim.native as py_jps
 from jupedsim.geometry_utils import build_geometry
 
 
+class RoutingAlgorithm(Enum):
+    """Path search used to route agents, see
+    :func:`~jupedsim.simulation.Simulation.set_routing_algorithm`."""
+
+    TRIANGLE_A_STAR = py_jps.RoutingAlgorithm.TriangleAStar
+    """A* over the triangles of the navigation mesh with funnel straightening.
+    Fast, but paths may be longer than the shortest path."""
+    POLYANYA = py_jps.RoutingAlgorithm.Polyanya
+    """Any-angle search over the merged convex polygons of the navigation
+    mesh. Always finds the shortest path."""
+    HIERARCHICAL = py_jps.RoutingAlgorithm.Hierarchical
+    """Search between the regions of the navigation mesh first, then A* over
+    the triangles of the regions along the found path only. Needs a geometry
+    built with ``routing_region_size``, otherwise the same as
+    :attr:`TRIANGLE_A_STAR`."""
+
+
+@dataclass
+class PathBatch:
+    """Paths between many pairs of points as arrays, the i-th entry of each
+    array belongs to the i-th pair. See
+    :meth:`RoutingEngine.compute_waypoints_batch`."""
+
+    length: npt.NDArray[np.float64]
+    """Length of each path, infinite if the pair cannot be routed."""
+    waypoints: npt.NDArray[np.float64]
+    """Waypoints of each path including start and target, shape
+    (pairs, max_waypoints, 2). Only the first ``waypoint_count`` entries of
+    each path are valid."""
+    waypoint_count: npt.NDArray[np.uint64]
+    """Number of waypoints of each path, 0 if the pair cannot be routed. May
+    exceed ``max_waypoints``, these paths are truncated in
+    :attr:`waypoints`."""
+
+
 class RoutingEngine:
     """RoutingEngine to compute the shortest paths with navigation meshes."""
 
@@ -59,6 +98,72 @@ class RoutingEngine:
         """
         return self._obj.compute_waypoints(frm, to)
 
+    def compute_waypoints_batch(
+        self,
+        frm: npt.ArrayLike,
+        to: npt.ArrayLike,
+        *,
+        algorithm: RoutingAlgorithm = RoutingAlgorithm.TRIANGLE_A_STAR,
+        thread_count: int = 0,
+        max_waypoints: int = 0,
+    ) -> PathBatch:
+        """Computes the shortest paths between many pairs of points in
+        parallel.
+
+        The paths are computed on native threads without holding the GIL.
+        Pairs that cannot be routed, because a point is outside of the
+        walkable area or the points are not connected, get an infinite length.
+
+        Arguments:
+            frm: start points as array of shape (pairs, 2)
+            to: target points as array of shape (pairs, 2)
+            algorithm: path search used for all pairs
+            thread_count: number of threads to use, 0 uses one thread per
+                hardware thread
+            max_waypoints: number of waypoints stored per path, 0 computes
+                the lengths only
+
+        Returns:
+            Lengths and waypoints of all paths.
+        """
+        length, waypoints, waypoint_count = self._obj.compute_waypoints_batch(
+            frm=frm,
+            to=to,
+            algorithm=algorithm.value,
+            thread_count=thread_count,
+            max_waypoints=max_waypoints,
+        )
+        return PathBatch(length, waypoints, waypoint_count)
+
+    def compute_distance_matrix(
+        self,
+        points: npt.ArrayLike,
+        *,
+        algorithm: RoutingAlgorithm = RoutingAlgorithm.TRIANGLE_A_STAR,
+        thread_count: int = 0,
+    ) -> npt.NDArray[np.float64]:
+        """Computes the walking distances between all pairs of points.
+
+        Arguments:
+            points: points as array of shape (n, 2)
+            algorithm: path search used for all pairs
+            thread_count: number of threads to use, 0 uses one thread per
+                hardware thread
+
+        Returns:
+            Matrix of shape (n, n) with the length of the shortest path from
+            points[i] to points[j] at [i, j], infinite if there is no path.
+        """
+        points = np.asarray(points, dtype=np.float64).reshape(-1, 2)
+        count = len(points)
+        batch = self.compute_waypoints_batch(
+            np.repeat(points, count, axis=0),
+            np.tile(points, (count, 1)),
+            algorithm=algorithm,
+            thread_count=thread_count,
+        )
+        return batch.length.reshape(count, count)
+
     def is_routable(self, p: tuple[float, float]) -> bool:
         """Tests if the supplied point is inside the underlying geometry.
 
@@ -68,6 +173,20 @@ class RoutingEngine:
         """
         return self._obj.is_routable(p)
 
+    def find_containing_polygons(
+        self, points: list[tuple[float, float]]
+    ) -> list[int | None]:
+        """Locates points in the navigation mesh.
+
+        Arguments:
+            points: points to locate
+
+        Returns:
+            For each point the index of the polygon in :meth:`mesh` containing
+            it or None if the point is outside of the navigation mesh.
+        """
+        return self._obj.find_containing_polygons(points)
+
     def mesh(
         self,
     ) -> tuple[list[tuple[float, float]], list[list[int]]]:
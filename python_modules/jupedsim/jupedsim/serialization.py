@@ -29,6 +29,12 @@ class TrajectoryWriter(metaclass=abc.ABCMeta):
         This method is intended to handle serialization of the trajectory data
         of a single iteration.
 
+        :func:`Simulation.iterate` calls this after every iteration when
+        advancing a single iteration. When advancing several iterations at
+        once it is only called for iterations that are a multiple of
+        :func:`every_nth_frame`, writers that need to observe every iteration
+        have to return 1 there.
+
         """
         raise NotImplementedError
 
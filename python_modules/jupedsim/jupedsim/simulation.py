@@ -1,15 +1,22 @@
 # SPDX-License-Identifier: LGPL-3.0-or-later
 
+import os
 from typing import Any, Iterable
 
 import shapely
 
 import jupedsim.native as py_jps
 from jupedsim.agent import Agent
+from jupedsim.events import Events
 from jupedsim.geometry import Geometry
 from jupedsim.geometry_utils import build_geometry
-from jupedsim.internal.tracing import Trace
+from jupedsim.internal.tracing import MemoryStats, Trace
 from jupedsim.journey import JourneyDescription
+from jupedsim.measurements import (
+    AreaMeasurement,
+    GridMeasurement,
+    LineMeasurement,
+)
 from jupedsim.models.anticipation_velocity_model import (
     AnticipationVelocityModel,
     AnticipationVelocityModelAgentParameters,
@@ -30,6 +37,7 @@ from jupedsim.models.social_force import (
     SocialForceModel,
     SocialForceModelAgentParameters,
 )
+from jupedsim.routing import RoutingAlgorithm
 from jupedsim.serialization import TrajectoryWriter
 from jupedsim.stages import (
     ExitStage,
@@ -60,7 +68,8 @@ class Simulation:
             | SocialForceModel
         ),
         geometry: (
-            str
+            Geometry
+            | str
             | shapely.GeometryCollection
             | shapely.Polygon
             | shapely.MultiPolygon
@@ -79,6 +88,8 @@ class Simulation:
             geometry:
                 Data to create the geometry out of. Data may be supplied as:
 
+                * :class:`~jupedsim.geometry.Geometry`, e.g. built once with :func:`~jupedsim.build_geometry`. Simulations created from the same :class:`~jupedsim.geometry.Geometry` share its data, including the navigation mesh, instead of building it again.
+
                 * list of 2d points describing the outer boundary, holes may be added with use of `excluded_areas` kw-argument
 
                 * :class:`~shapely.GeometryCollection` consisting only out of :class:`Polygons <shapely.Polygon>`, :class:`MultiPolygons <shapely.MultiPolygon>` and :class:`MultiPoints <shapely.MultiPoint>`
@@ -139,6 +150,7 @@ class Simulation:
         else:
             raise Exception("Unknown model type supplied")
         self._writer = trajectory_writer
+        self._writer_started = False
         self._obj = py_jps.Simulation(
             model=py_jps_model, geometry=build_geometry(geometry)._obj, dt=dt
         )
@@ -304,16 +316,41 @@ class Simulation:
     def iterate(self, count: int = 1) -> None:
         """Advance the simulation by the given number of iterations.
 
+        The iterations are computed natively without holding the GIL, other
+        Python threads keep running meanwhile. With ``count`` greater than 1
+        control only returns to Python to write the frames selected by the
+        writer's :func:`TrajectoryWriter.every_nth_frame`, with ``count`` 1
+        the writer is called after every iteration. Do not access the
+        simulation from other threads while it is iterating.
+
         Arguments:
             count: Number of iterations to advance
         """
-        if self._writer and self.iteration_count() == 0:
+        if not self._writer:
+            self._obj.iterate(count)
+            return
+
+        # Not tied to iteration 0, a restored simulation starts later
+        if not self._writer_started:
             self._writer.begin_writing(self)
             self._writer.write_iteration_state(self)
+            self._writer_started = True
 
-        for _ in range(0, count):
-            self._obj.iterate()
-            if self._writer:
+        if count == 1:
+            self._obj.iterate(1)
+            self._writer.write_iteration_state(self)
+            return
+
+        every_nth_frame = self._writer.every_nth_frame()
+        remaining = count
+        while remaining > 0:
+            until_next_frame = every_nth_frame - (
+                self.iteration_count() % every_nth_frame
+            )
+            steps = min(remaining, until_next_frame)
+            self._obj.iterate(steps)
+            remaining -= steps
+            if self.iteration_count() % every_nth_frame == 0:
                 self._writer.write_iteration_state(self)
 
     def switch_agent_journey(
@@ -321,6 +358,9 @@ class Simulation:
     ) -> None:
         """Switch agent to the given journey at the given stage.
 
+        Records a :attr:`EventType.STAGE_CHANGED` event if the agent targets a
+        different stage afterwards.
+
         Arguments:
             agent_id: Id of the agent to switch
             journey_id: Id of the new journey to follow
@@ -330,6 +370,84 @@ class Simulation:
             agent_id=agent_id, journey_id=journey_id, stage_id=stage_id
         )
 
+    def add_periodic_queue_pop(
+        self,
+        stage_id: int,
+        interval: float,
+        count: int = 1,
+        start_time: float = 0.0,
+    ) -> None:
+        """Pop agents from a queue at a fixed service rate.
+
+        The queue is popped at the beginning of each iteration starting at or
+        after ``start_time``, ``start_time + interval``, ... If several pops
+        fall due within one iteration, e.g. because ``interval`` is shorter
+        than the time step, all of them are applied in that iteration. This
+        replaces calling :func:`NotifiableQueueStage.pop` between iterations.
+
+        Arguments:
+            stage_id: Id of the queue to pop from
+            interval: Time in seconds between two pops, needs to be greater
+                than 0
+            count: Number of agents to pop each time
+            start_time: Time in seconds of the first pop
+        """
+        self._obj.add_periodic_queue_pop(
+            stage_id=stage_id,
+            interval=interval,
+            count=count,
+            start_time=start_time,
+        )
+
+    def add_waiting_set_thresholds(
+        self, stage_id: int, deactivate_at: int, activate_at: int = 0
+    ) -> None:
+        """Activate and deactivate a waiting set based on its occupancy.
+
+        The waiting set is deactivated once ``deactivate_at`` agents are
+        waiting and activated again once at most ``activate_at`` agents target
+        it. Thresholds are checked at the beginning of each iteration.
+
+        Arguments:
+            stage_id: Id of the waiting set to control
+            deactivate_at: Number of waiting agents to deactivate the waiting
+                set at, between 1 and the number of waiting positions
+            activate_at: Number of targeting agents to activate the waiting
+                set at, less than ``deactivate_at``
+        """
+        self._obj.add_waiting_set_thresholds(
+            stage_id=stage_id,
+            deactivate_at=deactivate_at,
+            activate_at=activate_at,
+        )
+
+    def schedule_journey_switch(
+        self,
+        time: float,
+        from_journey_id: int,
+        to_journey_id: int,
+        to_stage_id: int,
+    ) -> None:
+        """Switch all agents of a journey to another journey at a given time.
+
+        The switch is applied at the beginning of the first iteration starting
+        at or after ``time`` to all agents following ``from_journey_id`` at
+        that moment.
+
+        Arguments:
+            time: Time in seconds to switch at
+            from_journey_id: Id of the journey of the agents to switch
+            to_journey_id: Id of the new journey to follow
+            to_stage_id: Id of the stage in the new journey the agents
+                continue with
+        """
+        self._obj.schedule_journey_switch(
+            time=time,
+            from_journey_id=from_journey_id,
+            to_journey_id=to_journey_id,
+            to_stage_id=to_stage_id,
+        )
+
     def agent_count(self) -> int:
         """Number of agents in the simulation.
 
@@ -461,12 +579,195 @@ class Simulation:
                     f"Internal error, unexpected type: {type(stage)}"
                 )
 
+    def set_event_recording(self, status: bool) -> None:
+        """Enable / disable recording of events.
+
+        While enabled the simulation records stage changes, agent removals,
+        queue and waiting set updates as they happen during :func:`iterate`.
+        Recorded events are kept until read with :func:`read_events`.
+        Recording is disabled by default, disabling it discards all unread
+        events.
+
+        Arguments:
+            status: enable / disable event recording
+        """
+        self._obj.set_event_recording(status)
+
+    def set_routing_algorithm(self, algorithm: RoutingAlgorithm) -> None:
+        """Select the path search used to route agents to their next stage.
+
+        :attr:`RoutingAlgorithm.POLYANYA` always finds the shortest path,
+        :attr:`RoutingAlgorithm.TRIANGLE_A_STAR` (the default) may find
+        slightly longer paths around obstacles.
+
+        Arguments:
+            algorithm: path search to use from the next iteration on
+        """
+        self._obj.set_routing_algorithm(algorithm.value)
+
+    def routing_algorithm(self) -> RoutingAlgorithm:
+        """Path search used to route agents.
+
+        Returns:
+            The selected :class:`RoutingAlgorithm`
+        """
+        return RoutingAlgorithm(self._obj.get_routing_algorithm())
+
+    def read_events(self) -> Events:
+        """Read and remove all recorded events.
+
+        Reacting to events only requires work proportional to the number of
+        events instead of inspecting all agents after each iteration.
+
+        Returns:
+            All events recorded since the last call, see :class:`Events`.
+        """
+        return Events(*self._obj.read_events())
+
+    def add_grid_measurement(
+        self,
+        bounds: tuple[float, float, float, float],
+        cell_size: float,
+        interval: float,
+    ) -> int:
+        """Measure density and speed on a regular grid while simulating.
+
+        Every ``interval`` seconds, starting with the next iteration, each
+        agent inside the grid is counted in its cell together with the speed
+        it moved with in that iteration. The grid starts at the lower left
+        corner of ``bounds`` and is extended to a multiple of ``cell_size``
+        if needed.
+
+        Arguments:
+            bounds: Measured area as (xmin, ymin, xmax, ymax)
+            cell_size: Edge length of the square cells in meters
+            interval: Time in seconds between two samples
+
+        Returns:
+            Id of the measurement, see :func:`get_grid_measurement`
+        """
+        xmin, ymin, xmax, ymax = bounds
+        return self._obj.add_grid_measurement(
+            min=(xmin, ymin),
+            max=(xmax, ymax),
+            cell_size=cell_size,
+            interval=interval,
+        )
+
+    def get_grid_measurement(self, measurement_id: int) -> GridMeasurement:
+        """Read the fields of a grid measurement.
+
+        Arguments:
+            measurement_id: Id returned by :func:`add_grid_measurement`
+
+        Returns:
+            Density and speed averaged over all samples taken so far.
+        """
+        return GridMeasurement(*self._obj.read_grid_measurement(measurement_id))
+
+    def add_line_measurement(
+        self, p1: tuple[float, float], p2: tuple[float, float]
+    ) -> int:
+        """Record all agents crossing a line segment while simulating.
+
+        Arguments:
+            p1: Start of the line
+            p2: End of the line
+
+        Returns:
+            Id of the measurement, see :func:`get_line_measurement`
+        """
+        return self._obj.add_line_measurement(p1=p1, p2=p2)
+
+    def get_line_measurement(self, measurement_id: int) -> LineMeasurement:
+        """Read the crossings of a line measurement.
+
+        Arguments:
+            measurement_id: Id returned by :func:`add_line_measurement`
+
+        Returns:
+            All crossings recorded so far.
+        """
+        return LineMeasurement(*self._obj.read_line_measurement(measurement_id))
+
+    def add_area_measurement(
+        self,
+        polygon: (
+            str
+            | shapely.GeometryCollection
+            | shapely.Polygon
+            | shapely.MultiPolygon
+            | shapely.MultiPoint
+            | list[tuple[float, float]]
+        ),
+        interval: float,
+    ) -> int:
+        """Count the agents inside a polygon while simulating.
+
+        Arguments:
+            polygon: Polygon without holes to count the agents in, accepts
+                the same types as :func:`agents_in_polygon`. The polygon may
+                be concave.
+            interval: Time in seconds between two samples, the first sample
+                is taken in the next iteration
+
+        Returns:
+            Id of the measurement, see :func:`get_area_measurement`
+        """
+        return self._obj.add_area_measurement(
+            polygon=build_geometry(polygon).boundary(), interval=interval
+        )
+
+    def get_area_measurement(self, measurement_id: int) -> AreaMeasurement:
+        """Read the samples of an area measurement.
+
+        Arguments:
+            measurement_id: Id returned by :func:`add_area_measurement`
+
+        Returns:
+            All samples taken so far.
+        """
+        return AreaMeasurement(*self._obj.read_area_measurement(measurement_id))
+
     def set_tracing(self, status: bool) -> None:
         self._obj.set_tracing(status)
 
+    def set_hardware_counters(self, status: bool) -> bool:
+        """Enable / disable sampling of hardware performance counters.
+
+        When enabled, each traced span additionally reports CPU cycles,
+        instructions, cache misses and branch misses. Counters are only
+        sampled while tracing is enabled, see :func:`set_tracing`.
+
+        Hardware counters are only supported on Linux and require permission
+        to use perf events. If they are not available all counter values are
+        reported as zero.
+
+        Arguments:
+            status: enable / disable hardware counters
+
+        Returns:
+            True if hardware counters are enabled and available.
+        """
+        return self._obj.set_hardware_counters(status)
+
     def get_last_trace(self) -> Trace:
         return self._obj.get_last_trace()
 
+    def get_memory_stats(self) -> MemoryStats:
+        """Estimated heap memory usage per subsystem.
+
+        Reports current and peak usage in bytes for the agents, the
+        neighborhood search, the active collision geometry, the active routing
+        engine and previously used geometries. Agent related values are
+        sampled on each call, their peaks are the maximum over all calls.
+        Geometry related values are sampled whenever the geometry changes.
+
+        Returns:
+            Memory usage per subsystem.
+        """
+        return MemoryStats(self._obj.get_memory_stats())
+
     def get_geometry(self) -> Geometry:
         """Current geometry of the simulation.
 
@@ -487,3 +788,78 @@ class Simulation:
         """
         internal_geometry = build_geometry(geometry)
         self._obj.switch_geometry(internal_geometry._obj)
+
+    def save_snapshot(self, path: str | os.PathLike) -> None:
+        """Write the complete state of the simulation to a binary snapshot.
+
+        The snapshot contains all stages, journeys and agents including their
+        model parameters, the stage controllers and the current iteration. Use
+        :meth:`load_snapshot` to continue the simulation from this state, e.g.
+        to run several what-if variants from a common starting point.
+
+        .. note ::
+            Recorded events, statistics and the random state of the
+            operational model are not part of the snapshot. Trajectory writers
+            are not notified when saving.
+
+        Arguments:
+            path: File to write the snapshot to, an existing file is replaced.
+        """
+        self._obj.save_snapshot(os.fspath(path))
+
+    def load_snapshot(self, path: str | os.PathLike) -> None:
+        """Restore a snapshot written by :meth:`save_snapshot`.
+
+        The simulation needs to be created with the same model, geometry and
+        ``dt`` as the simulation the snapshot was taken from and may not
+        contain any stages, journeys or agents yet. All stage, journey and
+        agent ids are the same as in the snapshot. A trajectory writer of this
+        simulation begins writing with the restored state on the next call to
+        :meth:`iterate`.
+
+        Arguments:
+            path: Snapshot file to read.
+
+        Raises:
+            RuntimeError: if the snapshot cannot be read or does not match
+                this simulation.
+        """
+        self._obj.load_snapshot(os.fspath(path))
+
+    def fork(
+        self,
+        *,
+        seed: int | None = None,
+        trajectory_writer: TrajectoryWriter | None = None,
+    ) -> "Simulation":
+        """Create an independent copy of this simulation in memory.
+
+        The copy shares the geometry and navigation data with this simulation
+        and copies all stages, journeys and agents. Both simulations can be
+        iterated independently afterwards, e.g. to run many continuations
+        from one warmed-up state with :func:`~jupedsim.run_ensemble`. Stage,
+        journey and agent ids are the same in both simulations.
+
+        .. note ::
+            Recorded events and statistics are not copied.
+
+        Arguments:
+            seed: Restarts the random number generator of the copied model,
+                stochastic models then continue differently than this
+                simulation. Without a seed the copy produces the same random
+                numbers.
+            trajectory_writer: Writer for the trajectory of the copy, starts
+                writing with the current state of the copy right away.
+
+        Returns:
+            The copy of this simulation.
+        """
+        fork = Simulation.__new__(Simulation)
+        fork._writer = trajectory_writer
+        fork._writer_started = False
+        fork._obj = self._obj.fork(seed)
+        if trajectory_writer:
+            trajectory_writer.begin_writing(fork)
+            trajectory_writer.write_iteration_state(fork)
+            fork._writer_started = True
+        return fork
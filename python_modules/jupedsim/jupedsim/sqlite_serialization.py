@@ -27,6 +27,42 @@ def uses_latest_database_version(connection: sqlite3.Connection) -> bool:
     return version == DATABASE_VERSION
 
 
+def create_database_tables(cursor: sqlite3.Cursor) -> None:
+    """Creates empty trajectory tables, replacing existing ones.
+
+    Has to be called inside a transaction.
+    """
+    cursor.execute("DROP TABLE IF EXISTS trajectory_data")
+    cursor.execute(
+        "CREATE TABLE trajectory_data ("
+        "   frame INTEGER NOT NULL,"
+        "   id INTEGER NOT NULL,"
+        "   pos_x REAL NOT NULL,"
+        "   pos_y REAL NOT NULL,"
+        "   ori_x REAL NOT NULL,"
+        "   ori_y REAL NOT NULL)"
+    )
+    cursor.execute("DROP TABLE IF EXISTS metadata")
+    cursor.execute(
+        "CREATE TABLE metadata(key TEXT NOT NULL UNIQUE PRIMARY KEY, value TEXT NOT NULL)"
+    )
+    cursor.execute("DROP TABLE IF EXISTS geometry")
+    cursor.execute(
+        "CREATE TABLE geometry("
+        "   hash INTEGER NOT NULL, "
+        "   wkt TEXT NOT NULL)"
+    )
+    cursor.execute("CREATE UNIQUE INDEX geometry_hash on geometry( hash)")
+    cursor.execute("DROP TABLE IF EXISTS frame_data")
+    cursor.execute(
+        "CREATE TABLE frame_data("
+        "   frame INTEGER NOT NULL,"
+        "   geometry_hash INTEGER NOT NULL)"
+    )
+
+    cursor.execute("CREATE INDEX frame_id_idx ON trajectory_data(frame, id)")
+
+
 class SqliteTrajectoryWriter(TrajectoryWriter):
     """Write trajectory data into a sqlite db"""
 
@@ -62,45 +98,15 @@ class SqliteTrajectoryWriter(TrajectoryWriter):
         cur = self._con.cursor()
         try:
             cur.execute("BEGIN")
-            cur.execute("DROP TABLE IF EXISTS trajectory_data")
-            cur.execute(
-                "CREATE TABLE trajectory_data ("
-                "   frame INTEGER NOT NULL,"
-                "   id INTEGER NOT NULL,"
-                "   pos_x REAL NOT NULL,"
-                "   pos_y REAL NOT NULL,"
-                "   ori_x REAL NOT NULL,"
-                "   ori_y REAL NOT NULL)"
-            )
-            cur.execute("DROP TABLE IF EXISTS metadata")
-            cur.execute(
-                "CREATE TABLE metadata(key TEXT NOT NULL UNIQUE PRIMARY KEY, value TEXT NOT NULL)"
-            )
+            create_database_tables(cur)
             cur.executemany(
                 "INSERT INTO metadata VALUES(?, ?)",
                 (("version", DATABASE_VERSION), ("fps", fps)),
             )
-            cur.execute("DROP TABLE IF EXISTS geometry")
-            cur.execute(
-                "CREATE TABLE geometry("
-                "   hash INTEGER NOT NULL, "
-                "   wkt TEXT NOT NULL)"
-            )
-            cur.execute("CREATE UNIQUE INDEX geometry_hash on geometry( hash)")
             cur.execute(
                 "INSERT INTO geometry VALUES(?, ?)",
                 (hash(geo), geo),
             )
-            cur.execute("DROP TABLE IF EXISTS frame_data")
-            cur.execute(
-                "CREATE TABLE frame_data("
-                "   frame INTEGER NOT NULL,"
-                "   geometry_hash INTEGER NOT NULL)"
-            )
-
-            cur.execute(
-                "CREATE INDEX frame_id_idx ON trajectory_data(frame, id)"
-            )
             cur.execute("COMMIT")
         except sqlite3.Error as e:
             cur.execute("ROLLBACK")
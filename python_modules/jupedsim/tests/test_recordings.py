@@ -4,8 +4,7 @@ import sqlite3
 from jupedsim.recording import Recording
 
 
-def test_can_read_db():
-    db_name = "file::memory:?cache=shared"
+def create_db(db_name):
     db = sqlite3.connect(db_name, uri=True)
     with db:
         db.execute(
@@ -40,6 +39,12 @@ def test_can_read_db():
             (2, 3, 1.1, 1.1, 0.9, 0.1),
         ]
         db.executemany("INSERT INTO trajectory_data VALUES(?,?,?,?,?,?)", data)
+    return db, data
+
+
+def test_can_read_db():
+    db_name = "file::memory:?cache=shared"
+    db, data = create_db(db_name)
     rec = Recording(db_name, uri=True)
     for frame_index in range(0, 3):
         frame = rec.frame(frame_index)
@@ -51,3 +56,33 @@ def test_can_read_db():
             assert agent.position == (test_data[2], test_data[3])
             assert agent.orientation == (test_data[4], test_data[5])
     assert rec.geometry() is not None
+
+
+def test_can_read_frame_range():
+    db_name = "file:frame_range?mode=memory&cache=shared"
+    db, data = create_db(db_name)
+    rec = Recording(db_name, uri=True)
+    frames = rec.frames(1, 3)
+    assert len(frames) == 6
+    assert frames.frame.tolist() == [row[0] for row in data[3:]]
+    assert frames.id.tolist() == [row[1] for row in data[3:]]
+    assert frames.x.tolist() == [row[2] for row in data[3:]]
+    assert frames.orientation_y.tolist() == [row[5] for row in data[3:]]
+    assert frames.x.flags.c_contiguous
+    assert len(rec.frames(3, 10)) == 0
+
+
+def test_can_read_agent_trajectories():
+    db_name = "file:agent_trajectories?mode=memory&cache=shared"
+    db, data = create_db(db_name)
+    rec = Recording(db_name, uri=True)
+    assert rec.agent_ids().tolist() == [1, 2, 3]
+    trajectory = rec.agent_trajectory(2)
+    assert trajectory.id == 2
+    assert trajectory.frame.tolist() == [0, 1, 2]
+    assert trajectory.y.tolist() == [1.1, 1.1, 1.1]
+    trajectories = rec.agent_trajectories()
+    assert sorted(trajectories) == [1, 2, 3]
+    for agent_id, agent_trajectory in trajectories.items():
+        assert agent_trajectory.id == agent_id
+        assert agent_trajectory.frame.tolist() == [0, 1, 2]
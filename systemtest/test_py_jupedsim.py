@@ -1,5 +1,6 @@
 # SPDX-License-Identifier: LGPL-3.0-or-later
 import jupedsim as jps
+import numpy as np
 import pytest
 import shapely
 
@@ -501,3 +502,589 @@ def test_agent_can_not_be_added_outside_geometry():
                 stage_id=exit_id,
             )
         )
+
+
+def test_run_ensemble_with_shared_geometry():
+    geometry = jps.build_geometry([(0, 0), (10, 0), (10, 10), (0, 10)])
+
+    def scenario(desired_speed):
+        simulation = jps.Simulation(
+            model=jps.CollisionFreeSpeedModel(), geometry=geometry
+        )
+        exit_id = simulation.add_exit_stage([(9, 4), (10, 4), (10, 6), (9, 6)])
+        journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+        for position in [(1, 2), (1, 5), (1, 8)]:
+            simulation.add_agent(
+                jps.CollisionFreeSpeedModelAgentParameters(
+                    position=position,
+                    journey_id=journey_id,
+                    stage_id=exit_id,
+                    desired_speed=desired_speed,
+                )
+            )
+        return simulation
+
+    desired_speeds = [0.8, 1.2, 1.6]
+    runs = jps.run_ensemble(
+        scenario, desired_speeds, max_iterations=5000, every_nth_frame=10
+    )
+
+    assert [run.parameters for run in runs] == desired_speeds
+    for run in runs:
+        assert run.error is None
+        assert run.agent_count == 0
+        assert run.removed_agent_count == 3
+        assert run.trajectory is not None
+        assert len(run.trajectory) > 3
+        assert (run.trajectory.iteration % 10 == 0).all()
+    # Faster agents leave earlier
+    assert (
+        runs[0].iteration_count
+        > runs[1].iteration_count
+        > runs[2].iteration_count
+    )
+
+
+def test_run_ensemble_reports_scenario_errors():
+    geometry = jps.build_geometry([(0, 0), (10, 0), (10, 10), (0, 10)])
+
+    def scenario(broken):
+        if broken:
+            raise ValueError("broken scenario")
+        return jps.Simulation(
+            model=jps.CollisionFreeSpeedModel(), geometry=geometry
+        )
+
+    runs = jps.run_ensemble(scenario, [False, True], max_iterations=10)
+    assert runs[0].error is None
+    assert "broken scenario" in runs[1].error
+
+
+def test_restored_snapshot_continues_identically(tmp_path):
+    geometry = jps.build_geometry([(0, 0), (10, 0), (10, 10), (0, 10)])
+
+    def create_simulation():
+        return jps.Simulation(
+            model=jps.CollisionFreeSpeedModel(), geometry=geometry
+        )
+
+    simulation = create_simulation()
+    exit_id = simulation.add_exit_stage([(9, 4), (10, 4), (10, 6), (9, 6)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    for position in [(1, 2), (1, 5), (1, 8)]:
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position, journey_id=journey_id, stage_id=exit_id
+            )
+        )
+    simulation.iterate(200)
+
+    snapshot = tmp_path / "snapshot.bin"
+    simulation.save_snapshot(snapshot)
+    restored = create_simulation()
+    restored.load_snapshot(snapshot)
+    assert restored.iteration_count() == 200
+
+    def positions(sim):
+        return sorted((agent.id, agent.position) for agent in sim.agents())
+
+    simulation.iterate(300)
+    restored.iterate(300)
+    assert positions(restored) == positions(simulation)
+
+    with pytest.raises(RuntimeError, match="without journeys and agents"):
+        restored.load_snapshot(snapshot)
+
+
+def test_restored_snapshot_writes_trajectory(tmp_path):
+    geometry = jps.build_geometry([(0, 0), (10, 0), (10, 10), (0, 10)])
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(), geometry=geometry
+    )
+    exit_id = simulation.add_exit_stage([(9, 4), (10, 4), (10, 6), (9, 6)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    for position in [(1, 2), (1, 5), (1, 8)]:
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position, journey_id=journey_id, stage_id=exit_id
+            )
+        )
+    simulation.iterate(200)
+    snapshot = tmp_path / "snapshot.bin"
+    simulation.save_snapshot(snapshot)
+
+    trajectory_file = tmp_path / "restored.sqlite"
+    restored = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=geometry,
+        trajectory_writer=jps.SqliteTrajectoryWriter(
+            output_file=trajectory_file, every_nth_frame=10
+        ),
+    )
+    restored.load_snapshot(snapshot)
+    restored.iterate(50)
+
+    recording = jps.Recording(str(trajectory_file))
+    assert recording.num_frames == 6
+    assert len(recording.frame(20).agents) == 3
+
+
+def test_forked_simulation_continues_independently():
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+    )
+    exit_id = simulation.add_exit_stage([(9, 4), (10, 4), (10, 6), (9, 6)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    agent_ids = [
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position, journey_id=journey_id, stage_id=exit_id
+            )
+        )
+        for position in [(1, 2), (1, 5), (1, 8)]
+    ]
+    simulation.iterate(100)
+
+    fork = simulation.fork(seed=7)
+    assert fork.iteration_count() == simulation.iteration_count()
+    for agent_id in agent_ids:
+        assert (
+            fork.agent(agent_id).position
+            == simulation.agent(agent_id).position
+        )
+
+    fork.mark_agent_for_removal(agent_ids[0])
+    fork.iterate()
+    simulation.iterate()
+    assert fork.agent_count() == 2
+    assert simulation.agent_count() == 3
+
+
+def test_forked_simulation_writes_trajectory(tmp_path):
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+    )
+    exit_id = simulation.add_exit_stage([(9, 4), (10, 4), (10, 6), (9, 6)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    for position in [(1, 2), (1, 5), (1, 8)]:
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position, journey_id=journey_id, stage_id=exit_id
+            )
+        )
+    simulation.iterate(100)
+
+    trajectory_file = tmp_path / "fork.sqlite"
+    fork = simulation.fork(
+        trajectory_writer=jps.SqliteTrajectoryWriter(
+            output_file=trajectory_file, every_nth_frame=10
+        )
+    )
+    recording = jps.Recording(str(trajectory_file))
+    assert recording.num_frames == 1
+    assert sorted(agent.position for agent in recording.frame(10).agents) == (
+        sorted(agent.position for agent in simulation.agents())
+    )
+
+    fork.iterate(50)
+    assert recording.num_frames == 6
+
+
+def test_online_measurements_match_agent_positions():
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+        dt=0.01,
+    )
+    exit_id = simulation.add_exit_stage([(9, 0), (10, 0), (10, 10), (9, 10)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    for position in [(1, 2), (1, 5), (1, 8)]:
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position, journey_id=journey_id, stage_id=exit_id
+            )
+        )
+    area = shapely.Polygon([(0, 0), (6, 0), (6, 10), (3, 5), (0, 10)])
+    grid_id = simulation.add_grid_measurement(
+        (0, 0, 10, 10), cell_size=2.5, interval=0.1
+    )
+    line_id = simulation.add_line_measurement((5, 10), (5, 0))
+    area_id = simulation.add_area_measurement(area, interval=0.01)
+
+    expected_counts = []
+    while simulation.agent_count() > 0:
+        simulation.iterate()
+        expected_counts.append(
+            sum(
+                area.covers(shapely.Point(agent.position))
+                for agent in simulation.agents()
+            )
+        )
+
+    occupancy = simulation.get_area_measurement(area_id)
+    assert occupancy.count.tolist() == expected_counts
+    assert np.allclose(
+        occupancy.time,
+        np.arange(1, len(expected_counts) + 1) * simulation.delta_time(),
+    )
+
+    crossings = simulation.get_line_measurement(line_id)
+    assert crossings.forward == 3
+    assert crossings.backward == 0
+    assert np.all(np.diff(crossings.time) >= 0)
+    assert crossings.flow(0, simulation.elapsed_time()) > 0
+
+    fields = simulation.get_grid_measurement(grid_id)
+    assert fields.density.shape == (4, 4)
+    assert fields.samples > 0
+    assert np.all(fields.density[:, 0] > 0)
+    assert np.all(np.isnan(fields.speed[fields.density == 0]))
+    assert np.nanmax(fields.speed) <= 1.2 + 1e-9
+
+    with pytest.raises(RuntimeError, match="Unknown area measurement"):
+        simulation.get_area_measurement(area_id + 1)
+
+
+def test_live_frames_can_be_read_while_simulating():
+    with jps.LiveFramePublisher(
+        name="jupedsim-systemtest-live", slots=4, capacity=8
+    ) as publisher:
+        simulation = jps.Simulation(
+            model=jps.CollisionFreeSpeedModel(),
+            geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+            trajectory_writer=publisher,
+        )
+        exit_id = simulation.add_exit_stage(
+            [(9, 0), (10, 0), (10, 10), (9, 10)]
+        )
+        journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+        for position in [(1, 2), (1, 5)]:
+            simulation.add_agent(
+                jps.CollisionFreeSpeedModelAgentParameters(
+                    position=position, journey_id=journey_id, stage_id=exit_id
+                )
+            )
+        # The buffer is created with the first iteration
+        simulation.iterate()
+        reader = jps.LiveFrameReader("jupedsim-systemtest-live")
+        assert reader.capacity == 8
+
+        for _ in range(9):
+            simulation.iterate()
+            latest = reader.read_latest()
+            agents = list(simulation.agents())
+            assert latest.frame == simulation.iteration_count()
+            assert latest.time == simulation.elapsed_time()
+            assert latest.id.tolist() == [agent.id for agent in agents]
+            assert np.allclose(
+                latest.x, [agent.position[0] for agent in agents]
+            )
+
+        assert reader.published_count() == 11
+        assert reader.read(6) is None
+        assert reader.read(7).frame == 7
+
+
+def test_geometry_cache_reuses_built_geometry(tmp_path):
+    area = shapely.Polygon(
+        [(0, 0), (10, 0), (10, 10), (0, 10)],
+        holes=[[(4, 4), (6, 4), (6, 6), (4, 6)]],
+    )
+    built = jps.build_geometry(area, cache_directory=tmp_path)
+    assert len(list(tmp_path.glob("*.jpsgeo"))) == 1
+
+    loaded = jps.build_geometry(area.wkt, cache_directory=tmp_path)
+    assert len(list(tmp_path.glob("*.jpsgeo"))) == 1
+    assert loaded.as_wkt() == built.as_wkt()
+
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(), geometry=loaded
+    )
+    exit_id = simulation.add_exit_stage([(9, 9), (10, 9), (10, 10), (9, 10)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    simulation.add_agent(
+        jps.CollisionFreeSpeedModelAgentParameters(
+            position=(1, 1), journey_id=journey_id, stage_id=exit_id
+        )
+    )
+    while simulation.agent_count() > 0 and simulation.iteration_count() < 5000:
+        simulation.iterate()
+    assert simulation.agent_count() == 0
+
+
+def test_geometry_simplification_merges_collinear_walls():
+    area = shapely.Polygon(
+        [(0, 0), (5, 0), (10, 0), (10, 5), (10, 10), (5, 10.001), (0, 10)]
+    )
+    assert (
+        len(shapely.from_wkt(jps.build_geometry(area).as_wkt()).exterior.coords)
+        == 8
+    )
+
+    simplified = shapely.from_wkt(
+        jps.build_geometry(area, simplification_tolerance=0.01).as_wkt()
+    )
+    assert len(simplified.exterior.coords) == 5
+    assert simplified.area == pytest.approx(100, abs=0.01)
+
+    with pytest.raises(RuntimeError):
+        jps.build_geometry(area, simplification_tolerance=-1)
+
+
+def test_wall_distance_field_keeps_agents_off_walls():
+    area = shapely.Polygon(
+        [(0, 0), (10, 0), (10, 10), (0, 10)],
+        holes=[[(4, 4), (6, 4), (6, 6), (4, 6)]],
+    )
+    geometry = jps.build_geometry(area, wall_distance_field_spacing=0.05)
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(), geometry=geometry
+    )
+    exit_id = simulation.add_exit_stage([(9, 9), (10, 9), (10, 10), (9, 10)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    simulation.add_agent(
+        jps.CollisionFreeSpeedModelAgentParameters(
+            position=(1, 1), journey_id=journey_id, stage_id=exit_id
+        )
+    )
+    while simulation.agent_count() > 0 and simulation.iteration_count() < 5000:
+        simulation.iterate()
+    assert simulation.agent_count() == 0
+
+    with pytest.raises(RuntimeError):
+        jps.build_geometry(area, wall_distance_field_spacing=0)
+
+
+def test_polyanya_routing_moves_agents_around_obstacles():
+    area = shapely.Polygon(
+        [(0, 0), (10, 0), (10, 10), (0, 10)],
+        holes=[[(4, 2), (6, 2), (6, 8), (4, 8)]],
+    )
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(), geometry=area
+    )
+    assert (
+        simulation.routing_algorithm() == jps.RoutingAlgorithm.TRIANGLE_A_STAR
+    )
+    simulation.set_routing_algorithm(jps.RoutingAlgorithm.POLYANYA)
+    assert simulation.routing_algorithm() == jps.RoutingAlgorithm.POLYANYA
+
+    exit_id = simulation.add_exit_stage([(9, 4), (10, 4), (10, 6), (9, 6)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    simulation.add_agent(
+        jps.CollisionFreeSpeedModelAgentParameters(
+            position=(1, 5), journey_id=journey_id, stage_id=exit_id
+        )
+    )
+    while simulation.agent_count() > 0 and simulation.iteration_count() < 5000:
+        simulation.iterate()
+    assert simulation.agent_count() == 0
+
+
+def test_hierarchical_routing_uses_geometry_hierarchy(tmp_path):
+    area = shapely.Polygon(
+        [(0, 0), (40, 0), (40, 40), (0, 40)],
+        holes=[
+            [(x, y), (x + 2, y), (x + 2, y + 2), (x, y + 2)]
+            for x in range(5, 40, 10)
+            for y in range(5, 40, 10)
+        ],
+    )
+    for cache_directory in [None, tmp_path, tmp_path]:
+        geometry = jps.build_geometry(
+            area, routing_region_size=10, cache_directory=cache_directory
+        )
+        simulation = jps.Simulation(
+            model=jps.CollisionFreeSpeedModel(), geometry=geometry
+        )
+        simulation.set_routing_algorithm(jps.RoutingAlgorithm.HIERARCHICAL)
+        exit_id = simulation.add_exit_stage(
+            [(38, 38), (40, 38), (40, 40), (38, 40)]
+        )
+        journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=(1, 1), journey_id=journey_id, stage_id=exit_id
+            )
+        )
+        while (
+            simulation.agent_count() > 0
+            and simulation.iteration_count() < 10000
+        ):
+            simulation.iterate()
+        assert simulation.agent_count() == 0
+
+    with pytest.raises(RuntimeError):
+        jps.build_geometry(area, routing_region_size=-1)
+
+
+def test_routing_engine_computes_paths_of_many_pairs():
+    area = shapely.Polygon(
+        [(0, 0), (10, 0), (10, 10), (0, 10)],
+        holes=[[(4, 2), (6, 2), (6, 8), (4, 8)]],
+    )
+    engine = jps.RoutingEngine(area)
+    # The last point is inside of the hole
+    points = np.array([(1, 5), (9, 5), (5, 9), (5, 5)])
+
+    distances = engine.compute_distance_matrix(
+        points, algorithm=jps.RoutingAlgorithm.POLYANYA, thread_count=2
+    )
+    assert distances.shape == (4, 4)
+    assert np.allclose(np.diag(distances)[:3], 0)
+    assert np.allclose(distances[:3, :3], distances[:3, :3].T)
+    assert distances[0, 1] == pytest.approx(6 * np.sqrt(2) + 2)
+    assert np.all(np.isinf(distances[3, :]))
+    assert np.all(np.isinf(distances[:, 3]))
+
+    batch = engine.compute_waypoints_batch(
+        points[:3], np.roll(points[:3], 1, axis=0), max_waypoints=2
+    )
+    assert batch.waypoints.shape == (3, 2, 2)
+    for index, (frm, to) in enumerate(
+        zip(points[:3], np.roll(points[:3], 1, axis=0))
+    ):
+        path = np.array(engine.compute_waypoints(tuple(frm), tuple(to)))
+        assert batch.waypoint_count[index] == len(path)
+        assert np.allclose(batch.waypoints[index], path[:2])
+        assert batch.length[index] == pytest.approx(
+            np.sum(np.linalg.norm(np.diff(path, axis=0), axis=1))
+        )
+
+    with pytest.raises(RuntimeError):
+        engine.compute_waypoints_batch(points, points[:2])
+
+
+def test_columnar_trajectory_converts_to_and_from_sqlite(tmp_path):
+    columnar_file = tmp_path / "trajectory.jps"
+    sqlite_file = tmp_path / "trajectory.sqlite"
+    writer = jps.ColumnarTrajectoryWriter(
+        output_file=columnar_file, every_nth_frame=10
+    )
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+        trajectory_writer=writer,
+    )
+    exit_id = simulation.add_exit_stage([(9, 4), (10, 4), (10, 6), (9, 6)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    for position in [(1, 2), (1, 5), (1, 8)]:
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position, journey_id=journey_id, stage_id=exit_id
+            )
+        )
+    with writer:
+        simulation.iterate(100)
+
+    reader = jps.ColumnarTrajectoryReader(columnar_file)
+    assert len(reader) == 11
+    assert reader.fps == 10
+    first_frame = reader.frame(0)
+    assert first_frame.id.tolist() == sorted(first_frame.id.tolist())
+    assert not first_frame.x.flags.writeable
+
+    jps.convert_columnar_to_sqlite(columnar_file, sqlite_file)
+    recording = jps.Recording(str(sqlite_file))
+    for frame in reader:
+        agents = recording.frame(frame.frame).agents
+        assert [agent.id for agent in agents] == frame.id.tolist()
+        assert [agent.position for agent in agents] == list(
+            zip(frame.x.tolist(), frame.y.tolist())
+        )
+
+    quantized_file = tmp_path / "quantized.jps"
+    jps.convert_sqlite_to_columnar(
+        sqlite_file,
+        quantized_file,
+        storage=jps.TrajectoryStorage.QUANTIZED,
+        quantization_step=0.001,
+    )
+    quantized = jps.ColumnarTrajectoryReader(quantized_file)
+    assert quantized.metadata["fps"] == reader.metadata["fps"]
+    assert quantized.geometries == reader.geometries
+    for original, converted in zip(reader, quantized):
+        assert converted.id.tolist() == original.id.tolist()
+        assert abs(converted.x - original.x).max(initial=0) <= 0.0005
+        assert abs(converted.y - original.y).max(initial=0) <= 0.0005
+
+
+def test_columnar_range_reads_match_recording(tmp_path):
+    columnar_file = tmp_path / "trajectory.jps"
+    sqlite_file = tmp_path / "trajectory.sqlite"
+    writer = jps.ColumnarTrajectoryWriter(
+        output_file=columnar_file, every_nth_frame=5
+    )
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+        trajectory_writer=writer,
+    )
+    exit_id = simulation.add_exit_stage([(9, 4), (10, 4), (10, 6), (9, 6)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    for position in [(8, 5), (1, 5), (1, 8)]:
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position, journey_id=journey_id, stage_id=exit_id
+            )
+        )
+    with writer:
+        simulation.iterate(500)
+    jps.convert_columnar_to_sqlite(columnar_file, sqlite_file)
+
+    reader = jps.ColumnarTrajectoryReader(columnar_file)
+    recording = jps.Recording(str(sqlite_file))
+    columnar_frames = reader.frames(10, 50)
+    recorded_frames = recording.frames(10, 50)
+    assert len(columnar_frames) > 0
+    for column in ("frame", "id", "x", "y", "orientation_x", "orientation_y"):
+        assert (
+            getattr(columnar_frames, column).tolist()
+            == getattr(recorded_frames, column).tolist()
+        )
+
+    columnar_trajectories = reader.agent_trajectories()
+    recorded_trajectories = recording.agent_trajectories()
+    assert sorted(columnar_trajectories) == recording.agent_ids().tolist()
+    for agent_id, trajectory in recorded_trajectories.items():
+        assert (
+            columnar_trajectories[agent_id].frame.tolist()
+            == trajectory.frame.tolist()
+        )
+        assert (
+            recording.agent_trajectory(agent_id).x.tolist()
+            == trajectory.x.tolist()
+        )
+    # The agent starting next to the exit leaves early
+    lengths = [len(trajectory) for trajectory in recorded_trajectories.values()]
+    assert min(lengths) < max(lengths)
+
+
+def test_iterate_calls_writer_per_iteration_or_per_frame():
+    class IterationRecorder(jps.TrajectoryWriter):
+        def __init__(self):
+            self.iterations = []
+
+        def begin_writing(self, simulation):
+            pass
+
+        def write_iteration_state(self, simulation):
+            self.iterations.append(simulation.iteration_count())
+
+        def every_nth_frame(self):
+            return 10
+
+    writer = IterationRecorder()
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+        trajectory_writer=writer,
+    )
+    simulation.iterate()
+    simulation.iterate()
+    assert writer.iterations == [0, 1, 2]
+
+    simulation.iterate(25)
+    assert writer.iterations == [0, 1, 2, 10, 20]
@@ -254,3 +254,106 @@ def test_can_not_add_notifiable_queue_outside_geometry(square_room_5x5):
         match=r"NotifiableQueue point .* not inside walkable area",
     ):
         simulation.add_queue_stage([(2, -2), (-10, -10)])
+
+
+def test_records_waiting_set_events(square_room_5x5):
+    simulation = square_room_5x5
+    waiting_set_id = simulation.add_waiting_set_stage([(-1, 0), (1, 0)])
+    journey_id = simulation.add_journey(
+        jps.JourneyDescription([waiting_set_id])
+    )
+    simulation.set_event_recording(True)
+
+    agent_ids = [
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position,
+                journey_id=journey_id,
+                stage_id=waiting_set_id,
+            )
+        )
+        for position in [(-1, -1), (1, -1)]
+    ]
+
+    while simulation.get_stage(waiting_set_id).count_waiting() < 2:
+        simulation.iterate()
+        assert simulation.iteration_count() < 1000
+
+    events = simulation.read_events()
+    entered = events.type == jps.EventType.WAITING_SET_ENTERED
+    assert sorted(events.agent_id[entered]) == sorted(agent_ids)
+    assert (events.stage_id[entered] == waiting_set_id).all()
+    full = events.type == jps.EventType.WAITING_SET_FULL
+    assert full.sum() == 1
+    assert len(simulation.read_events()) == 0
+
+
+def test_records_manual_journey_switch(square_room_5x5):
+    simulation = square_room_5x5
+    first_id = simulation.add_waypoint_stage((-1, 0), 0.5)
+    second_id = simulation.add_waypoint_stage((1, 0), 0.5)
+    first_journey_id = simulation.add_journey(
+        jps.JourneyDescription([first_id])
+    )
+    second_journey_id = simulation.add_journey(
+        jps.JourneyDescription([second_id])
+    )
+    agent_id = simulation.add_agent(
+        jps.CollisionFreeSpeedModelAgentParameters(
+            position=(0, -1), journey_id=first_journey_id, stage_id=first_id
+        )
+    )
+    simulation.set_event_recording(True)
+
+    simulation.switch_agent_journey(
+        agent_id=agent_id, journey_id=second_journey_id, stage_id=second_id
+    )
+
+    events = simulation.read_events()
+    assert len(events) == 1
+    assert events.type[0] == jps.EventType.STAGE_CHANGED
+    assert events.agent_id[0] == agent_id
+    assert events.stage_id[0] == second_id
+    assert events.previous_stage_id[0] == first_id
+
+
+def test_waiting_set_thresholds_reject_activation_not_below_deactivation(
+    square_room_5x5,
+):
+    simulation = square_room_5x5
+    waiting_set_id = simulation.add_waiting_set_stage([(-1, 0), (1, 0)])
+
+    with pytest.raises(RuntimeError, match="Activation threshold"):
+        simulation.add_waiting_set_thresholds(
+            waiting_set_id, deactivate_at=1, activate_at=1
+        )
+
+
+def test_waiting_set_thresholds_release_full_waiting_set(square_room_5x5):
+    simulation = square_room_5x5
+    waiting_set_id = simulation.add_waiting_set_stage([(-1, 0), (1, 0)])
+    exit_id = simulation.add_exit_stage(
+        [(1.5, 1.5), (2.5, 1.5), (2.5, 2.5), (1.5, 2.5)]
+    )
+    journey = jps.JourneyDescription([waiting_set_id, exit_id])
+    journey.set_transition_for_stage(
+        waiting_set_id, jps.Transition.create_fixed_transition(exit_id)
+    )
+    journey_id = simulation.add_journey(journey)
+    simulation.add_waiting_set_thresholds(waiting_set_id, deactivate_at=2)
+
+    for position in [(-1, -1), (1, -1)]:
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position,
+                journey_id=journey_id,
+                stage_id=waiting_set_id,
+            )
+        )
+
+    while simulation.agent_count() > 0:
+        simulation.iterate()
+        assert simulation.iteration_count() < 2000
+
+    waiting_set = simulation.get_stage(waiting_set_id)
+    assert waiting_set.state == jps.WaitingSetState.ACTIVE